@@ -30,6 +30,46 @@ typedef struct ice_fs_dir {
     unsigned long items_count;      /* Number of the items in the directory */
 } ice_fs_dir;
 
+/* Directory iterator, Yields items of directory one at a time from caller-provided buffer without any allocation */
+typedef struct ice_fs_dir_iter {
+    void *handle;                   /* [INTERNAL] Handle of opened directory (Depends on platform) */
+    int fd;                         /* [INTERNAL] File descriptor of opened directory (Unix only) */
+    char *buf;                      /* [INTERNAL] Caller-provided buffer where entries are read into */
+    unsigned long buf_size;         /* [INTERNAL] Size of the buffer in bytes */
+    unsigned long buf_len;          /* [INTERNAL] Bytes of entries currently in the buffer */
+    unsigned long buf_pos;          /* [INTERNAL] Offset of next entry in the buffer */
+    int error;                      /* 0 or errno value if reading entries failed (So ice_fs_dir_iter_next returned ICE_FS_FALSE before the end of directory) */
+} ice_fs_dir_iter;
+
+/* Handle of opened directory that *_at functions resolve relative paths from, Opened by ice_fs_dir_open */
+typedef struct ice_fs_dir_handle {
+    int fd;                         /* [INTERNAL] File descriptor of the directory (Unix only, -1 elsewhere) */
+    char *path;                     /* [INTERNAL] Full path of the directory (Windows only, NULL elsewhere) */
+} ice_fs_dir_handle;
+
+/* Compiled glob pattern with exclude patterns, Compiled by ice_fs_glob_compile and searched for with ice_fs_dir_glob (Can be shared by multiple threads once compiled) */
+typedef struct ice_fs_glob {
+    void *handle;                   /* [INTERNAL] Compiled rules */
+} ice_fs_glob;
+
+/* Arena that *_arena path functions allocate paths from, Zero-initialized arena is empty and ready to use, Paths are freed at once with ice_fs_path_arena_reset (Keeps memory for reuse) or ice_fs_free_path_arena */
+typedef struct ice_fs_path_arena {
+    void *chunks;                   /* [INTERNAL] Chunks of memory owned by the arena (Oldest first) */
+    void *current;                  /* [INTERNAL] Chunk that next paths are allocated from */
+} ice_fs_path_arena;
+
+/* Size of chunks in bytes that ice_fs_path_arena allocates memory in (ICE_FS_PATH_ARENA_CHUNK_SIZE) */
+enum { ICE_FS_PATH_ARENA_CHUNK_SIZE = 16384 };
+
+/* View into path (Part of path string that isn't null-terminated), Stored by *_span path functions */
+typedef struct ice_fs_path_span {
+    unsigned long offset;           /* Index of first char of the view in path */
+    unsigned long len;              /* Number of chars of the view */
+} ice_fs_path_span;
+
+/* Minimum size of buffer in bytes that ice_fs_dir_iter_open accepts (ICE_FS_DIR_ITER_MIN_BUFFER_SIZE) */
+enum { ICE_FS_DIR_ITER_MIN_BUFFER_SIZE = 1024 };
+
 /* Enumeration for week days */
 typedef enum ice_fs_date_day {
     ICE_FS_DATE_DAY_UNKNOWN = 0,
@@ -90,6 +130,255 @@ typedef enum ice_fs_date_type {
     ICE_FS_LAST_STATUS_CHANGE_DATE      /* Last status change date of file/directory */
 } ice_fs_date_type;
 
+/* Size of buffer in bytes that date is written into as string by ice_fs_date_from_epoch and ice_fs_get_date_r (Same format as ctime, With newline and NUL terminator) */
+enum { ICE_FS_DATE_STR_SIZE = 26 };
+
+/* Access pattern hints for memory-mapped files (Passed to ice_fs_map) */
+typedef enum ice_fs_map_hint {
+    ICE_FS_MAP_HINT_NORMAL = 0,         /* No special treatment */
+    ICE_FS_MAP_HINT_SEQUENTIAL,         /* Pages will be accessed in sequential order (Read ahead aggressively) */
+    ICE_FS_MAP_HINT_RANDOM,             /* Pages will be accessed in random order (Don't read ahead) */
+    ICE_FS_MAP_HINT_WILLNEED            /* Pages will be needed soon (Start reading them in background) */
+} ice_fs_map_hint;
+
+/* Read-only memory-mapped view of file (Retrieved via ice_fs_map) */
+typedef struct ice_fs_map_view {
+    const void *data;               /* Content of the file (NULL for empty files) */
+    unsigned long size;             /* Size of the content in bytes */
+    void *handle;                   /* [INTERNAL] Handle of file mapping (Microsoft Windows only) */
+} ice_fs_map_view;
+
+/* Offset/Size in file (64-bit even where long is 32-bit) */
+typedef long long ice_fs_offset;
+
+/* Modes to open streams with (Passed to ice_fs_stream_open) */
+typedef enum ice_fs_stream_mode {
+    ICE_FS_STREAM_MODE_READ = 0,        /* Read only */
+    ICE_FS_STREAM_MODE_WRITE,           /* Write only, File is created if doesn't exist or truncated if exists */
+    ICE_FS_STREAM_MODE_APPEND,          /* Write only at end of file, File is created if doesn't exist */
+    ICE_FS_STREAM_MODE_READ_WRITE,      /* Read and write, File is created if doesn't exist */
+    ICE_FS_STREAM_MODE_DIRECT_READ,     /* Read only bypassing page cache (Direct I/O), For big files read once */
+    ICE_FS_STREAM_MODE_DIRECT_WRITE     /* Write only bypassing page cache (Direct I/O), File is created if doesn't exist or truncated if exists */
+} ice_fs_stream_mode;
+
+/* Origins to seek streams from (Passed to ice_fs_stream_seek) */
+typedef enum ice_fs_seek_origin {
+    ICE_FS_SEEK_START = 0,              /* Beginning of file */
+    ICE_FS_SEEK_CURRENT,                /* Current position */
+    ICE_FS_SEEK_END                     /* End of file */
+} ice_fs_seek_origin;
+
+/* Access pattern hints for streams (Passed to ice_fs_stream_advise) */
+typedef enum ice_fs_stream_hint {
+    ICE_FS_STREAM_HINT_NORMAL = 0,      /* No special treatment */
+    ICE_FS_STREAM_HINT_SEQUENTIAL,      /* Range will be accessed in sequential order (Read ahead aggressively) */
+    ICE_FS_STREAM_HINT_RANDOM,          /* Range will be accessed in random order (Don't read ahead) */
+    ICE_FS_STREAM_HINT_WILLNEED,        /* Range will be needed soon (Start reading it in background) */
+    ICE_FS_STREAM_HINT_DONTNEED         /* Range won't be needed again (Drop it from cache) */
+} ice_fs_stream_hint;
+
+/* Alignment in bytes of buffers, offsets and sizes for direct I/O, Default of ice_fs_aligned_alloc (ICE_FS_DIRECT_ALIGNMENT) */
+enum { ICE_FS_DIRECT_ALIGNMENT = 4096 };
+
+/* Buffered stream of opened file, Reads and writes go through caller-provided or allocated buffer of fixed size */
+typedef struct ice_fs_stream {
+    int fd;                         /* [INTERNAL] File descriptor of opened file */
+    char *buf;                      /* [INTERNAL] Buffer (Caller-provided or allocated) */
+    unsigned long buf_size;         /* [INTERNAL] Size of the buffer in bytes */
+    unsigned long buf_pos;          /* [INTERNAL] Offset of next unread byte in the buffer */
+    unsigned long buf_len;          /* [INTERNAL] Bytes in the buffer (Read ahead or pending to be written) */
+    ice_fs_bool writing;            /* [INTERNAL] ICE_FS_TRUE if bytes in the buffer are pending to be written */
+    ice_fs_bool owns_buf;           /* [INTERNAL] ICE_FS_TRUE if the buffer was allocated by ice_fs_stream_open */
+    ice_fs_bool direct;             /* [INTERNAL] ICE_FS_TRUE while the file is accessed with direct I/O */
+} ice_fs_stream;
+
+/* Line iterator, Yields lines of file one at a time from sliding window buffer without allocation per line */
+typedef struct ice_fs_line_iter {
+    int fd;                         /* [INTERNAL] File descriptor of opened file */
+    char *buf;                      /* [INTERNAL] Sliding window buffer */
+    unsigned long buf_size;         /* [INTERNAL] Size of the buffer in bytes */
+    unsigned long buf_pos;          /* [INTERNAL] Offset of next line in the buffer */
+    unsigned long buf_len;          /* [INTERNAL] Bytes read into the buffer */
+    unsigned long scan_pos;         /* [INTERNAL] Offset where search for next newline continues */
+    ice_fs_bool eof;                /* [INTERNAL] ICE_FS_TRUE when end of file was reached */
+    ice_fs_bool failed;             /* ICE_FS_TRUE if iteration stopped because of failure */
+} ice_fs_line_iter;
+
+/* Modes to write files with (Passed to ice_fs_file_write_buf and ice_fs_file_writev) */
+typedef enum ice_fs_write_mode {
+    ICE_FS_WRITE_MODE_OVERWRITE = 0,    /* File is created if doesn't exist or truncated if exists */
+    ICE_FS_WRITE_MODE_APPEND,           /* Data is appended to end of file, File is created if doesn't exist */
+    ICE_FS_WRITE_MODE_ATOMIC            /* Data is written to temporary file that is flushed to disk then renamed over the file, So the file has either old or new content even after crash */
+} ice_fs_write_mode;
+
+/* Buffer of data to write (Passed to ice_fs_file_writev) */
+typedef struct ice_fs_buf {
+    const void *data;               /* Pointer to the data */
+    unsigned long len;              /* Size of the data in bytes */
+} ice_fs_buf;
+
+/* Fields of metadata that ice_fs_get_stats retrieves (Flags, Can be combined with |) */
+typedef enum ice_fs_stat_field {
+    ICE_FS_STAT_TYPE = 1,           /* Type of object */
+    ICE_FS_STAT_SIZE = 2,           /* Size in bytes */
+    ICE_FS_STAT_MTIME = 4,          /* Last modification time */
+    ICE_FS_STAT_MODE = 8,           /* Permission bits */
+    ICE_FS_STAT_ALL = 15            /* All of the above */
+} ice_fs_stat_field;
+
+/* Metadata of object retrieved by ice_fs_get_stats, Fields that weren't asked for are 0 (Except type, Which is ICE_FS_OBJECT_TYPE_NONE since 0 means file) */
+typedef struct ice_fs_stat_info {
+    ice_fs_offset size;             /* Size in bytes (ICE_FS_STAT_SIZE) */
+    ice_fs_offset mtime;            /* Last modification time in nanoseconds since epoch (ICE_FS_STAT_MTIME) */
+    unsigned mode;                  /* Permission bits like 0644 (ICE_FS_STAT_MODE) */
+    ice_fs_object_type type;        /* Type of object (ICE_FS_STAT_TYPE), ICE_FS_OBJECT_TYPE_NONE if it wasn't asked for or couldn't be retrieved */
+    int error;                      /* 0 on success or errno value if object doesn't exist or can't be accessed */
+} ice_fs_stat_info;
+
+/* Region of file retrieved by ice_fs_file_regions */
+typedef struct ice_fs_file_region {
+    ice_fs_offset offset;           /* Offset of the region in bytes */
+    ice_fs_offset len;              /* Size of the region in bytes */
+    ice_fs_bool hole;               /* ICE_FS_TRUE if the region is hole (Reads as zeros, Includes space reserved but never written) or ICE_FS_FALSE if it has data */
+} ice_fs_file_region;
+
+/* Disk usage of directory retrieved by ice_fs_dir_usage */
+typedef struct ice_fs_usage {
+    char *path;                     /* Full path of the directory */
+    ice_fs_offset size;             /* Apparent size in bytes of the directory and everything in it (Sum of sizes, Like du --apparent-size) */
+    ice_fs_offset allocated;        /* Disk space in bytes allocated for the directory and everything in it (Like du, Same as size on Microsoft Windows) */
+    unsigned long files_count;      /* Number of items (Files, Directories, Links...) in the directory and its subdirectories */
+    unsigned long depth;            /* Levels of the directory below directory in path (0 for directory in path itself) */
+} ice_fs_usage;
+
+/* Operations of batched I/O requests (Passed to ice_fs_batch_submit) */
+typedef enum ice_fs_batch_op {
+    ICE_FS_BATCH_OP_OPEN = 0,           /* Opens file in path in mode and stores its file descriptor in fd */
+    ICE_FS_BATCH_OP_READ,               /* Reads up to len bytes from file of fd at offset into buf */
+    ICE_FS_BATCH_OP_WRITE,              /* Writes up to len bytes from buf to file of fd at offset */
+    ICE_FS_BATCH_OP_STAT,               /* Stores type and size of object in path (Or of file of fd if path is NULL) in type and size */
+    ICE_FS_BATCH_OP_CLOSE               /* Closes fd */
+} ice_fs_batch_op;
+
+/* Batched I/O request, Fields that its operation doesn't use are ignored */
+typedef struct ice_fs_batch_req {
+    ice_fs_batch_op op;             /* Operation to run */
+    const char *path;               /* Path of object (OPEN, STAT) */
+    ice_fs_stream_mode mode;        /* Mode to open file with (OPEN) */
+    int fd;                         /* File descriptor (READ, WRITE, STAT, CLOSE), Set by OPEN */
+    void *buf;                      /* Buffer to read into or write from (READ, WRITE) */
+    unsigned long len;              /* Size of the buffer in bytes (READ, WRITE) */
+    ice_fs_offset offset;           /* Offset in file (READ, WRITE) */
+    ice_fs_offset size;             /* Size of object in bytes, Set by STAT */
+    ice_fs_object_type type;        /* Type of object, Set by STAT */
+    long result;                    /* Number of read/written bytes (READ, WRITE) or 0 (Others) on success, Negative errno value on failure */
+} ice_fs_batch_req;
+
+/* Batched I/O context, Submits requests through io_uring on Linux or runs them on pool of threads (Elsewhere or if io_uring is unavailable), Should be used by one thread at a time */
+typedef struct ice_fs_batch {
+    void *handle;                   /* [INTERNAL] io_uring ring or pool of threads */
+    unsigned long depth;            /* [INTERNAL] Maximum number of requests in flight */
+    ice_fs_bool io_uring;           /* ICE_FS_TRUE if requests are submitted through io_uring or ICE_FS_FALSE if they run on pool of threads */
+} ice_fs_batch;
+
+/* 64-bit hash of data (Same value as XXH3_64bits of xxHash) */
+typedef unsigned long long ice_fs_hash_value;
+
+/* Streaming hash state, Started by ice_fs_hash_begin */
+typedef struct ice_fs_hash_state {
+    ice_fs_hash_value acc[8];       /* [INTERNAL] Accumulators of stripes consumed so far */
+    unsigned char buf[256];         /* [INTERNAL] Bytes waiting to be consumed (End of it keeps last consumed stripe) */
+    unsigned long buf_len;          /* [INTERNAL] Number of bytes waiting in the buffer */
+    unsigned long stripes;          /* [INTERNAL] Number of stripes consumed in current block */
+    ice_fs_hash_value total_len;    /* [INTERNAL] Number of bytes fed so far */
+} ice_fs_hash_state;
+
+/* File hashed by ice_fs_dir_hash */
+typedef struct ice_fs_hashed_file {
+    char *path;                     /* Full path of the file */
+    ice_fs_offset size;             /* Size of the file in bytes */
+    ice_fs_hash_value hash;         /* Hash of content of the file */
+} ice_fs_hashed_file;
+
+/* Group of files with same content, Found by ice_fs_dir_duplicates */
+typedef struct ice_fs_dup_group {
+    char **paths;                   /* Full paths of the files */
+    unsigned long paths_count;      /* Number of the files (2 or more) */
+    ice_fs_offset size;             /* Size of each file in bytes */
+    ice_fs_hash_value hash;         /* Hash of content of each file */
+} ice_fs_dup_group;
+
+/* Size of buffer in bytes that files are read through for hashing, Bigger files are mapped into memory instead on Unix (ICE_FS_HASH_BUFFER_SIZE) */
+enum { ICE_FS_HASH_BUFFER_SIZE = 131072 };
+
+/* Object of directory tree recorded by ice_fs_snapshot_take */
+typedef struct ice_fs_snapshot_entry {
+    char *path;                     /* Path relative to root directory of the snapshot */
+    ice_fs_object_type type;        /* Type of the object (Symbolic links have their own type, Which is file even for links to directories) */
+    ice_fs_bool is_link;            /* ICE_FS_TRUE if the object is symbolic link (Which is recorded itself and never followed) */
+    ice_fs_offset size;             /* Size in bytes (0 for directories) */
+    ice_fs_offset mtime;            /* Last modification time in nanoseconds since epoch (Whole seconds on platforms without finer timestamps) */
+    ice_fs_offset inode;            /* Inode number (0 on Windows) */
+} ice_fs_snapshot_entry;
+
+/* Snapshot of directory tree, Taken by ice_fs_snapshot_take or read by ice_fs_snapshot_load */
+typedef struct ice_fs_snapshot {
+    ice_fs_snapshot_entry *entries; /* Objects of the tree sorted by path */
+    unsigned long entries_count;    /* Number of the objects */
+} ice_fs_snapshot;
+
+/* Differences between two snapshots, Found by ice_fs_snapshot_diff (Entries point into the snapshots) */
+typedef struct ice_fs_snapshot_changes {
+    const ice_fs_snapshot_entry **added;    /* Entries of newer snapshot that older one doesn't have */
+    unsigned long added_count;
+    const ice_fs_snapshot_entry **removed;  /* Entries of older snapshot that newer one doesn't have */
+    unsigned long removed_count;
+    const ice_fs_snapshot_entry **modified; /* Entries of newer snapshot whose type, size, modification time or inode changed */
+    unsigned long modified_count;
+} ice_fs_snapshot_changes;
+
+/* Types of events reported by ice_fs_watch_poll */
+typedef enum ice_fs_watch_event_type {
+    ICE_FS_WATCH_EVENT_CREATED = 0, /* Object was created (Or moved into watched tree) */
+    ICE_FS_WATCH_EVENT_MODIFIED,    /* Content or attributes of object changed */
+    ICE_FS_WATCH_EVENT_DELETED,     /* Object was deleted (Or moved out of watched tree) */
+    ICE_FS_WATCH_EVENT_MOVED,       /* Object was moved from path to new_path inside watched tree */
+    ICE_FS_WATCH_EVENT_OVERFLOW     /* Events were lost since too many came at once, Watched trees should be scanned again */
+} ice_fs_watch_event_type;
+
+/* Event reported by ice_fs_watch_poll, Paths stay valid till next call to ice_fs_watch_poll */
+typedef struct ice_fs_watch_event {
+    ice_fs_watch_event_type type;   /* Type of the event */
+    ice_fs_bool is_dir;             /* ICE_FS_TRUE if the object is directory */
+    const char *path;               /* Full path of the object (NULL for ICE_FS_WATCH_EVENT_OVERFLOW) */
+    const char *new_path;           /* Full path the object was moved to (ICE_FS_WATCH_EVENT_MOVED only, NULL otherwise) */
+} ice_fs_watch_event;
+
+/* Watcher of directory trees, Uses inotify on Linux or compares snapshots of the trees periodically (Elsewhere or if inotify is unavailable), Should be used by one thread at a time */
+typedef struct ice_fs_watcher {
+    void *handle;                   /* [INTERNAL] State of the watcher */
+    ice_fs_bool inotify;            /* ICE_FS_TRUE if events come from inotify or ICE_FS_FALSE if trees are compared periodically */
+} ice_fs_watcher;
+
+/* Number of events that watcher keeps till they are polled, Further events are dropped and ICE_FS_WATCH_EVENT_OVERFLOW is reported (ICE_FS_WATCH_EVENTS_CAPACITY) */
+enum { ICE_FS_WATCH_EVENTS_CAPACITY = 4096 };
+
+/* Virtual filesystem that looks up paths in archives created by ice_fs_pack_create then on disk (Should be zero-initialized before first ice_fs_vfs_mount), Can be used by many threads at a time once archives are mounted */
+typedef struct ice_fs_vfs {
+    void *mounts;                   /* [INTERNAL] Mounted archives (Last mounted first) */
+} ice_fs_vfs;
+
+/* Alignment in bytes of content of files in archives created by ice_fs_pack_create, 4096 (Page size) allows mapping each file on its own (ICE_FS_PACK_ALIGNMENT) */
+enum { ICE_FS_PACK_ALIGNMENT = 64 };
+
+/* Stream of compressed file (Opened via ice_fs_zstream_open), Content is compressed in independent blocks with index of them at end of the file, So reads can seek and blocks can be decompressed in parallel */
+typedef struct ice_fs_zstream {
+    void *handle;                   /* [INTERNAL] State of the stream */
+} ice_fs_zstream;
+
+/* Size in bytes of uncompressed blocks that ice_fs_zstream_write and ice_fs_compress_file compress independently, Bigger blocks compress better while smaller ones make seeking cheaper (ICE_FS_ZSTREAM_BLOCK_SIZE) */
+enum { ICE_FS_ZSTREAM_BLOCK_SIZE = 262144 };
+
 /* ============================== Functions ============================== */
 
 /* [INTERNAL] Returns length of string */
@@ -173,6 +462,57 @@ char* ice_fs_format_path(const char *path);
 /* Returns full path of a path on allocation success or NULL on failure */
 char* ice_fs_fullpath(const char *path);
 
+/* Stores view of root of path in span (Without allocating, Drive like C: without slash is root too), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if path has no root) */
+ice_fs_bool ice_fs_root_span(const char *path, ice_fs_path_span *span);
+
+/* Stores view of file name with/without extension of path in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_filename_span(const char *path, ice_fs_bool with_ext, ice_fs_path_span *span);
+
+/* Stores view of file extension of path (Without dot) in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file name has no extension) */
+ice_fs_bool ice_fs_ext_span(const char *path, ice_fs_path_span *span);
+
+/* Stores view of previous parent of path (With its trailing slash) in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if path has no parent) */
+ice_fs_bool ice_fs_prev_path_span(const char *path, ice_fs_path_span *span);
+
+/* Frees all paths allocated from arena at once but keeps its memory to allocate next paths from */
+void ice_fs_path_arena_reset(ice_fs_path_arena *arena);
+
+/* Frees arena and all paths allocated from it */
+void ice_fs_free_path_arena(ice_fs_path_arena *arena);
+
+/* Same like ice_fs_concat_path but allocates result path from arena (Freed with arena instead of ice_fs_free_str) */
+char* ice_fs_concat_path_arena(ice_fs_path_arena *arena, const char *path1, const char *path2);
+
+/* Same like ice_fs_filename but allocates file name from arena (Freed with arena instead of ice_fs_free_str) */
+char* ice_fs_filename_arena(ice_fs_path_arena *arena, const char *path, ice_fs_bool with_ext);
+
+/* Same like ice_fs_ext but allocates file extension from arena (Freed with arena instead of ice_fs_free_str) */
+char* ice_fs_ext_arena(ice_fs_path_arena *arena, const char *path);
+
+/* Same like ice_fs_prev_path but allocates previous parent from arena (Freed with arena instead of ice_fs_free_str) */
+char* ice_fs_prev_path_arena(ice_fs_path_arena *arena, const char *path);
+
+/* Same like ice_fs_path_parents but allocates array and parents from arena (Freed with arena instead of ice_fs_free_strarr) */
+char** ice_fs_path_parents_arena(ice_fs_path_arena *arena, const char *path, unsigned long *results);
+
+/* Same like ice_fs_format_path but allocates formatted path from arena (Freed with arena instead of ice_fs_free_str) */
+char* ice_fs_format_path_arena(ice_fs_path_arena *arena, const char *path);
+
+/* Same like ice_fs_concat_path but writes result path into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if result path doesn't fit in buf) */
+ice_fs_bool ice_fs_concat_path_buf(const char *path1, const char *path2, char *buf, unsigned long buf_size);
+
+/* Same like ice_fs_filename but writes file name into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file name doesn't fit in buf) */
+ice_fs_bool ice_fs_filename_buf(const char *path, ice_fs_bool with_ext, char *buf, unsigned long buf_size);
+
+/* Same like ice_fs_ext but writes file extension into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file extension doesn't fit in buf) */
+ice_fs_bool ice_fs_ext_buf(const char *path, char *buf, unsigned long buf_size);
+
+/* Same like ice_fs_prev_path but writes previous parent into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if previous parent doesn't fit in buf) */
+ice_fs_bool ice_fs_prev_path_buf(const char *path, char *buf, unsigned long buf_size);
+
+/* Same like ice_fs_format_path but writes formatted path into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if formatted path doesn't fit in buf) */
+ice_fs_bool ice_fs_format_path_buf(const char *path, char *buf, unsigned long buf_size);
+
 /* Creates symbolic/hard link for object in path1 at path2, Retruns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ice_fs_bool ice_fs_link(const char *path1, const char *path2, ice_fs_bool hard_link);
 
@@ -182,50 +522,312 @@ char* ice_fs_readlink(const char *path);
 /* Returns type of object in specific path, Returns ICE_FS_OBJECT_TYPE_NONE on failure if path does not exist or returns any of values does ice_fs_object_type enumeration has */
 ice_fs_object_type ice_fs_type(const char *path);
 
+/* Same like ice_fs_type but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ice_fs_object_type ice_fs_type_at(const ice_fs_dir_handle *dir, const char *path);
+
 /* Reads content of file and returns the content on allocation success or NULL on failure, file_size is pointer to unsigned long integer that will store number of chars (bytes) the file has */
 char* ice_fs_file_content(const char *path, unsigned long *file_size);
 
+/* Same like ice_fs_file_content but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+char* ice_fs_file_content_at(const ice_fs_dir_handle *dir, const char *path, unsigned long *file_size);
+
 /* Creates file in path with content if doesn't exist or Appends to/Overwrites content of file in specific path if exists, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ice_fs_bool ice_fs_file_write(const char *path, const char *content, ice_fs_bool append);
 
+/* Writes len bytes of data (Which may contain NUL bytes) to file in path in mode, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_file_write_buf(const char *path, const void *data, unsigned long len, ice_fs_write_mode mode);
+
+/* Writes bufs_count buffers in bufs one after another to file in path (Without concatenating them first) in mode, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_file_writev(const char *path, const ice_fs_buf *bufs, unsigned long bufs_count, ice_fs_write_mode mode);
+
+/* Same like ice_fs_file_write_buf but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ice_fs_bool ice_fs_file_write_at(const ice_fs_dir_handle *dir, const char *path, const void *data, unsigned long len, ice_fs_write_mode mode);
+
 /* Reads content of file, Returns the content in array of strings for each line on allocation success or NULL on failure, lines should be pointer to unsigned long integer to store count of lines the file has */
 char** ice_fs_file_lines(const char *path, unsigned long *lines);
 
+/* Maps file in path into memory as read-only view and stores it in view struct by pointing to, Pages are read lazily on first access unless populate is ICE_FS_TRUE (Which reads all of them before returning), hint tells the system how the pages will be accessed, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_map(const char *path, ice_fs_map_hint hint, ice_fs_bool populate, ice_fs_map_view *view);
+
+/* Unmaps view that was mapped by ice_fs_map, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_unmap(ice_fs_map_view *view);
+
+/* Opens file in path as stream in mode, buf should be pointer to caller-provided buffer of buf_size bytes or NULL to allocate buffer of buf_size bytes (ICE_FS_STREAM_BUFFER_SIZE if 0), Direct modes bypass page cache with O_DIRECT on Linux (F_NOCACHE on macOS, Cached I/O elsewhere or on filesystems that refuse it) and need buffer aligned to ICE_FS_DIRECT_ALIGNMENT bytes with size multiple of it (Allocated buffer is rounded up), Unaligned tail of the file is read and written through page cache, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_stream_open(ice_fs_stream *stream, const char *path, ice_fs_stream_mode mode, void *buf, unsigned long buf_size);
+
+/* Reads up to len bytes from stream into dst and stores number of read bytes in read_len (Less than len only at end of file), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_stream_read(ice_fs_stream *stream, void *dst, unsigned long len, unsigned long *read_len);
+
+/* Writes len bytes from src to stream (Through the buffer), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_stream_write(ice_fs_stream *stream, const void *src, unsigned long len);
+
+/* Writes bytes pending in buffer of stream to the file, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_stream_flush(ice_fs_stream *stream);
+
+/* Moves position of stream to offset relative to origin and stores the new position in pos (If not NULL), Seeking 0 bytes from ICE_FS_SEEK_CURRENT retrieves the current position, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_stream_seek(ice_fs_stream *stream, ice_fs_offset offset, ice_fs_seek_origin origin, ice_fs_offset *pos);
+
+/* Tells the system how range of len bytes from offset in file of stream will be accessed (len of 0 means till end of file), Does nothing on platforms without posix_fadvise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_stream_advise(ice_fs_stream *stream, ice_fs_offset offset, ice_fs_offset len, ice_fs_stream_hint hint);
+
+/* Reserves disk space for first size bytes of file of stream without changing its size (With fallocate on Linux), So streaming big file doesn't fragment it or run out of space midway, Does nothing on platforms or filesystems that can't reserve space, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Like when disk is full) */
+ice_fs_bool ice_fs_stream_preallocate(ice_fs_stream *stream, ice_fs_offset size);
+
+/* Closes stream opened by ice_fs_stream_open after writing bytes pending in its buffer, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_stream_close(ice_fs_stream *stream);
+
+/* Allocates size bytes (With ICE_FS_MALLOC) at address that is multiple of alignment (Power of 2, ICE_FS_DIRECT_ALIGNMENT if 0), For buffers of direct I/O streams and batched requests on files opened in direct modes, Returns pointer to the memory on success or NULL on failure, The memory should be freed with ice_fs_aligned_free */
+void* ice_fs_aligned_alloc(unsigned long size, unsigned long alignment);
+
+/* Frees memory allocated by ice_fs_aligned_alloc */
+void ice_fs_aligned_free(void *ptr);
+
+/* Opens file in path for iteration of its lines with ice_fs_line_iter_next, buf_size is initial size of the sliding window buffer (ICE_FS_LINE_ITER_BUFFER_SIZE if 0, Grows only if a line doesn't fit), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_line_iter_open(ice_fs_line_iter *iter, const char *path, unsigned long buf_size);
+
+/* Retrieves next line of file opened by ice_fs_line_iter_open and stores pointer to it in line and its length in len, Lines are split and empty ones skipped like ice_fs_str_splitlines does ('\r' of "\r\n" stays in the line), Line is NUL-terminated and points into the iterator buffer till next call, Returns ICE_FS_TRUE if line was retrieved or ICE_FS_FALSE when there are no more lines or on failure (failed field of the iterator is set to ICE_FS_TRUE then) */
+ice_fs_bool ice_fs_line_iter_next(ice_fs_line_iter *iter, const char **line, unsigned long *len);
+
+/* Closes file opened by ice_fs_line_iter_open and frees the iterator buffer, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_line_iter_close(ice_fs_line_iter *iter);
+
 /* Changes current directory in the running program to another directory in path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ice_fs_bool ice_fs_chdir(const char *path);
 
 /* Returns directory informations with list of contents in path on success or NULL on failure */
 ice_fs_dir ice_fs_dir_content(const char *path);
 
+/* Same like ice_fs_dir_content but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ice_fs_dir ice_fs_dir_content_at(const ice_fs_dir_handle *dir, const char *path);
+
 /* Frees/Deallocates a directory information struct, dir should be pointer to the directory information struct that will be freed */
 void ice_fs_free_dir_content(ice_fs_dir *dir);
 
-/* Searches in contents of directory for a specific file/directory by string, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
+/* Opens directory in path for iteration with ice_fs_dir_iter_next, buf should be pointer to caller-provided buffer of buf_size bytes (At least ICE_FS_DIR_ITER_MIN_BUFFER_SIZE) that entries are read into, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_dir_iter_open(ice_fs_dir_iter *iter, const char *path, void *buf, unsigned long buf_size);
+
+/* Retrieves next item of the directory opened by ice_fs_dir_iter_open and stores it in item struct by pointing to, Name of the item points into the iterator buffer and stays valid till next call, Returns ICE_FS_TRUE if item was retrieved or ICE_FS_FALSE when there are no more items or on failure (error field of iter is set then) */
+ice_fs_bool ice_fs_dir_iter_next(ice_fs_dir_iter *iter, ice_fs_object *item);
+
+/* Closes directory opened by ice_fs_dir_iter_open, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Also if reading entries failed before, So directory isn't mistaken for fully read one) */
+ice_fs_bool ice_fs_dir_iter_close(ice_fs_dir_iter *iter);
+
+/* Opens directory in path (Relative to directory of dir handle or current directory if dir is NULL) and stores its handle in handle struct by pointing to, Paths given to *_at functions with the handle are looked up from the directory itself instead of walking its whole path again, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_dir_open(ice_fs_dir_handle *handle, const ice_fs_dir_handle *dir, const char *path);
+
+/* Closes directory handle opened by ice_fs_dir_open, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_dir_close(ice_fs_dir_handle *handle);
+
+/* Sets number of threads that parallel library functions (Like ice_fs_dir_search) use, 0 means number of CPU cores (The default) */
+void ice_fs_use_threads(unsigned long threads_count);
+
+/* Searches in contents of directory and its subdirectories (In parallel) for a specific file/directory by string, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
 char** ice_fs_dir_search(const char *path, const char *str, unsigned long *results);
 
+/* Sums sizes of everything in directory in path and its subdirectories (In parallel, Each item is stat'ed once relative to its directory, Symbolic links are counted but never followed, Hard linked files are counted once), Returns array of entries for the directory and its subdirectories up to max_depth levels below it (0 for the directory alone) sorted by path on allocation success or NULL on failure, entries_count should be pointer to unsigned long integer that stores number of the entries, Subdirectories that can't be read count as empty */
+ice_fs_usage* ice_fs_dir_usage(const char *path, unsigned long max_depth, unsigned long *entries_count);
+
+/* Frees array of entries returned by ice_fs_dir_usage */
+void ice_fs_free_dir_usage(ice_fs_usage *entries);
+
+
+/* Compiles glob pattern (Relative to searched directory, With / as separator) to glob that matches paths against it, * and ? match any chars and any char in a name, ** matches zero or more directories, [abc], [a-z] and [!abc] match chars of class and {a,b} matches any of alternatives, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, glob should be freed with ice_fs_free_glob */
+ice_fs_bool ice_fs_glob_compile(ice_fs_glob *glob, const char *pattern);
+
+/* Adds exclude pattern to glob compiled by ice_fs_glob_compile with syntax of .gitignore (Pattern without slash matches name at any depth, Leading slash anchors it to searched directory, Trailing slash matches directories only, ! re-includes and lines starting with # are ignored), Excluded directories are not searched at all, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_glob_exclude(ice_fs_glob *glob, const char *pattern);
+
+/* Adds exclude patterns from each line of file in path (Like .gitignore, Patterns are relative to searched directory) to glob compiled by ice_fs_glob_compile, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_glob_exclude_file(ice_fs_glob *glob, const char *path);
+
+/* Returns ICE_FS_TRUE if path (Relative to searched directory, Trailing slash marks directory) matches glob compiled by ice_fs_glob_compile and isn't excluded, Or ICE_FS_FALSE if not, Filesystem is not accessed */
+ice_fs_bool ice_fs_glob_match(const ice_fs_glob *glob, const char *path);
+
+/* Searches in contents of directory and its subdirectories (In parallel) for files/directories whose paths (Relative to path) match glob compiled by ice_fs_glob_compile, Directories that can't contain matches or are excluded are not searched, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
+char** ice_fs_dir_glob(const char *path, const ice_fs_glob *glob, unsigned long *results);
+
+/* Frees glob compiled by ice_fs_glob_compile */
+void ice_fs_free_glob(ice_fs_glob *glob);
+
 /* Creates file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ice_fs_bool ice_fs_create(const char *path, ice_fs_object_type type);
 
+/* Same like ice_fs_create but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ice_fs_bool ice_fs_create_at(const ice_fs_dir_handle *dir, const char *path, ice_fs_object_type type);
+
+/* Creates file in path (Or resizes existing one) of size bytes with its disk space reserved upfront (With fallocate on Linux), So writing it later neither fragments it nor runs out of space midway, Added bytes read as zeros, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_create_file(const char *path, ice_fs_offset size);
+
+/* Deallocates len bytes of file in path from offset (Range past end of the file is ignored), The range reads as zeros and size of the file stays same, Filesystems that can't deallocate get zeros written instead, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_punch_hole(const char *path, ice_fs_offset offset, ice_fs_offset len);
+
+/* Retrieves regions of data and holes (Deallocated ranges that read as zeros) of file in path in order and stores their number in regions_count (With SEEK_DATA and SEEK_HOLE, Files are one data region where they aren't available), Returns array of regions on success or NULL on failure, The array should be freed with ice_fs_free_file_regions */
+ice_fs_file_region* ice_fs_file_regions(const char *path, unsigned long *regions_count);
+
+/* Frees regions retrieved by ice_fs_file_regions */
+void ice_fs_free_file_regions(ice_fs_file_region *regions);
+
 /* Removes file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ice_fs_bool ice_fs_remove(const char *path);
 
+/* Same like ice_fs_remove but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ice_fs_bool ice_fs_remove_at(const ice_fs_dir_handle *dir, const char *path);
+
+/* Removes file/folder in specific path with all of its content (Subfolders are removed in parallel, Symbolic links are removed but never followed), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred) */
+ice_fs_bool ice_fs_remove_all(const char *path);
+
 /* Clears content of file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ice_fs_bool ice_fs_clear(const char *path);
 
-/* Copies file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+/* Copies file/folder from path1 to path2 (Files of folders are copied in parallel), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred) */
 ice_fs_bool ice_fs_copy(const char *path1, const char *path2);
 
+/* Sets maximum number of files that ice_fs_copy copies at same time when copying folders, 0 means 4 per thread of ice_fs_use_threads (The default) */
+void ice_fs_use_copy_limit(unsigned long files_count);
+
 /* Moves file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ice_fs_bool ice_fs_move(const char *path1, const char *path2);
 
 /* Renames file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ice_fs_bool ice_fs_rename(const char *path1, const char *path2);
 
+/* Same like ice_fs_rename but relative path1 is resolved from directory of dir1 handle and relative path2 from directory of dir2 handle (Current directory if NULL) */
+ice_fs_bool ice_fs_rename_at(const ice_fs_dir_handle *dir1, const char *path1, const ice_fs_dir_handle *dir2, const char *path2);
+
 /* Returns ICE_FS_TRUE if file/folder in specific path is empty or ICE_FS_FALSE if not empty */
 ice_fs_bool ice_fs_is_empty(const char *path);
 
-/* Retrieves [last modification, last status change, last access] date of file/directory and stores info in info struct by pointing to, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+/* Retrieves [last modification, last status change, last access] date of file/directory and stores info in info struct by pointing to, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, info->str points to static buffer that next call overwrites (ice_fs_get_date_r should be used from multiple threads) */
 ice_fs_bool ice_fs_get_date(const char *path, ice_fs_date_type date_type, ice_fs_date *info);
+
+/* Same like ice_fs_get_date but thread-safe (Uses no static storage), str should be caller-provided buffer of str_size bytes (At least ICE_FS_DATE_STR_SIZE) that date is written into as string and that info->str points to, Or NULL to set info->str to NULL, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_get_date_r(const char *path, ice_fs_date_type date_type, ice_fs_date *info, char *str, unsigned long str_size);
+
+/* Converts time in seconds since epoch (Shifted by utc_offset seconds for local time, 0 for UTC) to date in info with arithmetic alone (Thread-safe), str should be caller-provided buffer of str_size bytes (At least ICE_FS_DATE_STR_SIZE) that date is written into as string in same format as ctime and that info->str points to, Or NULL to set info->str to NULL, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_date_from_epoch(ice_fs_offset epoch, long utc_offset, ice_fs_date *info, char *str, unsigned long str_size);
+
+/* Stores [last modification, last status change, last access] time of each of paths_count paths in times in nanoseconds since epoch (-1 for paths that don't exist or can't be accessed), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_get_times(const char **paths, unsigned long paths_count, ice_fs_date_type date_type, ice_fs_offset *times);
+
+/* Retrieves fields (Combination of ice_fs_stat_field flags) of metadata of each of paths_count paths into infos (Many at once on multiple threads, With statx on Linux), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Paths that don't exist or can't be accessed don't fail the call (Their type is ICE_FS_OBJECT_TYPE_NONE and error is set) */
+ice_fs_bool ice_fs_get_stats(const char **paths, unsigned long paths_count, unsigned fields, ice_fs_stat_info *infos);
+
+/* Creates batched I/O context in batch that keeps up to depth requests in flight (ICE_FS_BATCH_DEPTH if 0), Uses io_uring if available or pool of threads otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_batch_init(ice_fs_batch *batch, unsigned long depth);
+
+/* Runs reqs_count requests in reqs through batch and waits for all of them, Requests run concurrently in any order (So request that needs result of another one should be submitted after it), Result of each request is stored in its result field, Returns ICE_FS_TRUE if all requests succeeded or ICE_FS_FALSE if any failed (errno is set to error of the first failed one) */
+ice_fs_bool ice_fs_batch_submit(ice_fs_batch *batch, ice_fs_batch_req *reqs, unsigned long reqs_count);
+
+/* Reads contents of paths_count files in paths through batch (Opens, Stats, Reads and Closes many files at same time), Returns array of contents (NULL for each file that failed to read) on allocation success or NULL on failure, sizes can be pointer to array of paths_count unsigned long integers to store size of each content, The array should be freed with ice_fs_free_strarr */
+char** ice_fs_batch_files_content(ice_fs_batch *batch, const char **paths, unsigned long paths_count, unsigned long *sizes);
+
+/* Closes batched I/O context created by ice_fs_batch_init, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_batch_close(ice_fs_batch *batch);
+
+/* Returns 64-bit hash of len bytes of data (Same value as XXH3_64bits of xxHash, So it's fast but not cryptographic) */
+ice_fs_hash_value ice_fs_hash(const void *data, unsigned long len);
+
+/* Starts streaming hash in state, Data is fed to it with ice_fs_hash_update and hash is retrieved with ice_fs_hash_digest (Same value as ice_fs_hash of all the data at once) */
+void ice_fs_hash_begin(ice_fs_hash_state *state);
+
+/* Feeds len bytes of data to streaming hash in state */
+void ice_fs_hash_update(ice_fs_hash_state *state, const void *data, unsigned long len);
+
+/* Returns hash of all data fed so far to streaming hash in state (Which can still be fed more data after) */
+ice_fs_hash_value ice_fs_hash_digest(const ice_fs_hash_state *state);
+
+/* Hashes content of file in path (Same value as ice_fs_hash of the whole content) and stores it in hash, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_file_hash(const char *path, ice_fs_hash_value *hash);
+
+/* Hashes contents of all files in directory and its subdirectories (In parallel, Symbolic links are skipped), Returns array of hashed files sorted by path on allocation success or NULL on failure (Or if there are no files), files_count should be pointer to unsigned long integer that stores number of the files, Files that can't be read are left out */
+ice_fs_hashed_file* ice_fs_dir_hash(const char *path, unsigned long *files_count);
+
+/* Frees array of hashed files returned by ice_fs_dir_hash */
+void ice_fs_free_dir_hash(ice_fs_hashed_file *files);
+
+/* Finds files with same content in directory and its subdirectories (Files of same size are hashed in parallel, Empty files and symbolic links are skipped), Returns array of groups of duplicates on allocation success or NULL on failure (Or if there are no duplicates), groups_count should be pointer to unsigned long integer that stores number of the groups, Paths in each group are sorted */
+ice_fs_dup_group* ice_fs_dir_duplicates(const char *path, unsigned long *groups_count);
+
+/* Frees array of groups of duplicates returned by ice_fs_dir_duplicates */
+void ice_fs_free_duplicates(ice_fs_dup_group *groups);
+
+/* Records path, type, size, modification time and inode of every object in directory and its subdirectories (Walked in parallel, Symbolic links are not followed) into snap, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Subdirectories that can't be read are left out, snap should be freed with ice_fs_free_snapshot */
+ice_fs_bool ice_fs_snapshot_take(ice_fs_snapshot *snap, const char *path);
+
+/* Writes snap to file in path in compact binary format (Each path only stores what differs from the previous one), The file is replaced atomically, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_snapshot_save(const ice_fs_snapshot *snap, const char *path);
+
+/* Reads snapshot written by ice_fs_snapshot_save from file in path into snap, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the file is corrupted), snap should be freed with ice_fs_free_snapshot */
+ice_fs_bool ice_fs_snapshot_load(ice_fs_snapshot *snap, const char *path);
+
+/* Returns entry of snap with path (Relative to root directory of the snapshot) without touching the filesystem, Or NULL if snap has no such entry */
+const ice_fs_snapshot_entry* ice_fs_snapshot_find(const ice_fs_snapshot *snap, const char *path);
+
+/* Compares older snapshot old_snap to newer snapshot new_snap (Of same directory) and stores added, removed and modified entries in changes, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Snapshots should outlive changes, changes should be freed with ice_fs_free_snapshot_changes */
+ice_fs_bool ice_fs_snapshot_diff(const ice_fs_snapshot *old_snap, const ice_fs_snapshot *new_snap, ice_fs_snapshot_changes *changes);
+
+/* Frees entries of snapshot taken by ice_fs_snapshot_take or read by ice_fs_snapshot_load */
+void ice_fs_free_snapshot(ice_fs_snapshot *snap);
+
+/* Frees changes found by ice_fs_snapshot_diff */
+void ice_fs_free_snapshot_changes(ice_fs_snapshot_changes *changes);
+
+/* Creates watcher in watcher, Uses inotify if available or compares snapshots of watched trees periodically otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_watch_init(ice_fs_watcher *watcher);
+
+/* Watches directory in path and all of its subdirectories (Including ones created later), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_watch_add(ice_fs_watcher *watcher, const char *path);
+
+/* Waits up to timeout milliseconds (0 doesn't wait and negative waits forever) for events of watched trees and stores up to events_capacity of them in events and their number in events_count, Repeated changes of same object are merged into one event, Returns ICE_FS_TRUE on success (Even if no event came in time) or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_watch_poll(ice_fs_watcher *watcher, ice_fs_watch_event *events, unsigned long events_capacity, unsigned long *events_count, long timeout);
+
+/* Closes watcher created by ice_fs_watch_init, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_watch_close(ice_fs_watcher *watcher);
+
+/* Packs files and directories in directory in path and all of its subdirectories into read-only archive in pack_path (Table of contents sorted by path with hash table for lookups, Content of files aligned to ICE_FS_PACK_ALIGNMENT bytes), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_pack_create(const char *path, const char *pack_path);
+
+/* Mounts archive in pack_path created by ice_fs_pack_create into vfs at mount_point (NULL or "" for current directory), Archives mounted later take priority over earlier ones and all of them take priority over disk, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the archive is malformed) */
+ice_fs_bool ice_fs_vfs_mount(ice_fs_vfs *vfs, const char *pack_path, const char *mount_point);
+
+/* Returns type of object in path (Looked up in mounted archives then on disk) */
+ice_fs_object_type ice_fs_vfs_type(const ice_fs_vfs *vfs, const char *path);
+
+/* Returns pointer to content of file in path inside mounted archive (Without copying, Valid till ice_fs_vfs_close) and stores its size in file_size, Or NULL if none of mounted archives has the file (Disk is not accessed) */
+const void* ice_fs_vfs_file_data(const ice_fs_vfs *vfs, const char *path, unsigned long *file_size);
+
+/* Same like ice_fs_file_content but file in path is looked up in mounted archives then on disk */
+char* ice_fs_vfs_file_content(const ice_fs_vfs *vfs, const char *path, unsigned long *file_size);
+
+/* Same like ice_fs_dir_content but items of directory in path are listed from mounted archives then disk (Items found earlier hide ones of same name) */
+ice_fs_dir ice_fs_vfs_dir_content(const ice_fs_vfs *vfs, const char *path);
+
+/* Unmounts all archives mounted into vfs, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_vfs_close(ice_fs_vfs *vfs);
+
+/* Opens compressed file in path as stream in mode (ICE_FS_STREAM_MODE_READ for file created with ice_fs_zstream_write or ice_fs_compress_file, Or ICE_FS_STREAM_MODE_WRITE to create it with blocks of ICE_FS_ZSTREAM_BLOCK_SIZE bytes), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the file is malformed) */
+ice_fs_bool ice_fs_zstream_open(ice_fs_zstream *stream, const char *path, ice_fs_stream_mode mode);
+
+/* Reads up to len bytes of uncompressed content from stream into dst and stores number of read bytes in read_len (Less than len only at end of content), Blocks that dst covers whole are decompressed straight into it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_zstream_read(ice_fs_zstream *stream, void *dst, unsigned long len, unsigned long *read_len);
+
+/* Writes len bytes from src to stream, Each ICE_FS_ZSTREAM_BLOCK_SIZE bytes are compressed into block and written once collected, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_zstream_write(ice_fs_zstream *stream, const void *src, unsigned long len);
+
+/* Moves position of stream opened for reading to offset of uncompressed content (Only block that holds it gets decompressed on next read), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_zstream_seek(ice_fs_zstream *stream, ice_fs_offset offset);
+
+/* Stores uncompressed size of content of stream in size (Bytes written so far for streams opened for writing), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_zstream_size(const ice_fs_zstream *stream, ice_fs_offset *size);
+
+/* Closes stream opened by ice_fs_zstream_open after writing pending bytes and index of blocks (For streams opened for writing), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_zstream_close(ice_fs_zstream *stream);
+
+/* Compresses file in path into compressed_path (Same format ice_fs_zstream_write creates, With blocks of ICE_FS_ZSTREAM_BLOCK_SIZE bytes compressed on multiple threads), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ice_fs_bool ice_fs_compress_file(const char *path, const char *compressed_path);
+
+/* Same like ice_fs_file_content but file in path is compressed file (Created by ice_fs_compress_file or ice_fs_zstream_write) that is decompressed straight into returned buffer (Blocks on multiple threads), Returns NULL on failure (Or if the file is malformed) */
+char* ice_fs_compressed_file_content(const char *path, unsigned long *file_size);
 ]])
 
 return ffi_load("ice_fs")
@@ -13,7 +13,7 @@ for l in ${libs[@]}; do
 done
 
 win_link_flags=("-lkernel32" "-lkernel32" "-lkernel32" "-lkernel32" "-lm" "-lkernel32" "-lkernel32" "" "-lkernel32" "-lkernel32 -luser32")
-linux_link_flags=("-ldl" "-ldl" "-lc" "-lc" "-lc" "-lm" "-lc" "-lc" "-lc")
+linux_link_flags=("-ldl" "-ldl" "-lc -lpthread" "-lc" "-lc" "-lm" "-lc" "-lc" "-lc")
 
 for i in ${!libs[@]}; do
   # ========== Build: Microsoft Windows (x86/i386, x86_64) ========== #
@@ -53,4 +53,11 @@ for i in ${!libs[@]}; do
   fi
 done
 
+# ========== Build: Checks and benchmarks of ice_fs (Linux x86_64) ========== #
+for s in samples/check_ice_fs_*.c samples/bench_ice_fs_*.c; do
+  if [ -e "${s}" ]; then
+    gcc ${s} -o ice_libs_builds/linux64/$(basename ${s} .c) -Iice_libs_builds -std=c89 -pedantic -Wall -Wextra -O2 -lc -lpthread
+  fi
+done
+
 rm -fr ice_libs_builds/*.c ice_libs_builds/*.h
@@ -107,6 +107,52 @@ typedef struct ice_fs_dir {
     unsigned long items_count;      // Number of the items in the directory
 } ice_fs_dir;
 
+// Minimum size of buffer in bytes that ice_fs_dir_iter_open accepts
+#define ICE_FS_DIR_ITER_MIN_BUFFER_SIZE 1024
+
+// Size of buffer in bytes that library functions use to iterate directories (Can be customized)
+#define ICE_FS_DIR_ITER_BUFFER_SIZE 32768
+
+// Size of buffer in bytes that ice_fs_copy uses when file can't be copied by the kernel (Can be customized)
+#define ICE_FS_COPY_BUFFER_SIZE 131072
+
+// Directory iterator, Yields items of directory one at a time from caller-provided buffer without any allocation
+typedef struct ice_fs_dir_iter {
+    void *handle;                   // [INTERNAL] Handle of opened directory (Depends on platform)
+    int fd;                         // [INTERNAL] File descriptor of opened directory (Unix only)
+    char *buf;                      // [INTERNAL] Caller-provided buffer where entries are read into
+    unsigned long buf_size;         // [INTERNAL] Size of the buffer in bytes
+    unsigned long buf_len;          // [INTERNAL] Bytes of entries currently in the buffer
+    unsigned long buf_pos;          // [INTERNAL] Offset of next entry in the buffer
+    int error;                      // 0 or errno value if reading entries failed (So ice_fs_dir_iter_next returned ICE_FS_FALSE before the end of directory)
+} ice_fs_dir_iter;
+
+// Handle of opened directory that *_at functions resolve relative paths from, Opened by ice_fs_dir_open
+typedef struct ice_fs_dir_handle {
+    int fd;                         // [INTERNAL] File descriptor of the directory (Unix only, -1 elsewhere)
+    char *path;                     // [INTERNAL] Full path of the directory (Windows only, NULL elsewhere)
+} ice_fs_dir_handle;
+
+// Compiled glob pattern with exclude patterns, Compiled by ice_fs_glob_compile and searched for with ice_fs_dir_glob (Can be shared by multiple threads once compiled)
+typedef struct ice_fs_glob {
+    void *handle;                   // [INTERNAL] Compiled rules
+} ice_fs_glob;
+
+// Arena that *_arena path functions allocate paths from, Zero-initialized arena is empty and ready to use, Paths are freed at once with ice_fs_path_arena_reset (Keeps memory for reuse) or ice_fs_free_path_arena
+typedef struct ice_fs_path_arena {
+    void *chunks;                   // [INTERNAL] Chunks of memory owned by the arena (Oldest first)
+    void *current;                  // [INTERNAL] Chunk that next paths are allocated from
+} ice_fs_path_arena;
+
+// Size of chunks in bytes that ice_fs_path_arena allocates memory in (Can be customized)
+#define ICE_FS_PATH_ARENA_CHUNK_SIZE 16384
+
+// View into path (Part of path string that isn't null-terminated), Stored by *_span path functions
+typedef struct ice_fs_path_span {
+    unsigned long offset;           // Index of first char of the view in path
+    unsigned long len;              // Number of chars of the view
+} ice_fs_path_span;
+
 // Enumeration for week days
 typedef enum ice_fs_date_day {
     ICE_FS_DATE_DAY_UNKNOWN = 0,
@@ -167,6 +213,278 @@ typedef enum ice_fs_date_type {
     ICE_FS_LAST_STATUS_CHANGE_DATE  // Last status change date of file/directory
 } ice_fs_date_type;
 
+// Size of buffer in bytes that date is written into as string by ice_fs_date_from_epoch and ice_fs_get_date_r (Same format as ctime, With newline and NUL terminator)
+#define ICE_FS_DATE_STR_SIZE 26
+
+// Access pattern hints for memory-mapped files (Passed to ice_fs_map)
+typedef enum ice_fs_map_hint {
+    ICE_FS_MAP_HINT_NORMAL = 0,     // No special treatment
+    ICE_FS_MAP_HINT_SEQUENTIAL,     // Pages will be accessed in sequential order (Read ahead aggressively)
+    ICE_FS_MAP_HINT_RANDOM,         // Pages will be accessed in random order (Don't read ahead)
+    ICE_FS_MAP_HINT_WILLNEED        // Pages will be needed soon (Start reading them in background)
+} ice_fs_map_hint;
+
+// Read-only memory-mapped view of file (Retrieved via ice_fs_map)
+typedef struct ice_fs_map_view {
+    const void *data;               // Content of the file (NULL for empty files)
+    unsigned long size;             // Size of the content in bytes
+    void *handle;                   // [INTERNAL] Handle of file mapping (Microsoft Windows only)
+} ice_fs_map_view;
+
+// Offset/Size in file (64-bit even where long is 32-bit)
+#if defined(_MSC_VER)
+typedef __int64 ice_fs_offset;
+#else
+typedef long long ice_fs_offset;
+#endif
+
+// Modes to open streams with (Passed to ice_fs_stream_open)
+typedef enum ice_fs_stream_mode {
+    ICE_FS_STREAM_MODE_READ = 0,    // Read only
+    ICE_FS_STREAM_MODE_WRITE,       // Write only, File is created if doesn't exist or truncated if exists
+    ICE_FS_STREAM_MODE_APPEND,      // Write only at end of file, File is created if doesn't exist
+    ICE_FS_STREAM_MODE_READ_WRITE,  // Read and write, File is created if doesn't exist
+    ICE_FS_STREAM_MODE_DIRECT_READ, // Read only bypassing page cache (Direct I/O), For big files read once
+    ICE_FS_STREAM_MODE_DIRECT_WRITE // Write only bypassing page cache (Direct I/O), File is created if doesn't exist or truncated if exists
+} ice_fs_stream_mode;
+
+// Origins to seek streams from (Passed to ice_fs_stream_seek)
+typedef enum ice_fs_seek_origin {
+    ICE_FS_SEEK_START = 0,          // Beginning of file
+    ICE_FS_SEEK_CURRENT,            // Current position
+    ICE_FS_SEEK_END                 // End of file
+} ice_fs_seek_origin;
+
+// Access pattern hints for streams (Passed to ice_fs_stream_advise)
+typedef enum ice_fs_stream_hint {
+    ICE_FS_STREAM_HINT_NORMAL = 0,  // No special treatment
+    ICE_FS_STREAM_HINT_SEQUENTIAL,  // Range will be accessed in sequential order (Read ahead aggressively)
+    ICE_FS_STREAM_HINT_RANDOM,      // Range will be accessed in random order (Don't read ahead)
+    ICE_FS_STREAM_HINT_WILLNEED,    // Range will be needed soon (Start reading it in background)
+    ICE_FS_STREAM_HINT_DONTNEED     // Range won't be needed again (Drop it from cache)
+} ice_fs_stream_hint;
+
+// Size of buffer in bytes that ice_fs_stream_open allocates when no buffer or size is given (Can be customized)
+#define ICE_FS_STREAM_BUFFER_SIZE 65536
+
+// Alignment in bytes of buffers, offsets and sizes for direct I/O (Default of ice_fs_aligned_alloc, Can be customized)
+#define ICE_FS_DIRECT_ALIGNMENT 4096
+
+// Buffered stream of opened file, Reads and writes go through caller-provided or allocated buffer of fixed size
+typedef struct ice_fs_stream {
+    int fd;                         // [INTERNAL] File descriptor of opened file
+    char *buf;                      // [INTERNAL] Buffer (Caller-provided or allocated)
+    unsigned long buf_size;         // [INTERNAL] Size of the buffer in bytes
+    unsigned long buf_pos;          // [INTERNAL] Offset of next unread byte in the buffer
+    unsigned long buf_len;          // [INTERNAL] Bytes in the buffer (Read ahead or pending to be written)
+    ice_fs_bool writing;            // [INTERNAL] ICE_FS_TRUE if bytes in the buffer are pending to be written
+    ice_fs_bool owns_buf;           // [INTERNAL] ICE_FS_TRUE if the buffer was allocated by ice_fs_stream_open
+    ice_fs_bool direct;             // [INTERNAL] ICE_FS_TRUE while the file is accessed with direct I/O
+} ice_fs_stream;
+
+// Size of buffer in bytes that ice_fs_line_iter_open allocates when no size is given (Can be customized)
+#define ICE_FS_LINE_ITER_BUFFER_SIZE 65536
+
+// Line iterator, Yields lines of file one at a time from sliding window buffer without allocation per line
+typedef struct ice_fs_line_iter {
+    int fd;                         // [INTERNAL] File descriptor of opened file
+    char *buf;                      // [INTERNAL] Sliding window buffer
+    unsigned long buf_size;         // [INTERNAL] Size of the buffer in bytes
+    unsigned long buf_pos;          // [INTERNAL] Offset of next line in the buffer
+    unsigned long buf_len;          // [INTERNAL] Bytes read into the buffer
+    unsigned long scan_pos;         // [INTERNAL] Offset where search for next newline continues
+    ice_fs_bool eof;                // [INTERNAL] ICE_FS_TRUE when end of file was reached
+    ice_fs_bool failed;             // ICE_FS_TRUE if iteration stopped because of failure
+} ice_fs_line_iter;
+
+// Modes to write files with (Passed to ice_fs_file_write_buf and ice_fs_file_writev)
+typedef enum ice_fs_write_mode {
+    ICE_FS_WRITE_MODE_OVERWRITE = 0, // File is created if doesn't exist or truncated if exists
+    ICE_FS_WRITE_MODE_APPEND,       // Data is appended to end of file, File is created if doesn't exist
+    ICE_FS_WRITE_MODE_ATOMIC        // Data is written to temporary file that is flushed to disk then renamed over the file, So the file has either old or new content even after crash
+} ice_fs_write_mode;
+
+// Buffer of data to write (Passed to ice_fs_file_writev)
+typedef struct ice_fs_buf {
+    const void *data;               // Pointer to the data
+    unsigned long len;              // Size of the data in bytes
+} ice_fs_buf;
+
+// Fields of metadata that ice_fs_get_stats retrieves (Flags, Can be combined with |)
+typedef enum ice_fs_stat_field {
+    ICE_FS_STAT_TYPE = 1,           // Type of object
+    ICE_FS_STAT_SIZE = 2,           // Size in bytes
+    ICE_FS_STAT_MTIME = 4,          // Last modification time
+    ICE_FS_STAT_MODE = 8,           // Permission bits
+    ICE_FS_STAT_ALL = 15            // All of the above
+} ice_fs_stat_field;
+
+// Metadata of object retrieved by ice_fs_get_stats, Fields that weren't asked for are 0 (Except type, Which is ICE_FS_OBJECT_TYPE_NONE since 0 means file)
+typedef struct ice_fs_stat_info {
+    ice_fs_offset size;             // Size in bytes (ICE_FS_STAT_SIZE)
+    ice_fs_offset mtime;            // Last modification time in nanoseconds since epoch (ICE_FS_STAT_MTIME)
+    unsigned mode;                  // Permission bits like 0644 (ICE_FS_STAT_MODE)
+    ice_fs_object_type type;        // Type of object (ICE_FS_STAT_TYPE), ICE_FS_OBJECT_TYPE_NONE if it wasn't asked for or couldn't be retrieved
+    int error;                      // 0 on success or errno value if object doesn't exist or can't be accessed
+} ice_fs_stat_info;
+
+// Region of file retrieved by ice_fs_file_regions
+typedef struct ice_fs_file_region {
+    ice_fs_offset offset;           // Offset of the region in bytes
+    ice_fs_offset len;              // Size of the region in bytes
+    ice_fs_bool hole;               // ICE_FS_TRUE if the region is hole (Reads as zeros, Includes space reserved but never written) or ICE_FS_FALSE if it has data
+} ice_fs_file_region;
+
+// Disk usage of directory retrieved by ice_fs_dir_usage
+typedef struct ice_fs_usage {
+    char *path;                 // Full path of the directory
+    ice_fs_offset size;         // Apparent size in bytes of the directory and everything in it (Sum of sizes, Like du --apparent-size)
+    ice_fs_offset allocated;    // Disk space in bytes allocated for the directory and everything in it (Like du, Same as size on Microsoft Windows)
+    unsigned long files_count;  // Number of items (Files, Directories, Links...) in the directory and its subdirectories
+    unsigned long depth;        // Levels of the directory below directory in path (0 for directory in path itself)
+} ice_fs_usage;
+
+// Operations of batched I/O requests (Passed to ice_fs_batch_submit)
+typedef enum ice_fs_batch_op {
+    ICE_FS_BATCH_OP_OPEN = 0,       // Opens file in path in mode and stores its file descriptor in fd
+    ICE_FS_BATCH_OP_READ,           // Reads up to len bytes from file of fd at offset into buf
+    ICE_FS_BATCH_OP_WRITE,          // Writes up to len bytes from buf to file of fd at offset
+    ICE_FS_BATCH_OP_STAT,           // Stores type and size of object in path (Or of file of fd if path is NULL) in type and size
+    ICE_FS_BATCH_OP_CLOSE           // Closes fd
+} ice_fs_batch_op;
+
+// Batched I/O request, Fields that its operation doesn't use are ignored
+typedef struct ice_fs_batch_req {
+    ice_fs_batch_op op;             // Operation to run
+    const char *path;               // Path of object (OPEN, STAT)
+    ice_fs_stream_mode mode;        // Mode to open file with (OPEN)
+    int fd;                         // File descriptor (READ, WRITE, STAT, CLOSE), Set by OPEN
+    void *buf;                      // Buffer to read into or write from (READ, WRITE)
+    unsigned long len;              // Size of the buffer in bytes (READ, WRITE)
+    ice_fs_offset offset;           // Offset in file (READ, WRITE)
+    ice_fs_offset size;             // Size of object in bytes, Set by STAT
+    ice_fs_object_type type;        // Type of object, Set by STAT
+    long result;                    // Number of read/written bytes (READ, WRITE) or 0 (Others) on success, Negative errno value on failure
+} ice_fs_batch_req;
+
+// Maximum number of requests in flight that ice_fs_batch_init uses when no depth is given (Can be customized)
+#define ICE_FS_BATCH_DEPTH 256
+
+// Batched I/O context, Submits requests through io_uring on Linux or runs them on pool of threads (Elsewhere or if io_uring is unavailable), Should be used by one thread at a time
+typedef struct ice_fs_batch {
+    void *handle;                   // [INTERNAL] io_uring ring or pool of threads
+    unsigned long depth;            // [INTERNAL] Maximum number of requests in flight
+    ice_fs_bool io_uring;           // ICE_FS_TRUE if requests are submitted through io_uring or ICE_FS_FALSE if they run on pool of threads
+} ice_fs_batch;
+
+// 64-bit hash of data (Same value as XXH3_64bits of xxHash)
+#if defined(_MSC_VER)
+typedef unsigned __int64 ice_fs_hash_value;
+#else
+typedef unsigned long long ice_fs_hash_value;
+#endif
+
+// Streaming hash state, Started by ice_fs_hash_begin
+typedef struct ice_fs_hash_state {
+    ice_fs_hash_value acc[8];       // [INTERNAL] Accumulators of stripes consumed so far
+    unsigned char buf[256];         // [INTERNAL] Bytes waiting to be consumed (End of it keeps last consumed stripe)
+    unsigned long buf_len;          // [INTERNAL] Number of bytes waiting in the buffer
+    unsigned long stripes;          // [INTERNAL] Number of stripes consumed in current block
+    ice_fs_hash_value total_len;    // [INTERNAL] Number of bytes fed so far
+} ice_fs_hash_state;
+
+// File hashed by ice_fs_dir_hash
+typedef struct ice_fs_hashed_file {
+    char *path;                     // Full path of the file
+    ice_fs_offset size;             // Size of the file in bytes
+    ice_fs_hash_value hash;         // Hash of content of the file
+} ice_fs_hashed_file;
+
+// Group of files with same content, Found by ice_fs_dir_duplicates
+typedef struct ice_fs_dup_group {
+    char **paths;                   // Full paths of the files
+    unsigned long paths_count;      // Number of the files (2 or more)
+    ice_fs_offset size;             // Size of each file in bytes
+    ice_fs_hash_value hash;         // Hash of content of each file
+} ice_fs_dup_group;
+
+// Size of buffer in bytes that files are read through for hashing, Bigger files are mapped into memory instead on Unix (Can be customized)
+#define ICE_FS_HASH_BUFFER_SIZE 131072
+
+// Object of directory tree recorded by ice_fs_snapshot_take
+typedef struct ice_fs_snapshot_entry {
+    char *path;                     // Path relative to root directory of the snapshot
+    ice_fs_object_type type;        // Type of the object (Symbolic links have their own type, Which is file even for links to directories)
+    ice_fs_bool is_link;            // ICE_FS_TRUE if the object is symbolic link (Which is recorded itself and never followed)
+    ice_fs_offset size;             // Size in bytes (0 for directories)
+    ice_fs_offset mtime;            // Last modification time in nanoseconds since epoch (Whole seconds on platforms without finer timestamps)
+    ice_fs_offset inode;            // Inode number (0 on Windows)
+} ice_fs_snapshot_entry;
+
+// Snapshot of directory tree, Taken by ice_fs_snapshot_take or read by ice_fs_snapshot_load
+typedef struct ice_fs_snapshot {
+    ice_fs_snapshot_entry *entries; // Objects of the tree sorted by path
+    unsigned long entries_count;    // Number of the objects
+} ice_fs_snapshot;
+
+// Differences between two snapshots, Found by ice_fs_snapshot_diff (Entries point into the snapshots)
+typedef struct ice_fs_snapshot_changes {
+    const ice_fs_snapshot_entry **added;    // Entries of newer snapshot that older one doesn't have
+    unsigned long added_count;
+    const ice_fs_snapshot_entry **removed;  // Entries of older snapshot that newer one doesn't have
+    unsigned long removed_count;
+    const ice_fs_snapshot_entry **modified; // Entries of newer snapshot whose type, size, modification time or inode changed
+    unsigned long modified_count;
+} ice_fs_snapshot_changes;
+
+// Types of events reported by ice_fs_watch_poll
+typedef enum ice_fs_watch_event_type {
+    ICE_FS_WATCH_EVENT_CREATED = 0, // Object was created (Or moved into watched tree)
+    ICE_FS_WATCH_EVENT_MODIFIED,    // Content or attributes of object changed
+    ICE_FS_WATCH_EVENT_DELETED,     // Object was deleted (Or moved out of watched tree)
+    ICE_FS_WATCH_EVENT_MOVED,       // Object was moved from path to new_path inside watched tree
+    ICE_FS_WATCH_EVENT_OVERFLOW     // Events were lost since too many came at once, Watched trees should be scanned again
+} ice_fs_watch_event_type;
+
+// Event reported by ice_fs_watch_poll, Paths stay valid till next call to ice_fs_watch_poll
+typedef struct ice_fs_watch_event {
+    ice_fs_watch_event_type type;   // Type of the event
+    ice_fs_bool is_dir;             // ICE_FS_TRUE if the object is directory
+    const char *path;               // Full path of the object (NULL for ICE_FS_WATCH_EVENT_OVERFLOW)
+    const char *new_path;           // Full path the object was moved to (ICE_FS_WATCH_EVENT_MOVED only, NULL otherwise)
+} ice_fs_watch_event;
+
+// Watcher of directory trees, Uses inotify on Linux or compares snapshots of the trees periodically (Elsewhere or if inotify is unavailable), Should be used by one thread at a time
+typedef struct ice_fs_watcher {
+    void *handle;                   // [INTERNAL] State of the watcher
+    ice_fs_bool inotify;            // ICE_FS_TRUE if events come from inotify or ICE_FS_FALSE if trees are compared periodically
+} ice_fs_watcher;
+
+// Number of events that watcher keeps till they are polled, Further events are dropped and ICE_FS_WATCH_EVENT_OVERFLOW is reported (Can be customized)
+#define ICE_FS_WATCH_EVENTS_CAPACITY 4096
+
+// Size of buffer in bytes that watcher keeps paths of events in (Can be customized)
+#define ICE_FS_WATCH_BUFFER_SIZE 262144
+
+// Milliseconds between comparisons of snapshots when watcher doesn't use inotify (Can be customized)
+#define ICE_FS_WATCH_POLL_INTERVAL 250
+
+// Virtual filesystem that looks up paths in archives created by ice_fs_pack_create then on disk (Should be zero-initialized before first ice_fs_vfs_mount), Can be used by many threads at a time once archives are mounted
+typedef struct ice_fs_vfs {
+    void *mounts;                   // [INTERNAL] Mounted archives (Last mounted first)
+} ice_fs_vfs;
+
+// Alignment in bytes of content of files in archives created by ice_fs_pack_create, 4096 (Page size) allows mapping each file on its own (Can be customized)
+#define ICE_FS_PACK_ALIGNMENT 64
+
+// Stream of compressed file (Opened via ice_fs_zstream_open), Content is compressed in independent blocks with index of them at end of the file, So reads can seek and blocks can be decompressed in parallel
+typedef struct ice_fs_zstream {
+    void *handle;                   // [INTERNAL] State of the stream
+} ice_fs_zstream;
+
+// Size in bytes of uncompressed blocks that ice_fs_zstream_write and ice_fs_compress_file compress independently, Bigger blocks compress better while smaller ones make seeking cheaper (Can be customized)
+#define ICE_FS_ZSTREAM_BLOCK_SIZE 262144
+
 // [INTERNAL] Returns length of string
 unsigned long ice_fs_str_len(const char *str);
 
@@ -248,6 +566,57 @@ char* ice_fs_format_path(const char *path);
 // Returns full path of a path on allocation success or NULL on failure
 char* ice_fs_fullpath(const char *path);
 
+// Stores view of root of path in span (Without allocating, Drive like C: without slash is root too), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if path has no root)
+ice_fs_bool ice_fs_root_span(const char *path, ice_fs_path_span *span);
+
+// Stores view of file name with/without extension of path in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_filename_span(const char *path, ice_fs_bool with_ext, ice_fs_path_span *span);
+
+// Stores view of file extension of path (Without dot) in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file name has no extension)
+ice_fs_bool ice_fs_ext_span(const char *path, ice_fs_path_span *span);
+
+// Stores view of previous parent of path (With its trailing slash) in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if path has no parent)
+ice_fs_bool ice_fs_prev_path_span(const char *path, ice_fs_path_span *span);
+
+// Frees all paths allocated from arena at once but keeps its memory to allocate next paths from
+void ice_fs_path_arena_reset(ice_fs_path_arena *arena);
+
+// Frees arena and all paths allocated from it
+void ice_fs_free_path_arena(ice_fs_path_arena *arena);
+
+// Same like ice_fs_concat_path but allocates result path from arena (Freed with arena instead of ice_fs_free_str)
+char* ice_fs_concat_path_arena(ice_fs_path_arena *arena, const char *path1, const char *path2);
+
+// Same like ice_fs_filename but allocates file name from arena (Freed with arena instead of ice_fs_free_str)
+char* ice_fs_filename_arena(ice_fs_path_arena *arena, const char *path, ice_fs_bool with_ext);
+
+// Same like ice_fs_ext but allocates file extension from arena (Freed with arena instead of ice_fs_free_str)
+char* ice_fs_ext_arena(ice_fs_path_arena *arena, const char *path);
+
+// Same like ice_fs_prev_path but allocates previous parent from arena (Freed with arena instead of ice_fs_free_str)
+char* ice_fs_prev_path_arena(ice_fs_path_arena *arena, const char *path);
+
+// Same like ice_fs_path_parents but allocates array and parents from arena (Freed with arena instead of ice_fs_free_strarr)
+char** ice_fs_path_parents_arena(ice_fs_path_arena *arena, const char *path, unsigned long *results);
+
+// Same like ice_fs_format_path but allocates formatted path from arena (Freed with arena instead of ice_fs_free_str)
+char* ice_fs_format_path_arena(ice_fs_path_arena *arena, const char *path);
+
+// Same like ice_fs_concat_path but writes result path into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if result path doesn't fit in buf)
+ice_fs_bool ice_fs_concat_path_buf(const char *path1, const char *path2, char *buf, unsigned long buf_size);
+
+// Same like ice_fs_filename but writes file name into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file name doesn't fit in buf)
+ice_fs_bool ice_fs_filename_buf(const char *path, ice_fs_bool with_ext, char *buf, unsigned long buf_size);
+
+// Same like ice_fs_ext but writes file extension into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file extension doesn't fit in buf)
+ice_fs_bool ice_fs_ext_buf(const char *path, char *buf, unsigned long buf_size);
+
+// Same like ice_fs_prev_path but writes previous parent into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if previous parent doesn't fit in buf)
+ice_fs_bool ice_fs_prev_path_buf(const char *path, char *buf, unsigned long buf_size);
+
+// Same like ice_fs_format_path but writes formatted path into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if formatted path doesn't fit in buf)
+ice_fs_bool ice_fs_format_path_buf(const char *path, char *buf, unsigned long buf_size);
+
 // Creates symbolic/hard link for object in path1 at path2, Retruns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
 ice_fs_bool ice_fs_link(const char *path1, const char *path2, ice_fs_bool hard_link);
 
@@ -257,56 +626,317 @@ char* ice_fs_readlink(const char *path);
 // Returns type of object in specific path, Returns ICE_FS_OBJECT_TYPE_NONE on failure if path does not exist or returns any of values does ice_fs_object_type enumeration has
 ice_fs_object_type ice_fs_type(const char *path);
 
+// Same like ice_fs_type but relative path is resolved from directory of dir handle (Current directory if dir is NULL)
+ice_fs_object_type ice_fs_type_at(const ice_fs_dir_handle *dir, const char *path);
+
 // Reads content of file and returns the content on allocation success or NULL on failure, file_size is pointer to unsigned long integer that will store number of chars (bytes) the file has
 char* ice_fs_file_content(const char *path, unsigned long *file_size);
 
+// Same like ice_fs_file_content but relative path is resolved from directory of dir handle (Current directory if dir is NULL)
+char* ice_fs_file_content_at(const ice_fs_dir_handle *dir, const char *path, unsigned long *file_size);
+
 // Creates file in path with content if doesn't exist or Appends to/Overwrites content of file in specific path if exists, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
 ice_fs_bool ice_fs_file_write(const char *path, const char *content, ice_fs_bool append);
 
+// Writes len bytes of data (Which may contain NUL bytes) to file in path in mode, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_file_write_buf(const char *path, const void *data, unsigned long len, ice_fs_write_mode mode);
+
+// Writes bufs_count buffers in bufs one after another to file in path (Without concatenating them first) in mode, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_file_writev(const char *path, const ice_fs_buf *bufs, unsigned long bufs_count, ice_fs_write_mode mode);
+
+// Same like ice_fs_file_write_buf but relative path is resolved from directory of dir handle (Current directory if dir is NULL)
+ice_fs_bool ice_fs_file_write_at(const ice_fs_dir_handle *dir, const char *path, const void *data, unsigned long len, ice_fs_write_mode mode);
+
 // Reads content of file, Returns the content in array of strings for each line on allocation success or NULL on failure, lines should be pointer to unsigned long integer to store count of lines the file has
 char** ice_fs_file_lines(const char *path, unsigned long *lines);
 
+// Maps file in path into memory as read-only view and stores it in view struct by pointing to, Pages are read lazily on first access unless populate is ICE_FS_TRUE (Which reads all of them before returning), hint tells the system how the pages will be accessed, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_map(const char *path, ice_fs_map_hint hint, ice_fs_bool populate, ice_fs_map_view *view);
+
+// Unmaps view that was mapped by ice_fs_map, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_unmap(ice_fs_map_view *view);
+
+// Opens file in path as stream in mode, buf should be pointer to caller-provided buffer of buf_size bytes or NULL to allocate buffer of buf_size bytes (ICE_FS_STREAM_BUFFER_SIZE if 0), Direct modes bypass page cache with O_DIRECT on Linux (F_NOCACHE on macOS, Cached I/O elsewhere or on filesystems that refuse it) and need buffer aligned to ICE_FS_DIRECT_ALIGNMENT bytes with size multiple of it (Allocated buffer is rounded up), Unaligned tail of the file is read and written through page cache, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_stream_open(ice_fs_stream *stream, const char *path, ice_fs_stream_mode mode, void *buf, unsigned long buf_size);
+
+// Reads up to len bytes from stream into dst and stores number of read bytes in read_len (Less than len only at end of file), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_stream_read(ice_fs_stream *stream, void *dst, unsigned long len, unsigned long *read_len);
+
+// Writes len bytes from src to stream (Through the buffer), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_stream_write(ice_fs_stream *stream, const void *src, unsigned long len);
+
+// Writes bytes pending in buffer of stream to the file, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_stream_flush(ice_fs_stream *stream);
+
+// Moves position of stream to offset relative to origin and stores the new position in pos (If not NULL), Seeking 0 bytes from ICE_FS_SEEK_CURRENT retrieves the current position, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_stream_seek(ice_fs_stream *stream, ice_fs_offset offset, ice_fs_seek_origin origin, ice_fs_offset *pos);
+
+// Tells the system how range of len bytes from offset in file of stream will be accessed (len of 0 means till end of file), Does nothing on platforms without posix_fadvise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_stream_advise(ice_fs_stream *stream, ice_fs_offset offset, ice_fs_offset len, ice_fs_stream_hint hint);
+
+// Reserves disk space for first size bytes of file of stream without changing its size (With fallocate on Linux), So streaming big file doesn't fragment it or run out of space midway, Does nothing on platforms or filesystems that can't reserve space, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Like when disk is full)
+ice_fs_bool ice_fs_stream_preallocate(ice_fs_stream *stream, ice_fs_offset size);
+
+// Closes stream opened by ice_fs_stream_open after writing bytes pending in its buffer, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_stream_close(ice_fs_stream *stream);
+
+// Allocates size bytes (With ICE_FS_MALLOC) at address that is multiple of alignment (Power of 2, ICE_FS_DIRECT_ALIGNMENT if 0), For buffers of direct I/O streams and batched requests on files opened in direct modes, Returns pointer to the memory on success or NULL on failure, The memory should be freed with ice_fs_aligned_free
+void* ice_fs_aligned_alloc(unsigned long size, unsigned long alignment);
+
+// Frees memory allocated by ice_fs_aligned_alloc
+void ice_fs_aligned_free(void *ptr);
+
+// Opens file in path for iteration of its lines with ice_fs_line_iter_next, buf_size is initial size of the sliding window buffer (ICE_FS_LINE_ITER_BUFFER_SIZE if 0, Grows only if a line doesn't fit), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_line_iter_open(ice_fs_line_iter *iter, const char *path, unsigned long buf_size);
+
+// Retrieves next line of file opened by ice_fs_line_iter_open and stores pointer to it in line and its length in len, Lines are split and empty ones skipped like ice_fs_str_splitlines does ('\r' of "\r\n" stays in the line), Line is NUL-terminated and points into the iterator buffer till next call, Returns ICE_FS_TRUE if line was retrieved or ICE_FS_FALSE when there are no more lines or on failure (failed field of the iterator is set to ICE_FS_TRUE then)
+ice_fs_bool ice_fs_line_iter_next(ice_fs_line_iter *iter, const char **line, unsigned long *len);
+
+// Closes file opened by ice_fs_line_iter_open and frees the iterator buffer, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_line_iter_close(ice_fs_line_iter *iter);
+
 // Changes current directory in the running program to another directory in path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
 ice_fs_bool ice_fs_chdir(const char *path);
 
 // Returns directory informations with list of contents in path on success or NULL on failure
 ice_fs_dir ice_fs_dir_content(const char *path);
 
+// Same like ice_fs_dir_content but relative path is resolved from directory of dir handle (Current directory if dir is NULL)
+ice_fs_dir ice_fs_dir_content_at(const ice_fs_dir_handle *dir, const char *path);
+
 // Frees/Deallocates a directory information struct, dir should be pointer to the directory information struct that will be freed
 void ice_fs_free_dir_content(ice_fs_dir *dir);
 
-// Searches in contents of directory for a specific file/directory by string, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items
+// Opens directory in path for iteration with ice_fs_dir_iter_next, buf should be pointer to caller-provided buffer of buf_size bytes (At least ICE_FS_DIR_ITER_MIN_BUFFER_SIZE) that entries are read into, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_dir_iter_open(ice_fs_dir_iter *iter, const char *path, void *buf, unsigned long buf_size);
+
+// Retrieves next item of the directory opened by ice_fs_dir_iter_open and stores it in item struct by pointing to, Name of the item points into the iterator buffer and stays valid till next call, Returns ICE_FS_TRUE if item was retrieved or ICE_FS_FALSE when there are no more items or on failure (error field of iter is set then)
+ice_fs_bool ice_fs_dir_iter_next(ice_fs_dir_iter *iter, ice_fs_object *item);
+
+// Closes directory opened by ice_fs_dir_iter_open, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Also if reading entries failed before, So directory isn't mistaken for fully read one)
+ice_fs_bool ice_fs_dir_iter_close(ice_fs_dir_iter *iter);
+
+// Opens directory in path (Relative to directory of dir handle or current directory if dir is NULL) and stores its handle in handle struct by pointing to, Paths given to *_at functions with the handle are looked up from the directory itself instead of walking its whole path again, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_dir_open(ice_fs_dir_handle *handle, const ice_fs_dir_handle *dir, const char *path);
+
+// Closes directory handle opened by ice_fs_dir_open, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_dir_close(ice_fs_dir_handle *handle);
+
+// Sets number of threads that parallel library functions (Like ice_fs_dir_search) use, 0 means number of CPU cores (The default)
+void ice_fs_use_threads(unsigned long threads_count);
+
+// Searches in contents of directory and its subdirectories (In parallel) for a specific file/directory by string, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items
 char** ice_fs_dir_search(const char *path, const char *str, unsigned long *results);
 
+// Sums sizes of everything in directory in path and its subdirectories (In parallel, Each item is stat'ed once relative to its directory, Symbolic links are counted but never followed, Hard linked files are counted once), Returns array of entries for the directory and its subdirectories up to max_depth levels below it (0 for the directory alone) sorted by path on allocation success or NULL on failure, entries_count should be pointer to unsigned long integer that stores number of the entries, Subdirectories that can't be read count as empty
+ice_fs_usage* ice_fs_dir_usage(const char *path, unsigned long max_depth, unsigned long *entries_count);
+
+// Frees array of entries returned by ice_fs_dir_usage
+void ice_fs_free_dir_usage(ice_fs_usage *entries);
+
+// Compiles glob pattern (Relative to searched directory, With / as separator) to glob that matches paths against it, * and ? match any chars and any char in a name, ** matches zero or more directories, [abc], [a-z] and [!abc] match chars of class and {a,b} matches any of alternatives, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, glob should be freed with ice_fs_free_glob
+ice_fs_bool ice_fs_glob_compile(ice_fs_glob *glob, const char *pattern);
+
+// Adds exclude pattern to glob compiled by ice_fs_glob_compile with syntax of .gitignore (Pattern without slash matches name at any depth, Leading slash anchors it to searched directory, Trailing slash matches directories only, ! re-includes and lines starting with # are ignored), Excluded directories are not searched at all, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_glob_exclude(ice_fs_glob *glob, const char *pattern);
+
+// Adds exclude patterns from each line of file in path (Like .gitignore, Patterns are relative to searched directory) to glob compiled by ice_fs_glob_compile, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_glob_exclude_file(ice_fs_glob *glob, const char *path);
+
+// Returns ICE_FS_TRUE if path (Relative to searched directory, Trailing slash marks directory) matches glob compiled by ice_fs_glob_compile and isn't excluded, Or ICE_FS_FALSE if not, Filesystem is not accessed
+ice_fs_bool ice_fs_glob_match(const ice_fs_glob *glob, const char *path);
+
+// Searches in contents of directory and its subdirectories (In parallel) for files/directories whose paths (Relative to path) match glob compiled by ice_fs_glob_compile, Directories that can't contain matches or are excluded are not searched, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items
+char** ice_fs_dir_glob(const char *path, const ice_fs_glob *glob, unsigned long *results);
+
+// Frees glob compiled by ice_fs_glob_compile
+void ice_fs_free_glob(ice_fs_glob *glob);
+
 // Creates file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
 ice_fs_bool ice_fs_create(const char *path, ice_fs_object_type type);
 
+// Same like ice_fs_create but relative path is resolved from directory of dir handle (Current directory if dir is NULL)
+ice_fs_bool ice_fs_create_at(const ice_fs_dir_handle *dir, const char *path, ice_fs_object_type type);
+
+// Creates file in path (Or resizes existing one) of size bytes with its disk space reserved upfront (With fallocate on Linux), So writing it later neither fragments it nor runs out of space midway, Added bytes read as zeros, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_create_file(const char *path, ice_fs_offset size);
+
+// Deallocates len bytes of file in path from offset (Range past end of the file is ignored), The range reads as zeros and size of the file stays same, Filesystems that can't deallocate get zeros written instead, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_punch_hole(const char *path, ice_fs_offset offset, ice_fs_offset len);
+
+// Retrieves regions of data and holes (Deallocated ranges that read as zeros) of file in path in order and stores their number in regions_count (With SEEK_DATA and SEEK_HOLE, Files are one data region where they aren't available), Returns array of regions on success or NULL on failure, The array should be freed with ice_fs_free_file_regions
+ice_fs_file_region* ice_fs_file_regions(const char *path, unsigned long *regions_count);
+
+// Frees regions retrieved by ice_fs_file_regions
+void ice_fs_free_file_regions(ice_fs_file_region *regions);
+
 // Removes file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
 ice_fs_bool ice_fs_remove(const char *path);
 
+// Same like ice_fs_remove but relative path is resolved from directory of dir handle (Current directory if dir is NULL)
+ice_fs_bool ice_fs_remove_at(const ice_fs_dir_handle *dir, const char *path);
+
+// Removes file/folder in specific path with all of its content (Subfolders are removed in parallel, Symbolic links are removed but never followed), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred)
+ice_fs_bool ice_fs_remove_all(const char *path);
+
 // Clears content of file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
 ice_fs_bool ice_fs_clear(const char *path);
 
-// Copies file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+// Copies file/folder from path1 to path2 (Files of folders are copied in parallel), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred)
 ice_fs_bool ice_fs_copy(const char *path1, const char *path2);
 
+// Sets maximum number of files that ice_fs_copy copies at same time when copying folders, 0 means 4 per thread of ice_fs_use_threads (The default)
+void ice_fs_use_copy_limit(unsigned long files_count);
+
 // Moves file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
 ice_fs_bool ice_fs_move(const char *path1, const char *path2);
 
 // Renames file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
 ice_fs_bool ice_fs_rename(const char *path1, const char *path2);
 
+// Same like ice_fs_rename but relative path1 is resolved from directory of dir1 handle and relative path2 from directory of dir2 handle (Current directory if NULL)
+ice_fs_bool ice_fs_rename_at(const ice_fs_dir_handle *dir1, const char *path1, const ice_fs_dir_handle *dir2, const char *path2);
+
 // Returns ICE_FS_TRUE if file/folder in specific path is empty or ICE_FS_FALSE if not empty
 ice_fs_bool ice_fs_is_empty(const char *path);
 
-// Retrieves [last modification, last status change, last access] date of file/directory and stores info in info struct by pointing to, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+// Retrieves [last modification, last status change, last access] date of file/directory and stores info in info struct by pointing to, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, info->str points to static buffer that next call overwrites (ice_fs_get_date_r should be used from multiple threads)
 ice_fs_bool ice_fs_get_date(const char *path, ice_fs_date_type date_type, ice_fs_date *info);
 
+// Same like ice_fs_get_date but thread-safe (Uses no static storage), str should be caller-provided buffer of str_size bytes (At least ICE_FS_DATE_STR_SIZE) that date is written into as string and that info->str points to, Or NULL to set info->str to NULL, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_get_date_r(const char *path, ice_fs_date_type date_type, ice_fs_date *info, char *str, unsigned long str_size);
+
+// Converts time in seconds since epoch (Shifted by utc_offset seconds for local time, 0 for UTC) to date in info with arithmetic alone (Thread-safe), str should be caller-provided buffer of str_size bytes (At least ICE_FS_DATE_STR_SIZE) that date is written into as string in same format as ctime and that info->str points to, Or NULL to set info->str to NULL, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_date_from_epoch(ice_fs_offset epoch, long utc_offset, ice_fs_date *info, char *str, unsigned long str_size);
+
+// Stores [last modification, last status change, last access] time of each of paths_count paths in times in nanoseconds since epoch (-1 for paths that don't exist or can't be accessed), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_get_times(const char **paths, unsigned long paths_count, ice_fs_date_type date_type, ice_fs_offset *times);
+
+// Retrieves fields (Combination of ice_fs_stat_field flags) of metadata of each of paths_count paths into infos (Many at once on multiple threads, With statx on Linux), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Paths that don't exist or can't be accessed don't fail the call (Their type is ICE_FS_OBJECT_TYPE_NONE and error is set)
+ice_fs_bool ice_fs_get_stats(const char **paths, unsigned long paths_count, unsigned fields, ice_fs_stat_info *infos);
+
+// Creates batched I/O context in batch that keeps up to depth requests in flight (ICE_FS_BATCH_DEPTH if 0), Uses io_uring if available or pool of threads otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_batch_init(ice_fs_batch *batch, unsigned long depth);
+
+// Runs reqs_count requests in reqs through batch and waits for all of them, Requests run concurrently in any order (So request that needs result of another one should be submitted after it), Result of each request is stored in its result field, Returns ICE_FS_TRUE if all requests succeeded or ICE_FS_FALSE if any failed (errno is set to error of the first failed one)
+ice_fs_bool ice_fs_batch_submit(ice_fs_batch *batch, ice_fs_batch_req *reqs, unsigned long reqs_count);
+
+// Reads contents of paths_count files in paths through batch (Opens, Stats, Reads and Closes many files at same time), Returns array of contents (NULL for each file that failed to read) on allocation success or NULL on failure, sizes can be pointer to array of paths_count unsigned long integers to store size of each content, The array should be freed with ice_fs_free_strarr
+char** ice_fs_batch_files_content(ice_fs_batch *batch, const char **paths, unsigned long paths_count, unsigned long *sizes);
+
+// Closes batched I/O context created by ice_fs_batch_init, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_batch_close(ice_fs_batch *batch);
+
+// Returns 64-bit hash of len bytes of data (Same value as XXH3_64bits of xxHash, So it's fast but not cryptographic)
+ice_fs_hash_value ice_fs_hash(const void *data, unsigned long len);
+
+// Starts streaming hash in state, Data is fed to it with ice_fs_hash_update and hash is retrieved with ice_fs_hash_digest (Same value as ice_fs_hash of all the data at once)
+void ice_fs_hash_begin(ice_fs_hash_state *state);
+
+// Feeds len bytes of data to streaming hash in state
+void ice_fs_hash_update(ice_fs_hash_state *state, const void *data, unsigned long len);
+
+// Returns hash of all data fed so far to streaming hash in state (Which can still be fed more data after)
+ice_fs_hash_value ice_fs_hash_digest(const ice_fs_hash_state *state);
+
+// Hashes content of file in path (Same value as ice_fs_hash of the whole content) and stores it in hash, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_file_hash(const char *path, ice_fs_hash_value *hash);
+
+// Hashes contents of all files in directory and its subdirectories (In parallel, Symbolic links are skipped), Returns array of hashed files sorted by path on allocation success or NULL on failure (Or if there are no files), files_count should be pointer to unsigned long integer that stores number of the files, Files that can't be read are left out
+ice_fs_hashed_file* ice_fs_dir_hash(const char *path, unsigned long *files_count);
+
+// Frees array of hashed files returned by ice_fs_dir_hash
+void ice_fs_free_dir_hash(ice_fs_hashed_file *files);
+
+// Finds files with same content in directory and its subdirectories (Files of same size are hashed in parallel, Empty files and symbolic links are skipped), Returns array of groups of duplicates on allocation success or NULL on failure (Or if there are no duplicates), groups_count should be pointer to unsigned long integer that stores number of the groups, Paths in each group are sorted
+ice_fs_dup_group* ice_fs_dir_duplicates(const char *path, unsigned long *groups_count);
+
+// Frees array of groups of duplicates returned by ice_fs_dir_duplicates
+void ice_fs_free_duplicates(ice_fs_dup_group *groups);
+
+// Records path, type, size, modification time and inode of every object in directory and its subdirectories (Walked in parallel, Symbolic links are not followed) into snap, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Subdirectories that can't be read are left out, snap should be freed with ice_fs_free_snapshot
+ice_fs_bool ice_fs_snapshot_take(ice_fs_snapshot *snap, const char *path);
+
+// Writes snap to file in path in compact binary format (Each path only stores what differs from the previous one), The file is replaced atomically, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_snapshot_save(const ice_fs_snapshot *snap, const char *path);
+
+// Reads snapshot written by ice_fs_snapshot_save from file in path into snap, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the file is corrupted), snap should be freed with ice_fs_free_snapshot
+ice_fs_bool ice_fs_snapshot_load(ice_fs_snapshot *snap, const char *path);
+
+// Returns entry of snap with path (Relative to root directory of the snapshot) without touching the filesystem, Or NULL if snap has no such entry
+const ice_fs_snapshot_entry* ice_fs_snapshot_find(const ice_fs_snapshot *snap, const char *path);
+
+// Compares older snapshot old_snap to newer snapshot new_snap (Of same directory) and stores added, removed and modified entries in changes, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Snapshots should outlive changes, changes should be freed with ice_fs_free_snapshot_changes
+ice_fs_bool ice_fs_snapshot_diff(const ice_fs_snapshot *old_snap, const ice_fs_snapshot *new_snap, ice_fs_snapshot_changes *changes);
+
+// Frees entries of snapshot taken by ice_fs_snapshot_take or read by ice_fs_snapshot_load
+void ice_fs_free_snapshot(ice_fs_snapshot *snap);
+
+// Frees changes found by ice_fs_snapshot_diff
+void ice_fs_free_snapshot_changes(ice_fs_snapshot_changes *changes);
+
+// Creates watcher in watcher, Uses inotify if available or compares snapshots of watched trees periodically otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_watch_init(ice_fs_watcher *watcher);
+
+// Watches directory in path and all of its subdirectories (Including ones created later), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_watch_add(ice_fs_watcher *watcher, const char *path);
+
+// Waits up to timeout milliseconds (0 doesn't wait and negative waits forever) for events of watched trees and stores up to events_capacity of them in events and their number in events_count, Repeated changes of same object are merged into one event, Returns ICE_FS_TRUE on success (Even if no event came in time) or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_watch_poll(ice_fs_watcher *watcher, ice_fs_watch_event *events, unsigned long events_capacity, unsigned long *events_count, long timeout);
+
+// Closes watcher created by ice_fs_watch_init, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_watch_close(ice_fs_watcher *watcher);
+
+// Packs files and directories in directory in path and all of its subdirectories into read-only archive in pack_path (Table of contents sorted by path with hash table for lookups, Content of files aligned to ICE_FS_PACK_ALIGNMENT bytes), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_pack_create(const char *path, const char *pack_path);
+
+// Mounts archive in pack_path created by ice_fs_pack_create into vfs at mount_point (NULL or "" for current directory), Archives mounted later take priority over earlier ones and all of them take priority over disk, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the archive is malformed)
+ice_fs_bool ice_fs_vfs_mount(ice_fs_vfs *vfs, const char *pack_path, const char *mount_point);
+
+// Returns type of object in path (Looked up in mounted archives then on disk)
+ice_fs_object_type ice_fs_vfs_type(const ice_fs_vfs *vfs, const char *path);
+
+// Returns pointer to content of file in path inside mounted archive (Without copying, Valid till ice_fs_vfs_close) and stores its size in file_size, Or NULL if none of mounted archives has the file (Disk is not accessed)
+const void* ice_fs_vfs_file_data(const ice_fs_vfs *vfs, const char *path, unsigned long *file_size);
+
+// Same like ice_fs_file_content but file in path is looked up in mounted archives then on disk
+char* ice_fs_vfs_file_content(const ice_fs_vfs *vfs, const char *path, unsigned long *file_size);
+
+// Same like ice_fs_dir_content but items of directory in path are listed from mounted archives then disk (Items found earlier hide ones of same name)
+ice_fs_dir ice_fs_vfs_dir_content(const ice_fs_vfs *vfs, const char *path);
+
+// Unmounts all archives mounted into vfs, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_vfs_close(ice_fs_vfs *vfs);
+
+// Opens compressed file in path as stream in mode (ICE_FS_STREAM_MODE_READ for file created with ice_fs_zstream_write or ice_fs_compress_file, Or ICE_FS_STREAM_MODE_WRITE to create it with blocks of ICE_FS_ZSTREAM_BLOCK_SIZE bytes), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the file is malformed)
+ice_fs_bool ice_fs_zstream_open(ice_fs_zstream *stream, const char *path, ice_fs_stream_mode mode);
+
+// Reads up to len bytes of uncompressed content from stream into dst and stores number of read bytes in read_len (Less than len only at end of content), Blocks that dst covers whole are decompressed straight into it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_zstream_read(ice_fs_zstream *stream, void *dst, unsigned long len, unsigned long *read_len);
+
+// Writes len bytes from src to stream, Each ICE_FS_ZSTREAM_BLOCK_SIZE bytes are compressed into block and written once collected, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_zstream_write(ice_fs_zstream *stream, const void *src, unsigned long len);
+
+// Moves position of stream opened for reading to offset of uncompressed content (Only block that holds it gets decompressed on next read), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_zstream_seek(ice_fs_zstream *stream, ice_fs_offset offset);
+
+// Stores uncompressed size of content of stream in size (Bytes written so far for streams opened for writing), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_zstream_size(const ice_fs_zstream *stream, ice_fs_offset *size);
+
+// Closes stream opened by ice_fs_zstream_open after writing pending bytes and index of blocks (For streams opened for writing), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_zstream_close(ice_fs_zstream *stream);
+
+// Compresses file in path into compressed_path (Same format ice_fs_zstream_write creates, With blocks of ICE_FS_ZSTREAM_BLOCK_SIZE bytes compressed on multiple threads), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure
+ice_fs_bool ice_fs_compress_file(const char *path, const char *compressed_path);
+
+// Same like ice_fs_file_content but file in path is compressed file (Created by ice_fs_compress_file or ice_fs_zstream_write) that is decompressed straight into returned buffer (Blocks on multiple threads), Returns NULL on failure (Or if the file is malformed)
+char* ice_fs_compressed_file_content(const char *path, unsigned long *file_size);
+
 
 ================================== Linking Flags ==================================
 
 1. Microsoft Windows    => -lkernel32
-2. Other                => -lc
+2. Other                => -lc -lpthread
 
 // NOTES:
 // 1. When using MSVC on Microsoft Windows, Required static libraries are automatically linked via #pragma preprocessor
@@ -353,6 +983,18 @@ ice_fs_bool ice_fs_get_date(const char *path, ice_fs_date_type date_type, ice_fs
 // Define this to customize ICE_FS_MALLOC, ICE_FS_CALLOC, ICE_FS_REALLOC, ICE_FS_FREE
 #define ICE_FS_CUSTOM_MEMORY_ALLOCATORS
 
+// Define this to not use io_uring on Linux, Batched I/O contexts run requests on pool of threads then
+#define ICE_FS_NO_IO_URING
+
+// Define this to not use SSE2/AVX2 instructions for hashing (Even if the compiler targets them), Portable code is used then
+#define ICE_FS_NO_SIMD
+
+// Define this to not use inotify on Linux, Watchers compare snapshots of watched trees periodically then
+#define ICE_FS_NO_INOTIFY
+
+// Define this to not use statx on Linux, ice_fs_get_stats uses stat then
+#define ICE_FS_NO_STATX
+
 
 ============================== Implementation Resources ===========================
 
@@ -543,6 +1185,58 @@ typedef struct ice_fs_dir {
     unsigned long items_count;      /* Number of the items in the directory */
 } ice_fs_dir;
 
+/* Minimum size of buffer in bytes that ice_fs_dir_iter_open accepts */
+#define ICE_FS_DIR_ITER_MIN_BUFFER_SIZE 1024
+
+/* Size of buffer in bytes that library functions use to iterate directories (Can be customized) */
+#if !defined(ICE_FS_DIR_ITER_BUFFER_SIZE)
+#  define ICE_FS_DIR_ITER_BUFFER_SIZE 32768
+#endif
+
+/* Size of buffer in bytes that ice_fs_copy uses when file can't be copied by the kernel (Can be customized) */
+#if !defined(ICE_FS_COPY_BUFFER_SIZE)
+#  define ICE_FS_COPY_BUFFER_SIZE 131072
+#endif
+
+/* Directory iterator, Yields items of directory one at a time from caller-provided buffer without any allocation */
+typedef struct ice_fs_dir_iter {
+    void *handle;                   /* [INTERNAL] Handle of opened directory (Depends on platform) */
+    int fd;                         /* [INTERNAL] File descriptor of opened directory (Unix only) */
+    char *buf;                      /* [INTERNAL] Caller-provided buffer where entries are read into */
+    unsigned long buf_size;         /* [INTERNAL] Size of the buffer in bytes */
+    unsigned long buf_len;          /* [INTERNAL] Bytes of entries currently in the buffer */
+    unsigned long buf_pos;          /* [INTERNAL] Offset of next entry in the buffer */
+    int error;                      /* 0 or errno value if reading entries failed (So ice_fs_dir_iter_next returned ICE_FS_FALSE before the end of directory) */
+} ice_fs_dir_iter;
+
+/* Handle of opened directory that *_at functions resolve relative paths from, Opened by ice_fs_dir_open */
+typedef struct ice_fs_dir_handle {
+    int fd;                         /* [INTERNAL] File descriptor of the directory (Unix only, -1 elsewhere) */
+    char *path;                     /* [INTERNAL] Full path of the directory (Windows only, NULL elsewhere) */
+} ice_fs_dir_handle;
+
+/* Compiled glob pattern with exclude patterns, Compiled by ice_fs_glob_compile and searched for with ice_fs_dir_glob (Can be shared by multiple threads once compiled) */
+typedef struct ice_fs_glob {
+    void *handle;                   /* [INTERNAL] Compiled rules */
+} ice_fs_glob;
+
+/* Arena that *_arena path functions allocate paths from, Zero-initialized arena is empty and ready to use, Paths are freed at once with ice_fs_path_arena_reset (Keeps memory for reuse) or ice_fs_free_path_arena */
+typedef struct ice_fs_path_arena {
+    void *chunks;                   /* [INTERNAL] Chunks of memory owned by the arena (Oldest first) */
+    void *current;                  /* [INTERNAL] Chunk that next paths are allocated from */
+} ice_fs_path_arena;
+
+/* Size of chunks in bytes that ice_fs_path_arena allocates memory in (Can be customized) */
+#if !defined(ICE_FS_PATH_ARENA_CHUNK_SIZE)
+#  define ICE_FS_PATH_ARENA_CHUNK_SIZE 16384
+#endif
+
+/* View into path (Part of path string that isn't null-terminated), Stored by *_span path functions */
+typedef struct ice_fs_path_span {
+    unsigned long offset;           /* Index of first char of the view in path */
+    unsigned long len;              /* Number of chars of the view */
+} ice_fs_path_span;
+
 /* Enumeration for week days */
 typedef enum ice_fs_date_day {
     ICE_FS_DATE_DAY_UNKNOWN = 0,
@@ -603,6 +1297,302 @@ typedef enum ice_fs_date_type {
     ICE_FS_LAST_STATUS_CHANGE_DATE      /* Last status change date of file/directory */
 } ice_fs_date_type;
 
+/* Size of buffer in bytes that date is written into as string by ice_fs_date_from_epoch and ice_fs_get_date_r (Same format as ctime, With newline and NUL terminator) */
+#define ICE_FS_DATE_STR_SIZE 26
+
+/* Access pattern hints for memory-mapped files (Passed to ice_fs_map) */
+typedef enum ice_fs_map_hint {
+    ICE_FS_MAP_HINT_NORMAL = 0,         /* No special treatment */
+    ICE_FS_MAP_HINT_SEQUENTIAL,         /* Pages will be accessed in sequential order (Read ahead aggressively) */
+    ICE_FS_MAP_HINT_RANDOM,             /* Pages will be accessed in random order (Don't read ahead) */
+    ICE_FS_MAP_HINT_WILLNEED            /* Pages will be needed soon (Start reading them in background) */
+} ice_fs_map_hint;
+
+/* Read-only memory-mapped view of file (Retrieved via ice_fs_map) */
+typedef struct ice_fs_map_view {
+    const void *data;               /* Content of the file (NULL for empty files) */
+    unsigned long size;             /* Size of the content in bytes */
+    void *handle;                   /* [INTERNAL] Handle of file mapping (Microsoft Windows only) */
+} ice_fs_map_view;
+
+/* Offset/Size in file (64-bit even where long is 32-bit) */
+#if defined(_MSC_VER)
+typedef __int64 ice_fs_offset;
+#elif defined(__GNUC__)
+__extension__ typedef long long ice_fs_offset;
+#else
+typedef long long ice_fs_offset;
+#endif
+
+/* Modes to open streams with (Passed to ice_fs_stream_open) */
+typedef enum ice_fs_stream_mode {
+    ICE_FS_STREAM_MODE_READ = 0,        /* Read only */
+    ICE_FS_STREAM_MODE_WRITE,           /* Write only, File is created if doesn't exist or truncated if exists */
+    ICE_FS_STREAM_MODE_APPEND,          /* Write only at end of file, File is created if doesn't exist */
+    ICE_FS_STREAM_MODE_READ_WRITE,      /* Read and write, File is created if doesn't exist */
+    ICE_FS_STREAM_MODE_DIRECT_READ,     /* Read only bypassing page cache (Direct I/O), For big files read once */
+    ICE_FS_STREAM_MODE_DIRECT_WRITE     /* Write only bypassing page cache (Direct I/O), File is created if doesn't exist or truncated if exists */
+} ice_fs_stream_mode;
+
+/* Origins to seek streams from (Passed to ice_fs_stream_seek) */
+typedef enum ice_fs_seek_origin {
+    ICE_FS_SEEK_START = 0,              /* Beginning of file */
+    ICE_FS_SEEK_CURRENT,                /* Current position */
+    ICE_FS_SEEK_END                     /* End of file */
+} ice_fs_seek_origin;
+
+/* Access pattern hints for streams (Passed to ice_fs_stream_advise) */
+typedef enum ice_fs_stream_hint {
+    ICE_FS_STREAM_HINT_NORMAL = 0,      /* No special treatment */
+    ICE_FS_STREAM_HINT_SEQUENTIAL,      /* Range will be accessed in sequential order (Read ahead aggressively) */
+    ICE_FS_STREAM_HINT_RANDOM,          /* Range will be accessed in random order (Don't read ahead) */
+    ICE_FS_STREAM_HINT_WILLNEED,        /* Range will be needed soon (Start reading it in background) */
+    ICE_FS_STREAM_HINT_DONTNEED         /* Range won't be needed again (Drop it from cache) */
+} ice_fs_stream_hint;
+
+/* Size of buffer in bytes that ice_fs_stream_open allocates when no buffer or size is given (Can be customized) */
+#if !defined(ICE_FS_STREAM_BUFFER_SIZE)
+#  define ICE_FS_STREAM_BUFFER_SIZE 65536
+#endif
+
+/* Alignment in bytes of buffers, offsets and sizes for direct I/O (Default of ice_fs_aligned_alloc, Can be customized) */
+#if !defined(ICE_FS_DIRECT_ALIGNMENT)
+#  define ICE_FS_DIRECT_ALIGNMENT 4096
+#endif
+
+/* Buffered stream of opened file, Reads and writes go through caller-provided or allocated buffer of fixed size */
+typedef struct ice_fs_stream {
+    int fd;                         /* [INTERNAL] File descriptor of opened file */
+    char *buf;                      /* [INTERNAL] Buffer (Caller-provided or allocated) */
+    unsigned long buf_size;         /* [INTERNAL] Size of the buffer in bytes */
+    unsigned long buf_pos;          /* [INTERNAL] Offset of next unread byte in the buffer */
+    unsigned long buf_len;          /* [INTERNAL] Bytes in the buffer (Read ahead or pending to be written) */
+    ice_fs_bool writing;            /* [INTERNAL] ICE_FS_TRUE if bytes in the buffer are pending to be written */
+    ice_fs_bool owns_buf;           /* [INTERNAL] ICE_FS_TRUE if the buffer was allocated by ice_fs_stream_open */
+    ice_fs_bool direct;             /* [INTERNAL] ICE_FS_TRUE while the file is accessed with direct I/O */
+} ice_fs_stream;
+
+/* Size of buffer in bytes that ice_fs_line_iter_open allocates when no size is given (Can be customized) */
+#if !defined(ICE_FS_LINE_ITER_BUFFER_SIZE)
+#  define ICE_FS_LINE_ITER_BUFFER_SIZE 65536
+#endif
+
+/* Line iterator, Yields lines of file one at a time from sliding window buffer without allocation per line */
+typedef struct ice_fs_line_iter {
+    int fd;                         /* [INTERNAL] File descriptor of opened file */
+    char *buf;                      /* [INTERNAL] Sliding window buffer */
+    unsigned long buf_size;         /* [INTERNAL] Size of the buffer in bytes */
+    unsigned long buf_pos;          /* [INTERNAL] Offset of next line in the buffer */
+    unsigned long buf_len;          /* [INTERNAL] Bytes read into the buffer */
+    unsigned long scan_pos;         /* [INTERNAL] Offset where search for next newline continues */
+    ice_fs_bool eof;                /* [INTERNAL] ICE_FS_TRUE when end of file was reached */
+    ice_fs_bool failed;             /* ICE_FS_TRUE if iteration stopped because of failure */
+} ice_fs_line_iter;
+
+/* Modes to write files with (Passed to ice_fs_file_write_buf and ice_fs_file_writev) */
+typedef enum ice_fs_write_mode {
+    ICE_FS_WRITE_MODE_OVERWRITE = 0,    /* File is created if doesn't exist or truncated if exists */
+    ICE_FS_WRITE_MODE_APPEND,           /* Data is appended to end of file, File is created if doesn't exist */
+    ICE_FS_WRITE_MODE_ATOMIC            /* Data is written to temporary file that is flushed to disk then renamed over the file, So the file has either old or new content even after crash */
+} ice_fs_write_mode;
+
+/* Buffer of data to write (Passed to ice_fs_file_writev) */
+typedef struct ice_fs_buf {
+    const void *data;               /* Pointer to the data */
+    unsigned long len;              /* Size of the data in bytes */
+} ice_fs_buf;
+
+/* Fields of metadata that ice_fs_get_stats retrieves (Flags, Can be combined with |) */
+typedef enum ice_fs_stat_field {
+    ICE_FS_STAT_TYPE = 1,               /* Type of object */
+    ICE_FS_STAT_SIZE = 2,               /* Size in bytes */
+    ICE_FS_STAT_MTIME = 4,              /* Last modification time */
+    ICE_FS_STAT_MODE = 8,               /* Permission bits */
+    ICE_FS_STAT_ALL = 15                /* All of the above */
+} ice_fs_stat_field;
+
+/* Metadata of object retrieved by ice_fs_get_stats, Fields that weren't asked for are 0 (Except type, Which is ICE_FS_OBJECT_TYPE_NONE since 0 means file) */
+typedef struct ice_fs_stat_info {
+    ice_fs_offset size;                 /* Size in bytes (ICE_FS_STAT_SIZE) */
+    ice_fs_offset mtime;                /* Last modification time in nanoseconds since epoch (ICE_FS_STAT_MTIME) */
+    unsigned mode;                      /* Permission bits like 0644 (ICE_FS_STAT_MODE) */
+    ice_fs_object_type type;            /* Type of object (ICE_FS_STAT_TYPE), ICE_FS_OBJECT_TYPE_NONE if it wasn't asked for or couldn't be retrieved */
+    int error;                          /* 0 on success or errno value if object doesn't exist or can't be accessed */
+} ice_fs_stat_info;
+
+/* Region of file retrieved by ice_fs_file_regions */
+typedef struct ice_fs_file_region {
+    ice_fs_offset offset;               /* Offset of the region in bytes */
+    ice_fs_offset len;                  /* Size of the region in bytes */
+    ice_fs_bool hole;                   /* ICE_FS_TRUE if the region is hole (Reads as zeros, Includes space reserved but never written) or ICE_FS_FALSE if it has data */
+} ice_fs_file_region;
+
+/* Disk usage of directory retrieved by ice_fs_dir_usage */
+typedef struct ice_fs_usage {
+    char *path;                     /* Full path of the directory */
+    ice_fs_offset size;             /* Apparent size in bytes of the directory and everything in it (Sum of sizes, Like du --apparent-size) */
+    ice_fs_offset allocated;        /* Disk space in bytes allocated for the directory and everything in it (Like du, Same as size on Microsoft Windows) */
+    unsigned long files_count;      /* Number of items (Files, Directories, Links...) in the directory and its subdirectories */
+    unsigned long depth;            /* Levels of the directory below directory in path (0 for directory in path itself) */
+} ice_fs_usage;
+
+/* Operations of batched I/O requests (Passed to ice_fs_batch_submit) */
+typedef enum ice_fs_batch_op {
+    ICE_FS_BATCH_OP_OPEN = 0,           /* Opens file in path in mode and stores its file descriptor in fd */
+    ICE_FS_BATCH_OP_READ,               /* Reads up to len bytes from file of fd at offset into buf */
+    ICE_FS_BATCH_OP_WRITE,              /* Writes up to len bytes from buf to file of fd at offset */
+    ICE_FS_BATCH_OP_STAT,               /* Stores type and size of object in path (Or of file of fd if path is NULL) in type and size */
+    ICE_FS_BATCH_OP_CLOSE               /* Closes fd */
+} ice_fs_batch_op;
+
+/* Batched I/O request, Fields that its operation doesn't use are ignored */
+typedef struct ice_fs_batch_req {
+    ice_fs_batch_op op;             /* Operation to run */
+    const char *path;               /* Path of object (OPEN, STAT) */
+    ice_fs_stream_mode mode;        /* Mode to open file with (OPEN) */
+    int fd;                         /* File descriptor (READ, WRITE, STAT, CLOSE), Set by OPEN */
+    void *buf;                      /* Buffer to read into or write from (READ, WRITE) */
+    unsigned long len;              /* Size of the buffer in bytes (READ, WRITE) */
+    ice_fs_offset offset;           /* Offset in file (READ, WRITE) */
+    ice_fs_offset size;             /* Size of object in bytes, Set by STAT */
+    ice_fs_object_type type;        /* Type of object, Set by STAT */
+    long result;                    /* Number of read/written bytes (READ, WRITE) or 0 (Others) on success, Negative errno value on failure */
+} ice_fs_batch_req;
+
+/* Maximum number of requests in flight that ice_fs_batch_init uses when no depth is given (Can be customized) */
+#if !defined(ICE_FS_BATCH_DEPTH)
+#  define ICE_FS_BATCH_DEPTH 256
+#endif
+
+/* Batched I/O context, Submits requests through io_uring on Linux or runs them on pool of threads (Elsewhere or if io_uring is unavailable), Should be used by one thread at a time */
+typedef struct ice_fs_batch {
+    void *handle;                   /* [INTERNAL] io_uring ring or pool of threads */
+    unsigned long depth;            /* [INTERNAL] Maximum number of requests in flight */
+    ice_fs_bool io_uring;           /* ICE_FS_TRUE if requests are submitted through io_uring or ICE_FS_FALSE if they run on pool of threads */
+} ice_fs_batch;
+
+/* 64-bit hash of data (Same value as XXH3_64bits of xxHash) */
+#if defined(_MSC_VER)
+typedef unsigned __int64 ice_fs_hash_value;
+#elif defined(__GNUC__)
+__extension__ typedef unsigned long long ice_fs_hash_value;
+#else
+typedef unsigned long long ice_fs_hash_value;
+#endif
+
+/* Streaming hash state, Started by ice_fs_hash_begin */
+typedef struct ice_fs_hash_state {
+    ice_fs_hash_value acc[8];       /* [INTERNAL] Accumulators of stripes consumed so far */
+    unsigned char buf[256];         /* [INTERNAL] Bytes waiting to be consumed (End of it keeps last consumed stripe) */
+    unsigned long buf_len;          /* [INTERNAL] Number of bytes waiting in the buffer */
+    unsigned long stripes;          /* [INTERNAL] Number of stripes consumed in current block */
+    ice_fs_hash_value total_len;    /* [INTERNAL] Number of bytes fed so far */
+} ice_fs_hash_state;
+
+/* File hashed by ice_fs_dir_hash */
+typedef struct ice_fs_hashed_file {
+    char *path;                     /* Full path of the file */
+    ice_fs_offset size;             /* Size of the file in bytes */
+    ice_fs_hash_value hash;         /* Hash of content of the file */
+} ice_fs_hashed_file;
+
+/* Group of files with same content, Found by ice_fs_dir_duplicates */
+typedef struct ice_fs_dup_group {
+    char **paths;                   /* Full paths of the files */
+    unsigned long paths_count;      /* Number of the files (2 or more) */
+    ice_fs_offset size;             /* Size of each file in bytes */
+    ice_fs_hash_value hash;         /* Hash of content of each file */
+} ice_fs_dup_group;
+
+/* Size of buffer in bytes that files are read through for hashing, Bigger files are mapped into memory instead on Unix (Can be customized) */
+#if !defined(ICE_FS_HASH_BUFFER_SIZE)
+#  define ICE_FS_HASH_BUFFER_SIZE 131072
+#endif
+
+/* Object of directory tree recorded by ice_fs_snapshot_take */
+typedef struct ice_fs_snapshot_entry {
+    char *path;                     /* Path relative to root directory of the snapshot */
+    ice_fs_object_type type;        /* Type of the object (Symbolic links have their own type, Which is file even for links to directories) */
+    ice_fs_bool is_link;            /* ICE_FS_TRUE if the object is symbolic link (Which is recorded itself and never followed) */
+    ice_fs_offset size;             /* Size in bytes (0 for directories) */
+    ice_fs_offset mtime;            /* Last modification time in nanoseconds since epoch (Whole seconds on platforms without finer timestamps) */
+    ice_fs_offset inode;            /* Inode number (0 on Windows) */
+} ice_fs_snapshot_entry;
+
+/* Snapshot of directory tree, Taken by ice_fs_snapshot_take or read by ice_fs_snapshot_load */
+typedef struct ice_fs_snapshot {
+    ice_fs_snapshot_entry *entries; /* Objects of the tree sorted by path */
+    unsigned long entries_count;    /* Number of the objects */
+} ice_fs_snapshot;
+
+/* Differences between two snapshots, Found by ice_fs_snapshot_diff (Entries point into the snapshots) */
+typedef struct ice_fs_snapshot_changes {
+    const ice_fs_snapshot_entry **added;    /* Entries of newer snapshot that older one doesn't have */
+    unsigned long added_count;
+    const ice_fs_snapshot_entry **removed;  /* Entries of older snapshot that newer one doesn't have */
+    unsigned long removed_count;
+    const ice_fs_snapshot_entry **modified; /* Entries of newer snapshot whose type, size, modification time or inode changed */
+    unsigned long modified_count;
+} ice_fs_snapshot_changes;
+
+/* Types of events reported by ice_fs_watch_poll */
+typedef enum ice_fs_watch_event_type {
+    ICE_FS_WATCH_EVENT_CREATED = 0, /* Object was created (Or moved into watched tree) */
+    ICE_FS_WATCH_EVENT_MODIFIED,    /* Content or attributes of object changed */
+    ICE_FS_WATCH_EVENT_DELETED,     /* Object was deleted (Or moved out of watched tree) */
+    ICE_FS_WATCH_EVENT_MOVED,       /* Object was moved from path to new_path inside watched tree */
+    ICE_FS_WATCH_EVENT_OVERFLOW     /* Events were lost since too many came at once, Watched trees should be scanned again */
+} ice_fs_watch_event_type;
+
+/* Event reported by ice_fs_watch_poll, Paths stay valid till next call to ice_fs_watch_poll */
+typedef struct ice_fs_watch_event {
+    ice_fs_watch_event_type type;   /* Type of the event */
+    ice_fs_bool is_dir;             /* ICE_FS_TRUE if the object is directory */
+    const char *path;               /* Full path of the object (NULL for ICE_FS_WATCH_EVENT_OVERFLOW) */
+    const char *new_path;           /* Full path the object was moved to (ICE_FS_WATCH_EVENT_MOVED only, NULL otherwise) */
+} ice_fs_watch_event;
+
+/* Watcher of directory trees, Uses inotify on Linux or compares snapshots of the trees periodically (Elsewhere or if inotify is unavailable), Should be used by one thread at a time */
+typedef struct ice_fs_watcher {
+    void *handle;                   /* [INTERNAL] State of the watcher */
+    ice_fs_bool inotify;            /* ICE_FS_TRUE if events come from inotify or ICE_FS_FALSE if trees are compared periodically */
+} ice_fs_watcher;
+
+/* Number of events that watcher keeps till they are polled, Further events are dropped and ICE_FS_WATCH_EVENT_OVERFLOW is reported (Can be customized) */
+#if !defined(ICE_FS_WATCH_EVENTS_CAPACITY)
+#  define ICE_FS_WATCH_EVENTS_CAPACITY 4096
+#endif
+
+/* Size of buffer in bytes that watcher keeps paths of events in (Can be customized) */
+#if !defined(ICE_FS_WATCH_BUFFER_SIZE)
+#  define ICE_FS_WATCH_BUFFER_SIZE 262144
+#endif
+
+/* Milliseconds between comparisons of snapshots when watcher doesn't use inotify (Can be customized) */
+#if !defined(ICE_FS_WATCH_POLL_INTERVAL)
+#  define ICE_FS_WATCH_POLL_INTERVAL 250
+#endif
+
+/* Virtual filesystem that looks up paths in archives created by ice_fs_pack_create then on disk (Should be zero-initialized before first ice_fs_vfs_mount), Can be used by many threads at a time once archives are mounted */
+typedef struct ice_fs_vfs {
+    void *mounts;                   /* [INTERNAL] Mounted archives (Last mounted first) */
+} ice_fs_vfs;
+
+/* Alignment in bytes of content of files in archives created by ice_fs_pack_create, 4096 (Page size) allows mapping each file on its own (Can be customized) */
+#if !defined(ICE_FS_PACK_ALIGNMENT)
+#  define ICE_FS_PACK_ALIGNMENT 64
+#endif
+
+/* Stream of compressed file (Opened via ice_fs_zstream_open), Content is compressed in independent blocks with index of them at end of the file, So reads can seek and blocks can be decompressed in parallel */
+typedef struct ice_fs_zstream {
+    void *handle;                   /* [INTERNAL] State of the stream */
+} ice_fs_zstream;
+
+/* Size in bytes of uncompressed blocks that ice_fs_zstream_write and ice_fs_compress_file compress independently, Bigger blocks compress better while smaller ones make seeking cheaper (Can be customized) */
+#if !defined(ICE_FS_ZSTREAM_BLOCK_SIZE)
+#  define ICE_FS_ZSTREAM_BLOCK_SIZE 262144
+#endif
+
 /* ============================== Functions ============================== */
 
 /* [INTERNAL] Returns length of string */
@@ -686,6 +1676,57 @@ ICE_FS_API char* ICE_FS_CALLCONV ice_fs_format_path(const char *path);
 /* Returns full path of a path on allocation success or NULL on failure */
 ICE_FS_API char* ICE_FS_CALLCONV ice_fs_fullpath(const char *path);
 
+/* Stores view of root of path in span (Without allocating, Drive like C: without slash is root too), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if path has no root) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_root_span(const char *path, ice_fs_path_span *span);
+
+/* Stores view of file name with/without extension of path in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_filename_span(const char *path, ice_fs_bool with_ext, ice_fs_path_span *span);
+
+/* Stores view of file extension of path (Without dot) in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file name has no extension) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_ext_span(const char *path, ice_fs_path_span *span);
+
+/* Stores view of previous parent of path (With its trailing slash) in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if path has no parent) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_prev_path_span(const char *path, ice_fs_path_span *span);
+
+/* Frees all paths allocated from arena at once but keeps its memory to allocate next paths from */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_path_arena_reset(ice_fs_path_arena *arena);
+
+/* Frees arena and all paths allocated from it */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_path_arena(ice_fs_path_arena *arena);
+
+/* Same like ice_fs_concat_path but allocates result path from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_concat_path_arena(ice_fs_path_arena *arena, const char *path1, const char *path2);
+
+/* Same like ice_fs_filename but allocates file name from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_filename_arena(ice_fs_path_arena *arena, const char *path, ice_fs_bool with_ext);
+
+/* Same like ice_fs_ext but allocates file extension from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_ext_arena(ice_fs_path_arena *arena, const char *path);
+
+/* Same like ice_fs_prev_path but allocates previous parent from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_prev_path_arena(ice_fs_path_arena *arena, const char *path);
+
+/* Same like ice_fs_path_parents but allocates array and parents from arena (Freed with arena instead of ice_fs_free_strarr) */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_path_parents_arena(ice_fs_path_arena *arena, const char *path, unsigned long *results);
+
+/* Same like ice_fs_format_path but allocates formatted path from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_format_path_arena(ice_fs_path_arena *arena, const char *path);
+
+/* Same like ice_fs_concat_path but writes result path into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if result path doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_concat_path_buf(const char *path1, const char *path2, char *buf, unsigned long buf_size);
+
+/* Same like ice_fs_filename but writes file name into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file name doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_filename_buf(const char *path, ice_fs_bool with_ext, char *buf, unsigned long buf_size);
+
+/* Same like ice_fs_ext but writes file extension into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file extension doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_ext_buf(const char *path, char *buf, unsigned long buf_size);
+
+/* Same like ice_fs_prev_path but writes previous parent into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if previous parent doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_prev_path_buf(const char *path, char *buf, unsigned long buf_size);
+
+/* Same like ice_fs_format_path but writes formatted path into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if formatted path doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_format_path_buf(const char *path, char *buf, unsigned long buf_size);
+
 /* Creates symbolic/hard link for object in path1 at path2, Retruns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_link(const char *path1, const char *path2, ice_fs_bool hard_link);
 
@@ -695,97 +1736,404 @@ ICE_FS_API char* ICE_FS_CALLCONV ice_fs_readlink(const char *path);
 /* Returns type of object in specific path, Returns ICE_FS_OBJECT_TYPE_NONE on failure if path does not exist or returns any of values does ice_fs_object_type enumeration has */
 ICE_FS_API ice_fs_object_type ICE_FS_CALLCONV ice_fs_type(const char *path);
 
+/* Same like ice_fs_type but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_object_type ICE_FS_CALLCONV ice_fs_type_at(const ice_fs_dir_handle *dir, const char *path);
+
 /* Reads content of file and returns the content on allocation success or NULL on failure, file_size is pointer to unsigned long integer that will store number of chars (bytes) the file has */
 ICE_FS_API char* ICE_FS_CALLCONV ice_fs_file_content(const char *path, unsigned long *file_size);
 
+/* Same like ice_fs_file_content but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_file_content_at(const ice_fs_dir_handle *dir, const char *path, unsigned long *file_size);
+
 /* Creates file in path with content if doesn't exist or Appends to/Overwrites content of file in specific path if exists, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_write(const char *path, const char *content, ice_fs_bool append);
 
+/* Writes len bytes of data (Which may contain NUL bytes) to file in path in mode, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_write_buf(const char *path, const void *data, unsigned long len, ice_fs_write_mode mode);
+
+/* Writes bufs_count buffers in bufs one after another to file in path (Without concatenating them first) in mode, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_writev(const char *path, const ice_fs_buf *bufs, unsigned long bufs_count, ice_fs_write_mode mode);
+
+/* Same like ice_fs_file_write_buf but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_write_at(const ice_fs_dir_handle *dir, const char *path, const void *data, unsigned long len, ice_fs_write_mode mode);
+
 /* Reads content of file, Returns the content in array of strings for each line on allocation success or NULL on failure, lines should be pointer to unsigned long integer to store count of lines the file has */
 ICE_FS_API char** ICE_FS_CALLCONV ice_fs_file_lines(const char *path, unsigned long *lines);
 
+/* Maps file in path into memory as read-only view and stores it in view struct by pointing to, Pages are read lazily on first access unless populate is ICE_FS_TRUE (Which reads all of them before returning), hint tells the system how the pages will be accessed, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_map(const char *path, ice_fs_map_hint hint, ice_fs_bool populate, ice_fs_map_view *view);
+
+/* Unmaps view that was mapped by ice_fs_map, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_unmap(ice_fs_map_view *view);
+
+/* Opens file in path as stream in mode, buf should be pointer to caller-provided buffer of buf_size bytes or NULL to allocate buffer of buf_size bytes (ICE_FS_STREAM_BUFFER_SIZE if 0), Direct modes bypass page cache with O_DIRECT on Linux (F_NOCACHE on macOS, Cached I/O elsewhere or on filesystems that refuse it) and need buffer aligned to ICE_FS_DIRECT_ALIGNMENT bytes with size multiple of it (Allocated buffer is rounded up), Unaligned tail of the file is read and written through page cache, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_open(ice_fs_stream *stream, const char *path, ice_fs_stream_mode mode, void *buf, unsigned long buf_size);
+
+/* Reads up to len bytes from stream into dst and stores number of read bytes in read_len (Less than len only at end of file), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_read(ice_fs_stream *stream, void *dst, unsigned long len, unsigned long *read_len);
+
+/* Writes len bytes from src to stream (Through the buffer), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_write(ice_fs_stream *stream, const void *src, unsigned long len);
+
+/* Writes bytes pending in buffer of stream to the file, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_flush(ice_fs_stream *stream);
+
+/* Moves position of stream to offset relative to origin and stores the new position in pos (If not NULL), Seeking 0 bytes from ICE_FS_SEEK_CURRENT retrieves the current position, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_seek(ice_fs_stream *stream, ice_fs_offset offset, ice_fs_seek_origin origin, ice_fs_offset *pos);
+
+/* Tells the system how range of len bytes from offset in file of stream will be accessed (len of 0 means till end of file), Does nothing on platforms without posix_fadvise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_advise(ice_fs_stream *stream, ice_fs_offset offset, ice_fs_offset len, ice_fs_stream_hint hint);
+
+/* Reserves disk space for first size bytes of file of stream without changing its size (With fallocate on Linux), So streaming big file doesn't fragment it or run out of space midway, Does nothing on platforms or filesystems that can't reserve space, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Like when disk is full) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_preallocate(ice_fs_stream *stream, ice_fs_offset size);
+
+/* Closes stream opened by ice_fs_stream_open after writing bytes pending in its buffer, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_close(ice_fs_stream *stream);
+
+/* Allocates size bytes (With ICE_FS_MALLOC) at address that is multiple of alignment (Power of 2, ICE_FS_DIRECT_ALIGNMENT if 0), For buffers of direct I/O streams and batched requests on files opened in direct modes, Returns pointer to the memory on success or NULL on failure, The memory should be freed with ice_fs_aligned_free */
+ICE_FS_API void* ICE_FS_CALLCONV ice_fs_aligned_alloc(unsigned long size, unsigned long alignment);
+
+/* Frees memory allocated by ice_fs_aligned_alloc */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_aligned_free(void *ptr);
+
+/* Opens file in path for iteration of its lines with ice_fs_line_iter_next, buf_size is initial size of the sliding window buffer (ICE_FS_LINE_ITER_BUFFER_SIZE if 0, Grows only if a line doesn't fit), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_line_iter_open(ice_fs_line_iter *iter, const char *path, unsigned long buf_size);
+
+/* Retrieves next line of file opened by ice_fs_line_iter_open and stores pointer to it in line and its length in len, Lines are split and empty ones skipped like ice_fs_str_splitlines does ('\r' of "\r\n" stays in the line), Line is NUL-terminated and points into the iterator buffer till next call, Returns ICE_FS_TRUE if line was retrieved or ICE_FS_FALSE when there are no more lines or on failure (failed field of the iterator is set to ICE_FS_TRUE then) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_line_iter_next(ice_fs_line_iter *iter, const char **line, unsigned long *len);
+
+/* Closes file opened by ice_fs_line_iter_open and frees the iterator buffer, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_line_iter_close(ice_fs_line_iter *iter);
+
 /* Changes current directory in the running program to another directory in path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_chdir(const char *path);
 
 /* Returns directory informations with list of contents in path on success or NULL on failure */
 ICE_FS_API ice_fs_dir ICE_FS_CALLCONV ice_fs_dir_content(const char *path);
 
+/* Same like ice_fs_dir_content but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_dir ICE_FS_CALLCONV ice_fs_dir_content_at(const ice_fs_dir_handle *dir, const char *path);
+
 /* Frees/Deallocates a directory information struct, dir should be pointer to the directory information struct that will be freed */
 ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_dir_content(ice_fs_dir *dir);
 
-/* Searches in contents of directory for a specific file/directory by string, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
+/* Opens directory in path for iteration with ice_fs_dir_iter_next, buf should be pointer to caller-provided buffer of buf_size bytes (At least ICE_FS_DIR_ITER_MIN_BUFFER_SIZE) that entries are read into, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_iter_open(ice_fs_dir_iter *iter, const char *path, void *buf, unsigned long buf_size);
+
+/* Retrieves next item of the directory opened by ice_fs_dir_iter_open and stores it in item struct by pointing to, Name of the item points into the iterator buffer and stays valid till next call, Returns ICE_FS_TRUE if item was retrieved or ICE_FS_FALSE when there are no more items or on failure (error field of iter is set then) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_iter_next(ice_fs_dir_iter *iter, ice_fs_object *item);
+
+/* Closes directory opened by ice_fs_dir_iter_open, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Also if reading entries failed before, So directory isn't mistaken for fully read one) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_iter_close(ice_fs_dir_iter *iter);
+
+/* Opens directory in path (Relative to directory of dir handle or current directory if dir is NULL) and stores its handle in handle struct by pointing to, Paths given to *_at functions with the handle are looked up from the directory itself instead of walking its whole path again, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_open(ice_fs_dir_handle *handle, const ice_fs_dir_handle *dir, const char *path);
+
+/* Closes directory handle opened by ice_fs_dir_open, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_close(ice_fs_dir_handle *handle);
+
+/* Sets number of threads that parallel library functions (Like ice_fs_dir_search) use, 0 means number of CPU cores (The default) */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_use_threads(unsigned long threads_count);
+
+/* Searches in contents of directory and its subdirectories (In parallel) for a specific file/directory by string, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
 ICE_FS_API char** ICE_FS_CALLCONV ice_fs_dir_search(const char *path, const char *str, unsigned long *results);
 
+/* Sums sizes of everything in directory in path and its subdirectories (In parallel, Each item is stat'ed once relative to its directory, Symbolic links are counted but never followed, Hard linked files are counted once), Returns array of entries for the directory and its subdirectories up to max_depth levels below it (0 for the directory alone) sorted by path on allocation success or NULL on failure, entries_count should be pointer to unsigned long integer that stores number of the entries, Subdirectories that can't be read count as empty */
+ICE_FS_API ice_fs_usage* ICE_FS_CALLCONV ice_fs_dir_usage(const char *path, unsigned long max_depth, unsigned long *entries_count);
+
+/* Frees array of entries returned by ice_fs_dir_usage */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_dir_usage(ice_fs_usage *entries);
+
+/* Compiles glob pattern (Relative to searched directory, With / as separator) to glob that matches paths against it, * and ? match any chars and any char in a name, ** matches zero or more directories, [abc], [a-z] and [!abc] match chars of class and {a,b} matches any of alternatives, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, glob should be freed with ice_fs_free_glob */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_glob_compile(ice_fs_glob *glob, const char *pattern);
+
+/* Adds exclude pattern to glob compiled by ice_fs_glob_compile with syntax of .gitignore (Pattern without slash matches name at any depth, Leading slash anchors it to searched directory, Trailing slash matches directories only, ! re-includes and lines starting with # are ignored), Excluded directories are not searched at all, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_glob_exclude(ice_fs_glob *glob, const char *pattern);
+
+/* Adds exclude patterns from each line of file in path (Like .gitignore, Patterns are relative to searched directory) to glob compiled by ice_fs_glob_compile, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_glob_exclude_file(ice_fs_glob *glob, const char *path);
+
+/* Returns ICE_FS_TRUE if path (Relative to searched directory, Trailing slash marks directory) matches glob compiled by ice_fs_glob_compile and isn't excluded, Or ICE_FS_FALSE if not, Filesystem is not accessed */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_glob_match(const ice_fs_glob *glob, const char *path);
+
+/* Searches in contents of directory and its subdirectories (In parallel) for files/directories whose paths (Relative to path) match glob compiled by ice_fs_glob_compile, Directories that can't contain matches or are excluded are not searched, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_dir_glob(const char *path, const ice_fs_glob *glob, unsigned long *results);
+
+/* Frees glob compiled by ice_fs_glob_compile */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_glob(ice_fs_glob *glob);
+
 /* Creates file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_create(const char *path, ice_fs_object_type type);
 
+/* Same like ice_fs_create but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_create_at(const ice_fs_dir_handle *dir, const char *path, ice_fs_object_type type);
+
+/* Creates file in path (Or resizes existing one) of size bytes with its disk space reserved upfront (With fallocate on Linux), So writing it later neither fragments it nor runs out of space midway, Added bytes read as zeros, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_create_file(const char *path, ice_fs_offset size);
+
+/* Deallocates len bytes of file in path from offset (Range past end of the file is ignored), The range reads as zeros and size of the file stays same, Filesystems that can't deallocate get zeros written instead, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_punch_hole(const char *path, ice_fs_offset offset, ice_fs_offset len);
+
+/* Retrieves regions of data and holes (Deallocated ranges that read as zeros) of file in path in order and stores their number in regions_count (With SEEK_DATA and SEEK_HOLE, Files are one data region where they aren't available), Returns array of regions on success or NULL on failure, The array should be freed with ice_fs_free_file_regions */
+ICE_FS_API ice_fs_file_region* ICE_FS_CALLCONV ice_fs_file_regions(const char *path, unsigned long *regions_count);
+
+/* Frees regions retrieved by ice_fs_file_regions */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_file_regions(ice_fs_file_region *regions);
+
 /* Removes file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_remove(const char *path);
 
+/* Same like ice_fs_remove but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_remove_at(const ice_fs_dir_handle *dir, const char *path);
+
+/* Removes file/folder in specific path with all of its content (Subfolders are removed in parallel, Symbolic links are removed but never followed), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_remove_all(const char *path);
+
 /* Clears content of file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_clear(const char *path);
 
-/* Copies file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+/* Copies file/folder from path1 to path2 (Files of folders are copied in parallel), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred) */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_copy(const char *path1, const char *path2);
 
+/* Sets maximum number of files that ice_fs_copy copies at same time when copying folders, 0 means 4 per thread of ice_fs_use_threads (The default) */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_use_copy_limit(unsigned long files_count);
+
 /* Moves file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_move(const char *path1, const char *path2);
 
 /* Renames file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_rename(const char *path1, const char *path2);
 
+/* Same like ice_fs_rename but relative path1 is resolved from directory of dir1 handle and relative path2 from directory of dir2 handle (Current directory if NULL) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_rename_at(const ice_fs_dir_handle *dir1, const char *path1, const ice_fs_dir_handle *dir2, const char *path2);
+
 /* Returns ICE_FS_TRUE if file/folder in specific path is empty or ICE_FS_FALSE if not empty */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_is_empty(const char *path);
 
-/* Retrieves [last modification, last status change, last access] date of file/directory and stores info in info struct by pointing to, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+/* Retrieves [last modification, last status change, last access] date of file/directory and stores info in info struct by pointing to, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, info->str points to static buffer that next call overwrites (ice_fs_get_date_r should be used from multiple threads) */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_date(const char *path, ice_fs_date_type date_type, ice_fs_date *info);
 
-#if defined(__cplusplus)
-}
-#endif
+/* Same like ice_fs_get_date but thread-safe (Uses no static storage), str should be caller-provided buffer of str_size bytes (At least ICE_FS_DATE_STR_SIZE) that date is written into as string and that info->str points to, Or NULL to set info->str to NULL, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_date_r(const char *path, ice_fs_date_type date_type, ice_fs_date *info, char *str, unsigned long str_size);
 
-#if defined(ICE_FS_IMPL)
+/* Converts time in seconds since epoch (Shifted by utc_offset seconds for local time, 0 for UTC) to date in info with arithmetic alone (Thread-safe), str should be caller-provided buffer of str_size bytes (At least ICE_FS_DATE_STR_SIZE) that date is written into as string in same format as ctime and that info->str points to, Or NULL to set info->str to NULL, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_date_from_epoch(ice_fs_offset epoch, long utc_offset, ice_fs_date *info, char *str, unsigned long str_size);
 
-#if defined(ICE_FS_MICROSOFT)
-#  undef NO_OLDNAMES
-#  define _CRT_INTERNAL_NONSTDC_NAMES 1
-#  define _CRT_DECLARE_NONSTDC_NAMES 1
-#  define _WIN32_WINNT 0x600
-#elif defined(ICE_FS_UNIX)
-#  define _POSIX_SOURCE 1
-#  define _GNU_SOURCE 1
-#endif
+/* Stores [last modification, last status change, last access] time of each of paths_count paths in times in nanoseconds since epoch (-1 for paths that don't exist or can't be accessed), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_times(const char **paths, unsigned long paths_count, ice_fs_date_type date_type, ice_fs_offset *times);
 
-#if defined(ICE_FS_MICROSOFT) || defined(ICE_FS_UNIX)
-#  include <time.h>
-#  include <stdlib.h>
-#  include <stdio.h>
-#  include <sys/types.h>
-#  include <sys/stat.h>
-#  if defined(ICE_FS_MICROSOFT)
-#    include <direct.h>
-#    include <io.h>
-#    include <fcntl.h>
-#    if defined(_MSC_VER)
-#      include <windows.h>
-#      pragma comment(lib, "kernel32.lib")
-#    else
-#      include <windef.h>
-#      include <winbase.h>
-#      include <fileapi.h>
-#    endif
-#    define ice_fs_open(path, flags)  open(path, flags)
-#    define ice_fs_mkdir(path)        mkdir(path)
-#  elif defined(ICE_FS_UNIX)
-#    include <unistd.h>
-#    include <sys/fcntl.h>
-#    include <sys/io.h>
-#    include <dirent.h>
+/* Retrieves fields (Combination of ice_fs_stat_field flags) of metadata of each of paths_count paths into infos (Many at once on multiple threads, With statx on Linux), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Paths that don't exist or can't be accessed don't fail the call (Their type is ICE_FS_OBJECT_TYPE_NONE and error is set) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_stats(const char **paths, unsigned long paths_count, unsigned fields, ice_fs_stat_info *infos);
+
+/* Creates batched I/O context in batch that keeps up to depth requests in flight (ICE_FS_BATCH_DEPTH if 0), Uses io_uring if available or pool of threads otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_batch_init(ice_fs_batch *batch, unsigned long depth);
+
+/* Runs reqs_count requests in reqs through batch and waits for all of them, Requests run concurrently in any order (So request that needs result of another one should be submitted after it), Result of each request is stored in its result field, Returns ICE_FS_TRUE if all requests succeeded or ICE_FS_FALSE if any failed (errno is set to error of the first failed one) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_batch_submit(ice_fs_batch *batch, ice_fs_batch_req *reqs, unsigned long reqs_count);
+
+/* Reads contents of paths_count files in paths through batch (Opens, Stats, Reads and Closes many files at same time), Returns array of contents (NULL for each file that failed to read) on allocation success or NULL on failure, sizes can be pointer to array of paths_count unsigned long integers to store size of each content, The array should be freed with ice_fs_free_strarr */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_batch_files_content(ice_fs_batch *batch, const char **paths, unsigned long paths_count, unsigned long *sizes);
+
+/* Closes batched I/O context created by ice_fs_batch_init, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_batch_close(ice_fs_batch *batch);
+
+/* Returns 64-bit hash of len bytes of data (Same value as XXH3_64bits of xxHash, So it's fast but not cryptographic) */
+ICE_FS_API ice_fs_hash_value ICE_FS_CALLCONV ice_fs_hash(const void *data, unsigned long len);
+
+/* Starts streaming hash in state, Data is fed to it with ice_fs_hash_update and hash is retrieved with ice_fs_hash_digest (Same value as ice_fs_hash of all the data at once) */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_hash_begin(ice_fs_hash_state *state);
+
+/* Feeds len bytes of data to streaming hash in state */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_hash_update(ice_fs_hash_state *state, const void *data, unsigned long len);
+
+/* Returns hash of all data fed so far to streaming hash in state (Which can still be fed more data after) */
+ICE_FS_API ice_fs_hash_value ICE_FS_CALLCONV ice_fs_hash_digest(const ice_fs_hash_state *state);
+
+/* Hashes content of file in path (Same value as ice_fs_hash of the whole content) and stores it in hash, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_hash(const char *path, ice_fs_hash_value *hash);
+
+/* Hashes contents of all files in directory and its subdirectories (In parallel, Symbolic links are skipped), Returns array of hashed files sorted by path on allocation success or NULL on failure (Or if there are no files), files_count should be pointer to unsigned long integer that stores number of the files, Files that can't be read are left out */
+ICE_FS_API ice_fs_hashed_file* ICE_FS_CALLCONV ice_fs_dir_hash(const char *path, unsigned long *files_count);
+
+/* Frees array of hashed files returned by ice_fs_dir_hash */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_dir_hash(ice_fs_hashed_file *files);
+
+/* Finds files with same content in directory and its subdirectories (Files of same size are hashed in parallel, Empty files and symbolic links are skipped), Returns array of groups of duplicates on allocation success or NULL on failure (Or if there are no duplicates), groups_count should be pointer to unsigned long integer that stores number of the groups, Paths in each group are sorted */
+ICE_FS_API ice_fs_dup_group* ICE_FS_CALLCONV ice_fs_dir_duplicates(const char *path, unsigned long *groups_count);
+
+/* Frees array of groups of duplicates returned by ice_fs_dir_duplicates */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_duplicates(ice_fs_dup_group *groups);
+
+/* Records path, type, size, modification time and inode of every object in directory and its subdirectories (Walked in parallel, Symbolic links are not followed) into snap, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Subdirectories that can't be read are left out, snap should be freed with ice_fs_free_snapshot */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_snapshot_take(ice_fs_snapshot *snap, const char *path);
+
+/* Writes snap to file in path in compact binary format (Each path only stores what differs from the previous one), The file is replaced atomically, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_snapshot_save(const ice_fs_snapshot *snap, const char *path);
+
+/* Reads snapshot written by ice_fs_snapshot_save from file in path into snap, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the file is corrupted), snap should be freed with ice_fs_free_snapshot */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_snapshot_load(ice_fs_snapshot *snap, const char *path);
+
+/* Returns entry of snap with path (Relative to root directory of the snapshot) without touching the filesystem, Or NULL if snap has no such entry */
+ICE_FS_API const ice_fs_snapshot_entry* ICE_FS_CALLCONV ice_fs_snapshot_find(const ice_fs_snapshot *snap, const char *path);
+
+/* Compares older snapshot old_snap to newer snapshot new_snap (Of same directory) and stores added, removed and modified entries in changes, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Snapshots should outlive changes, changes should be freed with ice_fs_free_snapshot_changes */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_snapshot_diff(const ice_fs_snapshot *old_snap, const ice_fs_snapshot *new_snap, ice_fs_snapshot_changes *changes);
+
+/* Frees entries of snapshot taken by ice_fs_snapshot_take or read by ice_fs_snapshot_load */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_snapshot(ice_fs_snapshot *snap);
+
+/* Frees changes found by ice_fs_snapshot_diff */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_snapshot_changes(ice_fs_snapshot_changes *changes);
+
+/* Creates watcher in watcher, Uses inotify if available or compares snapshots of watched trees periodically otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_watch_init(ice_fs_watcher *watcher);
+
+/* Watches directory in path and all of its subdirectories (Including ones created later), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_watch_add(ice_fs_watcher *watcher, const char *path);
+
+/* Waits up to timeout milliseconds (0 doesn't wait and negative waits forever) for events of watched trees and stores up to events_capacity of them in events and their number in events_count, Repeated changes of same object are merged into one event, Returns ICE_FS_TRUE on success (Even if no event came in time) or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_watch_poll(ice_fs_watcher *watcher, ice_fs_watch_event *events, unsigned long events_capacity, unsigned long *events_count, long timeout);
+
+/* Closes watcher created by ice_fs_watch_init, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_watch_close(ice_fs_watcher *watcher);
+
+/* Packs files and directories in directory in path and all of its subdirectories into read-only archive in pack_path (Table of contents sorted by path with hash table for lookups, Content of files aligned to ICE_FS_PACK_ALIGNMENT bytes), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_pack_create(const char *path, const char *pack_path);
+
+/* Mounts archive in pack_path created by ice_fs_pack_create into vfs at mount_point (NULL or "" for current directory), Archives mounted later take priority over earlier ones and all of them take priority over disk, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the archive is malformed) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_vfs_mount(ice_fs_vfs *vfs, const char *pack_path, const char *mount_point);
+
+/* Returns type of object in path (Looked up in mounted archives then on disk) */
+ICE_FS_API ice_fs_object_type ICE_FS_CALLCONV ice_fs_vfs_type(const ice_fs_vfs *vfs, const char *path);
+
+/* Returns pointer to content of file in path inside mounted archive (Without copying, Valid till ice_fs_vfs_close) and stores its size in file_size, Or NULL if none of mounted archives has the file (Disk is not accessed) */
+ICE_FS_API const void* ICE_FS_CALLCONV ice_fs_vfs_file_data(const ice_fs_vfs *vfs, const char *path, unsigned long *file_size);
+
+/* Same like ice_fs_file_content but file in path is looked up in mounted archives then on disk */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_vfs_file_content(const ice_fs_vfs *vfs, const char *path, unsigned long *file_size);
+
+/* Same like ice_fs_dir_content but items of directory in path are listed from mounted archives then disk (Items found earlier hide ones of same name) */
+ICE_FS_API ice_fs_dir ICE_FS_CALLCONV ice_fs_vfs_dir_content(const ice_fs_vfs *vfs, const char *path);
+
+/* Unmounts all archives mounted into vfs, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_vfs_close(ice_fs_vfs *vfs);
+
+/* Opens compressed file in path as stream in mode (ICE_FS_STREAM_MODE_READ for file created with ice_fs_zstream_write or ice_fs_compress_file, Or ICE_FS_STREAM_MODE_WRITE to create it with blocks of ICE_FS_ZSTREAM_BLOCK_SIZE bytes), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the file is malformed) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_open(ice_fs_zstream *stream, const char *path, ice_fs_stream_mode mode);
+
+/* Reads up to len bytes of uncompressed content from stream into dst and stores number of read bytes in read_len (Less than len only at end of content), Blocks that dst covers whole are decompressed straight into it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_read(ice_fs_zstream *stream, void *dst, unsigned long len, unsigned long *read_len);
+
+/* Writes len bytes from src to stream, Each ICE_FS_ZSTREAM_BLOCK_SIZE bytes are compressed into block and written once collected, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_write(ice_fs_zstream *stream, const void *src, unsigned long len);
+
+/* Moves position of stream opened for reading to offset of uncompressed content (Only block that holds it gets decompressed on next read), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_seek(ice_fs_zstream *stream, ice_fs_offset offset);
+
+/* Stores uncompressed size of content of stream in size (Bytes written so far for streams opened for writing), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_size(const ice_fs_zstream *stream, ice_fs_offset *size);
+
+/* Closes stream opened by ice_fs_zstream_open after writing pending bytes and index of blocks (For streams opened for writing), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_close(ice_fs_zstream *stream);
+
+/* Compresses file in path into compressed_path (Same format ice_fs_zstream_write creates, With blocks of ICE_FS_ZSTREAM_BLOCK_SIZE bytes compressed on multiple threads), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_compress_file(const char *path, const char *compressed_path);
+
+/* Same like ice_fs_file_content but file in path is compressed file (Created by ice_fs_compress_file or ice_fs_zstream_write) that is decompressed straight into returned buffer (Blocks on multiple threads), Returns NULL on failure (Or if the file is malformed) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_compressed_file_content(const char *path, unsigned long *file_size);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#if defined(ICE_FS_IMPL)
+
+#if defined(ICE_FS_MICROSOFT)
+#  undef NO_OLDNAMES
+#  define _CRT_INTERNAL_NONSTDC_NAMES 1
+#  define _CRT_DECLARE_NONSTDC_NAMES 1
+#  define _WIN32_WINNT 0x600
+#elif defined(ICE_FS_UNIX)
+#  define _POSIX_SOURCE 1
+#  define _GNU_SOURCE 1
+#endif
+
+#if defined(ICE_FS_MICROSOFT) || defined(ICE_FS_UNIX)
+#  include <time.h>
+#  include <stdlib.h>
+#  include <stdio.h>
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <errno.h>
+#  include <string.h>
+#  if defined(ICE_FS_MICROSOFT)
+#    include <direct.h>
+#    include <io.h>
+#    include <fcntl.h>
+#    if defined(_MSC_VER)
+#      include <windows.h>
+#      pragma comment(lib, "kernel32.lib")
+#    else
+#      include <windef.h>
+#      include <winbase.h>
+#      include <fileapi.h>
+#    endif
+#    define ice_fs_open(path, flags)  open(path, flags)
+#    define ice_fs_mkdir(path)        mkdir(path)
+#  elif defined(ICE_FS_UNIX)
+#    include <unistd.h>
+#    include <sys/fcntl.h>
+#    include <sys/io.h>
+#    include <dirent.h>
+#    include <sys/syscall.h>
+#    include <sys/mman.h>
+#    include <sys/uio.h>
+#    include <pthread.h>
+#    if defined(__linux__) && defined(SYS_getdents64)
+#      define ICE_FS_GETDENTS 1
+#    endif
+#    if defined(__linux__)
+#      include <sys/ioctl.h>
+#      include <sys/sendfile.h>
+#      if !defined(FICLONE)
+#        define FICLONE _IOW(0x94, 9, int)
+#      endif
+#      if defined(FALLOC_FL_KEEP_SIZE) && defined(FALLOC_FL_PUNCH_HOLE)
+#        define ICE_FS_FALLOCATE 1
+#      endif
+#      if defined(SYS_statx) && defined(STATX_TYPE) && !defined(ICE_FS_NO_STATX)
+#        define ICE_FS_STATX 1
+#      endif
+#      if !defined(ICE_FS_NO_INOTIFY)
+#        include <sys/inotify.h>
+#        include <poll.h>
+#        define ICE_FS_INOTIFY 1
+#      endif
+#      if defined(__GNUC__) && defined(SYS_io_uring_setup) && defined(SYS_io_uring_enter) && defined(SYS_io_uring_register) && defined(STATX_TYPE) && !defined(ICE_FS_NO_IO_URING) && defined(__has_include)
+#        if __has_include(<linux/io_uring.h>)
+#          include <linux/io_uring.h>
+#          if defined(IORING_FEAT_RW_CUR_POS)
+#            define ICE_FS_IO_URING 1
+#          endif
+#        endif
+#      endif
+#    endif
 #    define ice_fs_open(path, flags)  open(path, flags, 666)
 #    define ice_fs_mkdir(path)        mkdir(path, 0777)
 #  endif
 #endif
 
+/* Hashing uses AVX2 or SSE2 when the compiler targets them (AVX2 needs flag like -mavx2) */
+#if !defined(ICE_FS_NO_SIMD)
+#  if defined(__AVX2__)
+#    include <immintrin.h>
+#    define ICE_FS_AVX2 1
+#  elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#    include <emmintrin.h>
+#    define ICE_FS_SSE2 1
+#  endif
+#endif
+
 /* [INTERNAL] Returns length of string */
 ICE_FS_APIDEF unsigned long ICE_FS_CALLCONV ice_fs_str_len(const char *str) {
     unsigned long res = 0;
@@ -1012,62 +2360,44 @@ ICE_FS_API char** ICE_FS_CALLCONV ice_fs_str_splitlines(const char *str, unsigne
 ICE_FS_API unsigned long ICE_FS_CALLCONV ice_fs_str_matches(const char *str1, const char *str2, unsigned long **idxs) {
     unsigned long len1 = ice_fs_str_len(str1),
                   len2 = ice_fs_str_len(str2),
-                  char_matches = 0,
                   matches = 0,
                   alloc_size,
+                  lookup_state,
                   i;
+    unsigned long *matches_idxs = 0;
 
     if ((len1 == 0) || (len2 == 0)) return 0;
 
-    for (i = 0; i < len1; i++) {
-        if ((str1[i] == str2[0]) && ((i + (len2 - 1)) < len1)) {
-            unsigned long j;
+    /* First lookup counts the matches, Second one stores their indexes if requested */
+    for (lookup_state = 0; lookup_state < 2; lookup_state++) {
+        unsigned long count = 0;
 
-            for (j = 0; j < len2; j++) {
-                if (str1[i + j] == str2[j]) {
-                    char_matches++;
-                }
-            }
+        if (lookup_state == 1) {
+            if ((idxs == 0) || (matches == 0)) break;
 
-            if (char_matches == len2) {
-                matches++;
-                char_matches = 0;
-                i += len2;
-            }
+            alloc_size = (matches * sizeof(unsigned long));
+            matches_idxs = ICE_FS_MALLOC(alloc_size);
+
+            if (matches_idxs == 0) return 0;
         }
-    }
-    
-    if (idxs != 0) {
-        unsigned long count = 0, *matches_idxs;
-        
-        alloc_size = (matches * sizeof(unsigned long));
-        matches_idxs = ICE_FS_MALLOC(alloc_size);
-
-        if (matches_idxs == 0) return 0;
-
-        for (i = 0; i < len1; i++) {
-            if ((str1[i] == str2[0]) && ((i + (len2 - 1)) < len1)) {
-                unsigned long j;
-                
-                for (j = 0; j < len2; j++) {
-                    if (str1[i + j] == str2[j]) {
-                        char_matches++;
-                    }
-                }
-                
-                if (char_matches == len2) {
-                    char_matches = 0;
-                    matches_idxs[count] = i;
-                    i += len2;
-                }
-                
+
+        for (i = 0; (i + len2) <= len1; i++) {
+            unsigned long j = 0;
+
+            while ((j < len2) && (str1[i + j] == str2[j])) j++;
+
+            if (j == len2) {
+                if (lookup_state == 1) matches_idxs[count] = i;
                 count++;
+                i += (len2 - 1);
             }
         }
-        
-        *idxs = matches_idxs;
+
+        matches = count;
     }
 
+    if (idxs != 0) *idxs = matches_idxs;
+
     return matches;
 }
 
@@ -1094,331 +2424,87 @@ ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_strarr(char **strs, unsigned long ar
 
 /* Returns root of a path on allocation success or NULL on failure */
 ICE_FS_API char* ICE_FS_CALLCONV ice_fs_root(const char *path) {
-    unsigned long i,
-                  limit = 0,
-                  alloc_size = 0,
-                  len = ice_fs_str_len(path),
-                  slashes = ice_fs_str_slashes(path);
-    
-    int win_special_case = 0;
+    ice_fs_path_span span;
+    unsigned long i, sep;
     char *res = 0;
 
-    if (len == 0) return 0;
+    if (ice_fs_root_span(path, &span) == ICE_FS_FALSE) return 0;
 
-    for (i = 0; i < len; i++) {
-        char ch = path[i];
-        
-        if ((ch == '\\') || (ch == '/')) {
-            limit = i + 1;
-            break;
-        }
-    }
-    
-    win_special_case = (((slashes == 0) && (len == 2) && (path[len - 1] == ':')) ? 1 : 0);
-    
-    if (win_special_case == 1) limit = 2;
-    if (limit == 0) return 0;
-    
-    alloc_size = limit;
-    
-    if (win_special_case == 0) {
-        res = ICE_FS_MALLOC((alloc_size + 1) * sizeof(char));
-    } else if (win_special_case == 1) {
-        res = ICE_FS_MALLOC((alloc_size + 2) * sizeof(char));
-    }
-    
+    /* Drive without slash gets separator of platform */
+    sep = (((path[span.len - 1] == '\\') || (path[span.len - 1] == '/')) ? 0 : 1);
+
+    res = ICE_FS_MALLOC((span.len + sep + 1) * sizeof(char));
     if (res == 0) return 0;
-    
-    for (i = 0; i < alloc_size; i++) {
+
+    for (i = 0; i < span.len; i++) {
         res[i] = path[i];
     }
-    
-    if (win_special_case == 0) {
-        res[i] = 0;
-    } else if (win_special_case == 1) {
+
+    if (sep == 1) {
         res[i] = '\\';
-        res[i + 1] = 0;
+        i++;
     }
 
+    res[i] = 0;
+
     return res;
 }
 
 /* Returns ICE_FS_TRUE if the path is root or ICE_FS_FALSE if not */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_is_root(const char *path) {
-    ice_fs_bool res;
-
-    char *root_path = ice_fs_root(path);
-    if (root_path == 0) return ICE_FS_FALSE;
+    ice_fs_path_span span;
 
-    res = ice_fs_str_same(path, root_path);
-    ice_fs_free_str(root_path);
-
-    return res;
+    if (ice_fs_root_span(path, &span) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    return (path[span.len] == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
 }
 
 /* Concats 2 paths and returns result path on allocation success or NULL on failure */
 ICE_FS_API char* ICE_FS_CALLCONV ice_fs_concat_path(const char *path1, const char *path2) {
-    unsigned long i,
-                  alloc_size,
-                  len1 = ice_fs_str_len(path1),
-                  len2 = ice_fs_str_len(path2),
-                  count = 0;
-    ice_fs_bool end1, start2;
-    char *res = 0;
-    
-    if (path1 == 0) {
-        return 0;
-    } else {
-        end1 = ice_fs_str_ends_with_slash(path1);
-    }
-    
-    if (path2 == 0) goto special_case;
-    
-    start2 = ice_fs_str_starts_with_slash(path2);
-    
-    alloc_size = len1 + len2 + 1;
-    
-    if ((end1 == ICE_FS_FALSE) && (start2 == ICE_FS_FALSE)) {
-        alloc_size++;
-    } else if ((end1 == ICE_FS_TRUE) && (start2 == ICE_FS_TRUE)) {
-        alloc_size = alloc_size - 1;
-    }
-    
-    res = ICE_FS_MALLOC(alloc_size * sizeof(char));
-    if (res == 0) return 0;
-    
-    for (i = 0; i < len1; i++) {
-        char ch = path1[i];
-        
-        if ((end1 == ICE_FS_TRUE) && (start2 == ICE_FS_TRUE) && (i == len1 - 1)) break;
-        
-        if ((ch == '\\') || (ch == '/')) {
-#if defined(ICE_FS_MICROSOFT)
-            res[count] = '\\';
-#else
-            res[count] = '/';
-#endif
-        } else {
-            res[count] = ch;
-        }
-        
-        count++;
-    }
-    
-    if (end1 == start2) {
-#if defined(ICE_FS_MICROSOFT)
-        res[count] = '\\';
-#else
-        res[count] = '/';
-#endif
-        count++;
-    }
-    
-    i = ((end1 == ICE_FS_TRUE) && (start2 == ICE_FS_TRUE)) ? 1 : 0;
-    
-    while (i < len2) {
-        char ch = path2[i];
-        
-        if ((ch == '\\') || (ch == '/')) {
-#if defined(ICE_FS_MICROSOFT)
-            res[count] = '\\';
-#else
-            res[count] = '/';
-#endif
-        } else if (!((ch == '\\') || (ch == '/'))) {
-            res[count] = ch;
-        }
-        
-        count++;
-        i++;
-    }
-    
-    res[count] = 0;
-    
-    return res;
-
-special_case:
-    alloc_size = len1 + 1;
-    
-    res = ICE_FS_MALLOC(alloc_size * sizeof(char));
-    if (res == 0) return 0;
-    
-    for (i = 0; i < len1; i++) {
-        char ch = path1[i];
-        
-        if ((ch == '\\') || (ch == '/')) {
-#if defined(ICE_FS_MICROSOFT)
-            res[count] = '\\';
-#else
-            res[count] = '/';
-#endif
-        } else {
-            res[count] = ch;
-        }
-        
-        count++;
-    }
-    
-    res[count] = 0;
-    
-    return res;
+    return ice_fs_concat_path_arena(0, path1, path2);
 }
 
 /* Returns file name with/without extension from path on allocation success or NULL on failure */
 ICE_FS_API char* ICE_FS_CALLCONV ice_fs_filename(const char *path, ice_fs_bool with_ext) {
-    unsigned long i,
-                  limit = 0,
-                  limit_end = 0,
-                  len = ice_fs_str_len(path),
-                  dots_count = 0, dots = ice_fs_str_dots(path),
-                  slashes_count = 0, slashes = ice_fs_str_slashes(path);
-
-    if (len == 0) return 0;
-    
-    for (i = 0; i < len; i++) {
-        char ch = path[i];
-        
-        if ((ch == '\\') || (ch == '/')) {
-            slashes_count++;
-            
-            if (slashes_count == slashes) {
-                limit = i + 1;
-                break;
-            }
-        }
-    }
-    
-    if (with_ext == ICE_FS_TRUE) {
-        limit_end = len - 1;
-    } else if (with_ext == ICE_FS_FALSE) {
-        for (i = limit; i < len; i++) {
-            char ch = path[i];
-            
-            if (ch == '.') {
-                dots_count++;
-                
-                if (dots_count == dots) {
-                    limit_end = i - 1;
-                    break;
-                }
-            }
-        }
-    }
-    
-    return ice_fs_str_sub(path, limit, limit_end);
+    return ice_fs_filename_arena(0, path, with_ext);
 }
 
 /* Returns file extension from path on allocation success or NULL on failure */
 ICE_FS_API char* ICE_FS_CALLCONV ice_fs_ext(const char *path) {
-    unsigned long i,
-                  alloc_size,
-                  count = 0, limit = 0, len = ice_fs_str_len(path),
-                  dots_count = 0, dots = ice_fs_str_dots(path);
-    char *res = 0;
+    return ice_fs_ext_arena(0, path);
+}
 
-    if (len == 0) return 0;
+/* Returns ICE_FS_TRUE if extension of the path is ext or ICE_FS_FALSE if not */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_is_ext(const char *path, const char *ext) {
+    ice_fs_path_span span;
+    unsigned long i;
 
-    for (i = 0; i < len; i++) {
-        if (path[i] == '.') {
-            dots_count++;
+    if (path == 0) return ICE_FS_FALSE;
+    if (ice_fs_ext_span(path, &span) == ICE_FS_FALSE) return (ext == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+    if ((ext == 0) || (span.len == 0)) return ICE_FS_FALSE;
 
-            if (dots_count == dots) {
-                limit = i + 1;
-                break;
-            }
-        }
+    for (i = 0; i < span.len; i++) {
+        if (path[span.offset + i] != ext[i]) return ICE_FS_FALSE;
     }
 
-    if (limit == 0) return 0;
-    
-    alloc_size = len - limit;
-    res = ICE_FS_MALLOC((alloc_size + 1) * sizeof(char));
-    if (res == 0) return 0;
-    
-    for (i = limit; i < len; i++) {
-        res[count] = path[i];
-        count++;
-    }
+    return (ext[span.len] == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
 
-    res[count] = 0;
+/* Returns previous parent of a path on allocation success or NULL on failure */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_prev_path(const char *path) {
+    return ice_fs_prev_path_arena(0, path);
+}
 
-    return res;
+/* Returns parents of path in array on allocation success or NULL on failure */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_path_parents(const char *path, unsigned long *results) {
+    return ice_fs_path_parents_arena(0, path, results);
 }
 
-/* Returns ICE_FS_TRUE if extension of the path is ext or ICE_FS_FALSE if not */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_is_ext(const char *path, const char *ext) {
-    ice_fs_bool res = ICE_FS_FALSE;
-    char *path_ext = 0;
-    
-    if (path == 0) return res;
-    
-    path_ext = ice_fs_ext(path);
-    if ((path_ext == 0) && (ext == 0)) return ICE_FS_TRUE;
-    
-    res = ice_fs_str_same(path_ext, ext);
-    ice_fs_free_str(path_ext);
+/* Returns ICE_FS_TRUE if path exists or ICE_FS_FALSE if not */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_path_exists(const char *path) {
+    struct stat info;
+    int stat_res = stat(path, &info);
 
-    return res;
-}
-
-/* Returns previous parent of a path on allocation success or NULL on failure */
-ICE_FS_API char* ICE_FS_CALLCONV ice_fs_prev_path(const char *path) {
-    unsigned long i,
-                  limit = 0, len = ice_fs_str_len(path),
-                  slashes_count = 0, slashes = ice_fs_str_slashes(path);
-    ice_fs_bool ends_with_slash;
-    
-    if ((len == 0) || (slashes == 0)) return 0;
-    
-    ends_with_slash = ice_fs_str_ends_with_slash(path);
-    if (ends_with_slash == ICE_FS_TRUE) slashes_count++;
-
-    for (i = 0; i < len; i++) {
-        char ch = path[i];
-        
-        if ((ch == '\\') || (ch == '/')) {
-            slashes_count++;
-            
-            if (slashes_count == slashes) {
-                limit = i;
-                break;
-            }
-        }
-    }
-
-    return ice_fs_str_sub(path, 0, limit);
-}
-
-/* Returns parents of path in array on allocation success or NULL on failure */
-ICE_FS_API char** ICE_FS_CALLCONV ice_fs_path_parents(const char *path, unsigned long *results) {
-    unsigned long i, slashes_count = ice_fs_str_slashes(path);
-    char **res = 0;
-    ice_fs_bool ends_with_slash = ice_fs_str_ends_with_slash(path);
-
-    if (!(slashes_count > 1)) {
-        if (results != 0) *results = 0;
-        return res;
-    }
-
-    if (ends_with_slash == ICE_FS_TRUE) slashes_count = slashes_count - 1;
-    res = ICE_FS_MALLOC(slashes_count * sizeof(char*));
-    if (res == 0) return 0;
-
-    for (i = 0; i < slashes_count; i++) {
-        res[i] = ice_fs_prev_path(((i == 0) ? path : res[i - 1]));
-    }
-    
-    if (results != 0) *results = slashes_count;
-
-    return res;
-}
-
-/* Returns ICE_FS_TRUE if path exists or ICE_FS_FALSE if not */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_path_exists(const char *path) {
-    struct stat info;
-    int stat_res = stat(path, &info);
-
-    return (stat_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+    return (stat_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
 }
 
 /* Returns path of current working directory on allocation success or NULL on failure */
@@ -1442,29 +2528,7 @@ ICE_FS_API char* ICE_FS_CALLCONV ice_fs_home(void) {
 
 /* Returns formatted path of a path depending on platform on allocation success or NULL on failure */
 ICE_FS_API char* ICE_FS_CALLCONV ice_fs_format_path(const char *path) {
-    unsigned long i, lenstr = ice_fs_str_len(path);
-    char *res = 0;
-    
-    if (lenstr == 0) return 0;
-    
-    res = ICE_FS_MALLOC((lenstr + 1) * sizeof(char));
-    if (res == 0) return 0;
-
-    for (i = 0; i < lenstr; i++) {
-        if ((path[i] == '\\') || (path[i] == '/')) {
-#if defined(ICE_FS_MICROSOFT)
-            res[i] = '\\';
-#else
-            res[i] = '/';
-#endif
-        } else {
-            res[i] = path[i];
-        }
-    }
-
-    res[i] = 0;
-
-    return res;
+    return ice_fs_format_path_arena(0, path);
 }
 
 /* Returns full path of a path on allocation success or NULL on failure */
@@ -1504,6 +2568,395 @@ ICE_FS_API char* ICE_FS_CALLCONV ice_fs_fullpath(const char *path) {
     return res;
 }
 
+/* [INTERNAL] Returned by path writers on failure instead of length of result path */
+#define ICE_FS_PATH_NONE ((unsigned long)-1)
+
+/* [INTERNAL] Chunk of memory owned by ice_fs_path_arena, Data follows the struct */
+typedef struct ice_fs_path_arena_chunk {
+    struct ice_fs_path_arena_chunk *next;
+    unsigned long used;
+    unsigned long capacity;
+} ice_fs_path_arena_chunk;
+
+/* [INTERNAL] Allocates size bytes aligned to align bytes (Power of 2) from arena or with ICE_FS_MALLOC if arena is NULL, Returns pointer on allocation success or NULL on allocation failure */
+static void* ice_fs_path_alloc(ice_fs_path_arena *arena, unsigned long size, unsigned long align) {
+    ice_fs_path_arena_chunk *chunk, *new_chunk;
+    unsigned long pos, capacity;
+
+    if (arena == 0) return ICE_FS_MALLOC(size);
+
+    chunk = arena->current;
+
+    /* Chunks after current one are only left by ice_fs_path_arena_reset and are empty */
+    while (chunk != 0) {
+        pos = (chunk->used + (align - 1)) & ~(align - 1);
+
+        if ((pos <= chunk->capacity) && ((chunk->capacity - pos) >= size)) {
+            chunk->used = pos + size;
+            arena->current = chunk;
+            return ((char*)(chunk + 1)) + pos;
+        }
+
+        if (chunk->next == 0) break;
+        chunk = chunk->next;
+    }
+
+    capacity = ((size > ICE_FS_PATH_ARENA_CHUNK_SIZE) ? size : ICE_FS_PATH_ARENA_CHUNK_SIZE);
+
+    new_chunk = ICE_FS_MALLOC(sizeof(ice_fs_path_arena_chunk) + capacity);
+    if (new_chunk == 0) return 0;
+
+    new_chunk->next = 0;
+    new_chunk->used = size;
+    new_chunk->capacity = capacity;
+
+    if (chunk == 0) {
+        arena->chunks = new_chunk;
+    } else {
+        chunk->next = new_chunk;
+    }
+
+    arena->current = new_chunk;
+
+    return new_chunk + 1;
+}
+
+/* [INTERNAL] Copies len chars of path to dst with slashes replaced by separator of platform */
+static void ice_fs_path_copy(const char *path, unsigned long len, char *dst) {
+    unsigned long i;
+
+    for (i = 0; i < len; i++) {
+        char ch = path[i];
+
+        if ((ch == '\\') || (ch == '/')) {
+#if defined(ICE_FS_MICROSOFT)
+            dst[i] = '\\';
+#else
+            dst[i] = '/';
+#endif
+        } else {
+            dst[i] = ch;
+        }
+    }
+}
+
+/* [INTERNAL] Returns index after last slash in first len chars of path or 0 if there's no slash */
+static unsigned long ice_fs_path_name_start(const char *path, unsigned long len) {
+    while (len > 0) {
+        char ch = path[len - 1];
+        if ((ch == '\\') || (ch == '/')) break;
+        len--;
+    }
+
+    return len;
+}
+
+/* [INTERNAL] Returns index of last dot in chars of path from start to end or end if there's no dot */
+static unsigned long ice_fs_path_last_dot(const char *path, unsigned long start, unsigned long end) {
+    unsigned long i = end;
+
+    while (i > start) {
+        i--;
+        if (path[i] == '.') return i;
+    }
+
+    return end;
+}
+
+/* [INTERNAL] Writes concatenation of 2 paths (Without null character) to dst if dst is not NULL, Returns its length on success or ICE_FS_PATH_NONE on failure */
+static unsigned long ice_fs_concat_path_write(const char *path1, const char *path2, char *dst) {
+    unsigned long len1, len2, sep;
+    ice_fs_bool end1, start2;
+
+    if (path1 == 0) return ICE_FS_PATH_NONE;
+
+    len1 = ice_fs_str_len(path1);
+
+    if (path2 == 0) {
+        if (dst != 0) ice_fs_path_copy(path1, len1, dst);
+        return len1;
+    }
+
+    len2 = ice_fs_str_len(path2);
+    end1 = ice_fs_str_ends_with_slash(path1);
+    start2 = ice_fs_str_starts_with_slash(path2);
+
+    /* Both slashes are replaced by single separator */
+    if ((end1 == ICE_FS_TRUE) && (start2 == ICE_FS_TRUE)) {
+        len1--;
+        len2--;
+        path2++;
+    }
+
+    sep = ((end1 == start2) ? 1 : 0);
+
+    if (dst != 0) {
+        ice_fs_path_copy(path1, len1, dst);
+        if (sep == 1) ice_fs_path_copy("/", 1, dst + len1);
+        ice_fs_path_copy(path2, len2, dst + len1 + sep);
+    }
+
+    return len1 + sep + len2;
+}
+
+/* Stores view of root of path in span (Without allocating, Drive like C: without slash is root too), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if path has no root) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_root_span(const char *path, ice_fs_path_span *span) {
+    unsigned long i, len = ice_fs_str_len(path);
+
+    if ((len == 0) || (span == 0)) return ICE_FS_FALSE;
+
+    for (i = 0; i < len; i++) {
+        if ((path[i] == '\\') || (path[i] == '/')) {
+            span->offset = 0;
+            span->len = i + 1;
+            return ICE_FS_TRUE;
+        }
+    }
+
+    if ((len == 2) && (path[1] == ':')) {
+        span->offset = 0;
+        span->len = 2;
+        return ICE_FS_TRUE;
+    }
+
+    return ICE_FS_FALSE;
+}
+
+/* Stores view of file name with/without extension of path in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_filename_span(const char *path, ice_fs_bool with_ext, ice_fs_path_span *span) {
+    unsigned long start, len = ice_fs_str_len(path);
+
+    if ((len == 0) || (span == 0)) return ICE_FS_FALSE;
+
+    start = ice_fs_path_name_start(path, len);
+
+    span->offset = start;
+    span->len = ((with_ext == ICE_FS_TRUE) ? len : ice_fs_path_last_dot(path, start, len)) - start;
+
+    return ICE_FS_TRUE;
+}
+
+/* Stores view of file extension of path (Without dot) in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file name has no extension) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_ext_span(const char *path, ice_fs_path_span *span) {
+    unsigned long dot, len = ice_fs_str_len(path);
+
+    if ((len == 0) || (span == 0)) return ICE_FS_FALSE;
+
+    dot = ice_fs_path_last_dot(path, ice_fs_path_name_start(path, len), len);
+    if (dot == len) return ICE_FS_FALSE;
+
+    span->offset = dot + 1;
+    span->len = len - (dot + 1);
+
+    return ICE_FS_TRUE;
+}
+
+/* Stores view of previous parent of path (With its trailing slash) in span (Without allocating), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if path has no parent) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_prev_path_span(const char *path, ice_fs_path_span *span) {
+    unsigned long len = ice_fs_str_len(path);
+
+    if ((len == 0) || (span == 0)) return ICE_FS_FALSE;
+    if (ice_fs_str_ends_with_slash(path) == ICE_FS_TRUE) len--;
+
+    len = ice_fs_path_name_start(path, len);
+    if (len == 0) return ICE_FS_FALSE;
+
+    span->offset = 0;
+    span->len = len;
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Copies chars of path in span into null-terminated string allocated from arena or with ICE_FS_MALLOC if arena is NULL, Returns it on allocation success or NULL on allocation failure */
+static char* ice_fs_path_span_str(ice_fs_path_arena *arena, const char *path, ice_fs_path_span span) {
+    unsigned long i;
+    char *res = ice_fs_path_alloc(arena, span.len + 1, 1);
+
+    if (res == 0) return 0;
+
+    for (i = 0; i < span.len; i++) {
+        res[i] = path[span.offset + i];
+    }
+
+    res[span.len] = 0;
+
+    return res;
+}
+
+/* [INTERNAL] Copies chars of path in span into caller-provided buffer buf of buf_size bytes as null-terminated string, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if it doesn't fit */
+static ice_fs_bool ice_fs_path_span_buf(const char *path, ice_fs_path_span span, char *buf, unsigned long buf_size) {
+    unsigned long i;
+
+    if ((buf == 0) || (span.len >= buf_size)) return ICE_FS_FALSE;
+
+    for (i = 0; i < span.len; i++) {
+        buf[i] = path[span.offset + i];
+    }
+
+    buf[span.len] = 0;
+
+    return ICE_FS_TRUE;
+}
+
+/* Frees all paths allocated from arena at once but keeps its memory to allocate next paths from */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_path_arena_reset(ice_fs_path_arena *arena) {
+    ice_fs_path_arena_chunk *chunk;
+
+    if (arena == 0) return;
+
+    for (chunk = arena->chunks; chunk != 0; chunk = chunk->next) {
+        chunk->used = 0;
+    }
+
+    arena->current = arena->chunks;
+}
+
+/* Frees arena and all paths allocated from it */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_path_arena(ice_fs_path_arena *arena) {
+    ice_fs_path_arena_chunk *chunk;
+
+    if (arena == 0) return;
+
+    chunk = arena->chunks;
+
+    while (chunk != 0) {
+        ice_fs_path_arena_chunk *next = chunk->next;
+        ICE_FS_FREE(chunk);
+        chunk = next;
+    }
+
+    arena->chunks = 0;
+    arena->current = 0;
+}
+
+/* Same like ice_fs_concat_path but allocates result path from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_concat_path_arena(ice_fs_path_arena *arena, const char *path1, const char *path2) {
+    unsigned long len = ice_fs_concat_path_write(path1, path2, 0);
+    char *res;
+
+    if (len == ICE_FS_PATH_NONE) return 0;
+
+    res = ice_fs_path_alloc(arena, len + 1, 1);
+    if (res == 0) return 0;
+
+    ice_fs_concat_path_write(path1, path2, res);
+    res[len] = 0;
+
+    return res;
+}
+
+/* Same like ice_fs_filename but allocates file name from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_filename_arena(ice_fs_path_arena *arena, const char *path, ice_fs_bool with_ext) {
+    ice_fs_path_span span;
+
+    if (ice_fs_filename_span(path, with_ext, &span) == ICE_FS_FALSE) return 0;
+    return ice_fs_path_span_str(arena, path, span);
+}
+
+/* Same like ice_fs_ext but allocates file extension from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_ext_arena(ice_fs_path_arena *arena, const char *path) {
+    ice_fs_path_span span;
+
+    if (ice_fs_ext_span(path, &span) == ICE_FS_FALSE) return 0;
+    return ice_fs_path_span_str(arena, path, span);
+}
+
+/* Same like ice_fs_prev_path but allocates previous parent from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_prev_path_arena(ice_fs_path_arena *arena, const char *path) {
+    ice_fs_path_span span;
+
+    if (ice_fs_prev_path_span(path, &span) == ICE_FS_FALSE) return 0;
+    return ice_fs_path_span_str(arena, path, span);
+}
+
+/* Same like ice_fs_path_parents but allocates array and parents from arena (Freed with arena instead of ice_fs_free_strarr) */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_path_parents_arena(ice_fs_path_arena *arena, const char *path, unsigned long *results) {
+    unsigned long i, slashes_count = ice_fs_str_slashes(path);
+    char **res = 0;
+
+    if (!(slashes_count > 1)) {
+        if (results != 0) *results = 0;
+        return res;
+    }
+
+    if (ice_fs_str_ends_with_slash(path) == ICE_FS_TRUE) slashes_count = slashes_count - 1;
+
+    res = ice_fs_path_alloc(arena, slashes_count * sizeof(char*), sizeof(char*));
+    if (res == 0) return 0;
+
+    for (i = 0; i < slashes_count; i++) {
+        res[i] = ice_fs_prev_path_arena(arena, ((i == 0) ? path : res[i - 1]));
+    }
+
+    if (results != 0) *results = slashes_count;
+
+    return res;
+}
+
+/* Same like ice_fs_format_path but allocates formatted path from arena (Freed with arena instead of ice_fs_free_str) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_format_path_arena(ice_fs_path_arena *arena, const char *path) {
+    unsigned long len = ice_fs_str_len(path);
+    char *res;
+
+    if (len == 0) return 0;
+
+    res = ice_fs_path_alloc(arena, len + 1, 1);
+    if (res == 0) return 0;
+
+    ice_fs_path_copy(path, len, res);
+    res[len] = 0;
+
+    return res;
+}
+
+/* Same like ice_fs_concat_path but writes result path into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if result path doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_concat_path_buf(const char *path1, const char *path2, char *buf, unsigned long buf_size) {
+    unsigned long len = ice_fs_concat_path_write(path1, path2, 0);
+
+    if ((buf == 0) || (len == ICE_FS_PATH_NONE) || (len >= buf_size)) return ICE_FS_FALSE;
+
+    ice_fs_concat_path_write(path1, path2, buf);
+    buf[len] = 0;
+
+    return ICE_FS_TRUE;
+}
+
+/* Same like ice_fs_filename but writes file name into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file name doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_filename_buf(const char *path, ice_fs_bool with_ext, char *buf, unsigned long buf_size) {
+    ice_fs_path_span span;
+
+    if (ice_fs_filename_span(path, with_ext, &span) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    return ice_fs_path_span_buf(path, span, buf, buf_size);
+}
+
+/* Same like ice_fs_ext but writes file extension into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file extension doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_ext_buf(const char *path, char *buf, unsigned long buf_size) {
+    ice_fs_path_span span;
+
+    if (ice_fs_ext_span(path, &span) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    return ice_fs_path_span_buf(path, span, buf, buf_size);
+}
+
+/* Same like ice_fs_prev_path but writes previous parent into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if previous parent doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_prev_path_buf(const char *path, char *buf, unsigned long buf_size) {
+    ice_fs_path_span span;
+
+    if (ice_fs_prev_path_span(path, &span) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    return ice_fs_path_span_buf(path, span, buf, buf_size);
+}
+
+/* Same like ice_fs_format_path but writes formatted path into caller-provided buffer buf of buf_size bytes instead of allocating it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if formatted path doesn't fit in buf) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_format_path_buf(const char *path, char *buf, unsigned long buf_size) {
+    unsigned long len = ice_fs_str_len(path);
+
+    if ((len == 0) || (buf == 0) || (len >= buf_size)) return ICE_FS_FALSE;
+
+    ice_fs_path_copy(path, len, buf);
+    buf[len] = 0;
+
+    return ICE_FS_TRUE;
+}
+
 /* Creates symbolic/hard link for object in path1 at path2, Retruns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
 ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_link(const char *path1, const char *path2, ice_fs_bool hard_link) {
     int link_res = 0;
@@ -1614,54 +3067,182 @@ failure:
 #endif
 }
 
-/* Returns type of object in specific path, Returns ICE_FS_OBJECT_TYPE_NONE on failure if path does not exist or returns any of values does ice_fs_object_type enumeration has */
-ICE_FS_API ice_fs_object_type ICE_FS_CALLCONV ice_fs_type(const char *path) {
-    struct stat info;
+#if defined(ICE_FS_MICROSOFT)
+/* [INTERNAL] Returns path that Windows functions accept for path relative to directory of dir handle (path itself if dir is NULL or path is absolute, Otherwise allocated path that ice_fs_at_path_free frees) or NULL on failure */
+static const char* ice_fs_at_path(const ice_fs_dir_handle *dir, const char *path) {
+    unsigned long dir_len, path_len, i;
+    char *res;
+
+    if ((dir == 0) || (path == 0)) return path;
+    if ((path[0] == '\\') || (path[0] == '/') || ((path[0] != 0) && (path[1] == ':'))) return path;
+    if (dir->path == 0) return 0;
+
+    dir_len = ice_fs_str_len(dir->path);
+    path_len = ice_fs_str_len(path);
+
+    res = ICE_FS_MALLOC((dir_len + path_len + 2) * sizeof(char));
+    if (res == 0) return 0;
+
+    for (i = 0; i < dir_len; i++) res[i] = dir->path[i];
+    if ((dir_len > 0) && (res[dir_len - 1] != '\\') && (res[dir_len - 1] != '/')) res[dir_len++] = '\\';
+    for (i = 0; i <= path_len; i++) res[dir_len + i] = path[i];
+
+    return res;
+}
+
+/* [INTERNAL] Frees at_path returned by ice_fs_at_path for path (If it was allocated) */
+static void ice_fs_at_path_free(const char *path, const char *at_path) {
+    if ((at_path != 0) && (at_path != path)) ICE_FS_FREE((void*) at_path);
+}
+#elif defined(ICE_FS_UNIX)
+/* [INTERNAL] Returns file descriptor that *at system calls resolve paths relative to directory of dir handle from (AT_FDCWD if dir is NULL) */
+static int ice_fs_at_fd(const ice_fs_dir_handle *dir) {
+    return (dir != 0) ? dir->fd : AT_FDCWD;
+}
+#endif
+
+/* Returns type of object in specific path, Returns ICE_FS_OBJECT_TYPE_NONE on failure if path does not exist or returns any of values does ice_fs_object_type enumeration has */
+ICE_FS_API ice_fs_object_type ICE_FS_CALLCONV ice_fs_type(const char *path) {
+    return ice_fs_type_at(0, path);
+}
+
+/* Same like ice_fs_type but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_object_type ICE_FS_CALLCONV ice_fs_type_at(const ice_fs_dir_handle *dir, const char *path) {
+    struct stat info;
     int res;
+#if defined(ICE_FS_MICROSOFT)
+    const char *at_path;
+#endif
 
     if (path == 0) return ICE_FS_OBJECT_TYPE_NONE;
-    
-    res = stat(path, &info);
+
+#if defined(ICE_FS_MICROSOFT)
+    at_path = ice_fs_at_path(dir, path);
+    if (at_path == 0) return ICE_FS_OBJECT_TYPE_NONE;
+
+    res = stat(at_path, &info);
+    ice_fs_at_path_free(path, at_path);
+#elif defined(ICE_FS_UNIX)
+    res = fstatat(ice_fs_at_fd(dir), path, &info, 0);
+#endif
     if (res == -1) return ICE_FS_OBJECT_TYPE_NONE;
 
     return ((int)((info.st_mode & S_IFMT) == S_IFDIR)) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE;
 }
 
+/* [INTERNAL] Reads up to len bytes from fd into dst retrying on interrupts, Returns number of bytes read (0 on EOF) or -1 on failure */
+static long ice_fs_read_fd(int fd, void *dst, unsigned long len) {
+    if (len > 0x40000000) len = 0x40000000;
+
+    for (;;) {
+#if defined(ICE_FS_MICROSOFT)
+        int res = read(fd, dst, (unsigned int) len);
+#elif defined(ICE_FS_UNIX)
+        ssize_t res = read(fd, dst, (size_t) len);
+#endif
+
+        if ((res == -1) && (errno == EINTR)) continue;
+        return (long) res;
+    }
+}
+
+/* [INTERNAL] Writes all len bytes from src to fd retrying on short writes and interrupts, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_write_fd(int fd, const void *src, unsigned long len) {
+    const char *bytes = (const char*) src;
+
+    while (len > 0) {
+        unsigned long chunk = ((len > 0x40000000) ? 0x40000000 : len);
+#if defined(ICE_FS_MICROSOFT)
+        int res = write(fd, bytes, (unsigned int) chunk);
+#elif defined(ICE_FS_UNIX)
+        ssize_t res = write(fd, bytes, (size_t) chunk);
+#endif
+
+        if (res == -1) {
+            if (errno == EINTR) continue;
+            return ICE_FS_FALSE;
+        }
+
+        bytes += res;
+        len -= (unsigned long) res;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Moves file offset of fd, Returns new offset or -1 on failure */
+static ice_fs_offset ice_fs_seek_fd(int fd, ice_fs_offset offset, int whence) {
+#if defined(ICE_FS_MICROSOFT)
+    return (ice_fs_offset) _lseeki64(fd, (__int64) offset, whence);
+#elif defined(ICE_FS_UNIX)
+    return (ice_fs_offset) lseek(fd, (off_t) offset, whence);
+#endif
+}
+
 /* Reads content of file and returns the content on allocation success or NULL on failure, file_size is pointer to unsigned long integer that will store number of chars (bytes) the file has */
 ICE_FS_API char* ICE_FS_CALLCONV ice_fs_file_content(const char *path, unsigned long *file_size) {
+    return ice_fs_file_content_at(0, path, file_size);
+}
+
+/* Same like ice_fs_file_content but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_file_content_at(const ice_fs_dir_handle *dir, const char *path, unsigned long *file_size) {
     struct stat info;
     ice_fs_bool alloc_done = ICE_FS_FALSE;
     int fd = -1, posixcall_res;
-    off_t len;
+    off_t len, total = 0;
 #if defined(ICE_FS_MICROSOFT)
     __int64 read_size;
 #elif defined(ICE_FS_UNIX)
     ssize_t read_size;
 #endif
     char *res = 0;
+#if defined(ICE_FS_MICROSOFT)
+    const char *at_path;
+#endif
 
     if (path == 0) return 0;
-    
-    posixcall_res = stat(path, &info);
-    if (posixcall_res == -1) return 0;
 
-    fd = ice_fs_open(path, O_RDONLY);
+#if defined(ICE_FS_MICROSOFT)
+    at_path = ice_fs_at_path(dir, path);
+    if (at_path == 0) return 0;
+
+    fd = ice_fs_open(at_path, O_RDONLY);
+    ice_fs_at_path_free(path, at_path);
+#elif defined(ICE_FS_UNIX)
+    fd = openat(ice_fs_at_fd(dir), path, O_RDONLY);
+#endif
     if (fd == -1) return 0;
-    
+
+    /* Size is taken from the opened file, So path is looked up once */
+    posixcall_res = fstat(fd, &info);
+    if (posixcall_res == -1) goto failure;
+
     len = info.st_size;
 
     res = ICE_FS_MALLOC((len + 1) * sizeof(char));
     if (res == 0) goto failure;
     alloc_done = ICE_FS_TRUE;
 
-    read_size = read(fd, res, len);
-    if (read_size == -1) goto failure;
-    res[read_size] = 0;
+    /* read may return less than asked (Like on pipes or when interrupted by signal), So keep reading till EOF or len */
+    while (total < len) {
+        read_size = read(fd, res + total, len - total);
+
+        if (read_size == 0) break;
+
+        if (read_size == -1) {
+            if (errno == EINTR) continue;
+            goto failure;
+        }
+
+        total += read_size;
+    }
+
+    res[total] = 0;
     
     posixcall_res = close(fd);
     if (posixcall_res == -1) goto failure;
 
-    if (file_size != 0) *file_size = len;
+    if (file_size != 0) *file_size = total;
     
     return res;
 
@@ -1673,592 +3254,8863 @@ failure:
     return 0;
 }
 
-/* Creates file in path with content if doesn't exist or Appends to/Overwrites content of file in specific path if exists, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_write(const char *path, const char *content, ice_fs_bool append) {
-    ice_fs_bool file_created;
-    unsigned long len = ice_fs_str_len(content);
-    int fd = 0, write_res, close_res;
+/* [INTERNAL] Writes all bytes of bufs_count buffers in bufs to fd (Via writev where available) retrying on short writes and interrupts, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_writev_fd(int fd, const ice_fs_buf *bufs, unsigned long bufs_count) {
+#if defined(ICE_FS_UNIX)
+    struct iovec iov[64];
+    unsigned long i = 0, written = 0;
 
-    if ((path == 0) || (content == 0)) return ICE_FS_FALSE;
+    for (;;) {
+        unsigned long j, iov_count = 0;
+        ssize_t res;
 
-    file_created = ice_fs_create(path, ICE_FS_OBJECT_TYPE_FILE);
-    if (file_created == ICE_FS_FALSE) return ICE_FS_FALSE;
+        /* Skip buffers that were fully written (Or empty) */
+        while ((i < bufs_count) && (written == bufs[i].len)) {
+            i++;
+            written = 0;
+        }
 
-    if (append == ICE_FS_TRUE) {
-        fd = ice_fs_open(path, O_APPEND | O_WRONLY);
-    } else if (append == ICE_FS_FALSE) {
-        fd = ice_fs_open(path, O_TRUNC | O_APPEND | O_WRONLY);
-    }
-    
-    if (fd == -1) return ICE_FS_FALSE;
+        if (i == bufs_count) return ICE_FS_TRUE;
 
-    write_res = write(fd, content, len);
-    if (write_res == -1) return ICE_FS_FALSE;
+        for (j = i; (j < bufs_count) && (iov_count < (sizeof(iov) / sizeof(iov[0]))); j++) {
+            unsigned long offset = ((j == i) ? written : 0);
 
-    close_res = close(fd);
+            if (bufs[j].len == offset) continue;
 
-    return (close_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
-}
+            iov[iov_count].iov_base = (void*)(((const char*) bufs[j].data) + offset);
+            iov[iov_count].iov_len = (size_t) (bufs[j].len - offset);
+            iov_count++;
+        }
 
-/* Reads content of file, Returns the content in array of strings for each line on allocation success or NULL on failure, lines should be pointer to unsigned long integer to store count of lines the file has */
-ICE_FS_API char** ICE_FS_CALLCONV ice_fs_file_lines(const char *path, unsigned long *lines) {
-    unsigned long lines_count;
-    char **res = 0, *file_content = 0;
+        res = writev(fd, iov, (int) iov_count);
 
-    if (path == 0) return 0;
-    
-    file_content = ice_fs_file_content(path, 0);
-    if (file_content == 0) {
-        if (lines != 0) *lines = 0;
-        return 0;
-    }
-    
-    res = ice_fs_str_splitlines(file_content, &lines_count);
-    ice_fs_free_str(file_content);
-    
-    if (lines != 0) *lines = lines_count;
+        if (res == -1) {
+            if (errno == EINTR) continue;
+            return ICE_FS_FALSE;
+        }
 
-    return res;
-}
+        /* Advance through written buffers, Last one may be written partially */
+        while ((res > 0) && (i < bufs_count)) {
+            unsigned long left = (bufs[i].len - written);
+
+            if (((unsigned long) res) >= left) {
+                res -= (ssize_t) left;
+                i++;
+                written = 0;
+            } else {
+                written += (unsigned long) res;
+                res = 0;
+            }
+        }
+    }
+#else
+    unsigned long i;
 
-/* Changes current directory in the running program to another directory in path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_chdir(const char *path) {
-    int res;
-    
-    if (path == 0) return ICE_FS_FALSE;
+    for (i = 0; i < bufs_count; i++) {
+        if (ice_fs_write_fd(fd, bufs[i].data, bufs[i].len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    }
 
-    res = chdir(path);
-    return (res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+    return ICE_FS_TRUE;
+#endif
 }
 
-/* Returns directory informations with list of contents in path on success or NULL on failure */
-ICE_FS_API ice_fs_dir ICE_FS_CALLCONV ice_fs_dir_content(const char *path) {
-    ice_fs_dir res;
-    unsigned lookup_state = 0;
-    unsigned long items_count = 0;
-    int close_res;
+/* [INTERNAL] Writes decimal digits of n to dst, Returns number of written chars */
+static unsigned long ice_fs_str_put_ulong(char *dst, unsigned long n) {
+    char digits[24];
+    unsigned long i, len = 0;
 
-#if defined(ICE_FS_MICROSOFT)
-    char *search_path = 0;
-    ice_fs_bool ends_with_slash = ice_fs_str_ends_with_slash(path);
-    WIN32_FIND_DATAA find_data;
-    HANDLE find_handle = INVALID_HANDLE_VALUE;
-    
-    unsigned long i, len_add, len_search = ice_fs_str_len(path);
-    ice_fs_bool alloc = ICE_FS_FALSE;
-    
-    if (path == 0) goto failure;
+    do {
+        digits[len++] = (char) ('0' + (n % 10));
+        n /= 10;
+    } while (n > 0);
 
-    len_add = ((ends_with_slash == ICE_FS_FALSE) ? 3 : 2);
-    
-    search_path = ICE_FS_MALLOC((len_search + len_add) * sizeof(char));
-    if (search_path == 0) goto failure;
-    alloc = ICE_FS_TRUE;
-    
-    for (i = 0; i < len_search; i++) search_path[i] = path[i];
-    
-    search_path[i] = ((len_add == 3) ? '\\' : '*');
-    search_path[i + 1] = ((len_add == 3) ? '*' : 0);
-    if (len_add == 3) search_path[i + 2] = 0;
-    
-    goto find;
+    for (i = 0; i < len; i++) dst[i] = digits[len - 1 - i];
 
-find:
-    find_handle = FindFirstFileA(search_path, &find_data);
-    if (find_handle == INVALID_HANDLE_VALUE) goto failure;
-    
-    while (FindNextFileA(find_handle, &find_data) != 0) {
-        ice_fs_bool cd = ice_fs_str_same(find_data.cFileName, ".");
-        ice_fs_bool pd = ice_fs_str_same(find_data.cFileName, "..");
-        
-        if ((cd == ICE_FS_FALSE) && (pd == ICE_FS_FALSE)) {
-            items_count++;
-        
-            if (lookup_state == 1) {
-                unsigned long idx;
-                idx = items_count - 1;
-            
-                res.items[idx].name = ice_fs_str_copy(find_data.cFileName);
-            
-                if ((find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY) {
-                    res.items[idx].type = ICE_FS_OBJECT_TYPE_DIR;
-                } else {
-                    res.items[idx].type = ICE_FS_OBJECT_TYPE_FILE;
-                }
-            }
-        }
-    }
-    
-    close_res = FindClose(find_handle);
-    if (close_res == 0) goto failure;
+    return len;
+}
 
-    goto checkout;
+/* [INTERNAL] Counter that makes names of temporary files unique within the process */
+#if defined(ICE_FS_MICROSOFT)
+static volatile LONG ice_fs_temp_counter = 0;
+#elif defined(ICE_FS_UNIX)
+static unsigned long ice_fs_temp_counter = 0;
+static pthread_mutex_t ice_fs_temp_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
+/* [INTERNAL] Returns next value of ice_fs_temp_counter, Safe to call from multiple threads at once (Mutex is statically initialized so it's usable before any library function runs) */
+static unsigned long ice_fs_temp_next(void) {
+#if defined(ICE_FS_MICROSOFT)
+    return (unsigned long) InterlockedIncrement(&ice_fs_temp_counter);
 #elif defined(ICE_FS_UNIX)
-    DIR *d;
-    struct dirent *dir;
-    
-    if (path == 0) goto failure;
+    unsigned long res;
 
-find:
-    d = opendir(path);
-    
-    if (d != 0) {
-        while ((dir = readdir(d)) != 0) {
-            ice_fs_bool cd = ice_fs_str_same(dir->d_name, ".");
-            ice_fs_bool pd = ice_fs_str_same(dir->d_name, "..");
-            
-            if ((cd == ICE_FS_FALSE) && (pd == ICE_FS_FALSE)) {
-                items_count++;
-                
-                if (lookup_state == 1) {
-                    unsigned long idx = items_count - 1;
-                    char *path = 0;
-                    
-                    path = realpath(dir->d_name, 0);
-                    if (path == 0) goto failure;
-                    
-                    res.items[idx].name = ice_fs_str_copy(dir->d_name);
-                    res.items[idx].type = ice_fs_type(path);
-                    
-                    ice_fs_free_str(path);
-                }
-            }
-        }
+    (void) pthread_mutex_lock(&ice_fs_temp_mutex);
+    res = ice_fs_temp_counter++;
+    (void) pthread_mutex_unlock(&ice_fs_temp_mutex);
 
-        close_res = closedir(d);
-        if (close_res == -1) goto failure;
-    } else {
-        goto failure;
-    }
+    return res;
+#endif
+}
+
+/* [INTERNAL] Replaces file in path (Relative to directory of dir handle on Unix, Already resolved on Windows) atomically, Writes buffers to temporary file next to it then flushes the temporary file to disk and renames it over the file, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Leaving the file untouched) */
+static ice_fs_bool ice_fs_file_write_atomic(const ice_fs_dir_handle *dir, const char *path, const ice_fs_buf *bufs, unsigned long bufs_count) {
+    unsigned long path_len = ice_fs_str_len(path), i, attempt;
+    ice_fs_bool res = ICE_FS_FALSE;
+    char *temp_path;
+    int fd = -1;
+#if defined(ICE_FS_UNIX)
+    struct stat info;
+    unsigned long pid = (unsigned long) getpid();
+    int dfd = ice_fs_at_fd(dir);
+#elif defined(ICE_FS_MICROSOFT)
+    unsigned long pid = (unsigned long) GetCurrentProcessId();
 
-    goto checkout;
+    (void) dir;
 #endif
 
-checkout:
-    if (lookup_state == 0) {
-        res.items = ICE_FS_MALLOC(items_count * sizeof(ice_fs_object));
-        if (res.items == 0) goto failure;
-    }
+    /* path + ".tmp." + pid + "." + counter */
+    temp_path = ICE_FS_MALLOC((path_len + 64) * sizeof(char));
+    if (temp_path == 0) return ICE_FS_FALSE;
+
+    for (i = 0; i < path_len; i++) temp_path[i] = path[i];
 
-    lookup_state++;
+    /* Exclusive create, So names taken by other threads or processes are skipped */
+    for (attempt = 0; (fd == -1) && (attempt < 100); attempt++) {
+        unsigned long len = path_len;
+
+        temp_path[len++] = '.';
+        temp_path[len++] = 't';
+        temp_path[len++] = 'm';
+        temp_path[len++] = 'p';
+        temp_path[len++] = '.';
+        len += ice_fs_str_put_ulong(temp_path + len, pid);
+        temp_path[len++] = '.';
+        len += ice_fs_str_put_ulong(temp_path + len, ice_fs_temp_next());
+        temp_path[len] = 0;
 
-    if (lookup_state == 2) {
-        res.items_count = items_count;
 #if defined(ICE_FS_MICROSOFT)
-        if (alloc == ICE_FS_TRUE) ice_fs_free_str(search_path);
+        fd = open(temp_path, O_WRONLY | O_CREAT | O_EXCL | O_BINARY, S_IREAD | S_IWRITE);
+#elif defined(ICE_FS_UNIX)
+        fd = openat(dfd, temp_path, O_WRONLY | O_CREAT | O_EXCL, 0666);
 #endif
-        return res;
+
+        if ((fd == -1) && (errno != EEXIST)) break;
     }
 
-    items_count = 0;
-    goto find;
+    if (fd == -1) goto end;
 
-failure:
-    res.items = 0;
-    res.items_count = 0;
-    
-    return res;
-}
+#if defined(ICE_FS_UNIX)
+    /* Replaced file keeps its permissions */
+    if ((fstatat(dfd, path, &info, 0) == 0) && (fchmod(fd, info.st_mode & 07777) == -1)) goto failure;
+#endif
 
-/* Frees/Deallocates a directory information struct, dir should be pointer to the directory information struct that will be freed */
-ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_dir_content(ice_fs_dir *dir) {
-    unsigned long i;
+    if (ice_fs_writev_fd(fd, bufs, bufs_count) == ICE_FS_FALSE) goto failure;
 
-    if (dir == 0) return;
+#if defined(ICE_FS_MICROSOFT)
+    if (_commit(fd) == -1) goto failure;
+#elif defined(ICE_FS_UNIX)
+    if (fsync(fd) == -1) goto failure;
+#endif
 
-    for (i = 0; i < dir->items_count; i++) {
-        ice_fs_free_str((char*)(dir->items[i].name));
+    if (close(fd) == -1) {
+        fd = -1;
+        goto failure;
     }
 
-    ICE_FS_FREE(dir->items);
-    dir->items = 0;
-    dir->items_count = 0;
-}
+    fd = -1;
 
-/* Searches in contents of directory for a specific file/directory by string, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
-ICE_FS_API char** ICE_FS_CALLCONV ice_fs_dir_search(const char *path, const char *str, unsigned long *results) {
-    char **res = 0;
-    unsigned long i, items_count = 0, lookup_state = 0, count = 0;
-    ice_fs_dir d;
+#if defined(ICE_FS_MICROSOFT)
+    if (MoveFileExA(temp_path, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0) goto failure;
+#elif defined(ICE_FS_UNIX)
+    if (renameat(dfd, temp_path, dfd, path) == -1) goto failure;
 
-    if (path == 0) return 0;
+    /* Flush the directory too so the rename itself survives crash (Best effort) */
+    {
+        unsigned long slash = path_len;
 
-    d = ice_fs_dir_content(path);
-    if (d.items_count == 0) goto end;
-    
-    goto lookup;
+        while ((slash > 0) && (path[slash - 1] != '/')) slash--;
 
-lookup:
-    for (i = 0; i < d.items_count; i++) {
-        ice_fs_object_type t = d.items[i].type;
-        char *fullpath = ice_fs_str_copy(d.items[i].name);
-        unsigned long matches = ice_fs_str_matches(fullpath, str, 0);
-        
-        if (matches > 0) {
-            items_count++;
-            
-            if (lookup_state == 1) {
-                res[count] = ice_fs_concat_path(path, d.items[i].name);
-                count++;
-            }
+        if (slash == 0) {
+            temp_path[0] = '.';
+            temp_path[1] = 0;
+        } else {
+            for (i = 0; i < slash; i++) temp_path[i] = path[i];
+            temp_path[(slash > 1) ? (slash - 1) : 1] = 0;
         }
-        
-        if (t == ICE_FS_OBJECT_TYPE_DIR) {
-            unsigned long found = 0;
-            char **add = ice_fs_dir_search(fullpath, str, &found);
-            items_count += found;
-            
-            if (lookup_state == 1) {
-                unsigned long j;
-                
-                for (j = 0; j < found; j++) {
-                    res[count] = ice_fs_str_copy(add[j]);
-                    count++;
-                }
-            }
-            
-            ice_fs_free_strarr(add, found);
+
+        fd = openat(dfd, temp_path, O_RDONLY);
+
+        if (fd != -1) {
+            (void) fsync(fd);
+            (void) close(fd);
         }
-        
-        ice_fs_free_str(fullpath);
-    }
-    
-    lookup_state++;
-    
-    if (lookup_state == 1) {
-        res = ICE_FS_MALLOC(items_count * sizeof(char*));
-        if (res == 0) goto end;
-    }
-    
-    if (lookup_state == 2) {
-        if (d.items_count > 0) ice_fs_free_dir_content(&d);
-        if (results != 0) *results = items_count;
-        
-        return res;
     }
-    
-    items_count = 0;
-    
-    goto lookup;
+#endif
+
+    res = ICE_FS_TRUE;
+    goto end;
+
+failure:
+    if (fd != -1) (void) close(fd);
+#if defined(ICE_FS_MICROSOFT)
+    (void) unlink(temp_path);
+#elif defined(ICE_FS_UNIX)
+    (void) unlinkat(dfd, temp_path, 0);
+#endif
 
 end:
-    if (d.items_count > 0) ice_fs_free_dir_content(&d);
-    if (results != 0) *results = 0;
-    return 0;
+    ICE_FS_FREE(temp_path);
+
+    return res;
 }
 
-/* Creates file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_create(const char *path, ice_fs_object_type type) {
-    ice_fs_bool res = ICE_FS_FALSE, exists;
+/* [INTERNAL] Same like ice_fs_file_writev but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+static ice_fs_bool ice_fs_file_writev_at(const ice_fs_dir_handle *dir, const char *path, const ice_fs_buf *bufs, unsigned long bufs_count, ice_fs_write_mode mode) {
+    ice_fs_bool res;
+    unsigned long i;
+    int fd, flags;
+#if defined(ICE_FS_MICROSOFT)
+    const char *at_path;
+#endif
 
-    if ((path == 0) || (type == ICE_FS_OBJECT_TYPE_NONE)) return ICE_FS_FALSE;
+    if ((path == 0) || ((bufs == 0) && (bufs_count > 0))) return ICE_FS_FALSE;
 
-    exists = ice_fs_path_exists(path);
-    if (exists == ICE_FS_TRUE) goto done;
-    
-    if (type == ICE_FS_OBJECT_TYPE_FILE) {
-        int fd, close_res;
-        
-        fd = ice_fs_open(path, O_CREAT);
-        res = (fd == -1) ? ICE_FS_FALSE : ICE_FS_TRUE;
-        
-        close_res = close(fd);
-        res = (close_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
-    
-    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
-        int call_res = ice_fs_mkdir(path);
-        res = ((call_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE);
+    for (i = 0; i < bufs_count; i++) {
+        if ((bufs[i].data == 0) && (bufs[i].len > 0)) return ICE_FS_FALSE;
+    }
+
+    if (mode == ICE_FS_WRITE_MODE_OVERWRITE) flags = (O_WRONLY | O_CREAT | O_TRUNC);
+    else if (mode == ICE_FS_WRITE_MODE_APPEND) flags = (O_WRONLY | O_CREAT | O_APPEND);
+    else if (mode != ICE_FS_WRITE_MODE_ATOMIC) return ICE_FS_FALSE;
 
-        call_res = chmod(path, 0777);
-        res = ((call_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE);
+#if defined(ICE_FS_MICROSOFT)
+    at_path = ice_fs_at_path(dir, path);
+    if (at_path == 0) return ICE_FS_FALSE;
 
+    if (mode == ICE_FS_WRITE_MODE_ATOMIC) {
+        res = ice_fs_file_write_atomic(0, at_path, bufs, bufs_count);
+        ice_fs_at_path_free(path, at_path);
+        return res;
     }
-    
-    return res;
 
-done:
-    res = ICE_FS_TRUE;
-    return res;
-}
+    fd = open(at_path, flags | O_BINARY, S_IREAD | S_IWRITE);
+    ice_fs_at_path_free(path, at_path);
+#elif defined(ICE_FS_UNIX)
+    if (mode == ICE_FS_WRITE_MODE_ATOMIC) return ice_fs_file_write_atomic(dir, path, bufs, bufs_count);
 
-/* Removes file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_remove(const char *path) {
-    int res = -1;
-    ice_fs_object_type type;
+    fd = openat(ice_fs_at_fd(dir), path, flags, 0666);
+#endif
 
-    if (path == 0) return ICE_FS_FALSE;
+    if (fd == -1) return ICE_FS_FALSE;
 
-    type = ice_fs_type(path);
+    res = ice_fs_writev_fd(fd, bufs, bufs_count);
+    if (close(fd) == -1) res = ICE_FS_FALSE;
 
-    if (type == ICE_FS_OBJECT_TYPE_FILE) {
-        res = unlink(path);
-    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
-        res = rmdir(path);
-    }
+    return res;
+}
 
-    return (res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+/* Writes bufs_count buffers in bufs one after another to file in path (Without concatenating them first) in mode, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_writev(const char *path, const ice_fs_buf *bufs, unsigned long bufs_count, ice_fs_write_mode mode) {
+    return ice_fs_file_writev_at(0, path, bufs, bufs_count, mode);
 }
 
-/* Clears content of file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_clear(const char *path) {
-    ice_fs_object_type type;
-    ice_fs_bool res = ICE_FS_FALSE;
+/* Writes len bytes of data (Which may contain NUL bytes) to file in path in mode, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_write_buf(const char *path, const void *data, unsigned long len, ice_fs_write_mode mode) {
+    ice_fs_buf buf;
 
-    if (path == 0) return 0;
+    buf.data = data;
+    buf.len = len;
 
-    type = ice_fs_type(path);
+    return ice_fs_file_writev(path, &buf, 1, mode);
+}
 
-    if (type == ICE_FS_OBJECT_TYPE_FILE) {
-        res = ice_fs_path_exists(path);
-        if (res == ICE_FS_FALSE) return ICE_FS_FALSE;
-        
-        res = ice_fs_file_write(path, 0, ICE_FS_FALSE);
+/* Same like ice_fs_file_write_buf but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_write_at(const ice_fs_dir_handle *dir, const char *path, const void *data, unsigned long len, ice_fs_write_mode mode) {
+    ice_fs_buf buf;
 
-    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
-        unsigned long i;
-        ice_fs_dir d = ice_fs_dir_content(path);
-        
-        if (d.items_count == 0) return res;
-        
-        for (i = 0; i < d.items_count; i++) {
-            ice_fs_object_type t = d.items[i].type;
-            char *fullpath = ice_fs_concat_path(path, d.items[i].name);
-            
-            if (t == ICE_FS_OBJECT_TYPE_FILE) {
-                res = ice_fs_remove(fullpath);
-            } else if (t == ICE_FS_OBJECT_TYPE_DIR) {
-                res = ice_fs_clear(fullpath);
-            }
-            
-            ice_fs_free_str(fullpath);
-            if (res == ICE_FS_FALSE) break;
-        }
-        
-        ice_fs_free_dir_content(&d);
+    buf.data = data;
+    buf.len = len;
+
+    return ice_fs_file_writev_at(dir, path, &buf, 1, mode);
+}
+
+/* Creates file in path with content if doesn't exist or Appends to/Overwrites content of file in specific path if exists, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_write(const char *path, const char *content, ice_fs_bool append) {
+    if ((path == 0) || (content == 0)) return ICE_FS_FALSE;
+    return ice_fs_file_write_buf(path, content, ice_fs_str_len(content), (append == ICE_FS_TRUE) ? ICE_FS_WRITE_MODE_APPEND : ICE_FS_WRITE_MODE_OVERWRITE);
+}
+
+/* Reads content of file, Returns the content in array of strings for each line on allocation success or NULL on failure, lines should be pointer to unsigned long integer to store count of lines the file has */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_file_lines(const char *path, unsigned long *lines) {
+    unsigned long lines_count;
+    char **res = 0, *file_content = 0;
+
+    if (path == 0) return 0;
+    
+    file_content = ice_fs_file_content(path, 0);
+    if (file_content == 0) {
+        if (lines != 0) *lines = 0;
+        return 0;
     }
+    
+    res = ice_fs_str_splitlines(file_content, &lines_count);
+    ice_fs_free_str(file_content);
+    
+    if (lines != 0) *lines = lines_count;
 
     return res;
 }
 
-/* Copies file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_copy(const char *path1, const char *path2) {
-    ice_fs_object_type t1, t2;
-    
-    if ((path1 == 0) || (path2 == 0)) return ICE_FS_FALSE;
+/* Maps file in path into memory as read-only view and stores it in view struct by pointing to, Pages are read lazily on first access unless populate is ICE_FS_TRUE (Which reads all of them before returning), hint tells the system how the pages will be accessed, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_map(const char *path, ice_fs_map_hint hint, ice_fs_bool populate, ice_fs_map_view *view) {
+#if defined(ICE_FS_MICROSOFT)
+    HANDLE file, mapping;
+    LARGE_INTEGER size;
+    void *data;
 
-    t1 = ice_fs_type(path1);
-    t2 = ice_fs_type(path2);
-    
-    if ((t1 == ICE_FS_OBJECT_TYPE_DIR) && (t2 == ICE_FS_OBJECT_TYPE_DIR)) {
+    if ((path == 0) || (view == 0)) return ICE_FS_FALSE;
+
+    view->data = 0;
+    view->size = 0;
+    view->handle = 0;
+
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) return ICE_FS_FALSE;
+
+    if ((GetFileSizeEx(file, &size) == 0) || (size.HighPart != 0)) {
+        (void) CloseHandle(file);
+        return ICE_FS_FALSE;
+    }
+
+    /* Empty files can't be mapped, So they get empty view */
+    if (size.LowPart == 0) {
+        (void) CloseHandle(file);
+        return ICE_FS_TRUE;
+    }
+
+    /* Mapping keeps the file open by itself */
+    mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    (void) CloseHandle(file);
+    if (mapping == 0) return ICE_FS_FALSE;
+
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == 0) {
+        (void) CloseHandle(mapping);
+        return ICE_FS_FALSE;
+    }
+
+    view->data = data;
+    view->size = (unsigned long) size.LowPart;
+    view->handle = mapping;
+
+    /* Windows has no populate flag or access hints for views, So pages needed soon are touched instead */
+    if ((populate == ICE_FS_TRUE) || (hint == ICE_FS_MAP_HINT_WILLNEED)) {
+        const volatile char *pages = (const volatile char*) data;
         unsigned long i;
-        ice_fs_dir d = ice_fs_dir_content(path1);
-        ice_fs_bool cp = ICE_FS_FALSE;
-        
-        if (d.items_count == 0) return cp;
-        
-        for (i = 0; i < d.items_count; i++) {
-            char *fullpath1 = 0;
-            char *fullpath2 = 0;
-            ice_fs_object_type t = d.items[i].type;
-            
-            fullpath1 = ice_fs_concat_path(path1, d.items[i].name);
-            fullpath2 = ice_fs_concat_path(path2, d.items[i].name);
-            
-            cp = ice_fs_create(fullpath2, t);
-            
-            if (t == ICE_FS_OBJECT_TYPE_FILE) {
-                char *content = ice_fs_file_content(fullpath1, 0);
-                cp = ice_fs_file_write(fullpath2, content, ICE_FS_FALSE);
-                ice_fs_free_str(content);
-            } else if (t == ICE_FS_OBJECT_TYPE_DIR) {
-                cp = ice_fs_copy(fullpath1, fullpath2);
-            }
-            
-            ice_fs_free_str(fullpath1);
-            ice_fs_free_str(fullpath2);
-            
-            if (cp == ICE_FS_FALSE) break;
-        }
-        
-        ice_fs_free_dir_content(&d);
-        
-        return cp;
-        
-    } else if ((t1 == ICE_FS_OBJECT_TYPE_FILE) && (t2 == ICE_FS_OBJECT_TYPE_FILE || t2 == ICE_FS_OBJECT_TYPE_NONE)) {
-        char *content = ice_fs_file_content(path1, 0);
-        ice_fs_bool write_res = ice_fs_file_write(path2, content, ICE_FS_FALSE);
-        
-        ice_fs_free_str(content);
-        
-        return write_res;
-        
-    } else if ((t1 == ICE_FS_OBJECT_TYPE_FILE) && (t2 == ICE_FS_OBJECT_TYPE_DIR)) {
-        ice_fs_bool write_res;
-        char *content, *filename, *path;
-        
-        content = ice_fs_file_content(path1, 0);
-        filename = ice_fs_filename(path1, ICE_FS_TRUE);
-        path = ice_fs_concat_path(path2, filename);
-        
-        write_res = ice_fs_file_write(path, content, ICE_FS_FALSE);
-        
-        ice_fs_free_str(content);
-        ice_fs_free_str(filename);
-        ice_fs_free_str(path);
-        
-        return write_res;
+        char ch = 0;
+
+        for (i = 0; i < view->size; i += 4096) ch ^= pages[i];
+        (void) ch;
     }
-    
-    return ICE_FS_FALSE;
+
+    return ICE_FS_TRUE;
+#elif defined(ICE_FS_UNIX)
+    struct stat info;
+    int fd, flags = MAP_PRIVATE;
+    void *data;
+
+    if ((path == 0) || (view == 0)) return ICE_FS_FALSE;
+
+    view->data = 0;
+    view->size = 0;
+    view->handle = 0;
+
+    fd = open(path, O_RDONLY);
+    if (fd == -1) return ICE_FS_FALSE;
+
+    if ((fstat(fd, &info) == -1) || (!S_ISREG(info.st_mode)) || (((off_t)(unsigned long) info.st_size) != info.st_size) || (((off_t)(size_t) info.st_size) != info.st_size)) {
+        (void) close(fd);
+        return ICE_FS_FALSE;
+    }
+
+    /* Empty files can't be mapped, So they get empty view */
+    if (info.st_size == 0) {
+        (void) close(fd);
+        return ICE_FS_TRUE;
+    }
+
+#if defined(MAP_POPULATE)
+    if (populate == ICE_FS_TRUE) flags |= MAP_POPULATE;
+#else
+    /* Without MAP_POPULATE (Non-Linux), Ask to read the pages ahead at least */
+    if (populate == ICE_FS_TRUE) hint = ICE_FS_MAP_HINT_WILLNEED;
+#endif
+
+    /* Mapping keeps the file open by itself */
+    data = mmap(0, (size_t) info.st_size, PROT_READ, flags, fd, 0);
+    (void) close(fd);
+    if (data == MAP_FAILED) return ICE_FS_FALSE;
+
+    view->data = data;
+    view->size = (unsigned long) info.st_size;
+
+    /* Hints are only advice, So failures of madvise are ignored */
+#if defined(MADV_SEQUENTIAL)
+    if (hint == ICE_FS_MAP_HINT_SEQUENTIAL) {
+        (void) madvise(data, (size_t) info.st_size, MADV_SEQUENTIAL);
+    } else if (hint == ICE_FS_MAP_HINT_RANDOM) {
+        (void) madvise(data, (size_t) info.st_size, MADV_RANDOM);
+    } else if (hint == ICE_FS_MAP_HINT_WILLNEED) {
+        (void) madvise(data, (size_t) info.st_size, MADV_WILLNEED);
+    }
+#else
+    (void) hint;
+    (void) populate;
+#endif
+
+    return ICE_FS_TRUE;
+#endif
 }
 
-/* Moves file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_move(const char *path1, const char *path2) {
-    int move_res;
+/* Unmaps view that was mapped by ice_fs_map, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_unmap(ice_fs_map_view *view) {
+    ice_fs_bool res = ICE_FS_TRUE;
 
-    if ((path1 == 0) || (path2 == 0)) return ICE_FS_FALSE;
+    if (view == 0) return ICE_FS_FALSE;
+
+    /* Empty view of empty file */
+    if (view->data == 0) return ICE_FS_TRUE;
 
 #if defined(ICE_FS_MICROSOFT)
-    move_res = MoveFileA(path1, path2);
-    return (move_res != 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+    if (UnmapViewOfFile(view->data) == 0) res = ICE_FS_FALSE;
+    if (CloseHandle((HANDLE) view->handle) == 0) res = ICE_FS_FALSE;
 #elif defined(ICE_FS_UNIX)
-    move_res = rename(path1, path2);
-    return (move_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+    if (munmap((void*) view->data, (size_t) view->size) == -1) res = ICE_FS_FALSE;
 #endif
+
+    view->data = 0;
+    view->size = 0;
+    view->handle = 0;
+
+    return res;
 }
 
-/* Renames file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_rename(const char *path1, const char *path2) {
-    return ice_fs_move(path1, path2);
+/* [INTERNAL] Flag to open files for direct I/O with (0 where O_DIRECT isn't available) */
+#if defined(O_DIRECT)
+#  define ICE_FS_O_DIRECT O_DIRECT
+#else
+#  define ICE_FS_O_DIRECT 0
+#endif
+
+/* [INTERNAL] Switches file of stream from direct I/O to page cache (Once offset of the file isn't aligned anymore), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_stream_cached(ice_fs_stream *stream) {
+#if defined(ICE_FS_UNIX)
+    int flags = fcntl(stream->fd, F_GETFL);
+    if ((flags == -1) || (fcntl(stream->fd, F_SETFL, flags & ~ICE_FS_O_DIRECT) == -1)) return ICE_FS_FALSE;
+#endif
+
+    stream->direct = ICE_FS_FALSE;
+
+    return ICE_FS_TRUE;
 }
 
-/* Returns ICE_FS_TRUE if file/folder in specific path is empty or ICE_FS_FALSE if not empty */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_is_empty(const char *path) {
-    ice_fs_object_type type;
+/* [INTERNAL] Makes buffer of stream empty, Writes bytes pending in it or gives back read ahead bytes to the file, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_stream_drop(ice_fs_stream *stream) {
+    ice_fs_bool res = ICE_FS_TRUE;
 
-    if (path == 0) return ICE_FS_FALSE;
-    type = ice_fs_type(path);
-    
-    if (type == ICE_FS_OBJECT_TYPE_FILE) {
-        struct stat info;
-        int stat_res = stat(path, &info);
-        if (stat_res == -1) return ICE_FS_FALSE;
-        return (info.st_size == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
-        
-    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
-        unsigned long items_count = 0;
-        int close_res;
+    if (stream->writing == ICE_FS_TRUE) {
+        unsigned long whole = stream->buf_len;
 
-#if defined(ICE_FS_MICROSOFT)
-        WIN32_FIND_DATAA find_data;
-        HANDLE find_handle = INVALID_HANDLE_VALUE;
-    
-        unsigned long i, len_search = ice_fs_str_len(path);
-        
-        char *search_path = ICE_FS_MALLOC((len_search + 3) * sizeof(char));
-        if (search_path == 0) return ICE_FS_FALSE;
-        
-        for (i = 0; i < len_search; i++) search_path[i] = path[i];
-        
-        search_path[i] = '\\';
-        search_path[i + 1] = '*';
-        search_path[i + 2] = 0;
-        
-        find_handle = FindFirstFileA(search_path, &find_data);
-        ice_fs_free_str(search_path);
+        /* Direct I/O writes only whole blocks, So unaligned tail is written through the page cache */
+        if (stream->direct == ICE_FS_TRUE) whole -= (stream->buf_len % ICE_FS_DIRECT_ALIGNMENT);
 
-        if (find_handle == INVALID_HANDLE_VALUE) return ICE_FS_FALSE;
-        
-        while (FindNextFileA(find_handle, &find_data) != 0) {
-            ice_fs_bool cd = ice_fs_str_same(find_data.cFileName, ".");
-            ice_fs_bool pd = ice_fs_str_same(find_data.cFileName, "..");
-            
-            if ((cd == ICE_FS_FALSE) && (pd == ICE_FS_FALSE)) {
-                items_count++;
-            }
+        res = ice_fs_write_fd(stream->fd, stream->buf, whole);
+
+        if ((res == ICE_FS_TRUE) && (whole < stream->buf_len)) {
+            res = ice_fs_stream_cached(stream);
+            if (res == ICE_FS_TRUE) res = ice_fs_write_fd(stream->fd, stream->buf + whole, stream->buf_len - whole);
         }
-        
-        close_res = FindClose(find_handle);
-        if (close_res == 0) return ICE_FS_FALSE;
-        
+    } else if (stream->buf_pos < stream->buf_len) {
+        /* Rewind file offset to first unread byte, Fails on pipes where unread bytes are lost anyway */
+        if (ice_fs_seek_fd(stream->fd, -((ice_fs_offset) (stream->buf_len - stream->buf_pos)), SEEK_CUR) == -1) res = ICE_FS_FALSE;
+    }
+
+    stream->buf_pos = 0;
+    stream->buf_len = 0;
+    stream->writing = ICE_FS_FALSE;
+
+    return res;
+}
+
+/* [INTERNAL] Returns flags to open file with in mode or -1 if mode is invalid */
+static int ice_fs_stream_flags(ice_fs_stream_mode mode) {
+    if (mode == ICE_FS_STREAM_MODE_READ) return O_RDONLY;
+    else if (mode == ICE_FS_STREAM_MODE_WRITE) return (O_WRONLY | O_CREAT | O_TRUNC);
+    else if (mode == ICE_FS_STREAM_MODE_APPEND) return (O_WRONLY | O_CREAT | O_APPEND);
+    else if (mode == ICE_FS_STREAM_MODE_READ_WRITE) return (O_RDWR | O_CREAT);
+    else if (mode == ICE_FS_STREAM_MODE_DIRECT_READ) return (O_RDONLY | ICE_FS_O_DIRECT);
+    else if (mode == ICE_FS_STREAM_MODE_DIRECT_WRITE) return (O_WRONLY | O_CREAT | O_TRUNC | ICE_FS_O_DIRECT);
+    return -1;
+}
+
+/* Opens file in path as stream in mode, buf should be pointer to caller-provided buffer of buf_size bytes or NULL to allocate buffer of buf_size bytes (ICE_FS_STREAM_BUFFER_SIZE if 0), Direct modes bypass page cache with O_DIRECT on Linux (F_NOCACHE on macOS, Cached I/O elsewhere or on filesystems that refuse it) and need buffer aligned to ICE_FS_DIRECT_ALIGNMENT bytes with size multiple of it (Allocated buffer is rounded up), Unaligned tail of the file is read and written through page cache, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_open(ice_fs_stream *stream, const char *path, ice_fs_stream_mode mode, void *buf, unsigned long buf_size) {
+    ice_fs_bool direct = (((mode == ICE_FS_STREAM_MODE_DIRECT_READ) || (mode == ICE_FS_STREAM_MODE_DIRECT_WRITE)) ? ICE_FS_TRUE : ICE_FS_FALSE);
+    int flags;
+
+    if ((stream == 0) || (path == 0)) return ICE_FS_FALSE;
+    if ((buf != 0) && (buf_size == 0)) return ICE_FS_FALSE;
+
+    flags = ice_fs_stream_flags(mode);
+    if (flags == -1) return ICE_FS_FALSE;
+
+    if ((direct == ICE_FS_TRUE) && (buf != 0) && (((((size_t) buf) % ICE_FS_DIRECT_ALIGNMENT) != 0) || ((buf_size % ICE_FS_DIRECT_ALIGNMENT) != 0))) {
+        errno = EINVAL;
+        return ICE_FS_FALSE;
+    }
+
+    stream->buf_pos = 0;
+    stream->buf_len = 0;
+    stream->writing = ICE_FS_FALSE;
+    stream->owns_buf = ICE_FS_FALSE;
+    stream->direct = ICE_FS_FALSE;
+
+    if (buf != 0) {
+        stream->buf = (char*) buf;
+        stream->buf_size = buf_size;
+    } else {
+        stream->buf_size = ((buf_size != 0) ? buf_size : ICE_FS_STREAM_BUFFER_SIZE);
+
+        /* Allocated buffer is always aligned, So it's freed same way in any mode */
+        if (direct == ICE_FS_TRUE) stream->buf_size = (((stream->buf_size + (ICE_FS_DIRECT_ALIGNMENT - 1)) / ICE_FS_DIRECT_ALIGNMENT) * ICE_FS_DIRECT_ALIGNMENT);
+
+        stream->buf = ice_fs_aligned_alloc(stream->buf_size, ((direct == ICE_FS_TRUE) ? ICE_FS_DIRECT_ALIGNMENT : sizeof(void*)));
+        if (stream->buf == 0) return ICE_FS_FALSE;
+        stream->owns_buf = ICE_FS_TRUE;
+    }
+
+#if defined(ICE_FS_MICROSOFT)
+    /* Binary mode, So bytes are never translated */
+    stream->fd = open(path, flags | O_BINARY, S_IREAD | S_IWRITE);
 #elif defined(ICE_FS_UNIX)
-        DIR *d;
-        struct dirent *dir;
-    
-        d = opendir(path);
-    
-        if (d != 0) {
-            while ((dir = readdir(d)) != 0) {
-                ice_fs_bool cd = ice_fs_str_same(dir->d_name, ".");
-                ice_fs_bool pd = ice_fs_str_same(dir->d_name, "..");
-            
-                if ((cd == ICE_FS_FALSE) && (pd == ICE_FS_FALSE)) {
-                    items_count++;
-                }
-            }
+    stream->fd = open(path, flags, 0666);
 
-            close_res = closedir(d);
-            if (close_res == -1) return ICE_FS_FALSE;
-        } else return ICE_FS_FALSE;
+    /* Filesystems without direct I/O (Like tmpfs) refuse the flag, So they get cached I/O */
+    if ((stream->fd == -1) && (errno == EINVAL) && ((flags & ICE_FS_O_DIRECT) != 0)) {
+        flags &= ~ICE_FS_O_DIRECT;
+        stream->fd = open(path, flags, 0666);
+    }
 #endif
-        return (items_count == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+
+    if (stream->fd == -1) {
+        if (stream->owns_buf == ICE_FS_TRUE) ice_fs_aligned_free(stream->buf);
+        stream->buf = 0;
+        return ICE_FS_FALSE;
     }
-    
+
+    if ((flags & ICE_FS_O_DIRECT) != 0) stream->direct = ICE_FS_TRUE;
+
+#if defined(F_NOCACHE)
+    /* macOS has no O_DIRECT but can keep file out of the cache (Without alignment rules) */
+    if (direct == ICE_FS_TRUE) (void) fcntl(stream->fd, F_NOCACHE, 1);
+#endif
+
+    return ICE_FS_TRUE;
+}
+
+/* Reads up to len bytes from stream into dst and stores number of read bytes in read_len (Less than len only at end of file), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_read(ice_fs_stream *stream, void *dst, unsigned long len, unsigned long *read_len) {
+    char *bytes = (char*) dst;
+    unsigned long total = 0;
+
+    if (read_len != 0) *read_len = 0;
+    if ((stream == 0) || (stream->fd == -1) || ((dst == 0) && (len > 0))) return ICE_FS_FALSE;
+
+    if (stream->writing == ICE_FS_TRUE) {
+        if (ice_fs_stream_drop(stream) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    }
+
+    while (total < len) {
+        unsigned long available = (stream->buf_len - stream->buf_pos);
+        long res;
+
+        if (available > 0) {
+            unsigned long i, count = (((len - total) < available) ? (len - total) : available);
+
+            for (i = 0; i < count; i++) bytes[total + i] = stream->buf[stream->buf_pos + i];
+
+            stream->buf_pos += count;
+            total += count;
+            continue;
+        }
+
+        /* Large reads go straight into dst instead of through the buffer (With direct I/O only if dst is aligned, In whole blocks) */
+        if (((len - total) >= stream->buf_size) && ((stream->direct == ICE_FS_FALSE) || ((((size_t) (bytes + total)) % ICE_FS_DIRECT_ALIGNMENT) == 0))) {
+            unsigned long count = (len - total);
+
+            if (stream->direct == ICE_FS_TRUE) count -= (count % ICE_FS_DIRECT_ALIGNMENT);
+
+            res = ice_fs_read_fd(stream->fd, bytes + total, count);
+            if (res == -1) goto failure;
+            if (res == 0) break;
+
+            /* Short read reached end of the file at unaligned offset, Rest of it is read through the page cache */
+            if ((stream->direct == ICE_FS_TRUE) && ((res % ICE_FS_DIRECT_ALIGNMENT) != 0) && (ice_fs_stream_cached(stream) == ICE_FS_FALSE)) goto failure;
+
+            total += (unsigned long) res;
+            continue;
+        }
+
+        res = ice_fs_read_fd(stream->fd, stream->buf, stream->buf_size);
+        if (res == -1) goto failure;
+        if (res == 0) break;
+
+        if ((stream->direct == ICE_FS_TRUE) && ((res % ICE_FS_DIRECT_ALIGNMENT) != 0) && (ice_fs_stream_cached(stream) == ICE_FS_FALSE)) goto failure;
+
+        stream->buf_pos = 0;
+        stream->buf_len = (unsigned long) res;
+    }
+
+    if (read_len != 0) *read_len = total;
+
+    return ICE_FS_TRUE;
+
+failure:
+    if (read_len != 0) *read_len = total;
+
     return ICE_FS_FALSE;
 }
 
-/* Retrieves [last modification, last status change, last access] date of file/directory and stores info in info struct by pointing to, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
-ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_date(const char *path, ice_fs_date_type date_type, ice_fs_date *info) {
-    struct stat pinfo;
-    time_t t;
-    struct tm *pt;
-    int call_res = -1;
+/* Writes len bytes from src to stream (Through the buffer), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_write(ice_fs_stream *stream, const void *src, unsigned long len) {
+    const char *bytes = (const char*) src;
+    unsigned long i;
 
-    ice_fs_date_season season;
-    ice_fs_date_month month;
+    if ((stream == 0) || (stream->fd == -1) || ((src == 0) && (len > 0))) return ICE_FS_FALSE;
 
-    if ((path == 0) || (info == 0)) return ICE_FS_FALSE;
+    if (stream->writing == ICE_FS_FALSE) {
+        if (ice_fs_stream_drop(stream) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        stream->writing = ICE_FS_TRUE;
+    }
 
-    call_res = stat(path, &pinfo);
-    if (call_res == -1) return ICE_FS_FALSE;
+    /* Direct I/O writes only whole blocks, So the buffer is written only when full (Aligned src goes straight to the file when buffer is empty) */
+    if (stream->direct == ICE_FS_TRUE) {
+        while (len > 0) {
+            unsigned long count;
 
-    if (date_type == ICE_FS_LAST_ACCESS_DATE) t = pinfo.st_atime;
-    else if (date_type == ICE_FS_LAST_MODIFICATION_DATE) t = pinfo.st_mtime;
-    else if (date_type == ICE_FS_LAST_STATUS_CHANGE_DATE) t = pinfo.st_ctime;
-    else return ICE_FS_FALSE;
+            if ((stream->buf_len == 0) && (len >= stream->buf_size) && ((((size_t) bytes) % ICE_FS_DIRECT_ALIGNMENT) == 0)) {
+                count = (len - (len % ICE_FS_DIRECT_ALIGNMENT));
+                if (ice_fs_write_fd(stream->fd, bytes, count) == ICE_FS_FALSE) return ICE_FS_FALSE;
+            } else {
+                count = (((stream->buf_size - stream->buf_len) < len) ? (stream->buf_size - stream->buf_len) : len);
 
-    pt = localtime(&t);
-    
-    month = pt->tm_mon + 1;
-    
-    if (month == 12 || month == 1 || month == 2) {
-        season = ICE_FS_DATE_SEASON_WINTER;
-    } else if (month == 3 || month == 4 || month == 5) {
-        season = ICE_FS_DATE_SEASON_SPRING;
-    } else if (month == 6 || month == 7 || month == 8) {
-        season = ICE_FS_DATE_SEASON_SUMMER;
-    } else if (month == 9 || month == 10 || month == 11) {
-        season = ICE_FS_DATE_SEASON_AUTUMN;
-    } else {
-        season = ICE_FS_DATE_SEASON_UNKNOWN;
+                for (i = 0; i < count; i++) stream->buf[stream->buf_len + i] = bytes[i];
+                stream->buf_len += count;
+
+                if (stream->buf_len == stream->buf_size) {
+                    if (ice_fs_write_fd(stream->fd, stream->buf, stream->buf_len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+                    stream->buf_len = 0;
+                }
+            }
+
+            bytes += count;
+            len -= count;
+        }
+
+        return ICE_FS_TRUE;
     }
 
-    info->str = ctime(&t);
-    info->epoch = (unsigned long) t;
-    info->seconds = pt->tm_sec;
-    info->minutes = pt->tm_min;
-    info->hour = pt->tm_hour;
-    info->week_day = pt->tm_wday + 1;
-    info->month_day = pt->tm_mday;
-    info->year_day = pt->tm_yday;
-    info->month = month;
-    info->season = season;
-    info->year = (pt->tm_year + 1900);
+    /* Data that doesn't fit in the buffer is written directly after the pending bytes */
+    if ((stream->buf_len + len) > stream->buf_size) {
+        if (ice_fs_write_fd(stream->fd, stream->buf, stream->buf_len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        stream->buf_len = 0;
+
+        if (len >= stream->buf_size) return ice_fs_write_fd(stream->fd, bytes, len);
+    }
+
+    for (i = 0; i < len; i++) stream->buf[stream->buf_len + i] = bytes[i];
+    stream->buf_len += len;
 
     return ICE_FS_TRUE;
 }
 
+/* Writes bytes pending in buffer of stream to the file, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_flush(ice_fs_stream *stream) {
+    if ((stream == 0) || (stream->fd == -1)) return ICE_FS_FALSE;
+    if (stream->writing == ICE_FS_FALSE) return ICE_FS_TRUE;
+
+    return ice_fs_stream_drop(stream);
+}
+
+/* Moves position of stream to offset relative to origin and stores the new position in pos (If not NULL), Seeking 0 bytes from ICE_FS_SEEK_CURRENT retrieves the current position, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_seek(ice_fs_stream *stream, ice_fs_offset offset, ice_fs_seek_origin origin, ice_fs_offset *pos) {
+    ice_fs_offset res;
+    int whence;
+
+    if ((stream == 0) || (stream->fd == -1)) return ICE_FS_FALSE;
+
+    if (origin == ICE_FS_SEEK_START) whence = SEEK_SET;
+    else if (origin == ICE_FS_SEEK_CURRENT) whence = SEEK_CUR;
+    else if (origin == ICE_FS_SEEK_END) whence = SEEK_END;
+    else return ICE_FS_FALSE;
+
+    if (stream->writing == ICE_FS_TRUE) {
+        if (ice_fs_stream_drop(stream) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    } else if (whence == SEEK_CUR) {
+        /* File offset is ahead of the stream position by bytes read ahead */
+        offset -= (ice_fs_offset) (stream->buf_len - stream->buf_pos);
+    }
+
+    stream->buf_pos = 0;
+    stream->buf_len = 0;
+
+    res = ice_fs_seek_fd(stream->fd, offset, whence);
+    if (res == -1) return ICE_FS_FALSE;
+
+    if (pos != 0) *pos = res;
+
+#if defined(ICE_FS_UNIX)
+    /* Direct I/O reads only from aligned offsets, So reading starts from block of unaligned offset and skips to it (Writing goes through the page cache instead) */
+    if ((stream->direct == ICE_FS_TRUE) && ((res % ICE_FS_DIRECT_ALIGNMENT) != 0)) {
+        unsigned long skip = (unsigned long) (res % ICE_FS_DIRECT_ALIGNMENT);
+        long read_res;
+
+        if ((fcntl(stream->fd, F_GETFL) & O_ACCMODE) != O_RDONLY) return ice_fs_stream_cached(stream);
+        if (ice_fs_seek_fd(stream->fd, res - skip, SEEK_SET) == -1) return ICE_FS_FALSE;
+
+        read_res = ice_fs_read_fd(stream->fd, stream->buf, stream->buf_size);
+        if (read_res == -1) return ICE_FS_FALSE;
+
+        stream->buf_len = (unsigned long) read_res;
+        stream->buf_pos = ((skip < stream->buf_len) ? skip : stream->buf_len);
+
+        if (((read_res % ICE_FS_DIRECT_ALIGNMENT) != 0) && (ice_fs_stream_cached(stream) == ICE_FS_FALSE)) return ICE_FS_FALSE;
+    }
+#endif
+
+    return ICE_FS_TRUE;
+}
+
+/* Tells the system how range of len bytes from offset in file of stream will be accessed (len of 0 means till end of file), Does nothing on platforms without posix_fadvise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_advise(ice_fs_stream *stream, ice_fs_offset offset, ice_fs_offset len, ice_fs_stream_hint hint) {
+    if ((stream == 0) || (stream->fd == -1)) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_UNIX) && defined(POSIX_FADV_SEQUENTIAL)
+    {
+        int advice;
+
+        if (hint == ICE_FS_STREAM_HINT_NORMAL) advice = POSIX_FADV_NORMAL;
+        else if (hint == ICE_FS_STREAM_HINT_SEQUENTIAL) advice = POSIX_FADV_SEQUENTIAL;
+        else if (hint == ICE_FS_STREAM_HINT_RANDOM) advice = POSIX_FADV_RANDOM;
+        else if (hint == ICE_FS_STREAM_HINT_WILLNEED) advice = POSIX_FADV_WILLNEED;
+        else if (hint == ICE_FS_STREAM_HINT_DONTNEED) advice = POSIX_FADV_DONTNEED;
+        else return ICE_FS_FALSE;
+
+        return (posix_fadvise(stream->fd, (off_t) offset, (off_t) len, advice) == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+    }
+#else
+    (void) offset;
+    (void) len;
+    (void) hint;
+
+    return ICE_FS_TRUE;
+#endif
+}
+
+/* [INTERNAL] Reserves disk space for first size bytes of file fd (Without changing its size if keep_size is ICE_FS_TRUE), Does nothing where space can't be reserved, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Like when disk is full) */
+static ice_fs_bool ice_fs_reserve_fd(int fd, ice_fs_offset size, ice_fs_bool keep_size) {
+    if (size <= 0) return ICE_FS_TRUE;
+
+#if defined(ICE_FS_FALLOCATE)
+    {
+        int res;
+
+        do {
+            res = fallocate(fd, ((keep_size == ICE_FS_TRUE) ? FALLOC_FL_KEEP_SIZE : 0), 0, (off_t) size);
+        } while ((res == -1) && (errno == EINTR));
+
+        if (res == 0) return ICE_FS_TRUE;
+
+        /* Filesystems without extents (Like FAT) refuse it */
+        if ((errno != EOPNOTSUPP) && (errno != ENOSYS)) return ICE_FS_FALSE;
+    }
+#elif defined(ICE_FS_UNIX) && defined(_POSIX_ADVISORY_INFO) && (_POSIX_ADVISORY_INFO > 0)
+    /* posix_fallocate always grows the file */
+    if (keep_size == ICE_FS_FALSE) {
+        int res = posix_fallocate(fd, 0, (off_t) size);
+
+        if (res == 0) return ICE_FS_TRUE;
+        if ((res != EOPNOTSUPP) && (res != EINVAL)) {
+            errno = res;
+            return ICE_FS_FALSE;
+        }
+    }
+#elif defined(ICE_FS_MICROSOFT) && defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0600)
+    {
+        FILE_ALLOCATION_INFO info;
+
+        /* Allocation smaller than the file would cut it */
+        if ((keep_size == ICE_FS_FALSE) || (size > ((ice_fs_offset) _filelengthi64(fd)))) {
+            info.AllocationSize.QuadPart = (LONGLONG) size;
+            return (SetFileInformationByHandle((HANDLE) _get_osfhandle(fd), FileAllocationInfo, &info, sizeof(info)) != 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+        }
+    }
+#else
+    (void) fd;
+    (void) keep_size;
+#endif
+
+    return ICE_FS_TRUE;
+}
+
+/* Reserves disk space for first size bytes of file of stream without changing its size (With fallocate on Linux), So streaming big file doesn't fragment it or run out of space midway, Does nothing on platforms or filesystems that can't reserve space, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Like when disk is full) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_preallocate(ice_fs_stream *stream, ice_fs_offset size) {
+    if ((stream == 0) || (stream->fd == -1) || (size < 0)) return ICE_FS_FALSE;
+    return ice_fs_reserve_fd(stream->fd, size, ICE_FS_TRUE);
+}
+
+/* Closes stream opened by ice_fs_stream_open after writing bytes pending in its buffer, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_stream_close(ice_fs_stream *stream) {
+    ice_fs_bool res = ICE_FS_TRUE;
+
+    if ((stream == 0) || (stream->fd == -1)) return ICE_FS_FALSE;
+
+    if (stream->writing == ICE_FS_TRUE) res = ice_fs_stream_drop(stream);
+    if (close(stream->fd) == -1) res = ICE_FS_FALSE;
+
+    if (stream->owns_buf == ICE_FS_TRUE) ice_fs_aligned_free(stream->buf);
+
+    stream->fd = -1;
+    stream->buf = 0;
+    stream->buf_size = 0;
+    stream->buf_pos = 0;
+    stream->buf_len = 0;
+
+    return res;
+}
+
+/* Allocates size bytes (With ICE_FS_MALLOC) at address that is multiple of alignment (Power of 2, ICE_FS_DIRECT_ALIGNMENT if 0), For buffers of direct I/O streams and batched requests on files opened in direct modes, Returns pointer to the memory on success or NULL on failure, The memory should be freed with ice_fs_aligned_free */
+ICE_FS_API void* ICE_FS_CALLCONV ice_fs_aligned_alloc(unsigned long size, unsigned long alignment) {
+    char *base, *aligned;
+
+    if (alignment == 0) alignment = ICE_FS_DIRECT_ALIGNMENT;
+    if ((alignment & (alignment - 1)) != 0) return 0;
+
+    /* Pointer to the allocation is stored right before the aligned memory */
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+    if ((size + alignment + sizeof(void*)) < size) return 0;
+
+    base = ICE_FS_MALLOC(size + alignment + sizeof(void*));
+    if (base == 0) return 0;
+
+    aligned = base + sizeof(void*);
+    aligned += ((alignment - (((size_t) aligned) % alignment)) % alignment);
+
+    memcpy(aligned - sizeof(void*), &base, sizeof(void*));
+
+    return aligned;
+}
+
+/* Frees memory allocated by ice_fs_aligned_alloc */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_aligned_free(void *ptr) {
+    void *base;
+
+    if (ptr == 0) return;
+
+    memcpy(&base, ((char*) ptr) - sizeof(void*), sizeof(void*));
+    ICE_FS_FREE(base);
+}
+
+/* Opens file in path for iteration of its lines with ice_fs_line_iter_next, buf_size is initial size of the sliding window buffer (ICE_FS_LINE_ITER_BUFFER_SIZE if 0, Grows only if a line doesn't fit), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_line_iter_open(ice_fs_line_iter *iter, const char *path, unsigned long buf_size) {
+    if ((iter == 0) || (path == 0)) return ICE_FS_FALSE;
+
+    iter->buf_size = ((buf_size != 0) ? buf_size : ICE_FS_LINE_ITER_BUFFER_SIZE);
+    iter->buf_pos = 0;
+    iter->buf_len = 0;
+    iter->scan_pos = 0;
+    iter->eof = ICE_FS_FALSE;
+    iter->failed = ICE_FS_FALSE;
+
+    /* One more byte to terminate the last line */
+    iter->buf = ICE_FS_MALLOC(iter->buf_size + 1);
+    if (iter->buf == 0) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    iter->fd = open(path, O_RDONLY | O_BINARY);
+#elif defined(ICE_FS_UNIX)
+    iter->fd = open(path, O_RDONLY);
+#endif
+
+    if (iter->fd == -1) {
+        ICE_FS_FREE(iter->buf);
+        iter->buf = 0;
+        return ICE_FS_FALSE;
+    }
+
+#if defined(ICE_FS_UNIX) && defined(POSIX_FADV_SEQUENTIAL)
+    (void) posix_fadvise(iter->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    return ICE_FS_TRUE;
+}
+
+/* Retrieves next line of file opened by ice_fs_line_iter_open and stores pointer to it in line and its length in len, Lines are split and empty ones skipped like ice_fs_str_splitlines does ('\r' of "\r\n" stays in the line), Line is NUL-terminated and points into the iterator buffer till next call, Returns ICE_FS_TRUE if line was retrieved or ICE_FS_FALSE when there are no more lines or on failure (failed field of the iterator is set to ICE_FS_TRUE then) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_line_iter_next(ice_fs_line_iter *iter, const char **line, unsigned long *len) {
+    if ((iter == 0) || (iter->buf == 0) || (line == 0) || (len == 0)) return ICE_FS_FALSE;
+
+    for (;;) {
+        char *newline;
+        long read_size;
+
+        /* Consecutive newlines (Empty lines) are skipped */
+        while ((iter->buf_pos < iter->buf_len) && (iter->buf[iter->buf_pos] == '\n')) iter->buf_pos++;
+        if (iter->scan_pos < iter->buf_pos) iter->scan_pos = iter->buf_pos;
+
+        newline = (char*) memchr(iter->buf + iter->scan_pos, '\n', iter->buf_len - iter->scan_pos);
+
+        if (newline != 0) {
+            *newline = 0;
+            *line = iter->buf + iter->buf_pos;
+            *len = (unsigned long) (newline - *line);
+
+            iter->buf_pos = (unsigned long) ((newline + 1) - iter->buf);
+            iter->scan_pos = iter->buf_pos;
+
+            return ICE_FS_TRUE;
+        }
+
+        if (iter->eof == ICE_FS_TRUE) {
+            if (iter->buf_pos == iter->buf_len) return ICE_FS_FALSE;
+
+            /* Last line that doesn't end with newline */
+            iter->buf[iter->buf_len] = 0;
+            *line = iter->buf + iter->buf_pos;
+            *len = (iter->buf_len - iter->buf_pos);
+
+            iter->buf_pos = iter->buf_len;
+            iter->scan_pos = iter->buf_len;
+
+            return ICE_FS_TRUE;
+        }
+
+        /* Slide the incomplete line to the start of the window, Bytes of it were already scanned */
+        if (iter->buf_pos > 0) {
+            iter->buf_len -= iter->buf_pos;
+            memmove(iter->buf, iter->buf + iter->buf_pos, iter->buf_len);
+            iter->buf_pos = 0;
+        }
+
+        iter->scan_pos = iter->buf_len;
+
+        if (iter->buf_len == iter->buf_size) {
+            unsigned long buf_size = (iter->buf_size * 2);
+            char *buf = ICE_FS_REALLOC(iter->buf, buf_size + 1);
+
+            if (buf == 0) {
+                iter->failed = ICE_FS_TRUE;
+                return ICE_FS_FALSE;
+            }
+
+            iter->buf = buf;
+            iter->buf_size = buf_size;
+        }
+
+        read_size = ice_fs_read_fd(iter->fd, iter->buf + iter->buf_len, iter->buf_size - iter->buf_len);
+
+        if (read_size == -1) {
+            iter->failed = ICE_FS_TRUE;
+            return ICE_FS_FALSE;
+        }
+
+        if (read_size == 0) iter->eof = ICE_FS_TRUE;
+        iter->buf_len += (unsigned long) read_size;
+    }
+}
+
+/* Closes file opened by ice_fs_line_iter_open and frees the iterator buffer, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_line_iter_close(ice_fs_line_iter *iter) {
+    int close_res;
+
+    if ((iter == 0) || (iter->buf == 0)) return ICE_FS_FALSE;
+
+    close_res = close(iter->fd);
+
+    ICE_FS_FREE(iter->buf);
+    iter->buf = 0;
+    iter->fd = -1;
+
+    return (close_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* Changes current directory in the running program to another directory in path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_chdir(const char *path) {
+    int res;
+    
+    if (path == 0) return ICE_FS_FALSE;
+
+    res = chdir(path);
+    return (res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Entry recorded while enumerating a directory, name is offset into names buffer of ice_fs_dir_builder */
+typedef struct ice_fs_dir_entry {
+    unsigned long name_offset;
+    ice_fs_object_type type;
+} ice_fs_dir_entry;
+
+/* [INTERNAL] Growable buffers used to enumerate a directory in a single pass */
+typedef struct ice_fs_dir_builder {
+    ice_fs_dir_entry *entries;
+    unsigned long entries_count, entries_capacity;
+    char *names;
+    unsigned long names_len, names_capacity;
+} ice_fs_dir_builder;
+
+/* [INTERNAL] Appends entry of name with length name_len to the builder, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_dir_builder_push(ice_fs_dir_builder *b, const char *name, unsigned long name_len, ice_fs_object_type type) {
+    unsigned long i;
+
+    if (b->entries_count == b->entries_capacity) {
+        unsigned long capacity = ((b->entries_capacity == 0) ? 64 : (b->entries_capacity * 2));
+        ice_fs_dir_entry *entries = ICE_FS_REALLOC(b->entries, capacity * sizeof(ice_fs_dir_entry));
+        if (entries == 0) return ICE_FS_FALSE;
+
+        b->entries = entries;
+        b->entries_capacity = capacity;
+    }
+
+    if ((b->names_len + name_len + 1) > b->names_capacity) {
+        unsigned long capacity = ((b->names_capacity == 0) ? 1024 : b->names_capacity);
+        char *names;
+
+        while ((b->names_len + name_len + 1) > capacity) capacity *= 2;
+
+        names = ICE_FS_REALLOC(b->names, capacity * sizeof(char));
+        if (names == 0) return ICE_FS_FALSE;
+
+        b->names = names;
+        b->names_capacity = capacity;
+    }
+
+    b->entries[b->entries_count].name_offset = b->names_len;
+    b->entries[b->entries_count].type = type;
+    b->entries_count++;
+
+    for (i = 0; i < name_len; i++) b->names[b->names_len + i] = name[i];
+    b->names[b->names_len + name_len] = 0;
+    b->names_len += (name_len + 1);
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Packs items and names of the builder into one allocation owned by res and releases the builder buffers, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_dir_builder_finish(ice_fs_dir_builder *b, ice_fs_dir *res) {
+    unsigned long i, items_size = (b->entries_count * sizeof(ice_fs_object));
+    char *block, *names;
+    ice_fs_bool done = ICE_FS_FALSE;
+
+    res->items = 0;
+    res->items_count = 0;
+
+    if (b->entries_count == 0) {
+        done = ICE_FS_TRUE;
+        goto cleanup;
+    }
+
+    block = ICE_FS_MALLOC(items_size + (b->names_len * sizeof(char)));
+    if (block == 0) goto cleanup;
+
+    res->items = (ice_fs_object*)((void*) block);
+    names = block + items_size;
+
+    for (i = 0; i < b->names_len; i++) names[i] = b->names[i];
+
+    for (i = 0; i < b->entries_count; i++) {
+        res->items[i].name = names + b->entries[i].name_offset;
+        res->items[i].type = b->entries[i].type;
+    }
+
+    res->items_count = b->entries_count;
+    done = ICE_FS_TRUE;
+
+cleanup:
+    ICE_FS_FREE(b->entries);
+    ICE_FS_FREE(b->names);
+    b->entries = 0;
+    b->names = 0;
+
+    return done;
+}
+
+/* [INTERNAL] Returns ICE_FS_TRUE if name is "." or "..", Or ICE_FS_FALSE if not */
+static ice_fs_bool ice_fs_is_dot_name(const char *name) {
+    if (name[0] != '.') return ICE_FS_FALSE;
+    if (name[1] == 0) return ICE_FS_TRUE;
+    return ((name[1] == '.') && (name[2] == 0)) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+#if defined(ICE_FS_UNIX)
+/* [INTERNAL] Returns type of directory entry of name from its d_type and stores ICE_FS_TRUE in is_link if the entry is symbolic link, Stats the entry (Relative to the directory fd dfd) without following it only when the type is unknown, Symbolic links are reported as files unless follow is ICE_FS_TRUE (Then type of their target is returned like ice_fs_type does) */
+static ice_fs_object_type ice_fs_dirent_type(int dfd, const char *name, unsigned char d_type, ice_fs_bool follow, ice_fs_bool *is_link) {
+    struct stat info;
+
+    *is_link = ICE_FS_FALSE;
+
+#if defined(DT_UNKNOWN)
+    if (d_type == DT_DIR) return ICE_FS_OBJECT_TYPE_DIR;
+    if (d_type == DT_LNK) *is_link = ICE_FS_TRUE;
+    else if (d_type != DT_UNKNOWN) return ICE_FS_OBJECT_TYPE_FILE;
+#else
+    (void) d_type;
+#endif
+
+    if (*is_link == ICE_FS_FALSE) {
+        if (fstatat(dfd, name, &info, AT_SYMLINK_NOFOLLOW) == -1) return ICE_FS_OBJECT_TYPE_NONE;
+        if ((info.st_mode & S_IFMT) != S_IFLNK) return ((info.st_mode & S_IFMT) == S_IFDIR) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE;
+
+        *is_link = ICE_FS_TRUE;
+    }
+
+    if (follow == ICE_FS_FALSE) return ICE_FS_OBJECT_TYPE_FILE;
+
+    if (fstatat(dfd, name, &info, 0) == -1) return ICE_FS_OBJECT_TYPE_NONE;
+    return ((info.st_mode & S_IFMT) == S_IFDIR) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE;
+}
+#endif
+
+/* [INTERNAL] Prepares iter to read entries into buf of buf_size bytes, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if the buffer is too small */
+static ice_fs_bool ice_fs_dir_iter_init(ice_fs_dir_iter *iter, void *buf, unsigned long buf_size) {
+    unsigned long misalign;
+
+    if ((iter == 0) || (buf == 0)) return ICE_FS_FALSE;
+
+    /* Entries are read as 8-byte aligned records so align start of the buffer */
+    misalign = (unsigned long)(((size_t) buf) % 8);
+    if (misalign != 0) misalign = 8 - misalign;
+
+    if (buf_size < (ICE_FS_DIR_ITER_MIN_BUFFER_SIZE + misalign)) return ICE_FS_FALSE;
+
+    iter->handle = 0;
+    iter->fd = -1;
+    iter->buf = ((char*) buf) + misalign;
+    iter->buf_size = buf_size - misalign;
+    iter->buf_len = 0;
+    iter->buf_pos = 0;
+    iter->error = 0;
+
+    return ICE_FS_TRUE;
+}
+
+#if defined(ICE_FS_UNIX)
+/* [INTERNAL] Makes iter (Prepared by ice_fs_dir_iter_init) read entries of opened directory fd, The iterator owns fd from then (Closed by ice_fs_dir_iter_close, Or here on failure), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_dir_iter_attach(ice_fs_dir_iter *iter, int fd) {
+#  if defined(ICE_FS_GETDENTS)
+    iter->fd = fd;
+#  else
+    DIR *d = fdopendir(fd);
+
+    if (d == 0) {
+        (void) close(fd);
+        return ICE_FS_FALSE;
+    }
+
+    iter->handle = (void*) d;
+    iter->fd = dirfd(d);
+#  endif
+
+    return ICE_FS_TRUE;
+}
+#endif
+
+/* [INTERNAL] Same like ice_fs_dir_iter_open but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+static ice_fs_bool ice_fs_dir_iter_open_at(ice_fs_dir_iter *iter, const ice_fs_dir_handle *dir, const char *path, void *buf, unsigned long buf_size) {
+#if defined(ICE_FS_MICROSOFT)
+    const char *at_path;
+    char *search_path = 0;
+    HANDLE find_handle;
+#elif defined(ICE_FS_UNIX)
+    int fd;
+#endif
+
+    if ((path == 0) || (ice_fs_dir_iter_init(iter, buf, buf_size) == ICE_FS_FALSE)) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    at_path = ice_fs_at_path(dir, path);
+    if (at_path == 0) return ICE_FS_FALSE;
+
+    search_path = ice_fs_concat_path(at_path, "*");
+    ice_fs_at_path_free(path, at_path);
+    if (search_path == 0) return ICE_FS_FALSE;
+
+    find_handle = FindFirstFileA(search_path, (WIN32_FIND_DATAA*)((void*) iter->buf));
+    ice_fs_free_str(search_path);
+
+    if (find_handle == INVALID_HANDLE_VALUE) return ICE_FS_FALSE;
+
+    iter->handle = (void*) find_handle;
+
+    /* First result of FindFirstFileA is pending in the buffer */
+    iter->buf_len = 1;
+
+#elif defined(ICE_FS_UNIX)
+    fd = openat(ice_fs_at_fd(dir), path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1) return ICE_FS_FALSE;
+
+    if (ice_fs_dir_iter_attach(iter, fd) == ICE_FS_FALSE) return ICE_FS_FALSE;
+#endif
+
+    return ICE_FS_TRUE;
+}
+
+/* Opens directory in path for iteration with ice_fs_dir_iter_next, buf should be pointer to caller-provided buffer of buf_size bytes (At least ICE_FS_DIR_ITER_MIN_BUFFER_SIZE) that entries are read into, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_iter_open(ice_fs_dir_iter *iter, const char *path, void *buf, unsigned long buf_size) {
+    return ice_fs_dir_iter_open_at(iter, 0, path, buf, buf_size);
+}
+
+/* [INTERNAL] Same like ice_fs_dir_iter_next but if is_link is not NULL stores ICE_FS_TRUE in it if the item is symbolic link and reports links as files instead of following them (So tree walkers never stat through links or follow them into cycles) */
+static ice_fs_bool ice_fs_dir_iter_read(ice_fs_dir_iter *iter, ice_fs_object *item, ice_fs_bool *is_link) {
+#if defined(ICE_FS_MICROSOFT)
+    WIN32_FIND_DATAA *find_data;
+
+    if ((iter == 0) || (item == 0) || (iter->handle == 0)) return ICE_FS_FALSE;
+
+    find_data = (WIN32_FIND_DATAA*)((void*) iter->buf);
+
+    for (;;) {
+        if (iter->buf_len == 1) {
+            iter->buf_len = 0;
+        } else if (FindNextFileA((HANDLE) iter->handle, find_data) == 0) {
+            if (GetLastError() != ERROR_NO_MORE_FILES) iter->error = EIO;
+            return ICE_FS_FALSE;
+        }
+
+        if (ice_fs_is_dot_name(find_data->cFileName) == ICE_FS_TRUE) continue;
+
+        item->name = find_data->cFileName;
+        item->type = ((find_data->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE;
+        if (is_link != 0) *is_link = ((find_data->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == FILE_ATTRIBUTE_REPARSE_POINT) ? ICE_FS_TRUE : ICE_FS_FALSE;
+
+        return ICE_FS_TRUE;
+    }
+
+#elif defined(ICE_FS_UNIX)
+#  if defined(ICE_FS_GETDENTS)
+    ice_fs_bool link, follow = ((is_link == 0) ? ICE_FS_TRUE : ICE_FS_FALSE);
+
+    if ((iter == 0) || (item == 0) || (iter->fd == -1)) return ICE_FS_FALSE;
+    if (is_link == 0) is_link = &link;
+
+    for (;;) {
+        const char *rec, *name;
+        unsigned short reclen;
+
+        if (iter->buf_pos >= iter->buf_len) {
+            long read_size = syscall(SYS_getdents64, iter->fd, iter->buf, iter->buf_size);
+
+            if (read_size == 0) return ICE_FS_FALSE;
+
+            if (read_size < 0) {
+                iter->error = errno;
+                return ICE_FS_FALSE;
+            }
+
+            iter->buf_len = (unsigned long) read_size;
+            iter->buf_pos = 0;
+        }
+
+        /* struct linux_dirent64: u64 d_ino, s64 d_off, u16 d_reclen, u8 d_type, char d_name[] */
+        rec = iter->buf + iter->buf_pos;
+        reclen = *((const unsigned short*)((const void*)(rec + 16)));
+        name = rec + 19;
+
+        iter->buf_pos += reclen;
+
+        if (ice_fs_is_dot_name(name) == ICE_FS_TRUE) continue;
+
+        item->name = name;
+        item->type = ice_fs_dirent_type(iter->fd, name, (unsigned char) rec[18], follow, is_link);
+
+        return ICE_FS_TRUE;
+    }
+#  else
+    struct dirent *ent;
+    ice_fs_bool link, follow = ((is_link == 0) ? ICE_FS_TRUE : ICE_FS_FALSE);
+
+    if ((iter == 0) || (item == 0) || (iter->handle == 0)) return ICE_FS_FALSE;
+    if (is_link == 0) is_link = &link;
+
+    /* readdir returns NULL both at the end and on failure, Only errno tells them apart */
+    errno = 0;
+
+    while ((ent = readdir((DIR*) iter->handle)) != 0) {
+        if (ice_fs_is_dot_name(ent->d_name) == ICE_FS_TRUE) continue;
+
+        item->name = ent->d_name;
+#    if defined(DT_UNKNOWN)
+        item->type = ice_fs_dirent_type(iter->fd, ent->d_name, ent->d_type, follow, is_link);
+#    else
+        item->type = ice_fs_dirent_type(iter->fd, ent->d_name, 0, follow, is_link);
+#    endif
+
+        return ICE_FS_TRUE;
+    }
+
+    if (errno != 0) iter->error = errno;
+
+    return ICE_FS_FALSE;
+#  endif
+#endif
+}
+
+/* Retrieves next item of the directory opened by ice_fs_dir_iter_open and stores it in item struct by pointing to, Name of the item points into the iterator buffer and stays valid till next call, Returns ICE_FS_TRUE if item was retrieved or ICE_FS_FALSE when there are no more items or on failure (error field of iter is set then) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_iter_next(ice_fs_dir_iter *iter, ice_fs_object *item) {
+    return ice_fs_dir_iter_read(iter, item, 0);
+}
+
+/* Closes directory opened by ice_fs_dir_iter_open, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Also if reading entries failed before, So directory isn't mistaken for fully read one) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_iter_close(ice_fs_dir_iter *iter) {
+    int close_res = -1;
+
+    if (iter == 0) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    if (iter->handle != 0) close_res = ((FindClose((HANDLE) iter->handle) != 0) ? 0 : -1);
+#elif defined(ICE_FS_UNIX)
+#  if defined(ICE_FS_GETDENTS)
+    if (iter->fd != -1) close_res = close(iter->fd);
+#  else
+    if (iter->handle != 0) close_res = closedir((DIR*) iter->handle);
+#  endif
+#endif
+
+    if ((close_res == 0) && (iter->error != 0)) {
+        errno = iter->error;
+        close_res = -1;
+    }
+
+    iter->handle = 0;
+    iter->fd = -1;
+    iter->buf_len = 0;
+    iter->buf_pos = 0;
+
+    return (close_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* Opens directory in path (Relative to directory of dir handle or current directory if dir is NULL) and stores its handle in handle struct by pointing to, Paths given to *_at functions with the handle are looked up from the directory itself instead of walking its whole path again, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_open(ice_fs_dir_handle *handle, const ice_fs_dir_handle *dir, const char *path) {
+#if defined(ICE_FS_MICROSOFT)
+    const char *at_path;
+#endif
+
+    if ((handle == 0) || (path == 0)) return ICE_FS_FALSE;
+
+    handle->fd = -1;
+    handle->path = 0;
+
+#if defined(ICE_FS_MICROSOFT)
+    /* Windows has no directory-relative calls, So the handle keeps full path of the directory (Changing current directory later doesn't affect it) */
+    at_path = ice_fs_at_path(dir, path);
+    if (at_path == 0) return ICE_FS_FALSE;
+
+    if (ice_fs_type(at_path) == ICE_FS_OBJECT_TYPE_DIR) handle->path = ice_fs_fullpath(at_path);
+    ice_fs_at_path_free(path, at_path);
+
+    return (handle->path != 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#elif defined(ICE_FS_UNIX)
+    handle->fd = openat(ice_fs_at_fd(dir), path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    return (handle->fd != -1) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#endif
+}
+
+/* Closes directory handle opened by ice_fs_dir_open, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_dir_close(ice_fs_dir_handle *handle) {
+    int close_res = -1;
+
+    if (handle == 0) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    if (handle->path != 0) {
+        ice_fs_free_str(handle->path);
+        close_res = 0;
+    }
+#elif defined(ICE_FS_UNIX)
+    if (handle->fd != -1) close_res = close(handle->fd);
+#endif
+
+    handle->fd = -1;
+    handle->path = 0;
+
+    return (close_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* Returns directory informations with list of contents in path on success or NULL on failure */
+ICE_FS_API ice_fs_dir ICE_FS_CALLCONV ice_fs_dir_content(const char *path) {
+    return ice_fs_dir_content_at(0, path);
+}
+
+/* Same like ice_fs_dir_content but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_dir ICE_FS_CALLCONV ice_fs_dir_content_at(const ice_fs_dir_handle *dir, const char *path) {
+    ice_fs_dir res;
+    ice_fs_dir_builder b = { 0, 0, 0, 0, 0, 0 };
+    ice_fs_dir_iter iter;
+    ice_fs_object item;
+    ice_fs_bool pushed = ICE_FS_TRUE;
+    char buf[ICE_FS_DIR_ITER_BUFFER_SIZE];
+
+    res.items = 0;
+    res.items_count = 0;
+
+    if (ice_fs_dir_iter_open_at(&iter, dir, path, buf, sizeof(buf)) == ICE_FS_FALSE) return res;
+
+    while ((pushed == ICE_FS_TRUE) && (ice_fs_dir_iter_next(&iter, &item) == ICE_FS_TRUE)) {
+        pushed = ice_fs_dir_builder_push(&b, item.name, ice_fs_str_len(item.name), item.type);
+    }
+
+    if ((ice_fs_dir_iter_close(&iter) == ICE_FS_FALSE) || (pushed == ICE_FS_FALSE)) {
+        ICE_FS_FREE(b.entries);
+        ICE_FS_FREE(b.names);
+
+        return res;
+    }
+
+    (void) ice_fs_dir_builder_finish(&b, &res);
+    return res;
+}
+
+/* Frees/Deallocates a directory information struct, dir should be pointer to the directory information struct that will be freed */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_dir_content(ice_fs_dir *dir) {
+    if (dir == 0) return;
+
+    /* Items and their names are packed into single allocation by ice_fs_dir_content */
+    ICE_FS_FREE(dir->items);
+    dir->items = 0;
+    dir->items_count = 0;
+}
+
+/* ============================== Threads ============================== */
+
+#if defined(ICE_FS_MICROSOFT)
+typedef CRITICAL_SECTION ice_fs_mutex;
+typedef CONDITION_VARIABLE ice_fs_cond;
+#elif defined(ICE_FS_UNIX)
+typedef pthread_mutex_t ice_fs_mutex;
+typedef pthread_cond_t ice_fs_cond;
+#endif
+
+/* [INTERNAL] Thread that runs func with arg */
+typedef struct ice_fs_thread {
+    void (*func)(void *arg);
+    void *arg;
+#if defined(ICE_FS_MICROSOFT)
+    HANDLE handle;
+#elif defined(ICE_FS_UNIX)
+    pthread_t handle;
+#endif
+} ice_fs_thread;
+
+/* Number of threads library functions use, 0 means number of CPU cores (Set via ice_fs_use_threads) */
+static unsigned long ice_fs_threads_count = 0;
+
+static void ice_fs_mutex_init(ice_fs_mutex *mutex) {
+#if defined(ICE_FS_MICROSOFT)
+    InitializeCriticalSection(mutex);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_mutex_init(mutex, 0);
+#endif
+}
+
+static void ice_fs_mutex_lock(ice_fs_mutex *mutex) {
+#if defined(ICE_FS_MICROSOFT)
+    EnterCriticalSection(mutex);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_mutex_lock(mutex);
+#endif
+}
+
+static void ice_fs_mutex_unlock(ice_fs_mutex *mutex) {
+#if defined(ICE_FS_MICROSOFT)
+    LeaveCriticalSection(mutex);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_mutex_unlock(mutex);
+#endif
+}
+
+static void ice_fs_mutex_destroy(ice_fs_mutex *mutex) {
+#if defined(ICE_FS_MICROSOFT)
+    DeleteCriticalSection(mutex);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_mutex_destroy(mutex);
+#endif
+}
+
+static void ice_fs_cond_init(ice_fs_cond *cond) {
+#if defined(ICE_FS_MICROSOFT)
+    InitializeConditionVariable(cond);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_cond_init(cond, 0);
+#endif
+}
+
+static void ice_fs_cond_wait(ice_fs_cond *cond, ice_fs_mutex *mutex) {
+#if defined(ICE_FS_MICROSOFT)
+    (void) SleepConditionVariableCS(cond, mutex, INFINITE);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_cond_wait(cond, mutex);
+#endif
+}
+
+static void ice_fs_cond_broadcast(ice_fs_cond *cond) {
+#if defined(ICE_FS_MICROSOFT)
+    WakeAllConditionVariable(cond);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_cond_broadcast(cond);
+#endif
+}
+
+static void ice_fs_cond_signal(ice_fs_cond *cond) {
+#if defined(ICE_FS_MICROSOFT)
+    WakeConditionVariable(cond);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_cond_signal(cond);
+#endif
+}
+
+static void ice_fs_cond_destroy(ice_fs_cond *cond) {
+#if defined(ICE_FS_MICROSOFT)
+    (void) cond;
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_cond_destroy(cond);
+#endif
+}
+
+#if defined(ICE_FS_MICROSOFT)
+static DWORD WINAPI ice_fs_thread_main(LPVOID arg) {
+    ice_fs_thread *thread = (ice_fs_thread*) arg;
+    thread->func(thread->arg);
+    return 0;
+}
+#elif defined(ICE_FS_UNIX)
+static void* ice_fs_thread_main(void *arg) {
+    ice_fs_thread *thread = (ice_fs_thread*) arg;
+    thread->func(thread->arg);
+    return 0;
+}
+#endif
+
+/* [INTERNAL] Starts thread that calls func with arg, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_thread_start(ice_fs_thread *thread, void (*func)(void *arg), void *arg) {
+    thread->func = func;
+    thread->arg = arg;
+
+#if defined(ICE_FS_MICROSOFT)
+    thread->handle = CreateThread(0, 0, ice_fs_thread_main, thread, 0, 0);
+    return (thread->handle != 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#elif defined(ICE_FS_UNIX)
+    return (pthread_create(&thread->handle, 0, ice_fs_thread_main, thread) == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#endif
+}
+
+/* [INTERNAL] Waits for thread started by ice_fs_thread_start to finish */
+static void ice_fs_thread_join(ice_fs_thread *thread) {
+#if defined(ICE_FS_MICROSOFT)
+    (void) WaitForSingleObject(thread->handle, INFINITE);
+    (void) CloseHandle(thread->handle);
+#elif defined(ICE_FS_UNIX)
+    (void) pthread_join(thread->handle, 0);
+#endif
+}
+
+/* [INTERNAL] Returns number of threads library functions should use */
+static unsigned long ice_fs_get_threads_count(void) {
+    long cores = 1;
+
+    if (ice_fs_threads_count != 0) return ice_fs_threads_count;
+
+#if defined(ICE_FS_MICROSOFT)
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        cores = (long) info.dwNumberOfProcessors;
+    }
+#elif defined(ICE_FS_UNIX) && defined(_SC_NPROCESSORS_ONLN)
+    cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    return (cores > 0) ? ((unsigned long) cores) : 1;
+}
+
+/* Sets number of threads that parallel library functions (Like ice_fs_dir_search) use, 0 means number of CPU cores (The default) */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_use_threads(unsigned long threads_count) {
+    ice_fs_threads_count = threads_count;
+}
+
+/* ============================== Arena ============================== */
+
+/* [INTERNAL] Chunk of memory owned by ice_fs_str_arena, Data follows the struct */
+typedef struct ice_fs_str_arena_chunk {
+    struct ice_fs_str_arena_chunk *next;
+    unsigned long used;
+    unsigned long capacity;
+} ice_fs_str_arena_chunk;
+
+/* [INTERNAL] Append-only arena for strings, Freed at once with ice_fs_str_arena_free */
+typedef struct ice_fs_str_arena {
+    ice_fs_str_arena_chunk *chunks;
+} ice_fs_str_arena;
+
+/* [INTERNAL] Allocates len bytes from arena, Returns pointer on allocation success or NULL on allocation failure */
+static char* ice_fs_str_arena_alloc(ice_fs_str_arena *arena, unsigned long len) {
+    ice_fs_str_arena_chunk *chunk = arena->chunks;
+    char *res;
+
+    if ((chunk == 0) || ((chunk->capacity - chunk->used) < len)) {
+        unsigned long capacity = ((len > 65536) ? len : 65536);
+
+        chunk = ICE_FS_MALLOC(sizeof(ice_fs_str_arena_chunk) + capacity);
+        if (chunk == 0) return 0;
+
+        chunk->next = arena->chunks;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        arena->chunks = chunk;
+    }
+
+    res = ((char*)(chunk + 1)) + chunk->used;
+    chunk->used += len;
+
+    return res;
+}
+
+/* [INTERNAL] Frees all memory allocated from arena */
+static void ice_fs_str_arena_free(ice_fs_str_arena *arena) {
+    while (arena->chunks != 0) {
+        ice_fs_str_arena_chunk *next = arena->chunks->next;
+        ICE_FS_FREE(arena->chunks);
+        arena->chunks = next;
+    }
+}
+
+/* ============================== Tree Walker ============================== */
+
+/* [INTERNAL] Directory visited by ice_fs_walk */
+typedef struct ice_fs_walk_dir {
+    struct ice_fs_walk_dir *parent;     /* Parent directory (Kept till all of its subdirectories are done, NULL for root directory of the walk) */
+    char *path;                         /* Full path of the directory */
+    const char *name;                   /* Name of the directory in its parent (Points into path) */
+    unsigned long path_len;
+    unsigned long depth;                /* 0 for root directory of the walk */
+    unsigned long pending;              /* Directory itself and its children that are not done yet */
+    int fd;                             /* fd of directory from its visit till it's freed, Subdirectories are opened relative to it (Unix only, -1 otherwise) */
+    void *data;                         /* Allocated by callbacks for the directory (NULL till then), Freed with it */
+} ice_fs_walk_dir;
+
+/* [INTERNAL] Work-stealing deque of directories, Owner pushes/pops at tail while other workers steal from head */
+typedef struct ice_fs_walk_deque {
+    ice_fs_mutex mutex;
+    ice_fs_walk_dir **dirs;
+    unsigned long head, tail, capacity;
+} ice_fs_walk_deque;
+
+struct ice_fs_walk;
+
+/* [INTERNAL] Worker thread of ice_fs_walk */
+typedef struct ice_fs_walk_worker {
+    struct ice_fs_walk *walk;
+    unsigned long idx;
+    ice_fs_walk_deque deque;
+    ice_fs_thread thread;
+    ice_fs_bool started;
+    char *buf;                          /* Buffer used to iterate directories */
+    ice_fs_walk_dir **children;         /* Subdirectories found in directory being visited */
+    unsigned long children_count, children_capacity;
+} ice_fs_walk_worker;
+
+/* [INTERNAL] Called for each item in visited directory from worker of index worker (is_link is ICE_FS_TRUE if the item is symbolic link), Returns ICE_FS_TRUE to descend into the item if it's directory */
+typedef ice_fs_bool (*ice_fs_walk_item_func)(struct ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link);
+
+/* [INTERNAL] Called after directory and all of its subdirectories were visited (Post-order) */
+typedef void (*ice_fs_walk_leave_func)(struct ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir);
+
+/* [INTERNAL] Parallel tree walk, Each directory is visited by one of the workers and subdirectories are spread across workers via work stealing */
+typedef struct ice_fs_walk {
+    ice_fs_walk_item_func on_item;      /* Required */
+    ice_fs_walk_leave_func on_leave;    /* Optional */
+    void *user;
+    ice_fs_bool failed;                 /* ICE_FS_TRUE if any directory could not be visited or any callback failed */
+    ice_fs_bool stop;                   /* ICE_FS_TRUE if the walk should stop as soon as possible */
+    int error;                          /* errno of the first failure */
+    ice_fs_mutex mutex;
+    ice_fs_cond cond;
+    unsigned long outstanding;          /* Directories queued or being visited */
+    unsigned long idle;                 /* Workers waiting for directories */
+    unsigned long seq;                  /* Increased each time directories are queued */
+    ice_fs_walk_worker *workers;
+    unsigned long workers_count;
+} ice_fs_walk;
+
+/* [INTERNAL] Marks walk as failed (Keeping errno of the first failure), And stops it if stop is ICE_FS_TRUE */
+static void ice_fs_walk_fail(ice_fs_walk *walk, ice_fs_bool stop) {
+    int error = errno;
+
+    ice_fs_mutex_lock(&walk->mutex);
+    if (walk->failed == ICE_FS_FALSE) walk->error = error;
+    walk->failed = ICE_FS_TRUE;
+
+    if (stop == ICE_FS_TRUE) {
+        walk->stop = ICE_FS_TRUE;
+        ice_fs_cond_broadcast(&walk->cond);
+    }
+
+    ice_fs_mutex_unlock(&walk->mutex);
+}
+
+/* [INTERNAL] Writes path of item of name in directory dir to dst (Which should have dir->path_len + name_len + 2 chars at least), Returns length of written path */
+static unsigned long ice_fs_walk_join(const ice_fs_walk_dir *dir, const char *name, unsigned long name_len, char *dst) {
+    unsigned long i, len = dir->path_len;
+
+    for (i = 0; i < len; i++) dst[i] = dir->path[i];
+
+    if ((len > 0) && (dst[len - 1] != '/') && (dst[len - 1] != '\\')) {
+#if defined(ICE_FS_MICROSOFT)
+        dst[len++] = '\\';
+#else
+        dst[len++] = '/';
+#endif
+    }
+
+    for (i = 0; i < name_len; i++) dst[len + i] = name[i];
+    len += name_len;
+    dst[len] = 0;
+
+    return len;
+}
+
+/* [INTERNAL] Allocates directory of name in parent (Or directory in path name if parent is NULL), Returns pointer on allocation success or NULL on allocation failure */
+static ice_fs_walk_dir* ice_fs_walk_dir_new(ice_fs_walk_dir *parent, const char *name, unsigned long name_len) {
+    unsigned long alloc_size = (((parent != 0) ? parent->path_len : 0) + name_len + 2);
+    ice_fs_walk_dir *dir = ICE_FS_MALLOC(sizeof(ice_fs_walk_dir) + (alloc_size * sizeof(char)));
+
+    if (dir == 0) return 0;
+
+    dir->path = (char*)(dir + 1);
+    dir->parent = parent;
+    dir->depth = ((parent != 0) ? (parent->depth + 1) : 0);
+    dir->pending = 1;
+    dir->fd = -1;
+    dir->data = 0;
+
+    if (parent != 0) {
+        dir->path_len = ice_fs_walk_join(parent, name, name_len, dir->path);
+    } else {
+        unsigned long i;
+        for (i = 0; i < name_len; i++) dir->path[i] = name[i];
+        dir->path[name_len] = 0;
+        dir->path_len = name_len;
+    }
+
+    dir->name = (dir->path + (dir->path_len - name_len));
+
+    return dir;
+}
+
+/* [INTERNAL] Frees directory with its data (And closes its fd) */
+static void ice_fs_walk_dir_free(ice_fs_walk_dir *dir) {
+#if defined(ICE_FS_UNIX)
+    if (dir->fd != -1) (void) close(dir->fd);
+#endif
+    if (dir->data != 0) ICE_FS_FREE(dir->data);
+    ICE_FS_FREE(dir);
+}
+
+/* [INTERNAL] Returns type of item of directory dir being walked, Symbolic links (Which the walker reports as files without following them) are followed to type of their target (ICE_FS_OBJECT_TYPE_NONE if they're dangling) for callbacks that treat links to directories like directories */
+static ice_fs_object_type ice_fs_walk_target_type(const ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link) {
+#if defined(ICE_FS_UNIX)
+    struct stat info;
+
+    if (is_link == ICE_FS_FALSE) return item->type;
+
+    if (fstatat(dir->fd, item->name, &info, 0) == -1) return ICE_FS_OBJECT_TYPE_NONE;
+    return ((info.st_mode & S_IFMT) == S_IFDIR) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE;
+#else
+    /* Links to directories already have directory attribute on Windows */
+    (void) dir;
+    (void) is_link;
+
+    return item->type;
+#endif
+}
+
+/* [INTERNAL] Pushes directory to tail of deque, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_walk_deque_push(ice_fs_walk_deque *deque, ice_fs_walk_dir *dir) {
+    ice_fs_bool res = ICE_FS_TRUE;
+
+    ice_fs_mutex_lock(&deque->mutex);
+
+    if (deque->tail == deque->capacity) {
+        if (deque->head > 0) {
+            unsigned long i, count = (deque->tail - deque->head);
+            for (i = 0; i < count; i++) deque->dirs[i] = deque->dirs[deque->head + i];
+            deque->head = 0;
+            deque->tail = count;
+        } else {
+            unsigned long capacity = ((deque->capacity == 0) ? 64 : (deque->capacity * 2));
+            ice_fs_walk_dir **dirs = ICE_FS_REALLOC(deque->dirs, capacity * sizeof(ice_fs_walk_dir*));
+
+            if (dirs == 0) {
+                res = ICE_FS_FALSE;
+            } else {
+                deque->dirs = dirs;
+                deque->capacity = capacity;
+            }
+        }
+    }
+
+    if (res == ICE_FS_TRUE) deque->dirs[deque->tail++] = dir;
+
+    ice_fs_mutex_unlock(&deque->mutex);
+
+    return res;
+}
+
+/* [INTERNAL] Pops directory from tail (If steal is ICE_FS_FALSE) or head (If steal is ICE_FS_TRUE) of deque, Returns NULL if deque is empty */
+static ice_fs_walk_dir* ice_fs_walk_deque_pop(ice_fs_walk_deque *deque, ice_fs_bool steal) {
+    ice_fs_walk_dir *dir = 0;
+
+    ice_fs_mutex_lock(&deque->mutex);
+
+    if (deque->tail > deque->head) {
+        dir = ((steal == ICE_FS_TRUE) ? deque->dirs[deque->head++] : deque->dirs[--deque->tail]);
+        if (deque->head == deque->tail) deque->head = deque->tail = 0;
+    }
+
+    ice_fs_mutex_unlock(&deque->mutex);
+
+    return dir;
+}
+
+/* [INTERNAL] Finishes one pending reference of directory, Calls on_leave (If call_leave is ICE_FS_TRUE) and frees it and its parents once nothing is pending in them */
+static void ice_fs_walk_release(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, ice_fs_bool call_leave) {
+    while (dir != 0) {
+        ice_fs_walk_dir *parent = dir->parent;
+        ice_fs_bool done;
+
+        ice_fs_mutex_lock(&walk->mutex);
+        dir->pending--;
+        done = ((dir->pending == 0) ? ICE_FS_TRUE : ICE_FS_FALSE);
+        ice_fs_mutex_unlock(&walk->mutex);
+
+        if (done == ICE_FS_FALSE) break;
+
+        if ((call_leave == ICE_FS_TRUE) && (walk->on_leave != 0)) walk->on_leave(walk, worker, dir);
+        ice_fs_walk_dir_free(dir);
+
+        dir = parent;
+    }
+}
+
+/* [INTERNAL] Visits items of directory and queues its subdirectories to the worker */
+static void ice_fs_walk_visit(ice_fs_walk_worker *worker, ice_fs_walk_dir *dir) {
+    ice_fs_walk *walk = worker->walk;
+    ice_fs_dir_iter iter;
+    ice_fs_object item;
+    ice_fs_bool is_link, opened = ICE_FS_FALSE, queued = ICE_FS_TRUE;
+    unsigned long i;
+
+    worker->children_count = 0;
+
+#if defined(ICE_FS_MICROSOFT)
+    opened = ice_fs_dir_iter_open(&iter, dir->path, worker->buf, ICE_FS_DIR_ITER_BUFFER_SIZE);
+#elif defined(ICE_FS_UNIX)
+    /* Subdirectories are opened relative to their parent without following links and are never looked up by full path again, So symbolic link swapped in for one of them can't redirect the walk (Or ice_fs_remove_all) outside of the tree */
+    if (dir->parent != 0) dir->fd = openat(dir->parent->fd, dir->name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    else dir->fd = openat(AT_FDCWD, dir->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+    /* Iterator gets its own fd as it closes it, While dir->fd stays open for subdirectories (Buffer of worker is always big enough for ice_fs_dir_iter_init) */
+    if ((dir->fd != -1) && (ice_fs_dir_iter_init(&iter, worker->buf, ICE_FS_DIR_ITER_BUFFER_SIZE) == ICE_FS_TRUE)) {
+        int fd = fcntl(dir->fd, F_DUPFD_CLOEXEC, 0);
+        if (fd != -1) opened = ice_fs_dir_iter_attach(&iter, fd);
+    }
+#endif
+
+    if (opened == ICE_FS_TRUE) {
+        /* stop is only read under mutex of the walk when worker takes its next directory, So stopped walk still finishes the directory being visited (Without locking the mutex for each item) */
+        while (ice_fs_dir_iter_read(&iter, &item, &is_link) == ICE_FS_TRUE) {
+            ice_fs_bool descend = walk->on_item(walk, worker->idx, dir, &item, is_link);
+            ice_fs_walk_dir *child;
+
+            /* Symbolic links are reported but never followed, So link cycles can't trap the walk */
+            if ((descend == ICE_FS_FALSE) || (item.type != ICE_FS_OBJECT_TYPE_DIR) || (is_link == ICE_FS_TRUE)) continue;
+
+            if (worker->children_count == worker->children_capacity) {
+                unsigned long capacity = ((worker->children_capacity == 0) ? 64 : (worker->children_capacity * 2));
+                ice_fs_walk_dir **children = ICE_FS_REALLOC(worker->children, capacity * sizeof(ice_fs_walk_dir*));
+
+                if (children == 0) {
+                    ice_fs_walk_fail(walk, ICE_FS_TRUE);
+                    break;
+                }
+
+                worker->children = children;
+                worker->children_capacity = capacity;
+            }
+
+            child = ice_fs_walk_dir_new(dir, item.name, ice_fs_str_len(item.name));
+
+            if (child == 0) {
+                ice_fs_walk_fail(walk, ICE_FS_TRUE);
+                break;
+            }
+
+            worker->children[worker->children_count++] = child;
+        }
+
+        /* Directory that failed midway isn't passed off as fully read one, Which matters most to ice_fs_remove_all */
+        if (iter.error != 0) {
+            errno = iter.error;
+            ice_fs_walk_fail(walk, ICE_FS_TRUE);
+        }
+
+        (void) ice_fs_dir_iter_close(&iter);
+    } else {
+        ice_fs_walk_fail(walk, ICE_FS_FALSE);
+    }
+
+    /* Account children before they become visible to other workers so the walk never looks finished early */
+    ice_fs_mutex_lock(&walk->mutex);
+
+    walk->outstanding += worker->children_count;
+    walk->outstanding--;
+    dir->pending += worker->children_count;
+
+    for (i = 0; i < worker->children_count; i++) {
+        if (queued == ICE_FS_TRUE) queued = ice_fs_walk_deque_push(&worker->deque, worker->children[i]);
+
+        if (queued == ICE_FS_FALSE) {
+            walk->outstanding--;
+            dir->pending--;
+            if (walk->failed == ICE_FS_FALSE) walk->error = ENOMEM;
+            walk->failed = ICE_FS_TRUE;
+            walk->stop = ICE_FS_TRUE;
+            ice_fs_walk_dir_free(worker->children[i]);
+        }
+    }
+
+    if (worker->children_count > 0) walk->seq++;
+    if ((walk->idle > 0) && ((worker->children_count > 0) || (walk->outstanding == 0) || (walk->stop == ICE_FS_TRUE))) ice_fs_cond_broadcast(&walk->cond);
+
+    ice_fs_mutex_unlock(&walk->mutex);
+
+    ice_fs_walk_release(walk, worker->idx, dir, ICE_FS_TRUE);
+}
+
+/* [INTERNAL] Main loop of walk worker, Visits directories from own deque or steals them from other workers till the walk is done */
+static void ice_fs_walk_worker_main(void *arg) {
+    ice_fs_walk_worker *worker = (ice_fs_walk_worker*) arg;
+    ice_fs_walk *walk = worker->walk;
+
+    for (;;) {
+        ice_fs_walk_dir *dir;
+        unsigned long seen, i;
+        ice_fs_bool done;
+
+        ice_fs_mutex_lock(&walk->mutex);
+        seen = walk->seq;
+        done = (((walk->outstanding == 0) || (walk->stop == ICE_FS_TRUE)) ? ICE_FS_TRUE : ICE_FS_FALSE);
+        ice_fs_mutex_unlock(&walk->mutex);
+
+        if (done == ICE_FS_TRUE) break;
+
+        dir = ice_fs_walk_deque_pop(&worker->deque, ICE_FS_FALSE);
+
+        for (i = 1; (dir == 0) && (i < walk->workers_count); i++) {
+            dir = ice_fs_walk_deque_pop(&walk->workers[(worker->idx + i) % walk->workers_count].deque, ICE_FS_TRUE);
+        }
+
+        if (dir != 0) {
+            ice_fs_walk_visit(worker, dir);
+            continue;
+        }
+
+        ice_fs_mutex_lock(&walk->mutex);
+
+        while ((walk->seq == seen) && (walk->outstanding > 0) && (walk->stop == ICE_FS_FALSE)) {
+            walk->idle++;
+            ice_fs_cond_wait(&walk->cond, &walk->mutex);
+            walk->idle--;
+        }
+
+        ice_fs_mutex_unlock(&walk->mutex);
+    }
+}
+
+/* [INTERNAL] Walks tree of directory in path with threads_count workers (Calling thread is one of them), on_item and user fields of walk should be set before, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if walk failed */
+static ice_fs_bool ice_fs_walk_run(ice_fs_walk *walk, const char *path, unsigned long threads_count) {
+    ice_fs_walk_dir *root;
+    unsigned long i;
+
+    if ((walk == 0) || (path == 0) || (walk->on_item == 0)) return ICE_FS_FALSE;
+    if (threads_count == 0) threads_count = 1;
+
+    walk->failed = ICE_FS_FALSE;
+    walk->stop = ICE_FS_FALSE;
+    walk->error = 0;
+    walk->outstanding = 1;
+    walk->idle = 0;
+    walk->seq = 0;
+
+    walk->workers = ICE_FS_CALLOC(threads_count, sizeof(ice_fs_walk_worker));
+    if (walk->workers == 0) return ICE_FS_FALSE;
+    walk->workers_count = threads_count;
+
+    root = ice_fs_walk_dir_new(0, path, ice_fs_str_len(path));
+    if (root == 0) {
+        ICE_FS_FREE(walk->workers);
+        return ICE_FS_FALSE;
+    }
+
+    ice_fs_mutex_init(&walk->mutex);
+    ice_fs_cond_init(&walk->cond);
+
+    for (i = 0; i < threads_count; i++) {
+        ice_fs_walk_worker *worker = &walk->workers[i];
+
+        worker->walk = walk;
+        worker->idx = i;
+        ice_fs_mutex_init(&worker->deque.mutex);
+
+        worker->buf = ICE_FS_MALLOC(ICE_FS_DIR_ITER_BUFFER_SIZE);
+        if (worker->buf == 0) walk->stop = ICE_FS_TRUE;
+    }
+
+    if ((walk->stop == ICE_FS_FALSE) && (ice_fs_walk_deque_push(&walk->workers[0].deque, root) == ICE_FS_TRUE)) {
+        for (i = 1; i < threads_count; i++) {
+            walk->workers[i].started = ice_fs_thread_start(&walk->workers[i].thread, ice_fs_walk_worker_main, &walk->workers[i]);
+        }
+
+        ice_fs_walk_worker_main(&walk->workers[0]);
+
+        for (i = 1; i < threads_count; i++) {
+            if (walk->workers[i].started == ICE_FS_TRUE) ice_fs_thread_join(&walk->workers[i].thread);
+        }
+    } else {
+        walk->failed = ICE_FS_TRUE;
+        walk->error = ENOMEM;
+        ice_fs_walk_dir_free(root);
+    }
+
+    for (i = 0; i < threads_count; i++) {
+        ice_fs_walk_worker *worker = &walk->workers[i];
+        ice_fs_walk_dir *dir;
+
+        /* Directories left when the walk was stopped */
+        while ((dir = ice_fs_walk_deque_pop(&worker->deque, ICE_FS_FALSE)) != 0) ice_fs_walk_release(walk, i, dir, ICE_FS_FALSE);
+
+        ice_fs_mutex_destroy(&worker->deque.mutex);
+        ICE_FS_FREE(worker->deque.dirs);
+        ICE_FS_FREE(worker->children);
+        ICE_FS_FREE(worker->buf);
+    }
+
+    ice_fs_cond_destroy(&walk->cond);
+    ice_fs_mutex_destroy(&walk->mutex);
+    ICE_FS_FREE(walk->workers);
+    walk->workers = 0;
+
+    return (walk->failed == ICE_FS_TRUE) ? ICE_FS_FALSE : ICE_FS_TRUE;
+}
+
+/* [INTERNAL] State shared by workers of ice_fs_dir_search */
+typedef struct ice_fs_dir_search_ctx {
+    const char *str;
+    ice_fs_mutex mutex;
+    ice_fs_str_arena arena;             /* Paths of found items */
+    char **found;                       /* Pointers into the arena */
+    unsigned long found_count, found_capacity;
+} ice_fs_dir_search_ctx;
+
+/* [INTERNAL] Adds path of item of name (Of name_len chars) in directory dir to found items of ctx, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure (walk is stopped then) */
+static ice_fs_bool ice_fs_dir_search_add(ice_fs_walk *walk, ice_fs_dir_search_ctx *ctx, const ice_fs_walk_dir *dir, const char *name, unsigned long name_len) {
+    char *found_path;
+
+    ice_fs_mutex_lock(&ctx->mutex);
+
+    if (ctx->found_count == ctx->found_capacity) {
+        unsigned long capacity = ((ctx->found_capacity == 0) ? 64 : (ctx->found_capacity * 2));
+        char **found = ICE_FS_REALLOC(ctx->found, capacity * sizeof(char*));
+
+        if (found == 0) goto failure;
+
+        ctx->found = found;
+        ctx->found_capacity = capacity;
+    }
+
+    found_path = ice_fs_str_arena_alloc(&ctx->arena, dir->path_len + name_len + 2);
+    if (found_path == 0) goto failure;
+
+    (void) ice_fs_walk_join(dir, name, name_len, found_path);
+    ctx->found[ctx->found_count++] = found_path;
+
+    ice_fs_mutex_unlock(&ctx->mutex);
+
+    return ICE_FS_TRUE;
+
+failure:
+    ice_fs_mutex_unlock(&ctx->mutex);
+    ice_fs_walk_fail(walk, ICE_FS_TRUE);
+
+    return ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Copies found items of ctx after walk to array of strings and stores number of them in results, Returns the array on success or NULL on failure (Or if nothing was found) */
+static char** ice_fs_dir_search_results(ice_fs_dir_search_ctx *ctx, const ice_fs_walk *walk, unsigned long *results) {
+    unsigned long i;
+    char **res;
+
+    /* Unreadable subdirectories are skipped like before, Only failed allocations or reads abort the search */
+    if ((walk->stop == ICE_FS_TRUE) || (ctx->found_count == 0)) return 0;
+
+    res = ICE_FS_MALLOC(ctx->found_count * sizeof(char*));
+    if (res == 0) return 0;
+
+    for (i = 0; i < ctx->found_count; i++) {
+        res[i] = ice_fs_str_copy(ctx->found[i]);
+
+        if (res[i] == 0) {
+            ice_fs_free_strarr(res, i);
+            return 0;
+        }
+    }
+
+    if (results != 0) *results = ctx->found_count;
+
+    return res;
+}
+
+static ice_fs_bool ice_fs_dir_search_item(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link) {
+    ice_fs_dir_search_ctx *ctx = (ice_fs_dir_search_ctx*) walk->user;
+
+    (void) worker;
+    (void) is_link;
+
+    if (ice_fs_str_matches(item->name, ctx->str, 0) == 0) return ICE_FS_TRUE;
+
+    return ice_fs_dir_search_add(walk, ctx, dir, item->name, ice_fs_str_len(item->name));
+}
+
+/* Searches in contents of directory and its subdirectories (In parallel) for a specific file/directory by string, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_dir_search(const char *path, const char *str, unsigned long *results) {
+    ice_fs_dir_search_ctx ctx;
+    ice_fs_walk walk;
+    char **res;
+
+    if (results != 0) *results = 0;
+    if ((path == 0) || (ice_fs_str_len(str) == 0)) return 0;
+
+    ctx.str = str;
+    ctx.arena.chunks = 0;
+    ctx.found = 0;
+    ctx.found_count = 0;
+    ctx.found_capacity = 0;
+    ice_fs_mutex_init(&ctx.mutex);
+
+    walk.on_item = ice_fs_dir_search_item;
+    walk.on_leave = 0;
+    walk.user = &ctx;
+
+    (void) ice_fs_walk_run(&walk, path, ice_fs_get_threads_count());
+    res = ice_fs_dir_search_results(&ctx, &walk, results);
+
+    ice_fs_mutex_destroy(&ctx.mutex);
+    ice_fs_str_arena_free(&ctx.arena);
+    ICE_FS_FREE(ctx.found);
+
+    return res;
+}
+
+/* ============================== Disk Usage ============================== */
+
+/* [INTERNAL] Sizes summed for directory by ice_fs_dir_usage (Attached to data of walked directory) */
+typedef struct ice_fs_usage_sum {
+    ice_fs_offset size, allocated;
+    unsigned long files_count;
+} ice_fs_usage_sum;
+
+/* [INTERNAL] Identity of file with more than one hard link (Unix only) */
+typedef struct ice_fs_usage_inode {
+#if defined(ICE_FS_UNIX)
+    dev_t dev;
+    ino_t ino;
+#endif
+    ice_fs_bool used;
+} ice_fs_usage_inode;
+
+/* [INTERNAL] State shared by workers of ice_fs_dir_usage */
+typedef struct ice_fs_usage_ctx {
+    ice_fs_mutex mutex;
+    unsigned long max_depth;
+    ice_fs_str_arena arena;                     /* Paths of entries */
+    ice_fs_usage *entries;                      /* Paths point into the arena */
+    unsigned long entries_count, entries_capacity;
+    ice_fs_usage_inode *inodes;                 /* Hash set of hard linked files that were counted */
+    unsigned long inodes_count, inodes_capacity;
+} ice_fs_usage_ctx;
+
+/* [INTERNAL] Returns sum attached to directory (Attaching new one that starts with size of the directory itself if there's none yet) or NULL on allocation failure */
+static ice_fs_usage_sum* ice_fs_usage_sum_of(ice_fs_walk_dir *dir) {
+    ice_fs_usage_sum *sum = (ice_fs_usage_sum*) dir->data;
+    struct stat info;
+    int stat_res;
+
+    if (sum != 0) return sum;
+
+    sum = ICE_FS_CALLOC(1, sizeof(ice_fs_usage_sum));
+    if (sum == 0) return 0;
+
+    dir->data = sum;
+
+#if defined(ICE_FS_MICROSOFT)
+    stat_res = stat(dir->path, &info);
+    if (stat_res == 0) sum->allocated = (ice_fs_offset) info.st_size;
+#elif defined(ICE_FS_UNIX)
+    /* Directory is stat'ed via its fd while its items are visited, Or via its path if it had none (Or couldn't be read) */
+    stat_res = ((dir->fd != -1) ? fstat(dir->fd, &info) : stat(dir->path, &info));
+    if (stat_res == 0) sum->allocated = (((ice_fs_offset) info.st_blocks) * 512);
+#endif
+
+    if (stat_res == 0) sum->size = (ice_fs_offset) info.st_size;
+
+    return sum;
+}
+
+#if defined(ICE_FS_UNIX)
+/* [INTERNAL] Adds hard linked file of dev and ino to counted ones of ctx, Returns ICE_FS_TRUE if it wasn't counted yet or ICE_FS_FALSE if it was (Or on allocation failure, errno is ENOMEM then) */
+static ice_fs_bool ice_fs_usage_first_link(ice_fs_usage_ctx *ctx, dev_t dev, ino_t ino) {
+    ice_fs_bool res = ICE_FS_FALSE;
+    unsigned long i;
+
+    ice_fs_mutex_lock(&ctx->mutex);
+
+    /* Set is kept at most half full, So probing always ends at unused slot */
+    if (((ctx->inodes_count + 1) * 2) > ctx->inodes_capacity) {
+        unsigned long capacity = ((ctx->inodes_capacity == 0) ? 256 : (ctx->inodes_capacity * 2));
+        ice_fs_usage_inode *inodes = ICE_FS_MALLOC(capacity * sizeof(ice_fs_usage_inode));
+
+        if (inodes == 0) {
+            errno = ENOMEM;
+            goto end;
+        }
+
+        for (i = 0; i < capacity; i++) inodes[i].used = ICE_FS_FALSE;
+
+        for (i = 0; i < ctx->inodes_capacity; i++) {
+            unsigned long j;
+
+            if (ctx->inodes[i].used == ICE_FS_FALSE) continue;
+
+            j = ((((unsigned long) ctx->inodes[i].ino) * 2654435761UL) ^ ((unsigned long) ctx->inodes[i].dev)) & (capacity - 1);
+            while (inodes[j].used == ICE_FS_TRUE) j = ((j + 1) & (capacity - 1));
+            inodes[j] = ctx->inodes[i];
+        }
+
+        ICE_FS_FREE(ctx->inodes);
+        ctx->inodes = inodes;
+        ctx->inodes_capacity = capacity;
+    }
+
+    i = ((((unsigned long) ino) * 2654435761UL) ^ ((unsigned long) dev)) & (ctx->inodes_capacity - 1);
+
+    while (ctx->inodes[i].used == ICE_FS_TRUE) {
+        if ((ctx->inodes[i].dev == dev) && (ctx->inodes[i].ino == ino)) goto end;
+        i = ((i + 1) & (ctx->inodes_capacity - 1));
+    }
+
+    ctx->inodes[i].dev = dev;
+    ctx->inodes[i].ino = ino;
+    ctx->inodes[i].used = ICE_FS_TRUE;
+    ctx->inodes_count++;
+    res = ICE_FS_TRUE;
+
+end:
+    ice_fs_mutex_unlock(&ctx->mutex);
+
+    return res;
+}
+#endif
+
+/* [INTERNAL] Adds sizes of item to sum of directory it's in (Items that can't be stat'ed are skipped), Descends into every directory */
+static ice_fs_bool ice_fs_usage_item(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link) {
+    ice_fs_usage_ctx *ctx = (ice_fs_usage_ctx*) walk->user;
+    ice_fs_usage_sum *sum = ice_fs_usage_sum_of(dir);
+    struct stat info;
+
+    (void) worker;
+    (void) is_link;
+
+    if (sum == 0) {
+        ice_fs_walk_fail(walk, ICE_FS_TRUE);
+        return ICE_FS_FALSE;
+    }
+
+#if defined(ICE_FS_MICROSOFT)
+    (void) ctx;
+
+    {
+        unsigned long name_len = ice_fs_str_len(item->name);
+        char *item_path = ICE_FS_MALLOC((dir->path_len + name_len + 2) * sizeof(char));
+        int stat_res;
+
+        if (item_path == 0) {
+            ice_fs_walk_fail(walk, ICE_FS_TRUE);
+            return ICE_FS_FALSE;
+        }
+
+        (void) ice_fs_walk_join(dir, item->name, name_len, item_path);
+        stat_res = stat(item_path, &info);
+        ICE_FS_FREE(item_path);
+
+        if (stat_res == -1) return ICE_FS_TRUE;
+    }
+
+    if ((info.st_mode & S_IFMT) != S_IFDIR) {
+        sum->size += (ice_fs_offset) info.st_size;
+        sum->allocated += (ice_fs_offset) info.st_size;
+    }
+#elif defined(ICE_FS_UNIX)
+    /* Items removed meanwhile are skipped, Subdirectories add their own size once they're visited */
+    if (fstatat(dir->fd, item->name, &info, AT_SYMLINK_NOFOLLOW) == -1) return ICE_FS_TRUE;
+
+    if (S_ISDIR(info.st_mode)) {
+        sum->files_count++;
+        return ICE_FS_TRUE;
+    }
+
+    /* Hard linked file is counted only in first directory it's found in */
+    if ((info.st_nlink > 1) && (ice_fs_usage_first_link(ctx, info.st_dev, info.st_ino) == ICE_FS_FALSE)) {
+        if (errno == ENOMEM) {
+            ice_fs_walk_fail(walk, ICE_FS_TRUE);
+            return ICE_FS_FALSE;
+        }
+
+        return ICE_FS_TRUE;
+    }
+
+    sum->size += (ice_fs_offset) info.st_size;
+    sum->allocated += (((ice_fs_offset) info.st_blocks) * 512);
+#endif
+
+    sum->files_count++;
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Adds sum of directory (Complete once all of its subdirectories left) to its parent and records it as entry if it isn't deeper than max depth */
+static void ice_fs_usage_leave(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir) {
+    ice_fs_usage_ctx *ctx = (ice_fs_usage_ctx*) walk->user;
+    ice_fs_usage_sum *sum = ice_fs_usage_sum_of(dir);
+
+    (void) worker;
+
+    if (sum == 0) {
+        ice_fs_walk_fail(walk, ICE_FS_TRUE);
+        return;
+    }
+
+    ice_fs_mutex_lock(&ctx->mutex);
+
+    if (dir->parent != 0) {
+        ice_fs_usage_sum *parent_sum = (ice_fs_usage_sum*) dir->parent->data;
+
+        /* Parent got its sum when its items (This directory among them) were visited */
+        if (parent_sum != 0) {
+            parent_sum->size += sum->size;
+            parent_sum->allocated += sum->allocated;
+            parent_sum->files_count += sum->files_count;
+        }
+    }
+
+    if (dir->depth <= ctx->max_depth) {
+        ice_fs_usage *entry;
+        char *path;
+
+        if (ctx->entries_count == ctx->entries_capacity) {
+            unsigned long capacity = ((ctx->entries_capacity == 0) ? 64 : (ctx->entries_capacity * 2));
+            ice_fs_usage *entries = ICE_FS_REALLOC(ctx->entries, capacity * sizeof(ice_fs_usage));
+
+            if (entries == 0) goto failure;
+
+            ctx->entries = entries;
+            ctx->entries_capacity = capacity;
+        }
+
+        path = ice_fs_str_arena_alloc(&ctx->arena, dir->path_len + 1);
+        if (path == 0) goto failure;
+
+        memcpy(path, dir->path, dir->path_len + 1);
+
+        entry = &ctx->entries[ctx->entries_count++];
+        entry->path = path;
+        entry->size = sum->size;
+        entry->allocated = sum->allocated;
+        entry->files_count = sum->files_count;
+        entry->depth = dir->depth;
+    }
+
+    ice_fs_mutex_unlock(&ctx->mutex);
+
+    return;
+
+failure:
+    ice_fs_mutex_unlock(&ctx->mutex);
+    ice_fs_walk_fail(walk, ICE_FS_TRUE);
+}
+
+/* [INTERNAL] Orders entries of disk usage by path */
+static int ice_fs_usage_cmp_path(const void *a, const void *b) {
+    return strcmp(((const ice_fs_usage*) a)->path, ((const ice_fs_usage*) b)->path);
+}
+
+/* Sums sizes of everything in directory in path and its subdirectories (In parallel, Each item is stat'ed once relative to its directory, Symbolic links are counted but never followed, Hard linked files are counted once), Returns array of entries for the directory and its subdirectories up to max_depth levels below it (0 for the directory alone) sorted by path on allocation success or NULL on failure, entries_count should be pointer to unsigned long integer that stores number of the entries, Subdirectories that can't be read count as empty */
+ICE_FS_API ice_fs_usage* ICE_FS_CALLCONV ice_fs_dir_usage(const char *path, unsigned long max_depth, unsigned long *entries_count) {
+    ice_fs_usage_ctx ctx;
+    ice_fs_usage *res = 0;
+    unsigned long paths_len = 0, i;
+    struct stat info;
+    ice_fs_walk walk;
+    char *paths;
+
+    if (entries_count != 0) *entries_count = 0;
+    if ((path == 0) || (entries_count == 0)) return 0;
+
+    if (stat(path, &info) == -1) return 0;
+
+    ctx.max_depth = max_depth;
+    ctx.arena.chunks = 0;
+    ctx.entries = 0;
+    ctx.entries_count = 0;
+    ctx.entries_capacity = 0;
+    ctx.inodes = 0;
+    ctx.inodes_count = 0;
+    ctx.inodes_capacity = 0;
+    ice_fs_mutex_init(&ctx.mutex);
+
+    walk.on_item = ice_fs_usage_item;
+    walk.on_leave = ice_fs_usage_leave;
+    walk.user = &ctx;
+
+    /* Unreadable subdirectories are skipped like du does, Only failed allocations or reads abort */
+    (void) ice_fs_walk_run(&walk, path, ice_fs_get_threads_count());
+    if ((walk.stop == ICE_FS_TRUE) || (ctx.entries_count == 0)) goto end;
+
+    qsort(ctx.entries, ctx.entries_count, sizeof(ice_fs_usage), ice_fs_usage_cmp_path);
+
+    for (i = 0; i < ctx.entries_count; i++) paths_len += (ice_fs_str_len(ctx.entries[i].path) + 1);
+
+    /* Entries and their paths share one allocation, So ice_fs_free_dir_usage frees them at once */
+    res = ICE_FS_MALLOC((ctx.entries_count * sizeof(ice_fs_usage)) + (paths_len * sizeof(char)));
+    if (res == 0) goto end;
+
+    paths = (char*)(res + ctx.entries_count);
+
+    for (i = 0; i < ctx.entries_count; i++) {
+        unsigned long len = (ice_fs_str_len(ctx.entries[i].path) + 1);
+
+        res[i] = ctx.entries[i];
+        res[i].path = paths;
+
+        memcpy(paths, ctx.entries[i].path, len);
+        paths += len;
+    }
+
+    *entries_count = ctx.entries_count;
+
+end:
+    ice_fs_mutex_destroy(&ctx.mutex);
+    ice_fs_str_arena_free(&ctx.arena);
+    ICE_FS_FREE(ctx.entries);
+    ICE_FS_FREE(ctx.inodes);
+
+    return res;
+}
+
+/* Frees array of entries returned by ice_fs_dir_usage */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_dir_usage(ice_fs_usage *entries) {
+    ICE_FS_FREE(entries);
+}
+
+/* ============================== Globbing ============================== */
+
+/* [INTERNAL] Kinds of segments of compiled glob */
+#define ICE_FS_GLOB_SEG_END 0           /* End of rule, Path matches the rule once it gets here */
+#define ICE_FS_GLOB_SEG_LITERAL 1       /* Name without wildcards */
+#define ICE_FS_GLOB_SEG_PATTERN 2       /* Name with wildcards (*, ?, [...]) */
+#define ICE_FS_GLOB_SEG_GLOBSTAR 3      /* ** that matches zero or more names */
+
+/* [INTERNAL] Flags of rules of compiled glob (Kept in their END segments) */
+#define ICE_FS_GLOB_RULE_DIR 1          /* Matches directories only (Pattern ends with slash) */
+#define ICE_FS_GLOB_RULE_NEGATE 2       /* Re-includes objects that earlier exclude rules excluded (Pattern starts with !) */
+
+/* [INTERNAL] Largest number of alternatives that brace expansion of one pattern can produce */
+#define ICE_FS_GLOB_MAX_ALTERNATIVES 1024
+
+/* [INTERNAL] Segment of compiled glob, Matches one name of path */
+typedef struct ice_fs_glob_seg {
+    const char *str;                    /* Pattern of the name (Not NUL-terminated) */
+    unsigned long len;
+    unsigned kind;
+    unsigned flags;                     /* Flags of the rule (END segments only) */
+} ice_fs_glob_seg;
+
+/* [INTERNAL] Rules compiled to segments (Each rule ends with END segment), Matched as NFA whose states are indices of segments */
+typedef struct ice_fs_glob_nfa {
+    ice_fs_glob_seg *segs;
+    unsigned long segs_count, segs_capacity;
+} ice_fs_glob_nfa;
+
+/* [INTERNAL] Compiled glob */
+typedef struct ice_fs_glob_state {
+    ice_fs_glob_nfa include;            /* Rules that objects should match */
+    ice_fs_glob_nfa exclude;            /* Rules of ignored objects (Last matching rule decides) */
+    ice_fs_str_arena arena;             /* Text of the segments */
+} ice_fs_glob_state;
+
+/* [INTERNAL] Returns char c folded for comparison (Names are case-insensitive on Windows) */
+static char ice_fs_glob_fold(char c) {
+#if defined(ICE_FS_MICROSOFT)
+    if ((c >= 'A') && (c <= 'Z')) return (char) (c - 'A' + 'a');
+#endif
+    return c;
+}
+
+/* [INTERNAL] Returns ICE_FS_TRUE if char c matches single-char pattern at pat[p] (?, [...], \ escape or literal char) and stores index after it in next, Or ICE_FS_FALSE if not */
+static ice_fs_bool ice_fs_glob_match_char(const char *pat, unsigned long pat_len, unsigned long p, char c, unsigned long *next) {
+    if (pat[p] == '?') {
+        *next = p + 1;
+        return ICE_FS_TRUE;
+    }
+
+    if (pat[p] == '[') {
+        unsigned long i = p + 1;
+        ice_fs_bool negate = ICE_FS_FALSE, found = ICE_FS_FALSE;
+
+        if ((i < pat_len) && ((pat[i] == '!') || (pat[i] == '^'))) {
+            negate = ICE_FS_TRUE;
+            i++;
+        }
+
+        /* ] right after [ is part of the class */
+        do {
+            char lo, hi;
+
+            if (i >= pat_len) break;
+
+            if ((pat[i] == '\\') && ((i + 1) < pat_len)) i++;
+            lo = hi = pat[i++];
+
+            if (((i + 1) < pat_len) && (pat[i] == '-') && (pat[i + 1] != ']')) {
+                i++;
+                if ((pat[i] == '\\') && ((i + 1) < pat_len)) i++;
+                hi = pat[i++];
+            }
+
+            if (((c >= lo) && (c <= hi)) || ((ice_fs_glob_fold(c) >= ice_fs_glob_fold(lo)) && (ice_fs_glob_fold(c) <= ice_fs_glob_fold(hi)))) found = ICE_FS_TRUE;
+        } while ((i < pat_len) && (pat[i] != ']'));
+
+        /* [ without closing ] is literal char */
+        if (i < pat_len) {
+            *next = i + 1;
+            return (found != negate) ? ICE_FS_TRUE : ICE_FS_FALSE;
+        }
+    }
+
+    if ((pat[p] == '\\') && ((p + 1) < pat_len)) p++;
+
+    *next = p + 1;
+    return (ice_fs_glob_fold(pat[p]) == ice_fs_glob_fold(c)) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Returns ICE_FS_TRUE if name of name_len chars matches pattern pat of pat_len chars (*, ?, [...] and \ escapes), Or ICE_FS_FALSE if not */
+static ice_fs_bool ice_fs_glob_match_name(const char *pat, unsigned long pat_len, const char *name, unsigned long name_len) {
+    unsigned long p = 0, n = 0, star_p = 0, star_n = 0, next;
+    ice_fs_bool star = ICE_FS_FALSE;
+
+    while (n < name_len) {
+        if ((p < pat_len) && (pat[p] == '*')) {
+            star = ICE_FS_TRUE;
+            star_p = ++p;
+            star_n = n;
+            continue;
+        }
+
+        if ((p < pat_len) && (ice_fs_glob_match_char(pat, pat_len, p, name[n], &next) == ICE_FS_TRUE)) {
+            p = next;
+            n++;
+            continue;
+        }
+
+        /* Last * takes one more char, Earlier ones never need to be retried */
+        if (star == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+        p = star_p;
+        n = ++star_n;
+    }
+
+    while ((p < pat_len) && (pat[p] == '*')) p++;
+
+    return (p == pat_len) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Appends segment to nfa, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_glob_push(ice_fs_glob_nfa *nfa, const char *str, unsigned long len, unsigned kind, unsigned flags) {
+    if (nfa->segs_count == nfa->segs_capacity) {
+        unsigned long capacity = ((nfa->segs_capacity == 0) ? 16 : (nfa->segs_capacity * 2));
+        ice_fs_glob_seg *segs = ICE_FS_REALLOC(nfa->segs, capacity * sizeof(ice_fs_glob_seg));
+
+        if (segs == 0) return ICE_FS_FALSE;
+
+        nfa->segs = segs;
+        nfa->segs_capacity = capacity;
+    }
+
+    nfa->segs[nfa->segs_count].str = str;
+    nfa->segs[nfa->segs_count].len = len;
+    nfa->segs[nfa->segs_count].kind = kind;
+    nfa->segs[nfa->segs_count].flags = flags;
+    nfa->segs_count++;
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Compiles pattern of len chars (Without braces) to rule of nfa, Pattern without slash matches name at any depth if anywhere is ICE_FS_TRUE (Like in .gitignore), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_glob_add_rule(ice_fs_glob_state *state, ice_fs_glob_nfa *nfa, const char *pattern, unsigned long len, unsigned flags, ice_fs_bool anywhere) {
+    unsigned long start = nfa->segs_count, i = 0, j;
+    ice_fs_bool anchored = ICE_FS_FALSE;
+    char *str;
+
+    if ((len > 0) && (pattern[len - 1] == '/')) {
+        flags |= ICE_FS_GLOB_RULE_DIR;
+        while ((len > 0) && (pattern[len - 1] == '/')) len--;
+    }
+
+    while ((len >= 2) && (pattern[0] == '.') && (pattern[1] == '/')) {
+        pattern += 2;
+        len -= 2;
+        anchored = ICE_FS_TRUE;
+    }
+
+    if ((len > 0) && (pattern[0] == '/')) anchored = ICE_FS_TRUE;
+
+    for (j = 0; (j < len) && (anchored == ICE_FS_FALSE); j++) {
+        if (pattern[j] == '/') anchored = ICE_FS_TRUE;
+    }
+
+    str = ice_fs_str_arena_alloc(&state->arena, len + 1);
+    if (str == 0) return ICE_FS_FALSE;
+
+    for (j = 0; j < len; j++) str[j] = pattern[j];
+    str[len] = 0;
+
+    if ((anywhere == ICE_FS_TRUE) && (anchored == ICE_FS_FALSE)) {
+        if (ice_fs_glob_push(nfa, 0, 0, ICE_FS_GLOB_SEG_GLOBSTAR, 0) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    }
+
+    while (i < len) {
+        unsigned kind = ICE_FS_GLOB_SEG_LITERAL;
+
+        if (str[i] == '/') {
+            i++;
+            continue;
+        }
+
+        for (j = i; (j < len) && (str[j] != '/'); j++) {
+            if ((str[j] == '*') || (str[j] == '?') || (str[j] == '[') || (str[j] == '\\')) kind = ICE_FS_GLOB_SEG_PATTERN;
+        }
+
+        if (((j - i) == 2) && (str[i] == '*') && (str[i + 1] == '*')) kind = ICE_FS_GLOB_SEG_GLOBSTAR;
+
+        /* Consecutive ** are same as one */
+        if ((kind != ICE_FS_GLOB_SEG_GLOBSTAR) || (nfa->segs_count == start) || (nfa->segs[nfa->segs_count - 1].kind != ICE_FS_GLOB_SEG_GLOBSTAR)) {
+            if (ice_fs_glob_push(nfa, str + i, j - i, kind, 0) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        }
+
+        i = j;
+    }
+
+    /* Empty pattern matches nothing */
+    if (nfa->segs_count == start) return ICE_FS_TRUE;
+
+    return ice_fs_glob_push(nfa, 0, 0, ICE_FS_GLOB_SEG_END, flags);
+}
+
+/* [INTERNAL] Expands brace alternation of pattern of len chars ({a,b} becomes a and b) and compiles each alternative to rule of nfa, budget is number of alternatives left, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_glob_expand(ice_fs_glob_state *state, ice_fs_glob_nfa *nfa, const char *pattern, unsigned long len, unsigned flags, ice_fs_bool anywhere, unsigned long *budget) {
+    unsigned long open, close = 0, i, depth, commas;
+    ice_fs_bool res = ICE_FS_TRUE;
+    char *buf;
+
+    /* Finds first {...} that has comma at its top level, Other braces are literal */
+    for (open = 0; open < len; open++) {
+        if (pattern[open] == '\\') {
+            open++;
+            continue;
+        }
+
+        if (pattern[open] != '{') continue;
+
+        depth = 0;
+        commas = 0;
+
+        for (close = open; close < len; close++) {
+            if (pattern[close] == '\\') close++;
+            else if (pattern[close] == '{') depth++;
+            else if ((pattern[close] == ',') && (depth == 1)) commas++;
+            else if ((pattern[close] == '}') && (--depth == 0)) break;
+        }
+
+        if ((close < len) && (commas > 0)) break;
+    }
+
+    if (open >= len) {
+        if (*budget == 0) {
+            errno = E2BIG;
+            return ICE_FS_FALSE;
+        }
+
+        (*budget)--;
+        return ice_fs_glob_add_rule(state, nfa, pattern, len, flags, anywhere);
+    }
+
+    buf = ICE_FS_MALLOC(len);
+    if (buf == 0) return ICE_FS_FALSE;
+
+    for (i = 0; i < open; i++) buf[i] = pattern[i];
+
+    depth = 0;
+
+    for (i = open + 1; (i <= close) && (res == ICE_FS_TRUE); i++) {
+        unsigned long alt = i, alt_len, j;
+
+        /* Finds end of this alternative */
+        for (; i < close; i++) {
+            if (pattern[i] == '\\') i++;
+            else if (pattern[i] == '{') depth++;
+            else if (pattern[i] == '}') depth--;
+            else if ((pattern[i] == ',') && (depth == 0)) break;
+        }
+
+        if (i > close) i = close;
+        alt_len = i - alt;
+
+        for (j = 0; j < alt_len; j++) buf[open + j] = pattern[alt + j];
+        for (j = close + 1; j < len; j++) buf[open + alt_len + (j - close - 1)] = pattern[j];
+
+        res = ice_fs_glob_expand(state, nfa, buf, open + alt_len + (len - close - 1), flags, anywhere, budget);
+    }
+
+    ICE_FS_FREE(buf);
+
+    return res;
+}
+
+/* [INTERNAL] Adds states reachable from state (Including states after ** since it can match no names) to set of count states if they aren't in it yet (marks[s] == gen), Returns new count */
+static unsigned long ice_fs_glob_add_state(const ice_fs_glob_nfa *nfa, unsigned long *set, unsigned long count, unsigned long *marks, unsigned long gen, unsigned long state) {
+    while (marks[state] != gen) {
+        marks[state] = gen;
+        set[count++] = state;
+
+        if (nfa->segs[state].kind != ICE_FS_GLOB_SEG_GLOBSTAR) break;
+        state++;
+    }
+
+    return count;
+}
+
+/* [INTERNAL] Stores initial states of nfa (First segment of each rule) in set, Returns number of them */
+static unsigned long ice_fs_glob_begin(const ice_fs_glob_nfa *nfa, unsigned long *set, unsigned long *marks, unsigned long gen) {
+    unsigned long count = 0, i;
+
+    for (i = 0; i < nfa->segs_count; i++) {
+        if ((i == 0) || (nfa->segs[i - 1].kind == ICE_FS_GLOB_SEG_END)) count = ice_fs_glob_add_state(nfa, set, count, marks, gen, i);
+    }
+
+    return count;
+}
+
+/* [INTERNAL] Stores states that from_count states in from reach after name of name_len chars in to, Returns number of them */
+static unsigned long ice_fs_glob_step(const ice_fs_glob_nfa *nfa, const unsigned long *from, unsigned long from_count, const char *name, unsigned long name_len, unsigned long *to, unsigned long *marks, unsigned long gen) {
+    unsigned long count = 0, i, j;
+
+    for (i = 0; i < from_count; i++) {
+        const ice_fs_glob_seg *seg = &nfa->segs[from[i]];
+        ice_fs_bool matched = ICE_FS_FALSE;
+
+        if (seg->kind == ICE_FS_GLOB_SEG_GLOBSTAR) {
+            count = ice_fs_glob_add_state(nfa, to, count, marks, gen, from[i]);
+            continue;
+        }
+
+        if ((seg->kind == ICE_FS_GLOB_SEG_LITERAL) && (seg->len == name_len)) {
+            for (j = 0; (j < name_len) && (ice_fs_glob_fold(seg->str[j]) == ice_fs_glob_fold(name[j])); j++);
+            matched = ((j == name_len) ? ICE_FS_TRUE : ICE_FS_FALSE);
+        } else if (seg->kind == ICE_FS_GLOB_SEG_PATTERN) {
+            matched = ice_fs_glob_match_name(seg->str, seg->len, name, name_len);
+        }
+
+        if (matched == ICE_FS_TRUE) count = ice_fs_glob_add_state(nfa, to, count, marks, gen, from[i] + 1);
+    }
+
+    return count;
+}
+
+/* [INTERNAL] Returns END segment of last rule that accepts object in set of count states (is_dir is ICE_FS_TRUE for directories), Or NULL if no rule accepts it */
+static const ice_fs_glob_seg* ice_fs_glob_accepts(const ice_fs_glob_nfa *nfa, const unsigned long *set, unsigned long count, ice_fs_bool is_dir) {
+    const ice_fs_glob_seg *res = 0;
+    unsigned long i;
+
+    for (i = 0; i < count; i++) {
+        const ice_fs_glob_seg *seg = &nfa->segs[set[i]];
+
+        if ((seg->kind != ICE_FS_GLOB_SEG_END) || (((seg->flags & ICE_FS_GLOB_RULE_DIR) != 0) && (is_dir == ICE_FS_FALSE))) continue;
+        if ((res == 0) || (seg > res)) res = seg;
+    }
+
+    return res;
+}
+
+/* [INTERNAL] Returns ICE_FS_TRUE if set of count states can still reach end of any rule (So objects under directory of the set may match), Or ICE_FS_FALSE if not */
+static ice_fs_bool ice_fs_glob_alive(const ice_fs_glob_nfa *nfa, const unsigned long *set, unsigned long count) {
+    unsigned long i;
+
+    for (i = 0; i < count; i++) {
+        if (nfa->segs[set[i]].kind != ICE_FS_GLOB_SEG_END) return ICE_FS_TRUE;
+    }
+
+    return ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Returns ICE_FS_TRUE if set of count states of exclude rules excludes object (is_dir is ICE_FS_TRUE for directories), Or ICE_FS_FALSE if not */
+static ice_fs_bool ice_fs_glob_excluded(const ice_fs_glob_nfa *nfa, const unsigned long *set, unsigned long count, ice_fs_bool is_dir) {
+    const ice_fs_glob_seg *seg = ice_fs_glob_accepts(nfa, set, count, is_dir);
+    return ((seg != 0) && ((seg->flags & ICE_FS_GLOB_RULE_NEGATE) == 0)) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Buffers to match paths against compiled glob with, Owned by one thread */
+typedef struct ice_fs_glob_run {
+    unsigned long *buf;                 /* All arrays below in one allocation */
+    unsigned long *include, *include_next, *include_marks;
+    unsigned long *exclude, *exclude_next, *exclude_marks;
+    unsigned long include_count, exclude_count;
+    unsigned long gen;
+    char *path;                         /* Directory that include and exclude sets are of (ice_fs_dir_glob only) */
+    unsigned long path_len, path_capacity;
+} ice_fs_glob_run;
+
+/* [INTERNAL] Allocates buffers of run for glob state, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_glob_run_init(ice_fs_glob_run *run, const ice_fs_glob_state *state) {
+    unsigned long inc = state->include.segs_count, exc = state->exclude.segs_count;
+
+    run->buf = ICE_FS_CALLOC((3 * (inc + exc)) + 1, sizeof(unsigned long));
+    if (run->buf == 0) return ICE_FS_FALSE;
+
+    run->include = run->buf;
+    run->include_next = run->include + inc;
+    run->include_marks = run->include_next + inc;
+    run->exclude = run->include_marks + inc;
+    run->exclude_next = run->exclude + exc;
+    run->exclude_marks = run->exclude_next + exc;
+    run->include_count = 0;
+    run->exclude_count = 0;
+    run->gen = 0;
+    run->path = 0;
+    run->path_len = 0;
+    run->path_capacity = 0;
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Frees buffers of run */
+static void ice_fs_glob_run_free(ice_fs_glob_run *run) {
+    ICE_FS_FREE(run->buf);
+    ICE_FS_FREE(run->path);
+    run->buf = 0;
+    run->path = 0;
+}
+
+/* [INTERNAL] Resets include and exclude sets of run to initial states of state */
+static void ice_fs_glob_run_begin(ice_fs_glob_run *run, const ice_fs_glob_state *state) {
+    run->gen++;
+    run->include_count = ice_fs_glob_begin(&state->include, run->include, run->include_marks, run->gen);
+    run->exclude_count = ice_fs_glob_begin(&state->exclude, run->exclude, run->exclude_marks, run->gen);
+}
+
+/* [INTERNAL] Steps include and exclude sets of run over name of name_len chars into their next sets (Current sets stay as they are) */
+static void ice_fs_glob_run_step(ice_fs_glob_run *run, const ice_fs_glob_state *state, const char *name, unsigned long name_len, unsigned long *include_count, unsigned long *exclude_count) {
+    run->gen++;
+    *include_count = ice_fs_glob_step(&state->include, run->include, run->include_count, name, name_len, run->include_next, run->include_marks, run->gen);
+    *exclude_count = ice_fs_glob_step(&state->exclude, run->exclude, run->exclude_count, name, name_len, run->exclude_next, run->exclude_marks, run->gen);
+}
+
+/* [INTERNAL] Makes next sets of run (Of include_count and exclude_count states) its current sets */
+static void ice_fs_glob_run_advance(ice_fs_glob_run *run, unsigned long include_count, unsigned long exclude_count) {
+    unsigned long *set;
+
+    set = run->include;
+    run->include = run->include_next;
+    run->include_next = set;
+    run->include_count = include_count;
+
+    set = run->exclude;
+    run->exclude = run->exclude_next;
+    run->exclude_next = set;
+    run->exclude_count = exclude_count;
+}
+
+/* [INTERNAL] Creates empty compiled glob in glob if it has none yet, Returns it on success or NULL on allocation failure */
+static ice_fs_glob_state* ice_fs_glob_get_state(ice_fs_glob *glob) {
+    ice_fs_glob_state *state = (ice_fs_glob_state*) glob->handle;
+
+    if (state == 0) {
+        state = ICE_FS_CALLOC(1, sizeof(ice_fs_glob_state));
+        glob->handle = state;
+    }
+
+    return state;
+}
+
+/* Compiles glob pattern (Relative to searched directory, With / as separator) to glob that matches paths against it, * and ? match any chars and any char in a name, ** matches zero or more directories, [abc], [a-z] and [!abc] match chars of class and {a,b} matches any of alternatives, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, glob should be freed with ice_fs_free_glob */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_glob_compile(ice_fs_glob *glob, const char *pattern) {
+    ice_fs_glob_state *state;
+    unsigned long budget = ICE_FS_GLOB_MAX_ALTERNATIVES;
+
+    if ((glob == 0) || (pattern == 0)) return ICE_FS_FALSE;
+
+    glob->handle = 0;
+    state = ice_fs_glob_get_state(glob);
+    if (state == 0) return ICE_FS_FALSE;
+
+    if (ice_fs_glob_expand(state, &state->include, pattern, ice_fs_str_len(pattern), 0, ICE_FS_FALSE, &budget) == ICE_FS_FALSE) {
+        ice_fs_free_glob(glob);
+        return ICE_FS_FALSE;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* Adds exclude pattern to glob compiled by ice_fs_glob_compile with syntax of .gitignore (Pattern without slash matches name at any depth, Leading slash anchors it to searched directory, Trailing slash matches directories only, ! re-includes and lines starting with # are ignored), Excluded directories are not searched at all, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_glob_exclude(ice_fs_glob *glob, const char *pattern) {
+    ice_fs_glob_state *state;
+    unsigned long len = ice_fs_str_len(pattern), budget = ICE_FS_GLOB_MAX_ALTERNATIVES;
+    unsigned flags = 0;
+
+    if ((glob == 0) || (pattern == 0)) return ICE_FS_FALSE;
+
+    state = ice_fs_glob_get_state(glob);
+    if (state == 0) return ICE_FS_FALSE;
+
+    /* Trailing spaces are ignored unless escaped */
+    while ((len > 0) && ((pattern[len - 1] == ' ') || (pattern[len - 1] == '\r') || (pattern[len - 1] == '\n')) && ((len < 2) || (pattern[len - 2] != '\\'))) len--;
+
+    if ((len == 0) || (pattern[0] == '#')) return ICE_FS_TRUE;
+
+    if (pattern[0] == '!') {
+        flags |= ICE_FS_GLOB_RULE_NEGATE;
+        pattern++;
+        len--;
+    }
+
+    return ice_fs_glob_expand(state, &state->exclude, pattern, len, flags, ICE_FS_TRUE, &budget);
+}
+
+/* Adds exclude patterns from each line of file in path (Like .gitignore, Patterns are relative to searched directory) to glob compiled by ice_fs_glob_compile, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_glob_exclude_file(ice_fs_glob *glob, const char *path) {
+    unsigned long size = 0, start = 0, i;
+    ice_fs_bool res = ICE_FS_TRUE;
+    char *content;
+
+    if ((glob == 0) || (path == 0)) return ICE_FS_FALSE;
+
+    content = ice_fs_file_content(path, &size);
+    if (content == 0) return ICE_FS_FALSE;
+
+    for (i = 0; (i <= size) && (res == ICE_FS_TRUE); i++) {
+        if ((i < size) && (content[i] != '\n')) continue;
+
+        content[i] = 0;
+        res = ice_fs_glob_exclude(glob, content + start);
+        start = i + 1;
+    }
+
+    ice_fs_free_str(content);
+
+    return res;
+}
+
+/* Returns ICE_FS_TRUE if path (Relative to searched directory, Trailing slash marks directory) matches glob compiled by ice_fs_glob_compile and isn't excluded, Or ICE_FS_FALSE if not, Filesystem is not accessed */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_glob_match(const ice_fs_glob *glob, const char *path) {
+    const ice_fs_glob_state *state;
+    ice_fs_glob_run run;
+    unsigned long len = ice_fs_str_len(path), i = 0, j, include_count = 0, exclude_count = 0;
+    ice_fs_bool is_dir = ICE_FS_FALSE, res = ICE_FS_FALSE;
+
+    if ((glob == 0) || (glob->handle == 0) || (path == 0)) return ICE_FS_FALSE;
+
+    state = (const ice_fs_glob_state*) glob->handle;
+    if (ice_fs_glob_run_init(&run, state) == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+    ice_fs_glob_run_begin(&run, state);
+
+    if ((len > 0) && ((path[len - 1] == '/') || (path[len - 1] == '\\'))) is_dir = ICE_FS_TRUE;
+
+    while (i < len) {
+        ice_fs_bool last;
+
+        if ((path[i] == '/') || (path[i] == '\\')) {
+            i++;
+            continue;
+        }
+
+        for (j = i; (j < len) && (path[j] != '/') && (path[j] != '\\'); j++);
+        last = ((j >= len) || ((j + 1) >= len)) ? ICE_FS_TRUE : ICE_FS_FALSE;
+
+        if (!((j == (i + 1)) && (path[i] == '.'))) {
+            ice_fs_glob_run_step(&run, state, path + i, j - i, &include_count, &exclude_count);
+            ice_fs_glob_run_advance(&run, include_count, exclude_count);
+
+            /* Objects inside excluded directories are excluded too */
+            if (ice_fs_glob_excluded(&state->exclude, run.exclude, run.exclude_count, ((last == ICE_FS_TRUE) ? is_dir : ICE_FS_TRUE)) == ICE_FS_TRUE) goto end;
+        }
+
+        i = j;
+    }
+
+    if ((len > 0) && (ice_fs_glob_accepts(&state->include, run.include, run.include_count, is_dir) != 0)) res = ICE_FS_TRUE;
+
+end:
+    ice_fs_glob_run_free(&run);
+
+    return res;
+}
+
+/* Frees glob compiled by ice_fs_glob_compile */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_glob(ice_fs_glob *glob) {
+    ice_fs_glob_state *state;
+
+    if ((glob == 0) || (glob->handle == 0)) return;
+
+    state = (ice_fs_glob_state*) glob->handle;
+
+    ICE_FS_FREE(state->include.segs);
+    ICE_FS_FREE(state->exclude.segs);
+    ice_fs_str_arena_free(&state->arena);
+    ICE_FS_FREE(state);
+
+    glob->handle = 0;
+}
+
+/* [INTERNAL] State shared by workers of ice_fs_dir_glob */
+typedef struct ice_fs_dir_glob_ctx {
+    ice_fs_dir_search_ctx search;       /* Found items */
+    const ice_fs_glob_state *state;
+    ice_fs_glob_run *runs;              /* One for each worker */
+    unsigned long root_len;             /* Length of searched directory (With separator) that path of each directory under it starts with */
+} ice_fs_dir_glob_ctx;
+
+/* [INTERNAL] Makes sets of run of worker be sets of directory dir (Computed from its path once per directory), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_dir_glob_enter(ice_fs_dir_glob_ctx *ctx, ice_fs_glob_run *run, const ice_fs_walk_dir *dir) {
+    unsigned long i, j, include_count, exclude_count;
+
+    if ((run->path != 0) && (run->path_len == dir->path_len) && (memcmp(run->path, dir->path, dir->path_len) == 0)) return ICE_FS_TRUE;
+
+    if (run->path_capacity <= dir->path_len) {
+        char *path = ICE_FS_REALLOC(run->path, dir->path_len + 64);
+        if (path == 0) return ICE_FS_FALSE;
+
+        run->path = path;
+        run->path_capacity = dir->path_len + 64;
+    }
+
+    for (i = 0; i < dir->path_len; i++) run->path[i] = dir->path[i];
+    run->path_len = dir->path_len;
+
+    /* Directories were only queued if their names kept sets alive, So each name steps sets again */
+    ice_fs_glob_run_begin(run, ctx->state);
+    i = ((dir->depth > 0) ? ctx->root_len : dir->path_len);
+
+    while (i < dir->path_len) {
+        for (j = i; (j < dir->path_len) && (dir->path[j] != '/') && (dir->path[j] != '\\'); j++);
+
+        ice_fs_glob_run_step(run, ctx->state, dir->path + i, j - i, &include_count, &exclude_count);
+        ice_fs_glob_run_advance(run, include_count, exclude_count);
+
+        i = j + 1;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+static ice_fs_bool ice_fs_dir_glob_item(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link) {
+    ice_fs_dir_glob_ctx *ctx = (ice_fs_dir_glob_ctx*) walk->user;
+    ice_fs_glob_run *run = &ctx->runs[worker];
+    ice_fs_bool is_dir;
+    unsigned long name_len = ice_fs_str_len(item->name), include_count, exclude_count;
+
+    /* Links to directories match patterns of directories (Like "build/") as before, They're still never descended into */
+    is_dir = ((ice_fs_walk_target_type(dir, item, is_link) == ICE_FS_OBJECT_TYPE_DIR) ? ICE_FS_TRUE : ICE_FS_FALSE);
+
+    if (ice_fs_dir_glob_enter(ctx, run, dir) == ICE_FS_FALSE) {
+        ice_fs_walk_fail(walk, ICE_FS_TRUE);
+        return ICE_FS_FALSE;
+    }
+
+    ice_fs_glob_run_step(run, ctx->state, item->name, name_len, &include_count, &exclude_count);
+
+    /* Excluded directories are never descended into */
+    if (ice_fs_glob_excluded(&ctx->state->exclude, run->exclude_next, exclude_count, is_dir) == ICE_FS_TRUE) return ICE_FS_FALSE;
+
+    if (ice_fs_glob_accepts(&ctx->state->include, run->include_next, include_count, is_dir) != 0) {
+        if (ice_fs_dir_search_add(walk, &ctx->search, dir, item->name, name_len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    }
+
+    /* Subtrees that no rule can match anymore are pruned */
+    return ice_fs_glob_alive(&ctx->state->include, run->include_next, include_count);
+}
+
+/* Searches in contents of directory and its subdirectories (In parallel) for files/directories whose paths (Relative to path) match glob compiled by ice_fs_glob_compile, Directories that can't contain matches or are excluded are not searched, Returns array of strings that contains full path of founded items on allocation success or NULL on failure, results should be pointer to unsigned long integer that stores number of founded items */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_dir_glob(const char *path, const ice_fs_glob *glob, unsigned long *results) {
+    ice_fs_dir_glob_ctx ctx;
+    ice_fs_walk walk;
+    unsigned long threads_count = ice_fs_get_threads_count(), i;
+    char **res = 0;
+
+    if (results != 0) *results = 0;
+    if ((path == 0) || (glob == 0) || (glob->handle == 0)) return 0;
+
+    ctx.state = (const ice_fs_glob_state*) glob->handle;
+    ctx.root_len = ice_fs_str_len(path);
+    if ((ctx.root_len > 0) && (ice_fs_str_ends_with_slash(path) == ICE_FS_FALSE)) ctx.root_len++;
+
+    ctx.runs = ICE_FS_CALLOC(threads_count, sizeof(ice_fs_glob_run));
+    if (ctx.runs == 0) return 0;
+
+    for (i = 0; i < threads_count; i++) {
+        if (ice_fs_glob_run_init(&ctx.runs[i], ctx.state) == ICE_FS_FALSE) goto end;
+    }
+
+    ctx.search.str = 0;
+    ctx.search.arena.chunks = 0;
+    ctx.search.found = 0;
+    ctx.search.found_count = 0;
+    ctx.search.found_capacity = 0;
+    ice_fs_mutex_init(&ctx.search.mutex);
+
+    walk.on_item = ice_fs_dir_glob_item;
+    walk.on_leave = 0;
+    walk.user = &ctx;
+
+    (void) ice_fs_walk_run(&walk, path, threads_count);
+    res = ice_fs_dir_search_results(&ctx.search, &walk, results);
+
+    ice_fs_mutex_destroy(&ctx.search.mutex);
+    ice_fs_str_arena_free(&ctx.search.arena);
+    ICE_FS_FREE(ctx.search.found);
+
+end:
+    for (i = 0; i < threads_count; i++) ice_fs_glob_run_free(&ctx.runs[i]);
+    ICE_FS_FREE(ctx.runs);
+
+    return res;
+}
+
+
+/* Creates file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_create(const char *path, ice_fs_object_type type) {
+    return ice_fs_create_at(0, path, type);
+}
+
+/* Same like ice_fs_create but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_create_at(const ice_fs_dir_handle *dir, const char *path, ice_fs_object_type type) {
+    ice_fs_bool res = ICE_FS_FALSE;
+#if defined(ICE_FS_MICROSOFT)
+    const char *at_path;
+#elif defined(ICE_FS_UNIX)
+    struct stat info;
+    int dfd = ice_fs_at_fd(dir);
+#endif
+
+    if ((path == 0) || (type == ICE_FS_OBJECT_TYPE_NONE)) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    at_path = ice_fs_at_path(dir, path);
+    if (at_path == 0) return ICE_FS_FALSE;
+
+    if (ice_fs_path_exists(at_path) == ICE_FS_TRUE) {
+        res = ICE_FS_TRUE;
+    } else if (type == ICE_FS_OBJECT_TYPE_FILE) {
+        int fd = ice_fs_open(at_path, O_CREAT);
+        if (fd != -1) res = ((close(fd) == 0) ? ICE_FS_TRUE : ICE_FS_FALSE);
+    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
+        if ((ice_fs_mkdir(at_path) == 0) && (chmod(at_path, 0777) == 0)) res = ICE_FS_TRUE;
+    }
+
+    ice_fs_at_path_free(path, at_path);
+#elif defined(ICE_FS_UNIX)
+    if (fstatat(dfd, path, &info, 0) == 0) return ICE_FS_TRUE;
+
+    if (type == ICE_FS_OBJECT_TYPE_FILE) {
+        int fd = openat(dfd, path, O_RDONLY | O_CREAT, 0666);
+        if (fd != -1) res = ((close(fd) == 0) ? ICE_FS_TRUE : ICE_FS_FALSE);
+    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
+        if ((mkdirat(dfd, path, 0777) == 0) && (fchmodat(dfd, path, 0777, 0) == 0)) res = ICE_FS_TRUE;
+    }
+#endif
+
+    return res;
+}
+
+/* [INTERNAL] Writes len zero bytes to fd at offset, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_zero_fd(int fd, ice_fs_offset offset, ice_fs_offset len) {
+    unsigned long chunk = ((len > 65536) ? 65536 : (unsigned long) len);
+    ice_fs_bool res = ICE_FS_TRUE;
+    char *zeros;
+
+    if (len <= 0) return ICE_FS_TRUE;
+    if (ice_fs_seek_fd(fd, offset, SEEK_SET) == -1) return ICE_FS_FALSE;
+
+    zeros = ICE_FS_CALLOC(chunk, sizeof(char));
+    if (zeros == 0) return ICE_FS_FALSE;
+
+    while ((len > 0) && (res == ICE_FS_TRUE)) {
+        unsigned long count = ((len > (ice_fs_offset) chunk) ? chunk : (unsigned long) len);
+
+        res = ice_fs_write_fd(fd, zeros, count);
+        len -= count;
+    }
+
+    ICE_FS_FREE(zeros);
+
+    return res;
+}
+
+/* [INTERNAL] Finds first region with data at or after pos in file fd of size bytes and stores its start and end in data and data_end (Both are size if there's none), Files are all data where SEEK_DATA isn't available, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_next_data(int fd, ice_fs_offset pos, ice_fs_offset size, ice_fs_offset *data, ice_fs_offset *data_end) {
+    *data = pos;
+    *data_end = size;
+
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    {
+        ice_fs_offset res = ice_fs_seek_fd(fd, pos, SEEK_DATA);
+
+        if (res == -1) {
+            /* ENXIO means only hole is left, EINVAL means filesystem can't tell */
+            if (errno == ENXIO) *data = size;
+            return ((errno == ENXIO) || (errno == EINVAL)) ? ICE_FS_TRUE : ICE_FS_FALSE;
+        }
+
+        *data = ((res < size) ? res : size);
+
+        res = ice_fs_seek_fd(fd, *data, SEEK_HOLE);
+        if ((res != -1) && (res < size)) *data_end = res;
+    }
+#else
+    (void) fd;
+#endif
+
+    return ICE_FS_TRUE;
+}
+
+/* Creates file in path (Or resizes existing one) of size bytes with its disk space reserved upfront (With fallocate on Linux), So writing it later neither fragments it nor runs out of space midway, Added bytes read as zeros, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_create_file(const char *path, ice_fs_offset size) {
+    ice_fs_bool res = ICE_FS_FALSE;
+    int fd;
+
+    if ((path == 0) || (size < 0)) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    fd = open(path, O_RDWR | O_CREAT | O_BINARY, S_IREAD | S_IWRITE);
+    if (fd == -1) return ICE_FS_FALSE;
+
+    if (_chsize_s(fd, (__int64) size) == 0) res = ice_fs_reserve_fd(fd, size, ICE_FS_FALSE);
+#elif defined(ICE_FS_UNIX)
+    fd = open(path, O_RDWR | O_CREAT, 0666);
+    if (fd == -1) return ICE_FS_FALSE;
+
+    /* Size is set first, So filesystems that can't reserve space still get file of right size */
+    if (ftruncate(fd, (off_t) size) == 0) res = ice_fs_reserve_fd(fd, size, ICE_FS_FALSE);
+#endif
+
+    if (close(fd) == -1) res = ICE_FS_FALSE;
+
+    return res;
+}
+
+/* Deallocates len bytes of file in path from offset (Range past end of the file is ignored), The range reads as zeros and size of the file stays same, Filesystems that can't deallocate get zeros written instead, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_punch_hole(const char *path, ice_fs_offset offset, ice_fs_offset len) {
+    ice_fs_bool res = ICE_FS_FALSE;
+    ice_fs_offset size;
+    int fd;
+
+    if ((path == 0) || (offset < 0) || (len < 0)) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    fd = open(path, O_RDWR | O_BINARY);
+#elif defined(ICE_FS_UNIX)
+    fd = open(path, O_RDWR);
+#endif
+
+    if (fd == -1) return ICE_FS_FALSE;
+
+    size = ice_fs_seek_fd(fd, 0, SEEK_END);
+    if (size == -1) goto end;
+
+    if (offset >= size) {
+        res = ICE_FS_TRUE;
+        goto end;
+    }
+
+    if (len > (size - offset)) len = (size - offset);
+
+#if defined(ICE_FS_FALLOCATE)
+    {
+        int punch_res;
+
+        do {
+            punch_res = fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, (off_t) offset, (off_t) len);
+        } while ((punch_res == -1) && (errno == EINTR));
+
+        if (punch_res == 0) {
+            res = ICE_FS_TRUE;
+            goto end;
+        }
+
+        if ((errno != EOPNOTSUPP) && (errno != ENOSYS)) goto end;
+    }
+#endif
+
+    res = ice_fs_zero_fd(fd, offset, len);
+
+end:
+    if (close(fd) == -1) res = ICE_FS_FALSE;
+
+    return res;
+}
+
+/* Retrieves regions of data and holes (Deallocated ranges that read as zeros) of file in path in order and stores their number in regions_count (With SEEK_DATA and SEEK_HOLE, Files are one data region where they aren't available), Returns array of regions on success or NULL on failure, The array should be freed with ice_fs_free_file_regions */
+ICE_FS_API ice_fs_file_region* ICE_FS_CALLCONV ice_fs_file_regions(const char *path, unsigned long *regions_count) {
+    ice_fs_file_region *regions = 0;
+    unsigned long count = 0, capacity = 8;
+    ice_fs_offset size, pos = 0;
+    int fd;
+
+    if ((path == 0) || (regions_count == 0)) return 0;
+    *regions_count = 0;
+
+#if defined(ICE_FS_MICROSOFT)
+    fd = open(path, O_RDONLY | O_BINARY);
+#elif defined(ICE_FS_UNIX)
+    fd = open(path, O_RDONLY);
+#endif
+
+    if (fd == -1) return 0;
+
+    size = ice_fs_seek_fd(fd, 0, SEEK_END);
+    if (size == -1) goto failure;
+
+    regions = ICE_FS_MALLOC(capacity * sizeof(ice_fs_file_region));
+    if (regions == 0) goto failure;
+
+    while (pos < size) {
+        ice_fs_offset data, data_end;
+
+        if (ice_fs_next_data(fd, pos, size, &data, &data_end) == ICE_FS_FALSE) goto failure;
+
+        /* Hole before the data (Or at end of the file) and the data take two regions at most */
+        if ((count + 2) > capacity) {
+            ice_fs_file_region *grown = ICE_FS_REALLOC(regions, (capacity * 2) * sizeof(ice_fs_file_region));
+            if (grown == 0) goto failure;
+
+            regions = grown;
+            capacity *= 2;
+        }
+
+        if (data > pos) {
+            regions[count].offset = pos;
+            regions[count].len = (data - pos);
+            regions[count].hole = ICE_FS_TRUE;
+            count++;
+        }
+
+        if (data >= size) break;
+
+        regions[count].offset = data;
+        regions[count].len = (data_end - data);
+        regions[count].hole = ICE_FS_FALSE;
+        count++;
+
+        pos = data_end;
+    }
+
+    (void) close(fd);
+    *regions_count = count;
+
+    return regions;
+
+failure:
+    ICE_FS_FREE(regions);
+    (void) close(fd);
+
+    return 0;
+}
+
+/* Frees regions retrieved by ice_fs_file_regions */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_file_regions(ice_fs_file_region *regions) {
+    ICE_FS_FREE(regions);
+}
+
+/* Removes file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_remove(const char *path) {
+    return ice_fs_remove_at(0, path);
+}
+
+/* Same like ice_fs_remove but relative path is resolved from directory of dir handle (Current directory if dir is NULL) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_remove_at(const ice_fs_dir_handle *dir, const char *path) {
+    int res = -1;
+#if defined(ICE_FS_MICROSOFT)
+    const char *at_path;
+    ice_fs_object_type type;
+#elif defined(ICE_FS_UNIX)
+    int dfd = ice_fs_at_fd(dir);
+#endif
+
+    if (path == 0) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    at_path = ice_fs_at_path(dir, path);
+    if (at_path == 0) return ICE_FS_FALSE;
+
+    type = ice_fs_type(at_path);
+
+    if (type == ICE_FS_OBJECT_TYPE_FILE) {
+        res = unlink(at_path);
+    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
+        res = rmdir(at_path);
+    }
+
+    ice_fs_at_path_free(path, at_path);
+#elif defined(ICE_FS_UNIX)
+    /* Unlinking first saves stat for files, Folders are refused with EISDIR (Or EPERM outside Linux) */
+    res = unlinkat(dfd, path, 0);
+
+    if ((res == -1) && ((errno == EISDIR) || (errno == EPERM))) {
+        int error = errno;
+
+        res = unlinkat(dfd, path, AT_REMOVEDIR);
+        if ((res == -1) && (errno == ENOTDIR)) errno = error;
+    }
+#endif
+
+    return (res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Removes item of directory being walked (Relative to fd of the directory on Unix, So no path is built for it), Returns ICE_FS_TRUE to descend into the item if it's folder (Which is removed once it is empty) */
+static ice_fs_bool ice_fs_remove_tree_item(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link) {
+#if defined(ICE_FS_MICROSOFT)
+    unsigned long name_len = ice_fs_str_len(item->name);
+    char *path;
+    BOOL res;
+
+    (void) worker;
+
+    if ((item->type == ICE_FS_OBJECT_TYPE_DIR) && (is_link == ICE_FS_FALSE)) return ICE_FS_TRUE;
+
+    path = ICE_FS_MALLOC(dir->path_len + name_len + 2);
+
+    if (path == 0) {
+        errno = ENOMEM;
+        ice_fs_walk_fail(walk, ICE_FS_TRUE);
+        return ICE_FS_FALSE;
+    }
+
+    (void) ice_fs_walk_join(dir, item->name, name_len, path);
+
+    /* Symbolic links to folders are removed like empty folders */
+    res = ((item->type == ICE_FS_OBJECT_TYPE_DIR) ? RemoveDirectoryA(path) : DeleteFileA(path));
+
+    if (res == 0) {
+        errno = EACCES;
+        ice_fs_walk_fail(walk, ICE_FS_FALSE);
+    }
+
+    ICE_FS_FREE(path);
+    return ICE_FS_FALSE;
+#elif defined(ICE_FS_UNIX)
+    (void) worker;
+
+    /* Walker reports symbolic links as files without following them (Entries of unknown type are stat'ed once by the iterator), So type of folder can be trusted here */
+    if ((item->type == ICE_FS_OBJECT_TYPE_DIR) && (is_link == ICE_FS_FALSE)) return ICE_FS_TRUE;
+
+    if (unlinkat(dir->fd, item->name, 0) == -1) ice_fs_walk_fail(walk, ICE_FS_FALSE);
+
+    return ICE_FS_FALSE;
+#endif
+}
+
+/* [INTERNAL] Removes directory once all of its items are removed (Except root directory of the walk if walk user points to ICE_FS_TRUE) */
+static void ice_fs_remove_tree_leave(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir) {
+    ice_fs_bool *keep_root = (ice_fs_bool*) walk->user;
+
+    (void) worker;
+
+    if ((dir->depth == 0) && (*keep_root == ICE_FS_TRUE)) return;
+
+#if defined(ICE_FS_MICROSOFT)
+    if (rmdir(dir->path) == -1) ice_fs_walk_fail(walk, ICE_FS_FALSE);
+#elif defined(ICE_FS_UNIX)
+    /* Removed by name from its parent like items are, Instead of by full path that symbolic links could redirect */
+    if (unlinkat(((dir->parent != 0) ? dir->parent->fd : AT_FDCWD), ((dir->parent != 0) ? dir->name : dir->path), AT_REMOVEDIR) == -1) ice_fs_walk_fail(walk, ICE_FS_FALSE);
+#endif
+}
+
+/* [INTERNAL] Removes content of directory in path in parallel and the directory itself unless keep_root is ICE_FS_TRUE, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred) */
+static ice_fs_bool ice_fs_remove_tree(const char *path, ice_fs_bool keep_root) {
+    ice_fs_walk walk;
+
+    walk.on_item = ice_fs_remove_tree_item;
+    walk.on_leave = ice_fs_remove_tree_leave;
+    walk.user = &keep_root;
+
+    /* Items that can't be removed are skipped (Like rm -rf does), Their parents fail to be removed then */
+    if (ice_fs_walk_run(&walk, path, ice_fs_get_threads_count()) == ICE_FS_FALSE) {
+        errno = ((walk.error != 0) ? walk.error : EIO);
+        return ICE_FS_FALSE;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* Removes file/folder in specific path with all of its content (Subfolders are removed in parallel, Symbolic links are removed but never followed), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_remove_all(const char *path) {
+#if defined(ICE_FS_MICROSOFT)
+    DWORD attribs;
+#elif defined(ICE_FS_UNIX)
+    struct stat info;
+#endif
+
+    if (path == 0) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    attribs = GetFileAttributesA(path);
+
+    if (attribs == INVALID_FILE_ATTRIBUTES) {
+        errno = ENOENT;
+        return ICE_FS_FALSE;
+    }
+
+    if ((attribs & FILE_ATTRIBUTE_DIRECTORY) == 0) return (unlink(path) == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+    if ((attribs & FILE_ATTRIBUTE_REPARSE_POINT) != 0) return (RemoveDirectoryA(path) != 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#elif defined(ICE_FS_UNIX)
+    if (lstat(path, &info) == -1) return ICE_FS_FALSE;
+    if ((info.st_mode & S_IFMT) != S_IFDIR) return (unlink(path) == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#endif
+
+    return ice_fs_remove_tree(path, ICE_FS_FALSE);
+}
+
+/* Clears content of file/folder in specific path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_clear(const char *path) {
+    ice_fs_object_type type;
+    ice_fs_bool res = ICE_FS_FALSE;
+
+    if (path == 0) return 0;
+
+    type = ice_fs_type(path);
+
+    if (type == ICE_FS_OBJECT_TYPE_FILE) {
+        res = ice_fs_path_exists(path);
+        if (res == ICE_FS_FALSE) return ICE_FS_FALSE;
+        
+        res = ice_fs_file_write_buf(path, 0, 0, ICE_FS_WRITE_MODE_OVERWRITE);
+
+    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
+        res = ice_fs_remove_tree(path, ICE_FS_TRUE);
+    }
+
+    return res;
+}
+
+#if defined(ICE_FS_UNIX)
+/* [INTERNAL] Copies regions with data of sparse file fd1 of size bytes to empty file fd2 and leaves its holes unwritten, buf should have ICE_FS_COPY_BUFFER_SIZE bytes, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_copy_sparse(int fd1, int fd2, ice_fs_offset size, char *buf) {
+    ice_fs_offset pos = 0, data, data_end;
+
+    while (pos < size) {
+        if (ice_fs_next_data(fd1, pos, size, &data, &data_end) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        if (data >= size) break;
+
+        pos = data;
+
+#if defined(__linux__) && defined(SYS_copy_file_range)
+        while (pos < data_end) {
+            loff_t off1 = (loff_t) pos, off2 = (loff_t) pos;
+            ssize_t copied = syscall(SYS_copy_file_range, fd1, &off1, fd2, &off2, (size_t) (((data_end - pos) > 0x40000000) ? 0x40000000 : (data_end - pos)), 0u);
+
+            if (copied > 0) {
+                pos += copied;
+            } else if ((copied == -1) && (errno == EINTR)) {
+                continue;
+            } else {
+                break;
+            }
+        }
+#endif
+
+        while (pos < data_end) {
+            ssize_t read_size = pread(fd1, buf, (size_t) (((data_end - pos) > ICE_FS_COPY_BUFFER_SIZE) ? ICE_FS_COPY_BUFFER_SIZE : (data_end - pos)), (off_t) pos), written = 0;
+
+            if (read_size == 0) break;
+
+            if (read_size == -1) {
+                if (errno == EINTR) continue;
+                return ICE_FS_FALSE;
+            }
+
+            while (written < read_size) {
+                ssize_t write_res = pwrite(fd2, buf + written, (size_t) (read_size - written), (off_t) (pos + written));
+
+                if (write_res == -1) {
+                    if (errno == EINTR) continue;
+                    return ICE_FS_FALSE;
+                }
+
+                written += write_res;
+            }
+
+            pos += read_size;
+        }
+
+        pos = data_end;
+    }
+
+    /* Hole at end of the file is made by setting its size */
+    return (ftruncate(fd2, (off_t) size) == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+#endif
+
+/* [INTERNAL] Copies content and permissions of file in path1 to file in path2 (Created if doesn't exist), Holes of sparse files are kept, Tries reflink then copy_file_range then sendfile on Linux before falling back to buffered copy, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_copy_file(const char *path1, const char *path2) {
+#if defined(ICE_FS_MICROSOFT)
+    BOOL copy_res = CopyFileA(path1, path2, FALSE);
+    return (copy_res != 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#elif defined(ICE_FS_UNIX)
+    struct stat info1, info2;
+    ice_fs_bool res = ICE_FS_FALSE;
+    int fd1 = -1, fd2 = -1;
+    off_t remaining;
+    char *buf = 0;
+
+    fd1 = open(path1, O_RDONLY);
+    if (fd1 == -1) return ICE_FS_FALSE;
+
+    if (fstat(fd1, &info1) == -1) goto done;
+
+    /* Copying file onto itself would truncate it before it gets read */
+    if ((!S_ISREG(info1.st_mode)) || ((stat(path2, &info2) == 0) && (info2.st_dev == info1.st_dev) && (info2.st_ino == info1.st_ino))) {
+        errno = EINVAL;
+        goto done;
+    }
+
+    fd2 = open(path2, O_WRONLY | O_CREAT | O_TRUNC, info1.st_mode & 07777);
+    if (fd2 == -1) goto done;
+
+    /* Mode of existing file (Or the one masked by umask) is replaced by mode of the source */
+    if (fchmod(fd2, info1.st_mode & 07777) == -1) goto done;
+
+    remaining = info1.st_size;
+
+#if defined(FICLONE)
+    if ((remaining > 0) && (ioctl(fd2, FICLONE, fd1) == 0)) {
+        res = ICE_FS_TRUE;
+        goto done;
+    }
+#endif
+
+    /* File with fewer allocated blocks than its size has holes, Only its data is copied so the copy stays sparse */
+    if ((remaining > 0) && ((((ice_fs_offset) info1.st_blocks) * 512) < ((ice_fs_offset) info1.st_size))) {
+        buf = ICE_FS_MALLOC(ICE_FS_COPY_BUFFER_SIZE);
+        if (buf == 0) goto done;
+
+        res = ice_fs_copy_sparse(fd1, fd2, (ice_fs_offset) info1.st_size, buf);
+        goto done;
+    }
+
+#if defined(__linux__) && defined(SYS_copy_file_range)
+    while (remaining > 0) {
+        ssize_t copied = syscall(SYS_copy_file_range, fd1, (loff_t*) 0, fd2, (loff_t*) 0, (size_t) ((remaining > 0x40000000) ? 0x40000000 : remaining), 0u);
+
+        if (copied > 0) {
+            remaining -= copied;
+        } else if ((copied == -1) && (errno == EINTR)) {
+            continue;
+        } else {
+            break;
+        }
+    }
+#endif
+
+#if defined(__linux__)
+    while (remaining > 0) {
+        ssize_t copied = sendfile(fd2, fd1, (off_t*) 0, (size_t) ((remaining > 0x40000000) ? 0x40000000 : remaining));
+
+        if (copied > 0) {
+            remaining -= copied;
+        } else if ((copied == -1) && (errno == EINTR)) {
+            continue;
+        } else {
+            break;
+        }
+    }
+#endif
+
+    /* Buffered copy from current offsets, Also picks up files that report no size (Like ones in /proc) or grew meanwhile */
+    buf = ICE_FS_MALLOC(ICE_FS_COPY_BUFFER_SIZE);
+    if (buf == 0) goto done;
+
+    for (;;) {
+        ssize_t read_size = read(fd1, buf, ICE_FS_COPY_BUFFER_SIZE), written = 0;
+
+        if (read_size == 0) break;
+
+        if (read_size == -1) {
+            if (errno == EINTR) continue;
+            goto done;
+        }
+
+        while (written < read_size) {
+            ssize_t write_res = write(fd2, buf + written, (size_t) (read_size - written));
+
+            if (write_res == -1) {
+                if (errno == EINTR) continue;
+                goto done;
+            }
+
+            written += write_res;
+        }
+    }
+
+    res = ICE_FS_TRUE;
+
+done:
+    if (buf != 0) ICE_FS_FREE(buf);
+    if ((fd2 != -1) && (close(fd2) == -1)) res = ICE_FS_FALSE;
+    (void) close(fd1);
+
+    return res;
+#endif
+}
+
+/* Maximum number of files ice_fs_copy copies at same time, 0 means 4 per thread (Set via ice_fs_use_copy_limit) */
+static unsigned long ice_fs_copy_limit = 0;
+
+/* Sets maximum number of files that ice_fs_copy copies at same time when copying folders, 0 means 4 per thread of ice_fs_use_threads (The default) */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_use_copy_limit(unsigned long files_count) {
+    ice_fs_copy_limit = files_count;
+}
+
+/* [INTERNAL] State shared by threads of ice_fs_copy_dir */
+typedef struct ice_fs_copy_ctx {
+    const char *src;
+    unsigned long src_len;
+    const char *dst;
+    unsigned long dst_len;
+    ice_fs_mutex mutex;
+    ice_fs_cond not_empty, not_full;
+    ice_fs_str_arena arena;             /* Paths of files to copy (Collected while creating directories) */
+    char **files;                       /* Pointers into the arena */
+    unsigned long files_count, files_capacity;
+    char **queue;                       /* Bounded ring of files waiting for copier threads */
+    unsigned long queue_head, queue_count, queue_capacity;
+    ice_fs_bool closed;                 /* ICE_FS_TRUE when no more files will be queued */
+    ice_fs_bool failed;
+    int error;                          /* errno of the first failure */
+} ice_fs_copy_ctx;
+
+/* [INTERNAL] Records error as failure of the copy (Only the first one is kept) and wakes up all threads so they stop */
+static void ice_fs_copy_fail(ice_fs_copy_ctx *ctx, int error) {
+    ice_fs_mutex_lock(&ctx->mutex);
+
+    if (ctx->failed == ICE_FS_FALSE) {
+        ctx->failed = ICE_FS_TRUE;
+        ctx->error = ((error != 0) ? error : EIO);
+    }
+
+    ice_fs_cond_broadcast(&ctx->not_empty);
+    ice_fs_cond_broadcast(&ctx->not_full);
+    ice_fs_mutex_unlock(&ctx->mutex);
+}
+
+/* [INTERNAL] Returns path in destination folder that corresponds to path src in source folder on allocation success or NULL on failure */
+static char* ice_fs_copy_target(const ice_fs_copy_ctx *ctx, const char *src) {
+    const char *rel = src + ctx->src_len;
+    unsigned long rel_len, i, len = ctx->dst_len;
+    char *res;
+
+    while ((rel[0] == '/') || (rel[0] == '\\')) rel++;
+    rel_len = ice_fs_str_len(rel);
+
+    res = ICE_FS_MALLOC((ctx->dst_len + rel_len + 2) * sizeof(char));
+    if (res == 0) return 0;
+
+    for (i = 0; i < len; i++) res[i] = ctx->dst[i];
+
+    if ((len > 0) && (res[len - 1] != '/') && (res[len - 1] != '\\')) {
+#if defined(ICE_FS_MICROSOFT)
+        res[len++] = '\\';
+#else
+        res[len++] = '/';
+#endif
+    }
+
+    for (i = 0; i <= rel_len; i++) res[len + i] = rel[i];
+
+    return res;
+}
+
+#if defined(ICE_FS_UNIX)
+/* [INTERNAL] Returns target of symbolic link of name (Relative to directory fd dfd) on allocation success or NULL on failure, Buffer is sized from lstat and grown if the target doesn't fit (Link changed meanwhile or filesystem reports no size), So long targets are never truncated */
+static char* ice_fs_readlink_at(int dfd, const char *name) {
+    struct stat info;
+    unsigned long size;
+
+    if (fstatat(dfd, name, &info, AT_SYMLINK_NOFOLLOW) == -1) return 0;
+
+    /* Some filesystems (Like procfs) report size of 0 for links */
+    size = ((info.st_size > 0) ? (((unsigned long) info.st_size) + 1) : 256);
+
+    for (;;) {
+        char *res = ICE_FS_MALLOC(size * sizeof(char));
+        ssize_t len;
+
+        if (res == 0) {
+            errno = ENOMEM;
+            return 0;
+        }
+
+        len = readlinkat(dfd, name, res, size);
+
+        if (len == -1) {
+            int error = errno;
+
+            ICE_FS_FREE(res);
+            errno = error;
+
+            return 0;
+        }
+
+        /* Target that fills whole buffer may be truncated, So it's read again with bigger one */
+        if (((unsigned long) len) < size) {
+            res[len] = 0;
+            return res;
+        }
+
+        ICE_FS_FREE(res);
+        size *= 2;
+    }
+}
+#endif
+
+/* [INTERNAL] Creates directories and symbolic links (To files or directories, Recreated as links on Unix) of the source tree in destination folder as they are found, Files are collected to be copied after */
+static ice_fs_bool ice_fs_copy_dir_item(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link) {
+    ice_fs_copy_ctx *ctx = (ice_fs_copy_ctx*) walk->user;
+    unsigned long name_len = ice_fs_str_len(item->name);
+    char *src, *dst = 0;
+    int error = 0;
+#if defined(ICE_FS_UNIX)
+    char *target;
+    int link_res;
+#elif defined(ICE_FS_MICROSOFT)
+    /* Links are followed by CopyFileA and created as folders like before */
+    is_link = ICE_FS_FALSE;
+#endif
+
+    (void) worker;
+
+    /* Walker reports links as files, So they are checked first to never copy content of their targets */
+    if ((item->type == ICE_FS_OBJECT_TYPE_FILE) && (is_link == ICE_FS_FALSE)) {
+        ice_fs_mutex_lock(&ctx->mutex);
+
+        if (ctx->files_count == ctx->files_capacity) {
+            unsigned long capacity = ((ctx->files_capacity == 0) ? 256 : (ctx->files_capacity * 2));
+            char **files = ICE_FS_REALLOC(ctx->files, capacity * sizeof(char*));
+
+            if (files == 0) goto alloc_failure;
+
+            ctx->files = files;
+            ctx->files_capacity = capacity;
+        }
+
+        src = ice_fs_str_arena_alloc(&ctx->arena, dir->path_len + name_len + 2);
+        if (src == 0) goto alloc_failure;
+
+        (void) ice_fs_walk_join(dir, item->name, name_len, src);
+        ctx->files[ctx->files_count++] = src;
+
+        ice_fs_mutex_unlock(&ctx->mutex);
+
+        return ICE_FS_TRUE;
+
+alloc_failure:
+        ice_fs_mutex_unlock(&ctx->mutex);
+        ice_fs_copy_fail(ctx, ENOMEM);
+        ice_fs_walk_fail(walk, ICE_FS_TRUE);
+
+        return ICE_FS_FALSE;
+    }
+
+    if ((item->type != ICE_FS_OBJECT_TYPE_DIR) && (is_link == ICE_FS_FALSE)) return ICE_FS_FALSE;
+
+    src = ICE_FS_MALLOC((dir->path_len + name_len + 2) * sizeof(char));
+    if (src == 0) {
+        error = ENOMEM;
+        goto failure;
+    }
+
+    (void) ice_fs_walk_join(dir, item->name, name_len, src);
+
+    dst = ice_fs_copy_target(ctx, src);
+    if (dst == 0) {
+        error = ENOMEM;
+        goto failure;
+    }
+
+#if defined(ICE_FS_UNIX)
+    /* Links are read relative to fd of their directory like the walk does (Dangling ones are copied too) */
+    if (is_link == ICE_FS_TRUE) {
+        target = ice_fs_readlink_at(dir->fd, item->name);
+
+        if (target == 0) {
+            error = errno;
+            goto failure;
+        }
+
+        link_res = symlink(target, dst);
+        error = errno;
+        ICE_FS_FREE(target);
+
+        if ((link_res == 0) || (error == EEXIST)) goto done;
+        goto failure;
+    }
+#endif
+
+    /* Existing directories are merged into like before */
+    if ((ice_fs_mkdir(dst) == -1) && (errno != EEXIST)) {
+        error = errno;
+        goto failure;
+    }
+
+done:
+    ICE_FS_FREE(src);
+    ICE_FS_FREE(dst);
+
+    return ICE_FS_TRUE;
+
+failure:
+    if (src != 0) ICE_FS_FREE(src);
+    if (dst != 0) ICE_FS_FREE(dst);
+
+    ice_fs_copy_fail(ctx, error);
+    ice_fs_walk_fail(walk, ICE_FS_TRUE);
+
+    return ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Copier thread of ice_fs_copy_dir, Copies files from the queue till it's closed and empty or the copy failed */
+static void ice_fs_copy_dir_worker(void *arg) {
+    ice_fs_copy_ctx *ctx = (ice_fs_copy_ctx*) arg;
+
+    for (;;) {
+        char *src, *dst;
+
+        ice_fs_mutex_lock(&ctx->mutex);
+
+        while ((ctx->queue_count == 0) && (ctx->closed == ICE_FS_FALSE) && (ctx->failed == ICE_FS_FALSE)) {
+            ice_fs_cond_wait(&ctx->not_empty, &ctx->mutex);
+        }
+
+        if ((ctx->queue_count == 0) || (ctx->failed == ICE_FS_TRUE)) {
+            ice_fs_mutex_unlock(&ctx->mutex);
+            break;
+        }
+
+        src = ctx->queue[ctx->queue_head];
+        ctx->queue_head = ((ctx->queue_head + 1) % ctx->queue_capacity);
+        ctx->queue_count--;
+
+        ice_fs_cond_signal(&ctx->not_full);
+        ice_fs_mutex_unlock(&ctx->mutex);
+
+        dst = ice_fs_copy_target(ctx, src);
+
+        if (dst == 0) {
+            ice_fs_copy_fail(ctx, ENOMEM);
+            break;
+        }
+
+        if (ice_fs_copy_file(src, dst) == ICE_FS_FALSE) {
+            ice_fs_copy_fail(ctx, errno);
+            ICE_FS_FREE(dst);
+            break;
+        }
+
+        ICE_FS_FREE(dst);
+    }
+}
+
+/* [INTERNAL] Copies contents of folder in path1 into folder in path2, Creates the directory skeleton first (In parallel via ice_fs_walk) then copies files with up to ice_fs_copy_limit threads fed through a bounded queue, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure and sets errno to the first error */
+static ice_fs_bool ice_fs_copy_dir(const char *path1, const char *path2) {
+    ice_fs_copy_ctx ctx;
+    ice_fs_walk walk;
+    ice_fs_thread *threads = 0;
+    unsigned long threads_count, started = 0, i;
+
+    ctx.src = path1;
+    ctx.src_len = ice_fs_str_len(path1);
+    ctx.dst = path2;
+    ctx.dst_len = ice_fs_str_len(path2);
+    ctx.arena.chunks = 0;
+    ctx.files = 0;
+    ctx.files_count = 0;
+    ctx.files_capacity = 0;
+    ctx.queue = 0;
+    ctx.queue_head = 0;
+    ctx.queue_count = 0;
+    ctx.queue_capacity = 0;
+    ctx.closed = ICE_FS_FALSE;
+    ctx.failed = ICE_FS_FALSE;
+    ctx.error = 0;
+    ice_fs_mutex_init(&ctx.mutex);
+    ice_fs_cond_init(&ctx.not_empty);
+    ice_fs_cond_init(&ctx.not_full);
+
+    walk.on_item = ice_fs_copy_dir_item;
+    walk.on_leave = 0;
+    walk.user = &ctx;
+
+    /* Directory skeleton, Unreadable directories fail the copy */
+    if ((ice_fs_walk_run(&walk, path1, ice_fs_get_threads_count()) == ICE_FS_FALSE) && (ctx.failed == ICE_FS_FALSE)) {
+        ctx.failed = ICE_FS_TRUE;
+        ctx.error = ((walk.error != 0) ? walk.error : EIO);
+    }
+
+    if ((ctx.failed == ICE_FS_TRUE) || (ctx.files_count == 0)) goto end;
+
+    threads_count = ((ice_fs_copy_limit != 0) ? ice_fs_copy_limit : (ice_fs_get_threads_count() * 4));
+    if (threads_count > ctx.files_count) threads_count = ctx.files_count;
+
+    ctx.queue_capacity = (threads_count * 2);
+    ctx.queue = ICE_FS_MALLOC(ctx.queue_capacity * sizeof(char*));
+    threads = ICE_FS_MALLOC(threads_count * sizeof(ice_fs_thread));
+
+    if ((ctx.queue == 0) || (threads == 0)) {
+        ctx.failed = ICE_FS_TRUE;
+        ctx.error = ENOMEM;
+        goto end;
+    }
+
+    for (i = 0; i < threads_count; i++) {
+        if (ice_fs_thread_start(&threads[started], ice_fs_copy_dir_worker, &ctx) == ICE_FS_FALSE) break;
+        started++;
+    }
+
+    if (started == 0) {
+        /* No threads available, Copy from calling thread instead */
+        for (i = 0; (i < ctx.files_count) && (ctx.failed == ICE_FS_FALSE); i++) {
+            char *dst = ice_fs_copy_target(&ctx, ctx.files[i]);
+
+            if (dst == 0) {
+                ice_fs_copy_fail(&ctx, ENOMEM);
+            } else {
+                if (ice_fs_copy_file(ctx.files[i], dst) == ICE_FS_FALSE) ice_fs_copy_fail(&ctx, errno);
+                ICE_FS_FREE(dst);
+            }
+        }
+
+        goto end;
+    }
+
+    ice_fs_mutex_lock(&ctx.mutex);
+
+    for (i = 0; i < ctx.files_count; i++) {
+        while ((ctx.queue_count == ctx.queue_capacity) && (ctx.failed == ICE_FS_FALSE)) {
+            ice_fs_cond_wait(&ctx.not_full, &ctx.mutex);
+        }
+
+        /* Stop queueing as soon as any copy fails */
+        if (ctx.failed == ICE_FS_TRUE) break;
+
+        ctx.queue[(ctx.queue_head + ctx.queue_count) % ctx.queue_capacity] = ctx.files[i];
+        ctx.queue_count++;
+        ice_fs_cond_signal(&ctx.not_empty);
+    }
+
+    ctx.closed = ICE_FS_TRUE;
+    ice_fs_cond_broadcast(&ctx.not_empty);
+    ice_fs_mutex_unlock(&ctx.mutex);
+
+    for (i = 0; i < started; i++) ice_fs_thread_join(&threads[i]);
+
+end:
+    if (threads != 0) ICE_FS_FREE(threads);
+    if (ctx.queue != 0) ICE_FS_FREE(ctx.queue);
+    if (ctx.files != 0) ICE_FS_FREE(ctx.files);
+    ice_fs_str_arena_free(&ctx.arena);
+    ice_fs_cond_destroy(&ctx.not_full);
+    ice_fs_cond_destroy(&ctx.not_empty);
+    ice_fs_mutex_destroy(&ctx.mutex);
+
+    if (ctx.failed == ICE_FS_TRUE) {
+        errno = ctx.error;
+        return ICE_FS_FALSE;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* Copies file/folder from path1 to path2 (Files of folders are copied in parallel), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (errno is set to the first error that occurred) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_copy(const char *path1, const char *path2) {
+    ice_fs_object_type t1, t2;
+    
+    if ((path1 == 0) || (path2 == 0)) return ICE_FS_FALSE;
+
+    t1 = ice_fs_type(path1);
+    t2 = ice_fs_type(path2);
+    
+    if ((t1 == ICE_FS_OBJECT_TYPE_DIR) && (t2 == ICE_FS_OBJECT_TYPE_DIR)) {
+        return ice_fs_copy_dir(path1, path2);
+        
+    } else if ((t1 == ICE_FS_OBJECT_TYPE_FILE) && (t2 == ICE_FS_OBJECT_TYPE_FILE || t2 == ICE_FS_OBJECT_TYPE_NONE)) {
+        return ice_fs_copy_file(path1, path2);
+        
+    } else if ((t1 == ICE_FS_OBJECT_TYPE_FILE) && (t2 == ICE_FS_OBJECT_TYPE_DIR)) {
+        ice_fs_bool write_res;
+        char *filename, *path;
+        
+        filename = ice_fs_filename(path1, ICE_FS_TRUE);
+        path = ice_fs_concat_path(path2, filename);
+        
+        write_res = ice_fs_copy_file(path1, path);
+        
+        ice_fs_free_str(filename);
+        ice_fs_free_str(path);
+        
+        return write_res;
+    }
+    
+    return ICE_FS_FALSE;
+}
+
+/* Moves file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_move(const char *path1, const char *path2) {
+    return ice_fs_rename_at(0, path1, 0, path2);
+}
+
+/* Renames file/folder from path1 to path2, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_rename(const char *path1, const char *path2) {
+    return ice_fs_move(path1, path2);
+}
+
+/* Same like ice_fs_rename but relative path1 is resolved from directory of dir1 handle and relative path2 from directory of dir2 handle (Current directory if NULL) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_rename_at(const ice_fs_dir_handle *dir1, const char *path1, const ice_fs_dir_handle *dir2, const char *path2) {
+    int move_res;
+#if defined(ICE_FS_MICROSOFT)
+    const char *at_path1, *at_path2;
+#endif
+
+    if ((path1 == 0) || (path2 == 0)) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_MICROSOFT)
+    at_path1 = ice_fs_at_path(dir1, path1);
+    at_path2 = ice_fs_at_path(dir2, path2);
+
+    move_res = (((at_path1 != 0) && (at_path2 != 0)) ? MoveFileA(at_path1, at_path2) : 0);
+
+    ice_fs_at_path_free(path1, at_path1);
+    ice_fs_at_path_free(path2, at_path2);
+
+    return (move_res != 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#elif defined(ICE_FS_UNIX)
+    move_res = renameat(ice_fs_at_fd(dir1), path1, ice_fs_at_fd(dir2), path2);
+    return (move_res == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+#endif
+}
+
+/* Returns ICE_FS_TRUE if file/folder in specific path is empty or ICE_FS_FALSE if not empty */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_is_empty(const char *path) {
+    ice_fs_object_type type;
+
+    if (path == 0) return ICE_FS_FALSE;
+    type = ice_fs_type(path);
+    
+    if (type == ICE_FS_OBJECT_TYPE_FILE) {
+        struct stat info;
+        int stat_res = stat(path, &info);
+        if (stat_res == -1) return ICE_FS_FALSE;
+        return (info.st_size == 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+        
+    } else if (type == ICE_FS_OBJECT_TYPE_DIR) {
+        ice_fs_dir_iter iter;
+        ice_fs_object item;
+        ice_fs_bool has_item;
+        char buf[ICE_FS_DIR_ITER_MIN_BUFFER_SIZE + 8];
+
+        if (ice_fs_dir_iter_open(&iter, path, buf, sizeof(buf)) == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+        /* Only first item is needed to know that directory is not empty */
+        has_item = ice_fs_dir_iter_next(&iter, &item);
+        if (ice_fs_dir_iter_close(&iter) == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+        return (has_item == ICE_FS_TRUE) ? ICE_FS_FALSE : ICE_FS_TRUE;
+    }
+    
+    return ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Returns [last modification, last status change, last access] time in info in nanoseconds since epoch, Or -1 if date_type is invalid */
+static ice_fs_offset ice_fs_stat_time(const struct stat *info, ice_fs_date_type date_type) {
+#if defined(ICE_FS_UNIX) && defined(__APPLE__)
+    if (date_type == ICE_FS_LAST_ACCESS_DATE) return (((ice_fs_offset) info->st_atimespec.tv_sec) * 1000000000) + info->st_atimespec.tv_nsec;
+    else if (date_type == ICE_FS_LAST_MODIFICATION_DATE) return (((ice_fs_offset) info->st_mtimespec.tv_sec) * 1000000000) + info->st_mtimespec.tv_nsec;
+    else if (date_type == ICE_FS_LAST_STATUS_CHANGE_DATE) return (((ice_fs_offset) info->st_ctimespec.tv_sec) * 1000000000) + info->st_ctimespec.tv_nsec;
+#elif defined(ICE_FS_UNIX) && (defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__))
+    if (date_type == ICE_FS_LAST_ACCESS_DATE) return (((ice_fs_offset) info->st_atim.tv_sec) * 1000000000) + info->st_atim.tv_nsec;
+    else if (date_type == ICE_FS_LAST_MODIFICATION_DATE) return (((ice_fs_offset) info->st_mtim.tv_sec) * 1000000000) + info->st_mtim.tv_nsec;
+    else if (date_type == ICE_FS_LAST_STATUS_CHANGE_DATE) return (((ice_fs_offset) info->st_ctim.tv_sec) * 1000000000) + info->st_ctim.tv_nsec;
+#else
+    if (date_type == ICE_FS_LAST_ACCESS_DATE) return ((ice_fs_offset) info->st_atime) * 1000000000;
+    else if (date_type == ICE_FS_LAST_MODIFICATION_DATE) return ((ice_fs_offset) info->st_mtime) * 1000000000;
+    else if (date_type == ICE_FS_LAST_STATUS_CHANGE_DATE) return ((ice_fs_offset) info->st_ctime) * 1000000000;
+#endif
+    return -1;
+}
+
+/* [INTERNAL] Returns number of days since epoch of day in date of proleptic Gregorian calendar (month is 1 - 12) */
+static ice_fs_offset ice_fs_date_days(ice_fs_offset year, unsigned month, unsigned day) {
+    ice_fs_offset era, year_of_era, day_of_era, day_of_year;
+
+    /* Years start at March so that leap day is last day of year */
+    if (month <= 2) year--;
+
+    era = ((year >= 0) ? year : (year - 399)) / 400;
+    year_of_era = year - (era * 400);
+    day_of_year = (((153 * ((month > 2) ? (month - 3) : (month + 9))) + 2) / 5) + day - 1;
+    day_of_era = (year_of_era * 365) + (year_of_era / 4) - (year_of_era / 100) + day_of_year;
+
+    return (era * 146097) + day_of_era - 719468;
+}
+
+/* [INTERNAL] Writes unsigned number num with at least width digits (Padded with pad char) to str at offset, Returns offset after the number */
+static unsigned long ice_fs_date_write_num(char *str, unsigned long offset, unsigned long num, unsigned width, char pad) {
+    char digits[20];
+    unsigned count = 0;
+
+    do {
+        digits[count++] = (char) ('0' + (num % 10));
+        num /= 10;
+    } while (num > 0);
+
+    while (width > count) {
+        str[offset++] = pad;
+        width--;
+    }
+
+    while (count > 0) str[offset++] = digits[--count];
+
+    return offset;
+}
+
+/* Converts time in seconds since epoch (Shifted by utc_offset seconds for local time, 0 for UTC) to date in info with arithmetic alone (Thread-safe), str should be caller-provided buffer of str_size bytes (At least ICE_FS_DATE_STR_SIZE) that date is written into as string in same format as ctime and that info->str points to, Or NULL to set info->str to NULL, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_date_from_epoch(ice_fs_offset epoch, long utc_offset, ice_fs_date *info, char *str, unsigned long str_size) {
+    static const char week_days[] = "SunMonTueWedThuFriSat";
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    ice_fs_offset secs = epoch + utc_offset, days, rem, era, day_of_era, year_of_era, day_of_year, year, week_day;
+    unsigned month, month_day, i;
+    unsigned long len;
+
+    if (info == 0) return ICE_FS_FALSE;
+
+    days = secs / 86400;
+    rem = secs % 86400;
+
+    if (rem < 0) {
+        rem += 86400;
+        days--;
+    }
+
+    /* Inverse of ice_fs_date_days, Counts eras of 400 years (146097 days) from 0000-03-01 */
+    era = (((days + 719468) >= 0) ? (days + 719468) : (days + 719468 - 146096)) / 146097;
+    day_of_era = days + 719468 - (era * 146097);
+    year_of_era = (day_of_era - (day_of_era / 1460) + (day_of_era / 36524) - (day_of_era / 146096)) / 365;
+    day_of_year = day_of_era - ((365 * year_of_era) + (year_of_era / 4) - (year_of_era / 100));
+    month = (unsigned) (((5 * day_of_year) + 2) / 153);
+    month_day = (unsigned) (day_of_year - (((153 * month) + 2) / 5) + 1);
+    month = ((month < 10) ? (month + 3) : (month - 9));
+    year = (era * 400) + year_of_era + ((month <= 2) ? 1 : 0);
+
+    if (year < 0) return ICE_FS_FALSE;
+
+    /* 1970-01-01 was Thursday */
+    week_day = (days + 4) % 7;
+    if (week_day < 0) week_day += 7;
+
+    info->epoch = (unsigned long) epoch;
+    info->seconds = (unsigned) (rem % 60);
+    info->minutes = (unsigned) ((rem / 60) % 60);
+    info->hour = (unsigned) (rem / 3600);
+    info->week_day = (ice_fs_date_day) (week_day + 1);
+    info->month_day = month_day;
+    info->year_day = (unsigned) (days - ice_fs_date_days(year, 1, 1) + 1);
+    info->month = (ice_fs_date_month) month;
+    info->year = (unsigned) year;
+
+    if (month == 12 || month == 1 || month == 2) {
+        info->season = ICE_FS_DATE_SEASON_WINTER;
+    } else if (month == 3 || month == 4 || month == 5) {
+        info->season = ICE_FS_DATE_SEASON_SPRING;
+    } else if (month == 6 || month == 7 || month == 8) {
+        info->season = ICE_FS_DATE_SEASON_SUMMER;
+    } else {
+        info->season = ICE_FS_DATE_SEASON_AUTUMN;
+    }
+
+    info->str = 0;
+    if (str == 0) return ICE_FS_TRUE;
+
+    /* Years past 9999 need more space than ICE_FS_DATE_STR_SIZE */
+    if (str_size < (ICE_FS_DATE_STR_SIZE + ((year > 9999) ? 16 : 0))) return ICE_FS_FALSE;
+
+    /* Www Mmm dd hh:mm:ss yyyy\n */
+    for (i = 0; i < 3; i++) str[i] = week_days[(week_day * 3) + i];
+    str[3] = ' ';
+    for (i = 0; i < 3; i++) str[4 + i] = months[((month - 1) * 3) + i];
+    str[7] = ' ';
+    len = ice_fs_date_write_num(str, 8, month_day, 2, ' ');
+    str[len++] = ' ';
+    len = ice_fs_date_write_num(str, len, info->hour, 2, '0');
+    str[len++] = ':';
+    len = ice_fs_date_write_num(str, len, info->minutes, 2, '0');
+    str[len++] = ':';
+    len = ice_fs_date_write_num(str, len, info->seconds, 2, '0');
+    str[len++] = ' ';
+    len = ice_fs_date_write_num(str, len, (unsigned long) year, 4, '0');
+    str[len++] = '\n';
+    str[len] = 0;
+
+    info->str = str;
+
+    return ICE_FS_TRUE;
+}
+
+/* Same like ice_fs_get_date but thread-safe (Uses no static storage), str should be caller-provided buffer of str_size bytes (At least ICE_FS_DATE_STR_SIZE) that date is written into as string and that info->str points to, Or NULL to set info->str to NULL, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_date_r(const char *path, ice_fs_date_type date_type, ice_fs_date *info, char *str, unsigned long str_size) {
+    struct stat pinfo;
+    struct tm local;
+    ice_fs_offset ns, secs, offset;
+    time_t t;
+
+    if ((path == 0) || (info == 0)) return ICE_FS_FALSE;
+    if (stat(path, &pinfo) == -1) return ICE_FS_FALSE;
+
+    ns = ice_fs_stat_time(&pinfo, date_type);
+    if (ns == -1) return ICE_FS_FALSE;
+
+    secs = ns / 1000000000;
+    if ((ns % 1000000000) < 0) secs--;
+    t = (time_t) secs;
+
+    /* Only offset of local time from UTC (Which depends on daylight saving time of the date) is taken from libc */
+#if defined(ICE_FS_MICROSOFT)
+    if (localtime_s(&local, &t) != 0) return ICE_FS_FALSE;
+#elif defined(ICE_FS_UNIX)
+    if (localtime_r(&t, &local) == 0) return ICE_FS_FALSE;
+#endif
+
+    offset = (ice_fs_date_days(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday) * 86400) + (local.tm_hour * 3600) + (local.tm_min * 60) + local.tm_sec - secs;
+
+    return ice_fs_date_from_epoch(secs, (long) offset, info, str, str_size);
+}
+
+/* Retrieves [last modification, last status change, last access] date of file/directory and stores info in info struct by pointing to, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, info->str points to static buffer that next call overwrites (ice_fs_get_date_r should be used from multiple threads) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_date(const char *path, ice_fs_date_type date_type, ice_fs_date *info) {
+    static char str[ICE_FS_DATE_STR_SIZE + 16];
+    return ice_fs_get_date_r(path, date_type, info, str, sizeof(str));
+}
+
+/* Stores [last modification, last status change, last access] time of each of paths_count paths in times in nanoseconds since epoch (-1 for paths that don't exist or can't be accessed), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_times(const char **paths, unsigned long paths_count, ice_fs_date_type date_type, ice_fs_offset *times) {
+    struct stat pinfo;
+    unsigned long i;
+
+    if (((paths == 0) || (times == 0)) && (paths_count > 0)) return ICE_FS_FALSE;
+    if ((date_type != ICE_FS_LAST_ACCESS_DATE) && (date_type != ICE_FS_LAST_MODIFICATION_DATE) && (date_type != ICE_FS_LAST_STATUS_CHANGE_DATE)) return ICE_FS_FALSE;
+
+    for (i = 0; i < paths_count; i++) {
+        if ((paths[i] == 0) || (stat(paths[i], &pinfo) == -1)) times[i] = -1;
+        else times[i] = ice_fs_stat_time(&pinfo, date_type);
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Number of paths that each thread of ice_fs_get_stats takes at once */
+#define ICE_FS_STATS_CHUNK 256
+
+/* [INTERNAL] State shared by threads of ice_fs_get_stats */
+typedef struct ice_fs_stats_ctx {
+    ice_fs_mutex mutex;
+    const char **paths;
+    ice_fs_stat_info *infos;
+    unsigned long paths_count;
+    unsigned long next;                 /* Index of first path that no thread took yet */
+    unsigned fields;
+} ice_fs_stats_ctx;
+
+/* [INTERNAL] Retrieves fields of metadata of object in path into info */
+static void ice_fs_stats_one(const char *path, unsigned fields, ice_fs_stat_info *info) {
+#if defined(ICE_FS_MICROSOFT)
+    struct _stati64 st;
+#elif defined(ICE_FS_UNIX)
+    struct stat st;
+#endif
+#if defined(ICE_FS_STATX)
+    struct statx stx;
+    unsigned mask = 0;
+#endif
+
+    info->size = 0;
+    info->mtime = 0;
+    info->mode = 0;
+    info->type = ICE_FS_OBJECT_TYPE_NONE;
+    info->error = 0;
+
+    if (path == 0) {
+        info->error = EINVAL;
+        return;
+    }
+
+#if defined(ICE_FS_STATX)
+    /* statx lets filesystem skip fields that weren't asked for (Like size of files on network filesystems) */
+    if ((fields & ICE_FS_STAT_TYPE) != 0) mask |= STATX_TYPE;
+    if ((fields & ICE_FS_STAT_SIZE) != 0) mask |= STATX_SIZE;
+    if ((fields & ICE_FS_STAT_MTIME) != 0) mask |= STATX_MTIME;
+    if ((fields & ICE_FS_STAT_MODE) != 0) mask |= STATX_MODE;
+
+    if (syscall(SYS_statx, AT_FDCWD, path, AT_STATX_SYNC_AS_STAT, mask, &stx) == 0) {
+        if ((fields & ICE_FS_STAT_TYPE) != 0) info->type = (((stx.stx_mode & S_IFMT) == S_IFDIR) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE);
+        if ((fields & ICE_FS_STAT_SIZE) != 0) info->size = (ice_fs_offset) stx.stx_size;
+        if ((fields & ICE_FS_STAT_MTIME) != 0) info->mtime = (((ice_fs_offset) stx.stx_mtime.tv_sec) * 1000000000) + stx.stx_mtime.tv_nsec;
+        if ((fields & ICE_FS_STAT_MODE) != 0) info->mode = (unsigned) (stx.stx_mode & 07777);
+        return;
+    }
+
+    /* Kernels older than 4.11 (Or sandboxes) may not have statx */
+    if (errno != ENOSYS) {
+        info->error = errno;
+        return;
+    }
+#endif
+
+#if defined(ICE_FS_MICROSOFT)
+    if (_stati64(path, &st) == -1) {
+#elif defined(ICE_FS_UNIX)
+    if (stat(path, &st) == -1) {
+#endif
+        info->error = errno;
+        return;
+    }
+
+    if ((fields & ICE_FS_STAT_TYPE) != 0) info->type = (((st.st_mode & S_IFMT) == S_IFDIR) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE);
+    if ((fields & ICE_FS_STAT_SIZE) != 0) info->size = (ice_fs_offset) st.st_size;
+#if defined(ICE_FS_MICROSOFT)
+    if ((fields & ICE_FS_STAT_MTIME) != 0) info->mtime = ((ice_fs_offset) st.st_mtime) * 1000000000;
+#elif defined(ICE_FS_UNIX)
+    if ((fields & ICE_FS_STAT_MTIME) != 0) info->mtime = ice_fs_stat_time(&st, ICE_FS_LAST_MODIFICATION_DATE);
+#endif
+    if ((fields & ICE_FS_STAT_MODE) != 0) info->mode = (unsigned) (st.st_mode & 07777);
+}
+
+/* [INTERNAL] Thread of ice_fs_get_stats, Takes chunks of paths till none are left */
+static void ice_fs_stats_worker(void *arg) {
+    ice_fs_stats_ctx *ctx = (ice_fs_stats_ctx*) arg;
+    unsigned long start, end;
+
+    for (;;) {
+        ice_fs_mutex_lock(&ctx->mutex);
+        start = ctx->next;
+        end = (((ctx->paths_count - start) > ICE_FS_STATS_CHUNK) ? (start + ICE_FS_STATS_CHUNK) : ctx->paths_count);
+        ctx->next = end;
+        ice_fs_mutex_unlock(&ctx->mutex);
+
+        if (start == end) break;
+        for (; start < end; start++) ice_fs_stats_one(ctx->paths[start], ctx->fields, &ctx->infos[start]);
+    }
+}
+
+/* Retrieves fields (Combination of ice_fs_stat_field flags) of metadata of each of paths_count paths into infos (Many at once on multiple threads, With statx on Linux), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Paths that don't exist or can't be accessed don't fail the call (Their type is ICE_FS_OBJECT_TYPE_NONE and error is set) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_get_stats(const char **paths, unsigned long paths_count, unsigned fields, ice_fs_stat_info *infos) {
+    ice_fs_stats_ctx ctx;
+    ice_fs_thread *threads;
+    unsigned long threads_count = ice_fs_get_threads_count(), started = 0, i;
+
+    if (((paths == 0) || (infos == 0)) && (paths_count > 0)) return ICE_FS_FALSE;
+
+    /* Each thread should get few chunks at least, Calling thread runs one of them */
+    if (threads_count > (paths_count / (ICE_FS_STATS_CHUNK * 2))) threads_count = (paths_count / (ICE_FS_STATS_CHUNK * 2));
+
+    if (threads_count <= 1) {
+        for (i = 0; i < paths_count; i++) ice_fs_stats_one(paths[i], fields, &infos[i]);
+        return ICE_FS_TRUE;
+    }
+
+    ctx.paths = paths;
+    ctx.infos = infos;
+    ctx.paths_count = paths_count;
+    ctx.next = 0;
+    ctx.fields = fields;
+    ice_fs_mutex_init(&ctx.mutex);
+
+    /* Without threads everything runs on calling thread */
+    threads = ICE_FS_MALLOC((threads_count - 1) * sizeof(ice_fs_thread));
+
+    if (threads != 0) {
+        for (i = 0; i < (threads_count - 1); i++) {
+            if (ice_fs_thread_start(&threads[started], ice_fs_stats_worker, &ctx) == ICE_FS_FALSE) break;
+            started++;
+        }
+    }
+
+    ice_fs_stats_worker(&ctx);
+
+    for (i = 0; i < started; i++) ice_fs_thread_join(&threads[i]);
+
+    ICE_FS_FREE(threads);
+    ice_fs_mutex_destroy(&ctx.mutex);
+
+    return ICE_FS_TRUE;
+}
+
+/* ============================== Batched I/O ============================== */
+
+/* [INTERNAL] Largest number of bytes that single read/write request transfers (Same limit Linux has) */
+#define ICE_FS_BATCH_MAX_LEN 0x7ffff000UL
+
+/* [INTERNAL] Runs request on calling thread with blocking calls and stores its result */
+static void ice_fs_batch_run(ice_fs_batch_req *req) {
+    unsigned long len = ((req->len > ICE_FS_BATCH_MAX_LEN) ? ICE_FS_BATCH_MAX_LEN : req->len);
+    int flags;
+    long res = 0;
+
+    if (req->op == ICE_FS_BATCH_OP_OPEN) {
+        flags = ice_fs_stream_flags(req->mode);
+
+        if ((flags == -1) || (req->path == 0)) {
+            res = -EINVAL;
+        } else {
+#if defined(ICE_FS_MICROSOFT)
+            req->fd = open(req->path, flags | O_BINARY, S_IREAD | S_IWRITE);
+#elif defined(ICE_FS_UNIX)
+            req->fd = open(req->path, flags, 0666);
+#endif
+            if (req->fd == -1) res = -errno;
+        }
+
+    } else if ((req->op == ICE_FS_BATCH_OP_READ) || (req->op == ICE_FS_BATCH_OP_WRITE)) {
+#if defined(ICE_FS_MICROSOFT)
+        HANDLE handle = (HANDLE) _get_osfhandle(req->fd);
+        OVERLAPPED overlapped;
+        DWORD done = 0;
+        BOOL ok;
+
+        /* Offset of OVERLAPPED struct makes reads/writes positional like pread/pwrite */
+        memset(&overlapped, 0, sizeof(overlapped));
+        overlapped.Offset = (DWORD) (req->offset & 0xffffffff);
+        overlapped.OffsetHigh = (DWORD) (req->offset >> 32);
+
+        if (handle == INVALID_HANDLE_VALUE) {
+            res = -EBADF;
+        } else {
+            if (req->op == ICE_FS_BATCH_OP_READ) ok = ReadFile(handle, req->buf, (DWORD) len, &done, &overlapped);
+            else ok = WriteFile(handle, req->buf, (DWORD) len, &done, &overlapped);
+
+            if ((ok != 0) || (GetLastError() == ERROR_HANDLE_EOF)) res = (long) done;
+            else res = -EIO;
+        }
+#elif defined(ICE_FS_UNIX)
+        do {
+            if (req->op == ICE_FS_BATCH_OP_READ) res = (long) pread(req->fd, req->buf, (size_t) len, (off_t) req->offset);
+            else res = (long) pwrite(req->fd, req->buf, (size_t) len, (off_t) req->offset);
+        } while ((res == -1) && (errno == EINTR));
+
+        if (res == -1) res = -errno;
+#endif
+
+    } else if (req->op == ICE_FS_BATCH_OP_STAT) {
+#if defined(ICE_FS_MICROSOFT)
+        struct _stati64 info;
+        int stat_res = ((req->path != 0) ? _stati64(req->path, &info) : _fstati64(req->fd, &info));
+#elif defined(ICE_FS_UNIX)
+        struct stat info;
+        int stat_res = ((req->path != 0) ? stat(req->path, &info) : fstat(req->fd, &info));
+#endif
+
+        if (stat_res == -1) {
+            res = -errno;
+        } else {
+            req->size = (ice_fs_offset) info.st_size;
+            req->type = (((info.st_mode & S_IFMT) == S_IFDIR) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE);
+        }
+
+    } else if (req->op == ICE_FS_BATCH_OP_CLOSE) {
+        if (close(req->fd) == -1) res = -errno;
+
+    } else {
+        res = -EINVAL;
+    }
+
+    req->result = res;
+}
+
+/* [INTERNAL] Pool of threads that runs requests of batch when io_uring is unavailable */
+typedef struct ice_fs_batch_pool {
+    ice_fs_mutex mutex;
+    ice_fs_cond work_cond;          /* Signaled when requests are submitted or pool is closing */
+    ice_fs_cond done_cond;          /* Signaled when all submitted requests are done */
+    ice_fs_batch_req *reqs;         /* Submitted requests */
+    unsigned long reqs_count;
+    unsigned long next;             /* Index of next request to run */
+    unsigned long pending;          /* Number of submitted requests that aren't done yet */
+    ice_fs_bool closing;
+    ice_fs_thread *threads;
+    unsigned long threads_count;
+} ice_fs_batch_pool;
+
+/* [INTERNAL] Runs submitted requests of pool till all of them are taken, pool mutex should be locked */
+static void ice_fs_batch_pool_drain(ice_fs_batch_pool *pool) {
+    while (pool->next < pool->reqs_count) {
+        ice_fs_batch_req *req = &pool->reqs[pool->next++];
+
+        ice_fs_mutex_unlock(&pool->mutex);
+        ice_fs_batch_run(req);
+        ice_fs_mutex_lock(&pool->mutex);
+
+        pool->pending--;
+        if (pool->pending == 0) ice_fs_cond_broadcast(&pool->done_cond);
+    }
+}
+
+/* [INTERNAL] Thread of pool, Waits for submitted requests and runs them till pool is closing */
+static void ice_fs_batch_pool_worker(void *arg) {
+    ice_fs_batch_pool *pool = (ice_fs_batch_pool*) arg;
+
+    ice_fs_mutex_lock(&pool->mutex);
+
+    while (pool->closing == ICE_FS_FALSE) {
+        if (pool->next < pool->reqs_count) ice_fs_batch_pool_drain(pool);
+        else ice_fs_cond_wait(&pool->work_cond, &pool->mutex);
+    }
+
+    ice_fs_mutex_unlock(&pool->mutex);
+}
+
+/* [INTERNAL] Stops threads of pool and frees it */
+static void ice_fs_batch_pool_close(ice_fs_batch_pool *pool) {
+    unsigned long i;
+
+    ice_fs_mutex_lock(&pool->mutex);
+    pool->closing = ICE_FS_TRUE;
+    ice_fs_cond_broadcast(&pool->work_cond);
+    ice_fs_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < pool->threads_count; i++) ice_fs_thread_join(&pool->threads[i]);
+
+    ice_fs_cond_destroy(&pool->work_cond);
+    ice_fs_cond_destroy(&pool->done_cond);
+    ice_fs_mutex_destroy(&pool->mutex);
+    ICE_FS_FREE(pool->threads);
+    ICE_FS_FREE(pool);
+}
+
+/* [INTERNAL] Creates pool with threads to keep up to depth requests in flight (Calling thread runs requests too), Returns the pool on success or NULL on failure */
+static ice_fs_batch_pool* ice_fs_batch_pool_open(unsigned long depth) {
+    ice_fs_batch_pool *pool;
+    unsigned long threads_count = (ice_fs_get_threads_count() * 4), i;
+
+    /* Blocking calls wait for the disk most of time, So there are more threads than CPU cores like in ice_fs_copy */
+    if (threads_count > depth) threads_count = depth;
+    threads_count--;
+
+    pool = ICE_FS_MALLOC(sizeof(ice_fs_batch_pool));
+    if (pool == 0) return 0;
+
+    pool->reqs = 0;
+    pool->reqs_count = 0;
+    pool->next = 0;
+    pool->pending = 0;
+    pool->closing = ICE_FS_FALSE;
+    pool->threads_count = 0;
+    pool->threads = 0;
+
+    if (threads_count > 0) {
+        pool->threads = ICE_FS_MALLOC(threads_count * sizeof(ice_fs_thread));
+
+        if (pool->threads == 0) {
+            ICE_FS_FREE(pool);
+            return 0;
+        }
+    }
+
+    ice_fs_mutex_init(&pool->mutex);
+    ice_fs_cond_init(&pool->work_cond);
+    ice_fs_cond_init(&pool->done_cond);
+
+    /* Pool works with fewer threads (Or none) if some couldn't be started */
+    for (i = 0; i < threads_count; i++) {
+        if (ice_fs_thread_start(&pool->threads[pool->threads_count], ice_fs_batch_pool_worker, pool) == ICE_FS_FALSE) break;
+        pool->threads_count++;
+    }
+
+    return pool;
+}
+
+/* [INTERNAL] Runs requests on threads of pool and on calling thread, Returns when all of them are done */
+static void ice_fs_batch_pool_submit(ice_fs_batch_pool *pool, ice_fs_batch_req *reqs, unsigned long reqs_count) {
+    ice_fs_mutex_lock(&pool->mutex);
+
+    pool->reqs = reqs;
+    pool->reqs_count = reqs_count;
+    pool->next = 0;
+    pool->pending = reqs_count;
+    ice_fs_cond_broadcast(&pool->work_cond);
+
+    ice_fs_batch_pool_drain(pool);
+    while (pool->pending > 0) ice_fs_cond_wait(&pool->done_cond, &pool->mutex);
+
+    pool->reqs = 0;
+    pool->reqs_count = 0;
+    pool->next = 0;
+
+    ice_fs_mutex_unlock(&pool->mutex);
+}
+
+#if defined(ICE_FS_IO_URING)
+/* [INTERNAL] io_uring ring of batch with its queues mapped into memory, Each request in flight owns slot that is passed as user_data */
+typedef struct ice_fs_uring {
+    int fd;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned sq_entries;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ptr;
+    size_t sq_size;
+    void *cq_ptr;
+    size_t cq_size;
+    size_t sqes_size;
+    unsigned long *slot_reqs;       /* Index of request that each slot runs */
+    unsigned long *free_slots;      /* Stack of slots that aren't in flight */
+    unsigned long free_count;
+    struct statx *stats;            /* Buffer of STAT request that each slot runs */
+    unsigned long depth;            /* Number of slots */
+} ice_fs_uring;
+
+/* [INTERNAL] Unmaps queues of ring, Closes it and frees it */
+static ice_fs_bool ice_fs_uring_close(ice_fs_uring *ring) {
+    ice_fs_bool res = ICE_FS_TRUE;
+
+    if (ring->sqes != 0) (void) munmap(ring->sqes, ring->sqes_size);
+    if ((ring->cq_ptr != 0) && (ring->cq_ptr != ring->sq_ptr)) (void) munmap(ring->cq_ptr, ring->cq_size);
+    if (ring->sq_ptr != 0) (void) munmap(ring->sq_ptr, ring->sq_size);
+    if (close(ring->fd) == -1) res = ICE_FS_FALSE;
+
+    ICE_FS_FREE(ring->slot_reqs);
+    ICE_FS_FREE(ring->free_slots);
+    ICE_FS_FREE(ring->stats);
+    ICE_FS_FREE(ring);
+
+    return res;
+}
+
+/* [INTERNAL] Returns ICE_FS_TRUE if kernel of ring supports all operations of ice_fs_batch_op or ICE_FS_FALSE if not (Or kernel can't tell) */
+static ice_fs_bool ice_fs_uring_probe(int fd) {
+    static const unsigned char ops[] = { IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_STATX, IORING_OP_CLOSE };
+    struct io_uring_probe *probe;
+    unsigned long probe_size = (sizeof(struct io_uring_probe) + (256 * sizeof(struct io_uring_probe_op))), i;
+    ice_fs_bool res = ICE_FS_TRUE;
+
+    probe = ICE_FS_MALLOC(probe_size);
+    if (probe == 0) return ICE_FS_FALSE;
+    memset(probe, 0, probe_size);
+
+    if (syscall(SYS_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) < 0) {
+        res = ICE_FS_FALSE;
+    } else {
+        for (i = 0; i < (sizeof(ops) / sizeof(ops[0])); i++) {
+            if ((ops[i] > probe->last_op) || ((probe->ops[ops[i]].flags & IO_URING_OP_SUPPORTED) == 0)) res = ICE_FS_FALSE;
+        }
+    }
+
+    ICE_FS_FREE(probe);
+    return res;
+}
+
+/* [INTERNAL] Creates ring with depth slots and maps its queues, Returns the ring on success or NULL on failure (io_uring is unavailable or disabled) */
+static ice_fs_uring* ice_fs_uring_open(unsigned long depth) {
+    struct io_uring_params params;
+    ice_fs_uring *ring;
+    long fd;
+    unsigned long i;
+
+    memset(&params, 0, sizeof(params));
+
+    fd = syscall(SYS_io_uring_setup, (unsigned) depth, &params);
+    if (fd < 0) return 0;
+
+    ring = ICE_FS_CALLOC(1, sizeof(ice_fs_uring));
+
+    if (ring == 0) {
+        (void) close((int) fd);
+        return 0;
+    }
+
+    ring->fd = (int) fd;
+    ring->sq_entries = params.sq_entries;
+
+    if (ice_fs_uring_probe(ring->fd) == ICE_FS_FALSE) goto failure;
+
+    ring->slot_reqs = ICE_FS_MALLOC(depth * sizeof(unsigned long));
+    ring->free_slots = ICE_FS_MALLOC(depth * sizeof(unsigned long));
+    ring->stats = ICE_FS_MALLOC(depth * sizeof(struct statx));
+    if ((ring->slot_reqs == 0) || (ring->free_slots == 0) || (ring->stats == 0)) goto failure;
+
+    for (i = 0; i < depth; i++) ring->free_slots[i] = (depth - i - 1);
+    ring->free_count = depth;
+    ring->depth = depth;
+
+    ring->sq_size = (params.sq_off.array + (params.sq_entries * sizeof(unsigned)));
+    ring->cq_size = (params.cq_off.cqes + (params.cq_entries * sizeof(struct io_uring_cqe)));
+
+    /* Both queues share one mapping on kernels that support it */
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        if (ring->cq_size > ring->sq_size) ring->sq_size = ring->cq_size;
+        ring->cq_size = ring->sq_size;
+    }
+
+    ring->sq_ptr = mmap(0, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+
+    if (ring->sq_ptr == MAP_FAILED) {
+        ring->sq_ptr = 0;
+        goto failure;
+    }
+
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        ring->cq_ptr = ring->sq_ptr;
+    } else {
+        ring->cq_ptr = mmap(0, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+
+        if (ring->cq_ptr == MAP_FAILED) {
+            ring->cq_ptr = 0;
+            goto failure;
+        }
+    }
+
+    ring->sqes_size = (params.sq_entries * sizeof(struct io_uring_sqe));
+    ring->sqes = mmap(0, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = 0;
+        goto failure;
+    }
+
+    ring->sq_head = (unsigned*) ((char*) ring->sq_ptr + params.sq_off.head);
+    ring->sq_tail = (unsigned*) ((char*) ring->sq_ptr + params.sq_off.tail);
+    ring->sq_mask = (unsigned*) ((char*) ring->sq_ptr + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*) ((char*) ring->sq_ptr + params.sq_off.array);
+    ring->cq_head = (unsigned*) ((char*) ring->cq_ptr + params.cq_off.head);
+    ring->cq_tail = (unsigned*) ((char*) ring->cq_ptr + params.cq_off.tail);
+    ring->cq_mask = (unsigned*) ((char*) ring->cq_ptr + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*) ((char*) ring->cq_ptr + params.cq_off.cqes);
+
+    return ring;
+
+failure:
+    (void) ice_fs_uring_close(ring);
+    return 0;
+}
+
+/* [INTERNAL] Fills submission queue entry sqe for request req that runs in slot, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if request is invalid */
+static ice_fs_bool ice_fs_uring_prep(ice_fs_uring *ring, struct io_uring_sqe *sqe, ice_fs_batch_req *req, unsigned long slot) {
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->user_data = (__u64) slot;
+
+    if (req->op == ICE_FS_BATCH_OP_OPEN) {
+        int flags = ice_fs_stream_flags(req->mode);
+        if ((flags == -1) || (req->path == 0)) return ICE_FS_FALSE;
+
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (__u64) (unsigned long) req->path;
+        sqe->len = 0666;
+        sqe->open_flags = (__u32) flags;
+
+    } else if ((req->op == ICE_FS_BATCH_OP_READ) || (req->op == ICE_FS_BATCH_OP_WRITE)) {
+        sqe->opcode = ((req->op == ICE_FS_BATCH_OP_READ) ? IORING_OP_READ : IORING_OP_WRITE);
+        sqe->fd = req->fd;
+        sqe->addr = (__u64) (unsigned long) req->buf;
+        sqe->len = (__u32) ((req->len > ICE_FS_BATCH_MAX_LEN) ? ICE_FS_BATCH_MAX_LEN : req->len);
+        sqe->off = (__u64) req->offset;
+
+    } else if (req->op == ICE_FS_BATCH_OP_STAT) {
+        sqe->opcode = IORING_OP_STATX;
+        sqe->fd = ((req->path != 0) ? AT_FDCWD : req->fd);
+        sqe->addr = (__u64) (unsigned long) ((req->path != 0) ? req->path : "");
+        sqe->len = (STATX_TYPE | STATX_SIZE);
+        sqe->off = (__u64) (unsigned long) &ring->stats[slot];
+        sqe->statx_flags = ((req->path != 0) ? 0 : AT_EMPTY_PATH);
+
+    } else if (req->op == ICE_FS_BATCH_OP_CLOSE) {
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = req->fd;
+
+    } else {
+        return ICE_FS_FALSE;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Stores result of request that ran in slot */
+static void ice_fs_uring_complete(ice_fs_uring *ring, ice_fs_batch_req *req, unsigned long slot, int res) {
+    if (res < 0) {
+        req->result = res;
+        return;
+    }
+
+    req->result = 0;
+
+    if (req->op == ICE_FS_BATCH_OP_OPEN) {
+        req->fd = res;
+    } else if ((req->op == ICE_FS_BATCH_OP_READ) || (req->op == ICE_FS_BATCH_OP_WRITE)) {
+        req->result = res;
+    } else if (req->op == ICE_FS_BATCH_OP_STAT) {
+        req->size = (ice_fs_offset) ring->stats[slot].stx_size;
+        req->type = (((ring->stats[slot].stx_mode & S_IFMT) == S_IFDIR) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE);
+    }
+}
+
+/* [INTERNAL] Submits requests to ring while keeping its slots full and harvests all available completions after each wait, Returns when all of them are done or 0 on success or errno value if ring failed (Requests that weren't done are failed with it then) */
+static int ice_fs_uring_submit(ice_fs_uring *ring, ice_fs_batch_req *reqs, unsigned long reqs_count) {
+    unsigned long next = 0, done = 0, i;
+    int err = 0;
+
+    while (done < reqs_count) {
+        unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE),
+                 tail = *ring->sq_tail,
+                 cq_head, cq_tail;
+        long res;
+
+        /* Queue as many requests as there are free slots and free entries */
+        while ((next < reqs_count) && (ring->free_count > 0) && ((tail - head) < ring->sq_entries)) {
+            unsigned long slot = ring->free_slots[ring->free_count - 1];
+            unsigned idx = (tail & *ring->sq_mask);
+
+            if (ice_fs_uring_prep(ring, &ring->sqes[idx], &reqs[next], slot) == ICE_FS_FALSE) {
+                reqs[next].result = -EINVAL;
+                next++;
+                done++;
+                continue;
+            }
+
+            ring->free_count--;
+            ring->slot_reqs[slot] = next;
+            ring->sq_array[idx] = idx;
+            tail++;
+            next++;
+        }
+
+        __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+        if (done == reqs_count) break;
+
+        /* Submit queued entries and wait for at least one completion in one call */
+        res = syscall(SYS_io_uring_enter, ring->fd, tail - head, 1, IORING_ENTER_GETEVENTS, 0, 0);
+
+        if ((res < 0) && (errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY)) {
+            err = errno;
+            break;
+        }
+
+        cq_head = *ring->cq_head;
+        cq_tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+        while (cq_head != cq_tail) {
+            struct io_uring_cqe *cqe = &ring->cqes[cq_head & *ring->cq_mask];
+            unsigned long slot = (unsigned long) cqe->user_data;
+
+            ice_fs_uring_complete(ring, &reqs[ring->slot_reqs[slot]], slot, cqe->res);
+            ring->free_slots[ring->free_count++] = slot;
+            done++;
+            cq_head++;
+        }
+
+        __atomic_store_n(ring->cq_head, cq_head, __ATOMIC_RELEASE);
+    }
+
+    if (err != 0) {
+        /* Ring can't be used anymore, Requests in flight and the ones that weren't queued yet fail */
+        for (i = 0; i < ring->free_count; i++) ring->slot_reqs[ring->free_slots[i]] = reqs_count;
+
+        for (i = 0; i < ring->depth; i++) {
+            if (ring->slot_reqs[i] < reqs_count) reqs[ring->slot_reqs[i]].result = -err;
+        }
+
+        for (i = next; i < reqs_count; i++) reqs[i].result = -err;
+    }
+
+    return err;
+}
+#endif
+
+/* Creates batched I/O context in batch that keeps up to depth requests in flight (ICE_FS_BATCH_DEPTH if 0), Uses io_uring if available or pool of threads otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_batch_init(ice_fs_batch *batch, unsigned long depth) {
+    if (batch == 0) return ICE_FS_FALSE;
+
+    if (depth == 0) depth = ICE_FS_BATCH_DEPTH;
+
+    /* Largest number of entries that io_uring ring can have */
+    if (depth > 32768) depth = 32768;
+
+    batch->depth = depth;
+    batch->io_uring = ICE_FS_FALSE;
+
+#if defined(ICE_FS_IO_URING)
+    batch->handle = ice_fs_uring_open(depth);
+
+    if (batch->handle != 0) {
+        batch->io_uring = ICE_FS_TRUE;
+        return ICE_FS_TRUE;
+    }
+#endif
+
+    batch->handle = ice_fs_batch_pool_open(depth);
+    return (batch->handle != 0) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* Runs reqs_count requests in reqs through batch and waits for all of them, Requests run concurrently in any order (So request that needs result of another one should be submitted after it), Result of each request is stored in its result field, Returns ICE_FS_TRUE if all requests succeeded or ICE_FS_FALSE if any failed (errno is set to error of the first failed one) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_batch_submit(ice_fs_batch *batch, ice_fs_batch_req *reqs, unsigned long reqs_count) {
+    unsigned long i;
+
+    if ((batch == 0) || (batch->handle == 0) || ((reqs == 0) && (reqs_count > 0))) return ICE_FS_FALSE;
+
+    if (batch->io_uring == ICE_FS_TRUE) {
+#if defined(ICE_FS_IO_URING)
+        if (ice_fs_uring_submit((ice_fs_uring*) batch->handle, reqs, reqs_count) != 0) {
+            /* Ring failed, Later requests run on pool of threads instead */
+            (void) ice_fs_uring_close((ice_fs_uring*) batch->handle);
+            batch->io_uring = ICE_FS_FALSE;
+            batch->handle = ice_fs_batch_pool_open(batch->depth);
+        }
+#endif
+    } else if (reqs_count > 0) {
+        ice_fs_batch_pool_submit((ice_fs_batch_pool*) batch->handle, reqs, reqs_count);
+    }
+
+    for (i = 0; i < reqs_count; i++) {
+        if (reqs[i].result < 0) {
+            errno = (int) -reqs[i].result;
+            return ICE_FS_FALSE;
+        }
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* Reads contents of paths_count files in paths through batch (Opens, Stats, Reads and Closes many files at same time), Returns array of contents (NULL for each file that failed to read) on allocation success or NULL on failure, sizes can be pointer to array of paths_count unsigned long integers to store size of each content, The array should be freed with ice_fs_free_strarr */
+ICE_FS_API char** ICE_FS_CALLCONV ice_fs_batch_files_content(ice_fs_batch *batch, const char **paths, unsigned long paths_count, unsigned long *sizes) {
+    ice_fs_batch_req *reqs = 0, *opens;
+    unsigned long *reads_files = 0, chunk, closes = 0, i, j, k;
+    char **contents = 0;
+
+    if ((batch == 0) || (batch->handle == 0) || ((paths == 0) && (paths_count > 0))) return 0;
+
+    /*
+    Files are read in chunks of depth files, So opened files don't exceed limit of the process
+    Requests of each chunk are laid out in reqs as: [Reads or Closes of previous chunk][Opens and Stats]
+    */
+    chunk = batch->depth;
+
+    contents = ICE_FS_CALLOC(((paths_count > 0) ? paths_count : 1), sizeof(char*));
+    reqs = ICE_FS_MALLOC((chunk * 3) * sizeof(ice_fs_batch_req));
+    reads_files = ICE_FS_MALLOC(chunk * sizeof(unsigned long));
+
+    if ((contents == 0) || (reqs == 0) || (reads_files == 0)) {
+        ICE_FS_FREE(contents);
+        ICE_FS_FREE(reqs);
+        ICE_FS_FREE(reads_files);
+        return 0;
+    }
+
+    if (sizes != 0) {
+        for (i = 0; i < paths_count; i++) sizes[i] = 0;
+    }
+
+    opens = &reqs[chunk];
+
+    for (i = 0; i < paths_count; i += chunk) {
+        unsigned long count = (((paths_count - i) < chunk) ? (paths_count - i) : chunk), reads = 0;
+
+        for (j = 0; j < count; j++) {
+            opens[j * 2].op = ICE_FS_BATCH_OP_OPEN;
+            opens[j * 2].path = paths[i + j];
+            opens[j * 2].mode = ICE_FS_STREAM_MODE_READ;
+            opens[j * 2].fd = -1;
+            opens[j * 2].result = -EIO;
+            opens[(j * 2) + 1].op = ICE_FS_BATCH_OP_STAT;
+            opens[(j * 2) + 1].path = paths[i + j];
+            opens[(j * 2) + 1].result = -EIO;
+        }
+
+        /* Files of previous chunk are closed while files of this one are opened */
+        (void) ice_fs_batch_submit(batch, &reqs[chunk - closes], closes + (count * 2));
+
+        for (j = 0; j < count; j++) {
+            ice_fs_batch_req *open_req = &opens[j * 2], *stat_req = &opens[(j * 2) + 1];
+            unsigned long size = (unsigned long) stat_req->size;
+            char *content;
+
+            if ((open_req->result < 0) || (stat_req->result < 0) || (stat_req->type != ICE_FS_OBJECT_TYPE_FILE)) continue;
+
+            /* File is too big for unsigned long (On platforms where it is 32-bit) */
+            if ((stat_req->size < 0) || (((ice_fs_offset) size) != stat_req->size) || (size == (unsigned long) -1)) continue;
+
+            content = ICE_FS_MALLOC(size + 1);
+            if (content == 0) continue;
+
+            content[0] = 0;
+            contents[i + j] = content;
+            if (sizes != 0) sizes[i + j] = size;
+
+            if (size == 0) continue;
+
+            reqs[reads].op = ICE_FS_BATCH_OP_READ;
+            reqs[reads].fd = open_req->fd;
+            reqs[reads].buf = content;
+            reqs[reads].len = size;
+            reqs[reads].offset = 0;
+            reqs[reads].result = -EIO;
+            reads_files[reads] = j;
+            reads++;
+        }
+
+        (void) ice_fs_batch_submit(batch, reqs, reads);
+
+        for (k = 0; k < reads; k++) {
+            ice_fs_batch_req *req = &reqs[k];
+            unsigned long idx = (i + reads_files[k]), total;
+
+            /* Rest of file is read on calling thread if read was short (File changed since it was stated) */
+            total = (unsigned long) ((req->result > 0) ? req->result : 0);
+
+            while ((req->result > 0) && (total < req->len)) {
+                ice_fs_batch_req rest = *req;
+
+                rest.buf = ((char*) req->buf + total);
+                rest.len = (req->len - total);
+                rest.offset = (ice_fs_offset) total;
+                ice_fs_batch_run(&rest);
+
+                if (rest.result <= 0) {
+                    req->result = rest.result;
+                    break;
+                }
+
+                total += (unsigned long) rest.result;
+            }
+
+            if (req->result < 0) {
+                ICE_FS_FREE(contents[idx]);
+                contents[idx] = 0;
+                total = 0;
+            } else {
+                contents[idx][total] = 0;
+            }
+
+            if (sizes != 0) sizes[idx] = total;
+        }
+
+        /* Close requests go right before opens of next chunk */
+        closes = 0;
+
+        for (j = 0; j < count; j++) {
+            if (opens[j * 2].result < 0) continue;
+
+            closes++;
+            reqs[chunk - closes].op = ICE_FS_BATCH_OP_CLOSE;
+            reqs[chunk - closes].fd = opens[j * 2].fd;
+        }
+    }
+
+    (void) ice_fs_batch_submit(batch, &reqs[chunk - closes], closes);
+
+    ICE_FS_FREE(reqs);
+    ICE_FS_FREE(reads_files);
+
+    return contents;
+}
+
+/* Closes batched I/O context created by ice_fs_batch_init, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_batch_close(ice_fs_batch *batch) {
+    ice_fs_bool res = ICE_FS_TRUE;
+
+    if ((batch == 0) || (batch->handle == 0)) return ICE_FS_FALSE;
+
+    if (batch->io_uring == ICE_FS_TRUE) {
+#if defined(ICE_FS_IO_URING)
+        res = ice_fs_uring_close((ice_fs_uring*) batch->handle);
+#endif
+    } else {
+        ice_fs_batch_pool_close((ice_fs_batch_pool*) batch->handle);
+    }
+
+    batch->handle = 0;
+    batch->io_uring = ICE_FS_FALSE;
+
+    return res;
+}
+
+/* ============================== Hashing ============================== */
+
+/* [INTERNAL] Builds 64-bit constant from its high and low 32 bits (C89 has no 64-bit literals) */
+#define ICE_FS_HASH_U64(hi, lo) ((((ice_fs_hash_value) (hi)) << 32) | ((ice_fs_hash_value) (lo)))
+
+#define ICE_FS_HASH_PRIME32_1 0x9E3779B1UL
+#define ICE_FS_HASH_PRIME32_2 0x85EBCA77UL
+#define ICE_FS_HASH_PRIME32_3 0xC2B2AE3DUL
+#define ICE_FS_HASH_PRIME64_1 ICE_FS_HASH_U64(0x9E3779B1UL, 0x85EBCA87UL)
+#define ICE_FS_HASH_PRIME64_2 ICE_FS_HASH_U64(0xC2B2AE3DUL, 0x27D4EB4FUL)
+#define ICE_FS_HASH_PRIME64_3 ICE_FS_HASH_U64(0x165667B1UL, 0x9E3779F9UL)
+#define ICE_FS_HASH_PRIME64_4 ICE_FS_HASH_U64(0x85EBCA77UL, 0xC2B2AE63UL)
+#define ICE_FS_HASH_PRIME64_5 ICE_FS_HASH_U64(0x27D4EB2FUL, 0x165667C5UL)
+#define ICE_FS_HASH_PRIME_MX1 ICE_FS_HASH_U64(0x16566791UL, 0x9E3779F9UL)
+#define ICE_FS_HASH_PRIME_MX2 ICE_FS_HASH_U64(0x9FB21C65UL, 0x1E98DF25UL)
+
+/* [INTERNAL] Input is consumed in stripes of 64 bytes, 16 stripes make block that ends with scrambling of the accumulators */
+#define ICE_FS_HASH_STRIPE_SIZE 64
+#define ICE_FS_HASH_BLOCK_STRIPES 16
+
+/* [INTERNAL] Default secret of XXH3, So hashes match XXH3_64bits of xxHash */
+static const unsigned char ice_fs_hash_secret[192] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 ice_fs_hash_u128;
+#endif
+
+/* [INTERNAL] Reads little-endian 64-bit integer from p (Compilers turn it into single load on little-endian machines) */
+static ice_fs_hash_value ice_fs_hash_read64(const unsigned char *p) {
+    return ((ice_fs_hash_value) p[0]) | (((ice_fs_hash_value) p[1]) << 8) | (((ice_fs_hash_value) p[2]) << 16) | (((ice_fs_hash_value) p[3]) << 24) |
+           (((ice_fs_hash_value) p[4]) << 32) | (((ice_fs_hash_value) p[5]) << 40) | (((ice_fs_hash_value) p[6]) << 48) | (((ice_fs_hash_value) p[7]) << 56);
+}
+
+/* [INTERNAL] Reads little-endian 32-bit integer from p */
+static ice_fs_hash_value ice_fs_hash_read32(const unsigned char *p) {
+    return ((ice_fs_hash_value) p[0]) | (((ice_fs_hash_value) p[1]) << 8) | (((ice_fs_hash_value) p[2]) << 16) | (((ice_fs_hash_value) p[3]) << 24);
+}
+
+/* [INTERNAL] Returns x with order of its bytes reversed */
+static ice_fs_hash_value ice_fs_hash_swap64(ice_fs_hash_value x) {
+    ice_fs_hash_value res = 0;
+    unsigned long i;
+
+    for (i = 0; i < 8; i++) {
+        res = ((res << 8) | (x & 0xFF));
+        x >>= 8;
+    }
+
+    return res;
+}
+
+/* [INTERNAL] Returns XOR of high and low 64 bits of 128-bit product of a and b */
+static ice_fs_hash_value ice_fs_hash_mul128_fold(ice_fs_hash_value a, ice_fs_hash_value b) {
+#if defined(__SIZEOF_INT128__)
+    ice_fs_hash_u128 product = ((ice_fs_hash_u128) a) * b;
+
+    return ((ice_fs_hash_value) product) ^ ((ice_fs_hash_value) (product >> 64));
+#else
+    ice_fs_hash_value lo_lo = (a & 0xFFFFFFFFUL) * (b & 0xFFFFFFFFUL);
+    ice_fs_hash_value hi_lo = (a >> 32) * (b & 0xFFFFFFFFUL);
+    ice_fs_hash_value lo_hi = (a & 0xFFFFFFFFUL) * (b >> 32);
+    ice_fs_hash_value hi_hi = (a >> 32) * (b >> 32);
+    ice_fs_hash_value cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFUL) + lo_hi;
+    ice_fs_hash_value upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    ice_fs_hash_value lower = (cross << 32) | (lo_lo & 0xFFFFFFFFUL);
+
+    return upper ^ lower;
+#endif
+}
+
+/* [INTERNAL] Final mix of XXH64, Spreads every input bit over the whole hash */
+static ice_fs_hash_value ice_fs_hash_avalanche64(ice_fs_hash_value h) {
+    h ^= (h >> 33);
+    h *= ICE_FS_HASH_PRIME64_2;
+    h ^= (h >> 29);
+    h *= ICE_FS_HASH_PRIME64_3;
+    h ^= (h >> 32);
+
+    return h;
+}
+
+/* [INTERNAL] Final mix of XXH3 */
+static ice_fs_hash_value ice_fs_hash_avalanche(ice_fs_hash_value h) {
+    h ^= (h >> 37);
+    h *= ICE_FS_HASH_PRIME_MX1;
+    h ^= (h >> 32);
+
+    return h;
+}
+
+/* [INTERNAL] Stronger final mix of XXH3 for inputs of 4 to 8 bytes */
+static ice_fs_hash_value ice_fs_hash_rrmxmx(ice_fs_hash_value h, unsigned long len) {
+    h ^= (((h << 49) | (h >> 15)) ^ ((h << 24) | (h >> 40)));
+    h *= ICE_FS_HASH_PRIME_MX2;
+    h ^= ((h >> 35) + len);
+    h *= ICE_FS_HASH_PRIME_MX2;
+
+    return h ^ (h >> 28);
+}
+
+/* [INTERNAL] Mixes 16 bytes of data with 16 bytes of secret */
+static ice_fs_hash_value ice_fs_hash_mix16(const unsigned char *data, const unsigned char *secret) {
+    return ice_fs_hash_mul128_fold(ice_fs_hash_read64(data) ^ ice_fs_hash_read64(secret), ice_fs_hash_read64(data + 8) ^ ice_fs_hash_read64(secret + 8));
+}
+
+/* [INTERNAL] Hashes data of up to 240 bytes (Which never reaches the stripe loop) */
+static ice_fs_hash_value ice_fs_hash_short(const unsigned char *data, unsigned long len) {
+    const unsigned char *secret = ice_fs_hash_secret;
+    ice_fs_hash_value acc;
+    unsigned long i;
+
+    if (len == 0) return ice_fs_hash_avalanche64(ice_fs_hash_read64(secret + 56) ^ ice_fs_hash_read64(secret + 64));
+
+    if (len <= 3) {
+        ice_fs_hash_value combined = ((((ice_fs_hash_value) data[0]) << 16) | (((ice_fs_hash_value) data[len >> 1]) << 24) | ((ice_fs_hash_value) data[len - 1]) | (((ice_fs_hash_value) len) << 8));
+        return ice_fs_hash_avalanche64(combined ^ (ice_fs_hash_read32(secret) ^ ice_fs_hash_read32(secret + 4)));
+    }
+
+    if (len <= 8) {
+        ice_fs_hash_value input = (ice_fs_hash_read32(data + len - 4) + (ice_fs_hash_read32(data) << 32));
+        return ice_fs_hash_rrmxmx(input ^ (ice_fs_hash_read64(secret + 8) ^ ice_fs_hash_read64(secret + 16)), len);
+    }
+
+    if (len <= 16) {
+        ice_fs_hash_value lo = (ice_fs_hash_read64(data) ^ (ice_fs_hash_read64(secret + 24) ^ ice_fs_hash_read64(secret + 32)));
+        ice_fs_hash_value hi = (ice_fs_hash_read64(data + len - 8) ^ (ice_fs_hash_read64(secret + 40) ^ ice_fs_hash_read64(secret + 48)));
+        return ice_fs_hash_avalanche(len + ice_fs_hash_swap64(lo) + hi + ice_fs_hash_mul128_fold(lo, hi));
+    }
+
+    acc = (len * ICE_FS_HASH_PRIME64_1);
+
+    if (len <= 128) {
+        /* Pairs of 16 bytes from both ends meet in the middle */
+        for (i = 0; (i * 32) < len; i++) {
+            acc += ice_fs_hash_mix16(data + (16 * i), secret + (32 * i));
+            acc += ice_fs_hash_mix16(data + len - (16 * (i + 1)), secret + (32 * i) + 16);
+        }
+
+        return ice_fs_hash_avalanche(acc);
+    }
+
+    for (i = 0; i < 8; i++) acc += ice_fs_hash_mix16(data + (16 * i), secret + (16 * i));
+    acc = ice_fs_hash_avalanche(acc);
+
+    for (i = 8; i < (len / 16); i++) acc += ice_fs_hash_mix16(data + (16 * i), secret + (16 * (i - 8)) + 3);
+
+    return ice_fs_hash_avalanche(acc + ice_fs_hash_mix16(data + len - 16, secret + 119));
+}
+
+/* [INTERNAL] Consumes stripes_count stripes of data into the 8 accumulators, Stripe n is mixed with secret shifted by 8 * n bytes (Vectorized with AVX2 or SSE2 where available) */
+static void ice_fs_hash_accumulate(ice_fs_hash_value *acc, const unsigned char *data, const unsigned char *secret, unsigned long stripes_count) {
+    unsigned long n;
+#if defined(ICE_FS_AVX2)
+    __m256i acc0 = _mm256_loadu_si256((const __m256i*)((const void*) acc));
+    __m256i acc1 = _mm256_loadu_si256((const __m256i*)((const void*) (acc + 4)));
+
+    for (n = 0; n < stripes_count; n++) {
+        const unsigned char *in = (data + (n * ICE_FS_HASH_STRIPE_SIZE)), *key = (secret + (n * 8));
+        __m256i data0 = _mm256_loadu_si256((const __m256i*)((const void*) in));
+        __m256i data1 = _mm256_loadu_si256((const __m256i*)((const void*) (in + 32)));
+        __m256i key0 = _mm256_xor_si256(data0, _mm256_loadu_si256((const __m256i*)((const void*) key)));
+        __m256i key1 = _mm256_xor_si256(data1, _mm256_loadu_si256((const __m256i*)((const void*) (key + 32))));
+
+        /* acc[i] += low32(data_key) * high32(data_key), acc[i ^ 1] += data */
+        acc0 = _mm256_add_epi64(acc0, _mm256_add_epi64(_mm256_mul_epu32(key0, _mm256_shuffle_epi32(key0, 0x31)), _mm256_shuffle_epi32(data0, 0x4E)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_add_epi64(_mm256_mul_epu32(key1, _mm256_shuffle_epi32(key1, 0x31)), _mm256_shuffle_epi32(data1, 0x4E)));
+    }
+
+    _mm256_storeu_si256((__m256i*)((void*) acc), acc0);
+    _mm256_storeu_si256((__m256i*)((void*) (acc + 4)), acc1);
+#elif defined(ICE_FS_SSE2)
+    __m128i lanes[4];
+    unsigned long i;
+
+    for (i = 0; i < 4; i++) lanes[i] = _mm_loadu_si128((const __m128i*)((const void*) (acc + (2 * i))));
+
+    for (n = 0; n < stripes_count; n++) {
+        const unsigned char *in = (data + (n * ICE_FS_HASH_STRIPE_SIZE)), *key = (secret + (n * 8));
+
+        for (i = 0; i < 4; i++) {
+            __m128i data_vec = _mm_loadu_si128((const __m128i*)((const void*) (in + (16 * i))));
+            __m128i data_key = _mm_xor_si128(data_vec, _mm_loadu_si128((const __m128i*)((const void*) (key + (16 * i)))));
+
+            /* acc[i] += low32(data_key) * high32(data_key), acc[i ^ 1] += data */
+            lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(_mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, 0x31)), _mm_shuffle_epi32(data_vec, 0x4E)));
+        }
+    }
+
+    for (i = 0; i < 4; i++) _mm_storeu_si128((__m128i*)((void*) (acc + (2 * i))), lanes[i]);
+#else
+    unsigned long i;
+
+    for (n = 0; n < stripes_count; n++) {
+        const unsigned char *in = (data + (n * ICE_FS_HASH_STRIPE_SIZE)), *key = (secret + (n * 8));
+
+        for (i = 0; i < 8; i++) {
+            ice_fs_hash_value data_val = ice_fs_hash_read64(in + (8 * i));
+            ice_fs_hash_value data_key = (data_val ^ ice_fs_hash_read64(key + (8 * i)));
+
+            acc[i ^ 1] += data_val;
+            acc[i] += ((data_key & 0xFFFFFFFFUL) * (data_key >> 32));
+        }
+    }
+#endif
+}
+
+/* [INTERNAL] Scrambles the 8 accumulators with secret at end of each block */
+static void ice_fs_hash_scramble(ice_fs_hash_value *acc, const unsigned char *secret) {
+    unsigned long i;
+#if defined(ICE_FS_SSE2) || defined(ICE_FS_AVX2)
+    __m128i prime = _mm_set1_epi32((int) ICE_FS_HASH_PRIME32_1);
+
+    for (i = 0; i < 4; i++) {
+        __m128i lane = _mm_loadu_si128((const __m128i*)((const void*) (acc + (2 * i))));
+        __m128i data_key = _mm_xor_si128(_mm_xor_si128(lane, _mm_srli_epi64(lane, 47)), _mm_loadu_si128((const __m128i*)((const void*) (secret + (16 * i)))));
+        __m128i prod_lo = _mm_mul_epu32(data_key, prime);
+        __m128i prod_hi = _mm_mul_epu32(_mm_shuffle_epi32(data_key, 0x31), prime);
+
+        _mm_storeu_si128((__m128i*)((void*) (acc + (2 * i))), _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32)));
+    }
+#else
+    for (i = 0; i < 8; i++) {
+        ice_fs_hash_value a = acc[i];
+
+        a ^= (a >> 47);
+        a ^= ice_fs_hash_read64(secret + (8 * i));
+        a *= ICE_FS_HASH_PRIME32_1;
+
+        acc[i] = a;
+    }
+#endif
+}
+
+/* [INTERNAL] Sets the 8 accumulators to their initial values */
+static void ice_fs_hash_init_acc(ice_fs_hash_value *acc) {
+    acc[0] = ICE_FS_HASH_PRIME32_3;
+    acc[1] = ICE_FS_HASH_PRIME64_1;
+    acc[2] = ICE_FS_HASH_PRIME64_2;
+    acc[3] = ICE_FS_HASH_PRIME64_3;
+    acc[4] = ICE_FS_HASH_PRIME64_4;
+    acc[5] = ICE_FS_HASH_PRIME32_2;
+    acc[6] = ICE_FS_HASH_PRIME64_5;
+    acc[7] = ICE_FS_HASH_PRIME32_1;
+}
+
+/* [INTERNAL] Consumes stripes_count stripes of data into acc, stripes is number of stripes consumed in current block and gets updated (Block ends with scrambling) */
+static void ice_fs_hash_consume(ice_fs_hash_value *acc, unsigned long *stripes, const unsigned char *data, unsigned long stripes_count) {
+    while (stripes_count > 0) {
+        unsigned long count = (ICE_FS_HASH_BLOCK_STRIPES - *stripes);
+
+        if (count > stripes_count) count = stripes_count;
+
+        ice_fs_hash_accumulate(acc, data, ice_fs_hash_secret + (*stripes * 8), count);
+
+        data += (count * ICE_FS_HASH_STRIPE_SIZE);
+        stripes_count -= count;
+        *stripes += count;
+
+        if (*stripes == ICE_FS_HASH_BLOCK_STRIPES) {
+            ice_fs_hash_scramble(acc, ice_fs_hash_secret + sizeof(ice_fs_hash_secret) - ICE_FS_HASH_STRIPE_SIZE);
+            *stripes = 0;
+        }
+    }
+}
+
+/* [INTERNAL] Mixes last stripe (Which ends at last byte of input) into acc then merges the accumulators into the hash of total_len bytes */
+static ice_fs_hash_value ice_fs_hash_finish(ice_fs_hash_value *acc, const unsigned char *last_stripe, ice_fs_hash_value total_len) {
+    ice_fs_hash_value res = (total_len * ICE_FS_HASH_PRIME64_1);
+    unsigned long i;
+
+    ice_fs_hash_accumulate(acc, last_stripe, ice_fs_hash_secret + sizeof(ice_fs_hash_secret) - ICE_FS_HASH_STRIPE_SIZE - 7, 1);
+
+    for (i = 0; i < 4; i++) {
+        res += ice_fs_hash_mul128_fold(acc[2 * i] ^ ice_fs_hash_read64(ice_fs_hash_secret + 11 + (16 * i)), acc[(2 * i) + 1] ^ ice_fs_hash_read64(ice_fs_hash_secret + 19 + (16 * i)));
+    }
+
+    return ice_fs_hash_avalanche(res);
+}
+
+/* Returns 64-bit hash of len bytes of data (Same value as XXH3_64bits of xxHash, So it's fast but not cryptographic) */
+ICE_FS_API ice_fs_hash_value ICE_FS_CALLCONV ice_fs_hash(const void *data, unsigned long len) {
+    const unsigned char *bytes = (const unsigned char*) data;
+    ice_fs_hash_value acc[8];
+    unsigned long stripes = 0;
+
+    if (bytes == 0) len = 0;
+    if (len <= 240) return ice_fs_hash_short(bytes, len);
+
+    /* Every stripe but the last one, Which is mixed in by ice_fs_hash_finish (Overlapping previous one if needed) */
+    ice_fs_hash_init_acc(acc);
+    ice_fs_hash_consume(acc, &stripes, bytes, (len - 1) / ICE_FS_HASH_STRIPE_SIZE);
+
+    return ice_fs_hash_finish(acc, bytes + len - ICE_FS_HASH_STRIPE_SIZE, len);
+}
+
+/* Starts streaming hash in state, Data is fed to it with ice_fs_hash_update and hash is retrieved with ice_fs_hash_digest (Same value as ice_fs_hash of all the data at once) */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_hash_begin(ice_fs_hash_state *state) {
+    if (state == 0) return;
+
+    ice_fs_hash_init_acc(state->acc);
+    state->buf_len = 0;
+    state->stripes = 0;
+    state->total_len = 0;
+}
+
+/* Feeds len bytes of data to streaming hash in state */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_hash_update(ice_fs_hash_state *state, const void *data, unsigned long len) {
+    const unsigned char *bytes = (const unsigned char*) data;
+
+    if ((state == 0) || (bytes == 0) || (len == 0)) return;
+
+    state->total_len += len;
+
+    if ((state->buf_len + len) <= sizeof(state->buf)) {
+        memcpy(state->buf + state->buf_len, bytes, len);
+        state->buf_len += len;
+        return;
+    }
+
+    if (state->buf_len > 0) {
+        unsigned long fill = (sizeof(state->buf) - state->buf_len);
+
+        memcpy(state->buf + state->buf_len, bytes, fill);
+        ice_fs_hash_consume(state->acc, &state->stripes, state->buf, sizeof(state->buf) / ICE_FS_HASH_STRIPE_SIZE);
+
+        bytes += fill;
+        len -= fill;
+        state->buf_len = 0;
+    }
+
+    /* Whole stripes are consumed straight from data, At least 1 byte stays for ice_fs_hash_digest and the stripe before it is kept at end of the buffer */
+    if (len > sizeof(state->buf)) {
+        unsigned long count = ((len - 1) / ICE_FS_HASH_STRIPE_SIZE);
+
+        ice_fs_hash_consume(state->acc, &state->stripes, bytes, count);
+
+        bytes += (count * ICE_FS_HASH_STRIPE_SIZE);
+        len -= (count * ICE_FS_HASH_STRIPE_SIZE);
+
+        memcpy(state->buf + sizeof(state->buf) - ICE_FS_HASH_STRIPE_SIZE, bytes - ICE_FS_HASH_STRIPE_SIZE, ICE_FS_HASH_STRIPE_SIZE);
+    }
+
+    memcpy(state->buf, bytes, len);
+    state->buf_len = len;
+}
+
+/* Returns hash of all data fed so far to streaming hash in state (Which can still be fed more data after) */
+ICE_FS_API ice_fs_hash_value ICE_FS_CALLCONV ice_fs_hash_digest(const ice_fs_hash_state *state) {
+    ice_fs_hash_value acc[8];
+    unsigned char last_stripe[ICE_FS_HASH_STRIPE_SIZE];
+    const unsigned char *last;
+    unsigned long stripes, i;
+
+    if (state == 0) return 0;
+    if (state->total_len <= 240) return ice_fs_hash_short(state->buf, (unsigned long) state->total_len);
+
+    for (i = 0; i < 8; i++) acc[i] = state->acc[i];
+    stripes = state->stripes;
+
+    if (state->buf_len >= ICE_FS_HASH_STRIPE_SIZE) {
+        ice_fs_hash_consume(acc, &stripes, state->buf, (state->buf_len - 1) / ICE_FS_HASH_STRIPE_SIZE);
+        last = (state->buf + state->buf_len - ICE_FS_HASH_STRIPE_SIZE);
+    } else {
+        /* Last stripe starts in bytes that were already consumed, Which are still at end of the buffer */
+        unsigned long catchup = (ICE_FS_HASH_STRIPE_SIZE - state->buf_len);
+
+        memcpy(last_stripe, state->buf + sizeof(state->buf) - catchup, catchup);
+        memcpy(last_stripe + catchup, state->buf, state->buf_len);
+        last = last_stripe;
+    }
+
+    return ice_fs_hash_finish(acc, last, state->total_len);
+}
+
+/* [INTERNAL] Hashes content of file opened as fd (Of size bytes) and stores it in hash, Files bigger than buf_size are mapped into memory on Unix so their pages are hashed without copying, Others are read through buf of buf_size bytes, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_hash_fd(int fd, ice_fs_offset size, void *buf, unsigned long buf_size, ice_fs_hash_value *hash) {
+    ice_fs_hash_state state;
+    long read_size;
+
+    ice_fs_hash_begin(&state);
+
+#if defined(ICE_FS_UNIX)
+    if ((size > (ice_fs_offset) buf_size) && (((ice_fs_offset)(size_t) size) == size)) {
+        void *data = mmap(0, (size_t) size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED) {
+            const unsigned char *bytes = (const unsigned char*) data;
+            ice_fs_offset left = size;
+
+#  if defined(MADV_SEQUENTIAL)
+            (void) madvise(data, (size_t) size, MADV_SEQUENTIAL);
+#  endif
+
+            /* Fed in chunks since length of update is unsigned long (32-bit on some platforms) */
+            while (left > 0) {
+                unsigned long chunk = ((left > 0x40000000) ? 0x40000000 : (unsigned long) left);
+
+                ice_fs_hash_update(&state, bytes, chunk);
+                bytes += chunk;
+                left -= chunk;
+            }
+
+            (void) munmap(data, (size_t) size);
+            *hash = ice_fs_hash_digest(&state);
+
+            return ICE_FS_TRUE;
+        }
+    }
+
+#  if defined(POSIX_FADV_SEQUENTIAL)
+    (void) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#  endif
+#else
+    (void) size;
+#endif
+
+    while ((read_size = ice_fs_read_fd(fd, buf, buf_size)) > 0) ice_fs_hash_update(&state, buf, (unsigned long) read_size);
+    if (read_size == -1) return ICE_FS_FALSE;
+
+    *hash = ice_fs_hash_digest(&state);
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Hashes content of regular file in path through buf of buf_size bytes and stores it in hash and size of the file in size, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_hash_path(const char *path, void *buf, unsigned long buf_size, ice_fs_hash_value *hash, ice_fs_offset *size) {
+    struct stat info;
+    ice_fs_bool res = ICE_FS_FALSE;
+    int fd;
+
+#if defined(ICE_FS_MICROSOFT)
+    fd = open(path, O_RDONLY | O_BINARY);
+#elif defined(ICE_FS_UNIX)
+    /* O_NONBLOCK so opening a FIFO doesn't wait for a writer (It has no effect on reads of regular files) */
+    fd = open(path, O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+#endif
+    if (fd == -1) return ICE_FS_FALSE;
+
+    /* Other objects (Like FIFOs) could block forever or never end */
+    if ((fstat(fd, &info) == 0) && ((info.st_mode & S_IFMT) == S_IFREG)) {
+        res = ice_fs_hash_fd(fd, (ice_fs_offset) info.st_size, buf, buf_size, hash);
+        *size = (ice_fs_offset) info.st_size;
+    } else {
+        errno = EINVAL;
+    }
+
+    if ((close(fd) == -1) && (res == ICE_FS_TRUE)) res = ICE_FS_FALSE;
+
+    return res;
+}
+
+/* Hashes content of file in path (Same value as ice_fs_hash of the whole content) and stores it in hash, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_file_hash(const char *path, ice_fs_hash_value *hash) {
+    ice_fs_offset size;
+    ice_fs_bool res;
+    void *buf;
+
+    if ((path == 0) || (hash == 0)) return ICE_FS_FALSE;
+
+    buf = ICE_FS_MALLOC(ICE_FS_HASH_BUFFER_SIZE);
+    if (buf == 0) return ICE_FS_FALSE;
+
+    res = ice_fs_hash_path(path, buf, ICE_FS_HASH_BUFFER_SIZE, hash, &size);
+    ICE_FS_FREE(buf);
+
+    return res;
+}
+
+/* [INTERNAL] State shared by threads of ice_fs_dir_hash and ice_fs_dir_duplicates */
+typedef struct ice_fs_hash_ctx {
+    ice_fs_mutex mutex;
+    ice_fs_str_arena arena;             /* Paths of found files */
+    ice_fs_hashed_file *files;          /* Regular files of the tree, Paths point into the arena (size is -1 for files that couldn't be hashed) */
+    unsigned long files_count, files_capacity;
+    ice_fs_hashed_file **todo;          /* Files to hash */
+    unsigned long todo_count, todo_next;
+} ice_fs_hash_ctx;
+
+/* [INTERNAL] Collects regular files of the tree with their sizes, Symbolic links are skipped so nothing is hashed twice (Or reported as duplicate of itself) */
+static ice_fs_bool ice_fs_hash_tree_item(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link) {
+    ice_fs_hash_ctx *ctx = (ice_fs_hash_ctx*) walk->user;
+    unsigned long name_len;
+    struct stat info;
+    ice_fs_hashed_file *file;
+    char *path;
+
+    (void) worker;
+
+    if ((is_link == ICE_FS_TRUE) || (item->type != ICE_FS_OBJECT_TYPE_FILE)) return ICE_FS_TRUE;
+
+    name_len = ice_fs_str_len(item->name);
+
+#if defined(ICE_FS_MICROSOFT)
+    {
+        char *item_path = ICE_FS_MALLOC((dir->path_len + name_len + 2) * sizeof(char));
+        int stat_res;
+
+        if (item_path == 0) {
+            ice_fs_walk_fail(walk, ICE_FS_TRUE);
+            return ICE_FS_FALSE;
+        }
+
+        (void) ice_fs_walk_join(dir, item->name, name_len, item_path);
+        stat_res = stat(item_path, &info);
+        ICE_FS_FREE(item_path);
+
+        if (stat_res == -1) return ICE_FS_TRUE;
+    }
+#elif defined(ICE_FS_UNIX)
+    /* Files removed meanwhile are skipped */
+    if (fstatat(dir->fd, item->name, &info, AT_SYMLINK_NOFOLLOW) == -1) return ICE_FS_TRUE;
+#endif
+
+    if ((info.st_mode & S_IFMT) != S_IFREG) return ICE_FS_TRUE;
+
+    ice_fs_mutex_lock(&ctx->mutex);
+
+    if (ctx->files_count == ctx->files_capacity) {
+        unsigned long capacity = ((ctx->files_capacity == 0) ? 256 : (ctx->files_capacity * 2));
+        ice_fs_hashed_file *files = ICE_FS_REALLOC(ctx->files, capacity * sizeof(ice_fs_hashed_file));
+
+        if (files == 0) goto failure;
+
+        ctx->files = files;
+        ctx->files_capacity = capacity;
+    }
+
+    path = ice_fs_str_arena_alloc(&ctx->arena, dir->path_len + name_len + 2);
+    if (path == 0) goto failure;
+
+    file = &ctx->files[ctx->files_count++];
+    file->path = path;
+    file->size = (ice_fs_offset) info.st_size;
+    file->hash = 0;
+
+    (void) ice_fs_walk_join(dir, item->name, name_len, path);
+
+    ice_fs_mutex_unlock(&ctx->mutex);
+
+    return ICE_FS_TRUE;
+
+failure:
+    ice_fs_mutex_unlock(&ctx->mutex);
+    ice_fs_walk_fail(walk, ICE_FS_TRUE);
+
+    return ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Hashing thread of ice_fs_hash_tree, Takes files from the todo list till none is left (Files that can't be read get size of -1) */
+static void ice_fs_hash_tree_worker(void *arg) {
+    ice_fs_hash_ctx *ctx = (ice_fs_hash_ctx*) arg;
+    void *buf = ICE_FS_MALLOC(ICE_FS_HASH_BUFFER_SIZE);
+
+    /* Files left by thread that couldn't allocate its buffer are taken by others */
+    if (buf == 0) return;
+
+    for (;;) {
+        ice_fs_hashed_file *file;
+
+        ice_fs_mutex_lock(&ctx->mutex);
+
+        if (ctx->todo_next == ctx->todo_count) {
+            ice_fs_mutex_unlock(&ctx->mutex);
+            break;
+        }
+
+        file = ctx->todo[ctx->todo_next++];
+        ice_fs_mutex_unlock(&ctx->mutex);
+
+        if (ice_fs_hash_path(file->path, buf, ICE_FS_HASH_BUFFER_SIZE, &file->hash, &file->size) == ICE_FS_FALSE) file->size = -1;
+    }
+
+    ICE_FS_FREE(buf);
+}
+
+/* [INTERNAL] Orders files by path */
+static int ice_fs_hash_cmp_path(const void *a, const void *b) {
+    return strcmp(((const ice_fs_hashed_file*) a)->path, ((const ice_fs_hashed_file*) b)->path);
+}
+
+/* [INTERNAL] Orders files by size */
+static int ice_fs_hash_cmp_size(const void *a, const void *b) {
+    const ice_fs_hashed_file *file1 = (const ice_fs_hashed_file*) a, *file2 = (const ice_fs_hashed_file*) b;
+
+    if (file1->size != file2->size) return (file1->size < file2->size) ? -1 : 1;
+    return 0;
+}
+
+/* [INTERNAL] Orders files by size then hash then path, So files with same content end up next to each other */
+static int ice_fs_hash_cmp_content(const void *a, const void *b) {
+    const ice_fs_hashed_file *file1 = (const ice_fs_hashed_file*) a, *file2 = (const ice_fs_hashed_file*) b;
+
+    if (file1->size != file2->size) return (file1->size < file2->size) ? -1 : 1;
+    if (file1->hash != file2->hash) return (file1->hash < file2->hash) ? -1 : 1;
+
+    return strcmp(file1->path, file2->path);
+}
+
+/* [INTERNAL] Collects regular files in tree of directory in path into ctx (In parallel via ice_fs_walk) then hashes them with ice_fs_use_threads threads, Only files of sizes shared with other files are hashed if dups_only is ICE_FS_TRUE (Empty ones are never), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (ctx should be freed with ice_fs_hash_ctx_free either way) */
+static ice_fs_bool ice_fs_hash_tree(ice_fs_hash_ctx *ctx, const char *path, ice_fs_bool dups_only) {
+    unsigned long threads_count = ice_fs_get_threads_count(), started = 0, i;
+    ice_fs_thread *threads = 0;
+    ice_fs_walk walk;
+
+    ctx->arena.chunks = 0;
+    ctx->files = 0;
+    ctx->files_count = 0;
+    ctx->files_capacity = 0;
+    ctx->todo = 0;
+    ctx->todo_count = 0;
+    ctx->todo_next = 0;
+    ice_fs_mutex_init(&ctx->mutex);
+
+    walk.on_item = ice_fs_hash_tree_item;
+    walk.on_leave = 0;
+    walk.user = ctx;
+
+    /* Unreadable subdirectories are skipped like ice_fs_dir_search does, Only failed allocations or reads abort */
+    (void) ice_fs_walk_run(&walk, path, threads_count);
+    if (walk.stop == ICE_FS_TRUE) return ICE_FS_FALSE;
+
+    if (ctx->files_count == 0) return ICE_FS_TRUE;
+
+    ctx->todo = ICE_FS_MALLOC(ctx->files_count * sizeof(ice_fs_hashed_file*));
+    if (ctx->todo == 0) return ICE_FS_FALSE;
+
+    if (dups_only == ICE_FS_TRUE) {
+        /* Files of unique size can't have duplicates, So only the rest are read */
+        qsort(ctx->files, ctx->files_count, sizeof(ice_fs_hashed_file), ice_fs_hash_cmp_size);
+
+        for (i = 0; i < ctx->files_count; i++) {
+            ice_fs_offset size = ctx->files[i].size;
+
+            if ((size > 0) && (((i > 0) && (ctx->files[i - 1].size == size)) || (((i + 1) < ctx->files_count) && (ctx->files[i + 1].size == size)))) {
+                ctx->todo[ctx->todo_count++] = &ctx->files[i];
+            } else {
+                ctx->files[i].size = -1;
+            }
+        }
+    } else {
+        for (i = 0; i < ctx->files_count; i++) ctx->todo[ctx->todo_count++] = &ctx->files[i];
+    }
+
+    if (threads_count > ctx->todo_count) threads_count = ctx->todo_count;
+
+    if (threads_count > 1) {
+        threads = ICE_FS_MALLOC((threads_count - 1) * sizeof(ice_fs_thread));
+
+        for (i = 0; (threads != 0) && (i < (threads_count - 1)); i++) {
+            if (ice_fs_thread_start(&threads[i], ice_fs_hash_tree_worker, ctx) == ICE_FS_FALSE) break;
+            started++;
+        }
+    }
+
+    ice_fs_hash_tree_worker(ctx);
+
+    for (i = 0; i < started; i++) ice_fs_thread_join(&threads[i]);
+    ICE_FS_FREE(threads);
+
+    /* Every thread failed to allocate its buffer */
+    if (ctx->todo_next < ctx->todo_count) {
+        errno = ENOMEM;
+        return ICE_FS_FALSE;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Frees memory of ctx used by ice_fs_hash_tree */
+static void ice_fs_hash_ctx_free(ice_fs_hash_ctx *ctx) {
+    ice_fs_mutex_destroy(&ctx->mutex);
+    ice_fs_str_arena_free(&ctx->arena);
+    ICE_FS_FREE(ctx->files);
+    ICE_FS_FREE(ctx->todo);
+}
+
+/* Hashes contents of all files in directory and its subdirectories (In parallel, Symbolic links are skipped), Returns array of hashed files sorted by path on allocation success or NULL on failure (Or if there are no files), files_count should be pointer to unsigned long integer that stores number of the files, Files that can't be read are left out */
+ICE_FS_API ice_fs_hashed_file* ICE_FS_CALLCONV ice_fs_dir_hash(const char *path, unsigned long *files_count) {
+    ice_fs_hash_ctx ctx;
+    ice_fs_hashed_file *res = 0;
+    unsigned long count = 0, paths_len = 0, i;
+    char *paths;
+
+    if (files_count != 0) *files_count = 0;
+    if ((path == 0) || (files_count == 0)) return 0;
+
+    if (ice_fs_hash_tree(&ctx, path, ICE_FS_FALSE) == ICE_FS_FALSE) goto end;
+
+    for (i = 0; i < ctx.files_count; i++) {
+        if (ctx.files[i].size == -1) continue;
+
+        ctx.files[count++] = ctx.files[i];
+        paths_len += (ice_fs_str_len(ctx.files[i].path) + 1);
+    }
+
+    if (count == 0) goto end;
+
+    qsort(ctx.files, count, sizeof(ice_fs_hashed_file), ice_fs_hash_cmp_path);
+
+    /* Files and their paths share one allocation, So ice_fs_free_dir_hash frees them at once */
+    res = ICE_FS_MALLOC((count * sizeof(ice_fs_hashed_file)) + (paths_len * sizeof(char)));
+    if (res == 0) goto end;
+
+    paths = (char*)(res + count);
+
+    for (i = 0; i < count; i++) {
+        unsigned long len = (ice_fs_str_len(ctx.files[i].path) + 1);
+
+        res[i] = ctx.files[i];
+        res[i].path = paths;
+
+        memcpy(paths, ctx.files[i].path, len);
+        paths += len;
+    }
+
+    *files_count = count;
+
+end:
+    ice_fs_hash_ctx_free(&ctx);
+
+    return res;
+}
+
+/* Frees array of hashed files returned by ice_fs_dir_hash */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_dir_hash(ice_fs_hashed_file *files) {
+    ICE_FS_FREE(files);
+}
+
+/* Finds files with same content in directory and its subdirectories (Files of same size are hashed in parallel, Empty files and symbolic links are skipped), Returns array of groups of duplicates on allocation success or NULL on failure (Or if there are no duplicates), groups_count should be pointer to unsigned long integer that stores number of the groups, Paths in each group are sorted */
+ICE_FS_API ice_fs_dup_group* ICE_FS_CALLCONV ice_fs_dir_duplicates(const char *path, unsigned long *groups_count) {
+    ice_fs_hash_ctx ctx;
+    ice_fs_dup_group *res = 0;
+    unsigned long count = 0, groups = 0, paths_count = 0, paths_len = 0, i, j;
+    char **paths_arr, *paths;
+
+    if (groups_count != 0) *groups_count = 0;
+    if ((path == 0) || (groups_count == 0)) return 0;
+
+    if (ice_fs_hash_tree(&ctx, path, ICE_FS_TRUE) == ICE_FS_FALSE) goto end;
+
+    for (i = 0; i < ctx.files_count; i++) {
+        if (ctx.files[i].size != -1) ctx.files[count++] = ctx.files[i];
+    }
+
+    qsort(ctx.files, count, sizeof(ice_fs_hashed_file), ice_fs_hash_cmp_content);
+
+    /* Runs of 2 or more files with same size and hash are the groups */
+    for (i = 0; i < count; i = j) {
+        for (j = i + 1; (j < count) && (ctx.files[j].size == ctx.files[i].size) && (ctx.files[j].hash == ctx.files[i].hash); j++);
+        if ((j - i) < 2) continue;
+
+        groups++;
+        paths_count += (j - i);
+        while (i < j) paths_len += (ice_fs_str_len(ctx.files[i++].path) + 1);
+    }
+
+    if (groups == 0) goto end;
+
+    /* Groups, Arrays of paths and the paths share one allocation, So ice_fs_free_duplicates frees them at once */
+    res = ICE_FS_MALLOC((groups * sizeof(ice_fs_dup_group)) + (paths_count * sizeof(char*)) + (paths_len * sizeof(char)));
+    if (res == 0) goto end;
+
+    paths_arr = (char**)(res + groups);
+    paths = (char*)(paths_arr + paths_count);
+    groups = 0;
+
+    for (i = 0; i < count; i = j) {
+        ice_fs_dup_group *group;
+
+        for (j = i + 1; (j < count) && (ctx.files[j].size == ctx.files[i].size) && (ctx.files[j].hash == ctx.files[i].hash); j++);
+        if ((j - i) < 2) continue;
+
+        group = &res[groups++];
+        group->paths = paths_arr;
+        group->paths_count = (j - i);
+        group->size = ctx.files[i].size;
+        group->hash = ctx.files[i].hash;
+
+        for (; i < j; i++) {
+            unsigned long len = (ice_fs_str_len(ctx.files[i].path) + 1);
+
+            *paths_arr++ = paths;
+            memcpy(paths, ctx.files[i].path, len);
+            paths += len;
+        }
+    }
+
+    *groups_count = groups;
+
+end:
+    ice_fs_hash_ctx_free(&ctx);
+
+    return res;
+}
+
+/* Frees array of groups of duplicates returned by ice_fs_dir_duplicates */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_duplicates(ice_fs_dup_group *groups) {
+    ICE_FS_FREE(groups);
+}
+
+/* ============================== Snapshots ============================== */
+
+/* [INTERNAL] Bytes that snapshot files start with, Followed by version of the format */
+#define ICE_FS_SNAPSHOT_MAGIC "ICEFSSNP"
+#define ICE_FS_SNAPSHOT_VERSION 1
+
+/* [INTERNAL] Largest number of bytes that variable-length integer takes */
+#define ICE_FS_SNAPSHOT_MAX_VARINT 10
+
+/* [INTERNAL] Flags of snapshot entry in snapshot files */
+#define ICE_FS_SNAPSHOT_FLAG_DIR 1
+#define ICE_FS_SNAPSHOT_FLAG_LINK 2
+
+/* [INTERNAL] State shared by threads of ice_fs_snapshot_take */
+typedef struct ice_fs_snapshot_ctx {
+    ice_fs_mutex mutex;
+    ice_fs_str_arena arena;             /* Full paths of found objects */
+    ice_fs_snapshot_entry *entries;     /* Paths point into the arena past root directory */
+    unsigned long entries_count, entries_capacity;
+    unsigned long root_len;             /* Length of root directory (With separator) that each full path starts with */
+    unsigned long paths_len;            /* Total length of relative paths (With NUL terminators) */
+} ice_fs_snapshot_ctx;
+
+/* [INTERNAL] Records each object of the tree with its stat info, Objects removed meanwhile are left out */
+static ice_fs_bool ice_fs_snapshot_item(ice_fs_walk *walk, unsigned long worker, ice_fs_walk_dir *dir, const ice_fs_object *item, ice_fs_bool is_link) {
+    ice_fs_snapshot_ctx *ctx = (ice_fs_snapshot_ctx*) walk->user;
+    unsigned long name_len = ice_fs_str_len(item->name), path_len;
+    ice_fs_snapshot_entry *entry;
+    struct stat info;
+    char *path;
+
+    (void) worker;
+
+#if defined(ICE_FS_MICROSOFT)
+    {
+        char *item_path = ICE_FS_MALLOC((dir->path_len + name_len + 2) * sizeof(char));
+        int stat_res;
+
+        if (item_path == 0) {
+            ice_fs_walk_fail(walk, ICE_FS_TRUE);
+            return ICE_FS_FALSE;
+        }
+
+        (void) ice_fs_walk_join(dir, item->name, name_len, item_path);
+        stat_res = stat(item_path, &info);
+        ICE_FS_FREE(item_path);
+
+        if (stat_res == -1) return ICE_FS_FALSE;
+    }
+#elif defined(ICE_FS_UNIX)
+    if (fstatat(dir->fd, item->name, &info, AT_SYMLINK_NOFOLLOW) == -1) return ICE_FS_FALSE;
+#endif
+
+    ice_fs_mutex_lock(&ctx->mutex);
+
+    if (ctx->entries_count == ctx->entries_capacity) {
+        unsigned long capacity = ((ctx->entries_capacity == 0) ? 256 : (ctx->entries_capacity * 2));
+        ice_fs_snapshot_entry *entries = ICE_FS_REALLOC(ctx->entries, capacity * sizeof(ice_fs_snapshot_entry));
+
+        if (entries == 0) goto failure;
+
+        ctx->entries = entries;
+        ctx->entries_capacity = capacity;
+    }
+
+    path = ice_fs_str_arena_alloc(&ctx->arena, dir->path_len + name_len + 2);
+    if (path == 0) goto failure;
+
+    path_len = ice_fs_walk_join(dir, item->name, name_len, path);
+
+    entry = &ctx->entries[ctx->entries_count++];
+    entry->path = (path + ctx->root_len);
+    entry->type = (((info.st_mode & S_IFMT) == S_IFDIR) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE);
+    entry->is_link = is_link;
+    entry->size = ((entry->type == ICE_FS_OBJECT_TYPE_DIR) ? 0 : (ice_fs_offset) info.st_size);
+    entry->mtime = ice_fs_stat_time(&info, ICE_FS_LAST_MODIFICATION_DATE);
+#if defined(ICE_FS_MICROSOFT)
+    entry->inode = 0;
+#else
+    entry->inode = (ice_fs_offset) info.st_ino;
+#endif
+
+    ctx->paths_len += (path_len - ctx->root_len + 1);
+
+    ice_fs_mutex_unlock(&ctx->mutex);
+
+    return ICE_FS_TRUE;
+
+failure:
+    ice_fs_mutex_unlock(&ctx->mutex);
+    ice_fs_walk_fail(walk, ICE_FS_TRUE);
+
+    return ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Orders snapshot entries by path */
+static int ice_fs_snapshot_cmp_path(const void *a, const void *b) {
+    return strcmp(((const ice_fs_snapshot_entry*) a)->path, ((const ice_fs_snapshot_entry*) b)->path);
+}
+
+/* Records path, type, size, modification time and inode of every object in directory and its subdirectories (Walked in parallel, Symbolic links are not followed) into snap, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Subdirectories that can't be read are left out, snap should be freed with ice_fs_free_snapshot */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_snapshot_take(ice_fs_snapshot *snap, const char *path) {
+    ice_fs_snapshot_ctx ctx;
+    ice_fs_bool res = ICE_FS_FALSE;
+    ice_fs_walk walk;
+    unsigned long len, i;
+    char *paths;
+
+    if (snap != 0) {
+        snap->entries = 0;
+        snap->entries_count = 0;
+    }
+
+    if ((snap == 0) || (path == 0)) return ICE_FS_FALSE;
+
+    len = ice_fs_str_len(path);
+    if (len == 0) return ICE_FS_FALSE;
+
+    ctx.arena.chunks = 0;
+    ctx.entries = 0;
+    ctx.entries_count = 0;
+    ctx.entries_capacity = 0;
+    ctx.root_len = (len + ((ice_fs_str_ends_with_slash(path) == ICE_FS_TRUE) ? 0 : 1));
+    ctx.paths_len = 0;
+    ice_fs_mutex_init(&ctx.mutex);
+
+    walk.on_item = ice_fs_snapshot_item;
+    walk.on_leave = 0;
+    walk.user = &ctx;
+
+    /* Unreadable subdirectories are skipped, But walk that found nothing failed on root directory itself */
+    if ((ice_fs_walk_run(&walk, path, ice_fs_get_threads_count()) == ICE_FS_FALSE) && ((walk.stop == ICE_FS_TRUE) || (ctx.entries_count == 0))) {
+        if (walk.failed == ICE_FS_TRUE) errno = walk.error;
+        goto end;
+    }
+
+    res = ICE_FS_TRUE;
+    if (ctx.entries_count == 0) goto end;
+
+    qsort(ctx.entries, ctx.entries_count, sizeof(ice_fs_snapshot_entry), ice_fs_snapshot_cmp_path);
+
+    /* Entries and their paths share one allocation, So ice_fs_free_snapshot frees them at once */
+    snap->entries = ICE_FS_MALLOC((ctx.entries_count * sizeof(ice_fs_snapshot_entry)) + (ctx.paths_len * sizeof(char)));
+
+    if (snap->entries == 0) {
+        res = ICE_FS_FALSE;
+        goto end;
+    }
+
+    paths = (char*)(snap->entries + ctx.entries_count);
+
+    for (i = 0; i < ctx.entries_count; i++) {
+        unsigned long path_len = (ice_fs_str_len(ctx.entries[i].path) + 1);
+
+        snap->entries[i] = ctx.entries[i];
+        snap->entries[i].path = paths;
+
+        memcpy(paths, ctx.entries[i].path, path_len);
+        paths += path_len;
+    }
+
+    snap->entries_count = ctx.entries_count;
+
+end:
+    ice_fs_mutex_destroy(&ctx.mutex);
+    ice_fs_str_arena_free(&ctx.arena);
+    ICE_FS_FREE(ctx.entries);
+
+    return res;
+}
+
+/* [INTERNAL] Writes value to buf as variable-length integer (7 bits per byte, Lowest ones first), Returns number of written bytes */
+static unsigned long ice_fs_snapshot_put(unsigned char *buf, ice_fs_hash_value value) {
+    unsigned long len = 0;
+
+    while (value >= 0x80) {
+        buf[len++] = (unsigned char)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+
+    buf[len++] = (unsigned char) value;
+
+    return len;
+}
+
+/* [INTERNAL] Reads variable-length integer from data of len bytes at pos (Which is advanced past it) and stores it in value, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if data is malformed */
+static ice_fs_bool ice_fs_snapshot_get(const unsigned char *data, unsigned long len, unsigned long *pos, ice_fs_hash_value *value) {
+    ice_fs_hash_value res = 0;
+    unsigned long shift;
+
+    for (shift = 0; (*pos < len) && (shift < 64); shift += 7) {
+        unsigned char byte = data[(*pos)++];
+
+        res |= (((ice_fs_hash_value)(byte & 0x7f)) << shift);
+
+        if ((byte & 0x80) == 0) {
+            *value = res;
+            return ICE_FS_TRUE;
+        }
+    }
+
+    return ICE_FS_FALSE;
+}
+
+/* Writes snap to file in path in compact binary format (Each path only stores what differs from the previous one), The file is replaced atomically, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_snapshot_save(const ice_fs_snapshot *snap, const char *path) {
+    unsigned long alloc_size = (8 + (2 * ICE_FS_SNAPSHOT_MAX_VARINT) + 8), len = 8, prev_len = 0, i;
+    const char *prev = "";
+    ice_fs_hash_value hash;
+    unsigned char *buf;
+    ice_fs_bool res;
+
+    if ((snap == 0) || (path == 0)) return ICE_FS_FALSE;
+
+    for (i = 0; i < snap->entries_count; i++) alloc_size += (ice_fs_str_len(snap->entries[i].path) + 1 + (5 * ICE_FS_SNAPSHOT_MAX_VARINT));
+
+    buf = ICE_FS_MALLOC(alloc_size);
+    if (buf == 0) return ICE_FS_FALSE;
+
+    memcpy(buf, ICE_FS_SNAPSHOT_MAGIC, 8);
+    len += ice_fs_snapshot_put(buf + len, ICE_FS_SNAPSHOT_VERSION);
+    len += ice_fs_snapshot_put(buf + len, snap->entries_count);
+
+    for (i = 0; i < snap->entries_count; i++) {
+        const ice_fs_snapshot_entry *entry = &snap->entries[i];
+        unsigned long entry_len = ice_fs_str_len(entry->path), shared = 0;
+
+        /* Sorted paths mostly share directories with previous one, So only length of common prefix and the rest are stored */
+        while ((shared < prev_len) && (shared < entry_len) && (prev[shared] == entry->path[shared])) shared++;
+
+        len += ice_fs_snapshot_put(buf + len, shared);
+        len += ice_fs_snapshot_put(buf + len, entry_len - shared);
+        memcpy(buf + len, entry->path + shared, entry_len - shared);
+        len += (entry_len - shared);
+
+        buf[len++] = (unsigned char)(((entry->type == ICE_FS_OBJECT_TYPE_DIR) ? ICE_FS_SNAPSHOT_FLAG_DIR : 0) | ((entry->is_link == ICE_FS_TRUE) ? ICE_FS_SNAPSHOT_FLAG_LINK : 0));
+        len += ice_fs_snapshot_put(buf + len, (ice_fs_hash_value) entry->size);
+        len += ice_fs_snapshot_put(buf + len, (ice_fs_hash_value) entry->mtime);
+        len += ice_fs_snapshot_put(buf + len, (ice_fs_hash_value) entry->inode);
+
+        prev = entry->path;
+        prev_len = entry_len;
+    }
+
+    /* Hash of everything before it lets ice_fs_snapshot_load reject corrupted files */
+    hash = ice_fs_hash(buf, len);
+    for (i = 0; i < 8; i++) buf[len++] = (unsigned char)(hash >> (i * 8));
+
+    res = ice_fs_file_write_buf(path, buf, len, ICE_FS_WRITE_MODE_ATOMIC);
+    ICE_FS_FREE(buf);
+
+    return res;
+}
+
+/* [INTERNAL] Parses snapshot file content of len bytes (Without hash at its end), Only counts entries and total length of their paths if entries is NULL, Or fills entries and paths (Allocated for the counted sizes) otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if content is malformed */
+static ice_fs_bool ice_fs_snapshot_parse(const unsigned char *data, unsigned long len, ice_fs_snapshot_entry *entries, char *paths, unsigned long *entries_count, unsigned long *paths_len) {
+    ice_fs_hash_value version, count, shared, suffix, size, mtime, inode;
+    unsigned long pos = 8, prev_len = 0, total = 0, i;
+    const char *prev = 0;
+
+    if ((len < 8) || (memcmp(data, ICE_FS_SNAPSHOT_MAGIC, 8) != 0)) return ICE_FS_FALSE;
+    if ((ice_fs_snapshot_get(data, len, &pos, &version) == ICE_FS_FALSE) || (version != ICE_FS_SNAPSHOT_VERSION)) return ICE_FS_FALSE;
+
+    /* Each entry takes 5 bytes at least, So bigger count can only come from malformed file */
+    if ((ice_fs_snapshot_get(data, len, &pos, &count) == ICE_FS_FALSE) || (count > ((len - pos) / 5))) return ICE_FS_FALSE;
+
+    for (i = 0; i < (unsigned long) count; i++) {
+        unsigned char flags;
+
+        if (ice_fs_snapshot_get(data, len, &pos, &shared) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        if (ice_fs_snapshot_get(data, len, &pos, &suffix) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        if ((shared > prev_len) || (suffix > (len - pos))) return ICE_FS_FALSE;
+
+        if (entries != 0) {
+            char *path = paths;
+
+            if (shared > 0) memcpy(path, prev, (unsigned long) shared);
+            memcpy(path + shared, data + pos, (unsigned long) suffix);
+            path[shared + suffix] = 0;
+
+            /* Entries should be sorted by path, So ice_fs_snapshot_find and ice_fs_snapshot_diff work */
+            if ((prev != 0) && (strcmp(prev, path) >= 0)) return ICE_FS_FALSE;
+
+            entries[i].path = path;
+            prev = path;
+            paths += (shared + suffix + 1);
+        }
+
+        pos += (unsigned long) suffix;
+        prev_len = (unsigned long)(shared + suffix);
+        total += (prev_len + 1);
+
+        if (pos == len) return ICE_FS_FALSE;
+        flags = data[pos++];
+
+        if (ice_fs_snapshot_get(data, len, &pos, &size) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        if (ice_fs_snapshot_get(data, len, &pos, &mtime) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        if (ice_fs_snapshot_get(data, len, &pos, &inode) == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+        if (entries != 0) {
+            entries[i].type = (((flags & ICE_FS_SNAPSHOT_FLAG_DIR) != 0) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE);
+            entries[i].is_link = (((flags & ICE_FS_SNAPSHOT_FLAG_LINK) != 0) ? ICE_FS_TRUE : ICE_FS_FALSE);
+            entries[i].size = (ice_fs_offset) size;
+            entries[i].mtime = (ice_fs_offset) mtime;
+            entries[i].inode = (ice_fs_offset) inode;
+        }
+    }
+
+    if (pos != len) return ICE_FS_FALSE;
+
+    *entries_count = (unsigned long) count;
+    *paths_len = total;
+
+    return ICE_FS_TRUE;
+}
+
+/* Reads snapshot written by ice_fs_snapshot_save from file in path into snap, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the file is corrupted), snap should be freed with ice_fs_free_snapshot */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_snapshot_load(ice_fs_snapshot *snap, const char *path) {
+    unsigned long size = 0, entries_count, paths_len, i;
+    ice_fs_bool res = ICE_FS_FALSE;
+    ice_fs_hash_value hash = 0;
+    unsigned char *data;
+    char *content;
+
+    if (snap != 0) {
+        snap->entries = 0;
+        snap->entries_count = 0;
+    }
+
+    if ((snap == 0) || (path == 0)) return ICE_FS_FALSE;
+
+    content = ice_fs_file_content(path, &size);
+    if (content == 0) return ICE_FS_FALSE;
+
+    data = (unsigned char*) content;
+
+    if (size < 16) goto malformed;
+
+    size -= 8;
+    for (i = 0; i < 8; i++) hash |= (((ice_fs_hash_value) data[size + i]) << (i * 8));
+
+    if (ice_fs_hash(data, size) != hash) goto malformed;
+    if (ice_fs_snapshot_parse(data, size, 0, 0, &entries_count, &paths_len) == ICE_FS_FALSE) goto malformed;
+
+    res = ICE_FS_TRUE;
+    if (entries_count == 0) goto end;
+
+    /* Entries and their paths share one allocation like ones of ice_fs_snapshot_take */
+    snap->entries = ICE_FS_MALLOC((entries_count * sizeof(ice_fs_snapshot_entry)) + (paths_len * sizeof(char)));
+
+    if (snap->entries == 0) {
+        res = ICE_FS_FALSE;
+        goto end;
+    }
+
+    if (ice_fs_snapshot_parse(data, size, snap->entries, (char*)(snap->entries + entries_count), &entries_count, &paths_len) == ICE_FS_FALSE) {
+        ICE_FS_FREE(snap->entries);
+        snap->entries = 0;
+        goto malformed;
+    }
+
+    snap->entries_count = entries_count;
+    goto end;
+
+malformed:
+    res = ICE_FS_FALSE;
+    errno = EINVAL;
+
+end:
+    ICE_FS_FREE(content);
+
+    return res;
+}
+
+/* Returns entry of snap with path (Relative to root directory of the snapshot) without touching the filesystem, Or NULL if snap has no such entry */
+ICE_FS_API const ice_fs_snapshot_entry* ICE_FS_CALLCONV ice_fs_snapshot_find(const ice_fs_snapshot *snap, const char *path) {
+    unsigned long low = 0, high;
+
+    if ((snap == 0) || (path == 0)) return 0;
+
+    high = snap->entries_count;
+
+    while (low < high) {
+        unsigned long mid = (low + ((high - low) / 2));
+        int cmp = strcmp(snap->entries[mid].path, path);
+
+        if (cmp == 0) return &snap->entries[mid];
+
+        if (cmp < 0) {
+            low = (mid + 1);
+        } else {
+            high = mid;
+        }
+    }
+
+    return 0;
+}
+
+/* [INTERNAL] Returns ICE_FS_TRUE if object of entry1 and entry2 (Of same path) differs in type, size, modification time or inode, Or ICE_FS_FALSE if not (Modification time of directories changes with their items, Which are compared by themselves, So it's ignored) */
+static ice_fs_bool ice_fs_snapshot_modified(const ice_fs_snapshot_entry *entry1, const ice_fs_snapshot_entry *entry2) {
+    if ((entry1->type != entry2->type) || (entry1->is_link != entry2->is_link) || (entry1->inode != entry2->inode)) return ICE_FS_TRUE;
+    if (entry1->type == ICE_FS_OBJECT_TYPE_DIR) return ICE_FS_FALSE;
+
+    return ((entry1->size != entry2->size) || (entry1->mtime != entry2->mtime)) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* Compares older snapshot old_snap to newer snapshot new_snap (Of same directory) and stores added, removed and modified entries in changes, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure, Snapshots should outlive changes, changes should be freed with ice_fs_free_snapshot_changes */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_snapshot_diff(const ice_fs_snapshot *old_snap, const ice_fs_snapshot *new_snap, ice_fs_snapshot_changes *changes) {
+    unsigned long added = 0, removed = 0, modified = 0, lookup_state;
+    const ice_fs_snapshot_entry **lists;
+
+    if (changes != 0) {
+        changes->added = changes->removed = changes->modified = 0;
+        changes->added_count = changes->removed_count = changes->modified_count = 0;
+    }
+
+    if ((old_snap == 0) || (new_snap == 0) || (changes == 0)) return ICE_FS_FALSE;
+
+    /* First pass counts the changes, Second one stores them, Both merge the sorted entries */
+    for (lookup_state = 0; lookup_state < 2; lookup_state++) {
+        unsigned long i = 0, j = 0;
+
+        if (lookup_state == 1) {
+            if ((added + removed + modified) == 0) break;
+
+            /* All three lists share one allocation, So ice_fs_free_snapshot_changes frees them at once */
+            lists = ICE_FS_MALLOC((added + removed + modified) * sizeof(ice_fs_snapshot_entry*));
+            if (lists == 0) return ICE_FS_FALSE;
+
+            changes->added = lists;
+            changes->removed = (lists + added);
+            changes->modified = (lists + added + removed);
+        }
+
+        while ((i < old_snap->entries_count) || (j < new_snap->entries_count)) {
+            int cmp;
+
+            if (i == old_snap->entries_count) {
+                cmp = 1;
+            } else if (j == new_snap->entries_count) {
+                cmp = -1;
+            } else {
+                cmp = strcmp(old_snap->entries[i].path, new_snap->entries[j].path);
+            }
+
+            if (cmp < 0) {
+                if (lookup_state == 1) changes->removed[changes->removed_count++] = &old_snap->entries[i];
+                else removed++;
+                i++;
+            } else if (cmp > 0) {
+                if (lookup_state == 1) changes->added[changes->added_count++] = &new_snap->entries[j];
+                else added++;
+                j++;
+            } else {
+                if (ice_fs_snapshot_modified(&old_snap->entries[i], &new_snap->entries[j]) == ICE_FS_TRUE) {
+                    if (lookup_state == 1) changes->modified[changes->modified_count++] = &new_snap->entries[j];
+                    else modified++;
+                }
+
+                i++;
+                j++;
+            }
+        }
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* Frees entries of snapshot taken by ice_fs_snapshot_take or read by ice_fs_snapshot_load */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_snapshot(ice_fs_snapshot *snap) {
+    if (snap == 0) return;
+
+    ICE_FS_FREE(snap->entries);
+    snap->entries = 0;
+    snap->entries_count = 0;
+}
+
+/* Frees changes found by ice_fs_snapshot_diff */
+ICE_FS_API void ICE_FS_CALLCONV ice_fs_free_snapshot_changes(ice_fs_snapshot_changes *changes) {
+    if (changes == 0) return;
+
+    /* Lists share allocation that starts with added one */
+    ICE_FS_FREE(changes->added);
+    changes->added = changes->removed = changes->modified = 0;
+    changes->added_count = changes->removed_count = changes->modified_count = 0;
+}
+
+/* ============================== Watching ============================== */
+
+/* [INTERNAL] Size of buffer in bytes that inotify events are read into */
+#define ICE_FS_WATCH_RAW_SIZE 65536
+
+/* [INTERNAL] Event waiting in ring of watcher, Its path (Followed by new path for moves) is kept in ring of chars */
+typedef struct ice_fs_watch_slot {
+    ice_fs_watch_event_type type;
+    ice_fs_bool is_dir;
+    unsigned long offset;               /* Offset of path in ring of chars */
+    unsigned long path_len;             /* Length of path (New path of moves starts after its NUL terminator) */
+    unsigned long len;                  /* Number of chars the slot takes in ring of chars */
+    ice_fs_hash_value hash;             /* Hash of path, So queued event of same object is found quickly */
+} ice_fs_watch_slot;
+
+/* [INTERNAL] Directory watched through inotify */
+typedef struct ice_fs_watch_dir {
+    int wd;
+    ice_fs_bool root;                   /* ICE_FS_TRUE if directory was given to ice_fs_watch_add */
+    char *path;
+    unsigned long path_len;
+} ice_fs_watch_dir;
+
+/* [INTERNAL] Tree compared periodically when inotify is not used */
+typedef struct ice_fs_watch_root {
+    char *path;
+    unsigned long path_len;
+    ice_fs_bool exists;                 /* ICE_FS_FALSE after directory was deleted (Till it appears again) */
+    ice_fs_snapshot snap;               /* Snapshot of last comparison */
+} ice_fs_watch_root;
+
+/* [INTERNAL] State of watcher, Allocated once so bursts of events don't allocate */
+typedef struct ice_fs_watch_state {
+#if defined(ICE_FS_INOTIFY)
+    char raw[ICE_FS_WATCH_RAW_SIZE];    /* inotify events read but not translated yet (First member so it's aligned like struct inotify_event) */
+    unsigned long raw_len, raw_pos;
+    int fd;                             /* inotify instance (-1 if not used) */
+    ice_fs_watch_dir *dirs;             /* Watched directories sorted by wd */
+    unsigned long dirs_count, dirs_capacity;
+#endif
+    ice_fs_watch_slot slots[ICE_FS_WATCH_EVENTS_CAPACITY];   /* Ring of events waiting to be polled */
+    unsigned long slots_head, slots_count;
+    unsigned long delivered;            /* Events at head of the ring returned by last poll (Released by next one) */
+    char chars[ICE_FS_WATCH_BUFFER_SIZE];   /* Ring of paths of the events */
+    unsigned long chars_head, chars_tail;
+    ice_fs_bool overflow;               /* ICE_FS_TRUE if events were dropped since last poll */
+    char *scratch;                      /* Paths of event being built */
+    unsigned long scratch_capacity;
+    ice_fs_watch_root *roots;
+    unsigned long roots_count;
+} ice_fs_watch_state;
+
+/* [INTERNAL] Reserves len chars in ring of chars of state, Returns offset of them on success or ICE_FS_WATCH_BUFFER_SIZE if there is no room */
+static unsigned long ice_fs_watch_reserve(ice_fs_watch_state *state, unsigned long len) {
+    unsigned long offset;
+
+    if (state->slots_count == 0) state->chars_head = state->chars_tail = 0;
+
+    /* Used chars never wrap around in middle of a path, So tail reaching head only happens when the ring is empty */
+    if (state->chars_tail >= state->chars_head) {
+        if ((ICE_FS_WATCH_BUFFER_SIZE - state->chars_tail) >= len) {
+            offset = state->chars_tail;
+        } else if (state->chars_head > len) {
+            offset = 0;
+        } else {
+            return ICE_FS_WATCH_BUFFER_SIZE;
+        }
+    } else if ((state->chars_head - state->chars_tail) > len) {
+        offset = state->chars_tail;
+    } else {
+        return ICE_FS_WATCH_BUFFER_SIZE;
+    }
+
+    state->chars_tail = (offset + len);
+
+    return offset;
+}
+
+/* [INTERNAL] Queues event of type for object in path of path_len chars (Moved to new_path of new_path_len chars for moves), Unless it's repeated creation/modification of object whose latest queued event is same, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if there is no room */
+static ice_fs_bool ice_fs_watch_push(ice_fs_watch_state *state, ice_fs_watch_event_type type, ice_fs_bool is_dir, const char *path, unsigned long path_len, const char *new_path, unsigned long new_path_len) {
+    ice_fs_hash_value hash = ice_fs_hash(path, path_len);
+    unsigned long len = ((path_len + 1) + ((new_path != 0) ? (new_path_len + 1) : 0)), offset, i;
+    ice_fs_watch_slot *slot;
+
+    /* Writes come as many events for same file, Only first one is kept if nothing else happened to the file in between (Events already polled are never merged) */
+    if ((type == ICE_FS_WATCH_EVENT_CREATED) || (type == ICE_FS_WATCH_EVENT_MODIFIED)) {
+        for (i = state->slots_count; i > state->delivered; i--) {
+            slot = &state->slots[(state->slots_head + i - 1) % ICE_FS_WATCH_EVENTS_CAPACITY];
+
+            if ((slot->hash != hash) || (slot->path_len != path_len) || (memcmp(state->chars + slot->offset, path, path_len) != 0)) continue;
+
+            if ((slot->type == type) || ((slot->type == ICE_FS_WATCH_EVENT_CREATED) && (type == ICE_FS_WATCH_EVENT_MODIFIED))) return ICE_FS_TRUE;
+            break;
+        }
+    }
+
+    if (state->slots_count == ICE_FS_WATCH_EVENTS_CAPACITY) return ICE_FS_FALSE;
+
+    offset = ice_fs_watch_reserve(state, len);
+    if (offset == ICE_FS_WATCH_BUFFER_SIZE) return ICE_FS_FALSE;
+
+    memcpy(state->chars + offset, path, path_len);
+    state->chars[offset + path_len] = 0;
+
+    if (new_path != 0) {
+        memcpy(state->chars + offset + path_len + 1, new_path, new_path_len);
+        state->chars[offset + path_len + 1 + new_path_len] = 0;
+    }
+
+    slot = &state->slots[(state->slots_head + state->slots_count) % ICE_FS_WATCH_EVENTS_CAPACITY];
+    slot->type = type;
+    slot->is_dir = is_dir;
+    slot->offset = offset;
+    slot->path_len = path_len;
+    slot->len = len;
+    slot->hash = hash;
+    state->slots_count++;
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Releases events returned by last poll from rings of state */
+static void ice_fs_watch_release(ice_fs_watch_state *state) {
+    while (state->delivered > 0) {
+        ice_fs_watch_slot *slot = &state->slots[state->slots_head];
+
+        state->chars_head = (slot->offset + slot->len);
+        state->slots_head = ((state->slots_head + 1) % ICE_FS_WATCH_EVENTS_CAPACITY);
+        state->slots_count--;
+        state->delivered--;
+    }
+}
+
+/* [INTERNAL] Writes path of name (Of name_len chars) in directory dir (Of dir_len chars) to scratch of state at offset, Returns length of written path on success or 0 on allocation failure */
+static unsigned long ice_fs_watch_join(ice_fs_watch_state *state, unsigned long offset, const char *dir, unsigned long dir_len, const char *name, unsigned long name_len) {
+    unsigned long len = dir_len, capacity = (offset + dir_len + name_len + 2);
+
+    if (capacity > state->scratch_capacity) {
+        char *scratch = ICE_FS_REALLOC(state->scratch, capacity * 2);
+        if (scratch == 0) return 0;
+
+        state->scratch = scratch;
+        state->scratch_capacity = (capacity * 2);
+    }
+
+    memcpy(state->scratch + offset, dir, dir_len);
+
+    if ((name_len > 0) && (len > 0) && (dir[len - 1] != '/') && (dir[len - 1] != '\\')) {
+#if defined(ICE_FS_MICROSOFT)
+        state->scratch[offset + len++] = '\\';
+#else
+        state->scratch[offset + len++] = '/';
+#endif
+    }
+
+    memcpy(state->scratch + offset + len, name, name_len);
+    len += name_len;
+    state->scratch[offset + len] = 0;
+
+    return len;
+}
+
+/* [INTERNAL] Returns ICE_FS_TRUE if path (Of path_len chars) is in directory dir (Of dir_len chars) or is dir itself, Or ICE_FS_FALSE if not */
+static ice_fs_bool ice_fs_watch_is_under(const char *path, unsigned long path_len, const char *dir, unsigned long dir_len) {
+    if ((path_len < dir_len) || (memcmp(path, dir, dir_len) != 0)) return ICE_FS_FALSE;
+
+    return ((path_len == dir_len) || (path[dir_len] == '/') || (path[dir_len] == '\\')) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+#if defined(ICE_FS_INOTIFY)
+/* [INTERNAL] inotify events watched in each directory */
+#define ICE_FS_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK)
+
+/* [INTERNAL] Returns index of watched directory of wd in state (Found by binary search) or index it should be inserted at if there is none */
+static unsigned long ice_fs_watch_find_dir(ice_fs_watch_state *state, int wd) {
+    unsigned long low = 0, high = state->dirs_count;
+
+    while (low < high) {
+        unsigned long mid = (low + ((high - low) / 2));
+
+        if (state->dirs[mid].wd < wd) {
+            low = (mid + 1);
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+/* [INTERNAL] Returns watched directory of wd in state or NULL if there is none */
+static ice_fs_watch_dir* ice_fs_watch_get_dir(ice_fs_watch_state *state, int wd) {
+    unsigned long idx = ice_fs_watch_find_dir(state, wd);
+    return ((idx < state->dirs_count) && (state->dirs[idx].wd == wd)) ? &state->dirs[idx] : 0;
+}
+
+/* [INTERNAL] Stores path (Of path_len chars) of directory watched as wd in state, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_watch_set_dir(ice_fs_watch_state *state, int wd, const char *path, unsigned long path_len, ice_fs_bool root) {
+    unsigned long idx = ice_fs_watch_find_dir(state, wd), i;
+    char *dir_path = ICE_FS_MALLOC((path_len + 1) * sizeof(char));
+
+    if (dir_path == 0) return ICE_FS_FALSE;
+
+    memcpy(dir_path, path, path_len);
+    dir_path[path_len] = 0;
+
+    /* Directory watched again (Like subdirectory given to ice_fs_watch_add) keeps same wd */
+    if ((idx < state->dirs_count) && (state->dirs[idx].wd == wd)) {
+        ICE_FS_FREE(state->dirs[idx].path);
+    } else {
+        if (state->dirs_count == state->dirs_capacity) {
+            unsigned long capacity = ((state->dirs_capacity == 0) ? 64 : (state->dirs_capacity * 2));
+            ice_fs_watch_dir *dirs = ICE_FS_REALLOC(state->dirs, capacity * sizeof(ice_fs_watch_dir));
+
+            if (dirs == 0) {
+                ICE_FS_FREE(dir_path);
+                return ICE_FS_FALSE;
+            }
+
+            state->dirs = dirs;
+            state->dirs_capacity = capacity;
+        }
+
+        for (i = state->dirs_count; i > idx; i--) state->dirs[i] = state->dirs[i - 1];
+        state->dirs_count++;
+
+        state->dirs[idx].wd = wd;
+        state->dirs[idx].root = ICE_FS_FALSE;
+    }
+
+    state->dirs[idx].path = dir_path;
+    state->dirs[idx].path_len = path_len;
+    if (root == ICE_FS_TRUE) state->dirs[idx].root = ICE_FS_TRUE;
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Forgets watched directory at index idx of state */
+static void ice_fs_watch_remove_dir(ice_fs_watch_state *state, unsigned long idx) {
+    unsigned long i;
+
+    ICE_FS_FREE(state->dirs[idx].path);
+    for (i = (idx + 1); i < state->dirs_count; i++) state->dirs[i - 1] = state->dirs[i];
+    state->dirs_count--;
+}
+
+/* [INTERNAL] Stops watching directories in directory of path (Of path_len chars) moved out of watched trees, And that directory itself */
+static void ice_fs_watch_forget_dirs(ice_fs_watch_state *state, const char *path, unsigned long path_len) {
+    unsigned long i = 0;
+
+    while (i < state->dirs_count) {
+        if (ice_fs_watch_is_under(state->dirs[i].path, state->dirs[i].path_len, path, path_len) == ICE_FS_TRUE) {
+            (void) inotify_rm_watch(state->fd, state->dirs[i].wd);
+            ice_fs_watch_remove_dir(state, i);
+        } else {
+            i++;
+        }
+    }
+}
+
+/* [INTERNAL] Updates paths of watched directories in directory of path (Of path_len chars) that was moved to new_path (Of new_path_len chars), And of that directory itself */
+static void ice_fs_watch_move_dirs(ice_fs_watch_state *state, const char *path, unsigned long path_len, const char *new_path, unsigned long new_path_len) {
+    unsigned long i;
+
+    for (i = 0; i < state->dirs_count; i++) {
+        ice_fs_watch_dir *dir = &state->dirs[i];
+        unsigned long len;
+        char *dir_path;
+
+        if (ice_fs_watch_is_under(dir->path, dir->path_len, path, path_len) == ICE_FS_FALSE) continue;
+
+        len = (new_path_len + (dir->path_len - path_len));
+        dir_path = ICE_FS_MALLOC((len + 1) * sizeof(char));
+
+        /* Events of the directory would get stale path, So caller is told to scan again */
+        if (dir_path == 0) {
+            state->overflow = ICE_FS_TRUE;
+            continue;
+        }
+
+        memcpy(dir_path, new_path, new_path_len);
+        memcpy(dir_path + new_path_len, dir->path + path_len, (dir->path_len - path_len) + 1);
+
+        ICE_FS_FREE(dir->path);
+        dir->path = dir_path;
+        dir->path_len = len;
+    }
+}
+
+/* [INTERNAL] Watches directory in path (Of path_len chars) and its subdirectories through inotify, Queues ICE_FS_WATCH_EVENT_CREATED for all of their items if created is ICE_FS_TRUE (For directories that appeared after the watch, Whose items could be created before they got watched), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_watch_add_tree(ice_fs_watch_state *state, const char *path, unsigned long path_len, ice_fs_bool root, ice_fs_bool created) {
+    ice_fs_bool res = ICE_FS_TRUE, is_link;
+    ice_fs_dir_iter iter;
+    ice_fs_object item;
+    char *buf, *dir_path;
+    int wd;
+
+    wd = inotify_add_watch(state->fd, path, ICE_FS_WATCH_MASK);
+    if (wd == -1) return ICE_FS_FALSE;
+
+    if (ice_fs_watch_set_dir(state, wd, path, path_len, root) == ICE_FS_FALSE) {
+        (void) inotify_rm_watch(state->fd, wd);
+        return ICE_FS_FALSE;
+    }
+
+    /* path can point into scratch of state which is reused below, So it's copied after the buffer */
+    buf = ICE_FS_MALLOC(ICE_FS_DIR_ITER_BUFFER_SIZE + path_len + 1);
+    if (buf == 0) return ICE_FS_FALSE;
+
+    dir_path = (buf + ICE_FS_DIR_ITER_BUFFER_SIZE);
+    memcpy(dir_path, path, path_len + 1);
+
+    if (ice_fs_dir_iter_open(&iter, dir_path, buf, ICE_FS_DIR_ITER_BUFFER_SIZE) == ICE_FS_FALSE) {
+        ICE_FS_FREE(buf);
+        return ICE_FS_FALSE;
+    }
+
+    while (ice_fs_dir_iter_read(&iter, &item, &is_link) == ICE_FS_TRUE) {
+        ice_fs_bool is_dir = (((item.type == ICE_FS_OBJECT_TYPE_DIR) && (is_link == ICE_FS_FALSE)) ? ICE_FS_TRUE : ICE_FS_FALSE);
+        unsigned long len = ice_fs_watch_join(state, 0, dir_path, path_len, item.name, ice_fs_str_len(item.name));
+
+        if (len == 0) {
+            res = ICE_FS_FALSE;
+            break;
+        }
+
+        if ((created == ICE_FS_TRUE) && (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_CREATED, is_dir, state->scratch, len, 0, 0) == ICE_FS_FALSE)) state->overflow = ICE_FS_TRUE;
+
+        /* Subdirectories removed or unreadable meanwhile are skipped, But running out of watches or memory is reported */
+        if ((is_dir == ICE_FS_TRUE) && (ice_fs_watch_add_tree(state, state->scratch, len, ICE_FS_FALSE, created) == ICE_FS_FALSE) && ((errno == ENOSPC) || (errno == ENOMEM))) {
+            res = ICE_FS_FALSE;
+            break;
+        }
+    }
+
+    if ((res == ICE_FS_TRUE) && (iter.error != 0)) {
+        errno = iter.error;
+        res = ICE_FS_FALSE;
+    }
+
+    (void) ice_fs_dir_iter_close(&iter);
+    ICE_FS_FREE(buf);
+
+    return res;
+}
+
+/* [INTERNAL] Queues event for inotify event (Of object in scratch of state of len chars), IN_MOVED_TO of same cookie that follows IN_MOVED_FROM in raw buffer is consumed along with it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if there is no room */
+static ice_fs_bool ice_fs_watch_translate_event(ice_fs_watch_state *state, const struct inotify_event *event, ice_fs_bool is_dir, unsigned long len) {
+    if ((event->mask & IN_MOVED_FROM) != 0) {
+        const struct inotify_event *next = 0;
+        ice_fs_watch_dir *next_dir = 0;
+
+        /* Object that stayed in watched trees has IN_MOVED_TO of same cookie right after */
+        if (state->raw_pos < state->raw_len) {
+            next = (const struct inotify_event*)(state->raw + state->raw_pos);
+            if (((next->mask & IN_MOVED_TO) == 0) || (next->cookie != event->cookie)) next = 0;
+        }
+
+        if (next != 0) next_dir = ice_fs_watch_get_dir(state, next->wd);
+
+        if (next_dir != 0) {
+            unsigned long new_len = ice_fs_watch_join(state, len + 1, next_dir->path, next_dir->path_len, next->name, ice_fs_str_len(next->name));
+
+            if (new_len == 0) {
+                state->overflow = ICE_FS_TRUE;
+                return ICE_FS_TRUE;
+            }
+
+            if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_MOVED, is_dir, state->scratch, len, state->scratch + len + 1, new_len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+            if (is_dir == ICE_FS_TRUE) ice_fs_watch_move_dirs(state, state->scratch, len, state->scratch + len + 1, new_len);
+        } else {
+            if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_DELETED, is_dir, state->scratch, len, 0, 0) == ICE_FS_FALSE) return ICE_FS_FALSE;
+            if (is_dir == ICE_FS_TRUE) ice_fs_watch_forget_dirs(state, state->scratch, len);
+        }
+
+        if (next != 0) state->raw_pos += (sizeof(struct inotify_event) + next->len);
+    } else if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+        if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_CREATED, is_dir, state->scratch, len, 0, 0) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        if ((is_dir == ICE_FS_TRUE) && (ice_fs_watch_add_tree(state, state->scratch, len, ICE_FS_FALSE, ICE_FS_TRUE) == ICE_FS_FALSE) && ((errno == ENOSPC) || (errno == ENOMEM))) state->overflow = ICE_FS_TRUE;
+    } else if ((event->mask & IN_DELETE) != 0) {
+        return ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_DELETED, is_dir, state->scratch, len, 0, 0);
+    } else if ((event->mask & (IN_MODIFY | IN_ATTRIB)) != 0) {
+        return ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_MODIFIED, is_dir, state->scratch, len, 0, 0);
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Translates inotify events in raw buffer of state to queued events, Stops early if the queue is full (Rest stays in raw buffer) */
+static void ice_fs_watch_translate(ice_fs_watch_state *state) {
+    while (state->raw_pos < state->raw_len) {
+        const struct inotify_event *event = (const struct inotify_event*)(state->raw + state->raw_pos);
+        ice_fs_bool is_dir = (((event->mask & IN_ISDIR) != 0) ? ICE_FS_TRUE : ICE_FS_FALSE), queued = ICE_FS_TRUE;
+        unsigned long start = state->raw_pos, len;
+        ice_fs_watch_dir *dir;
+
+        state->raw_pos += (sizeof(struct inotify_event) + event->len);
+
+        if ((event->mask & IN_Q_OVERFLOW) != 0) {
+            state->overflow = ICE_FS_TRUE;
+            continue;
+        }
+
+        if ((event->mask & IN_IGNORED) != 0) {
+            unsigned long idx = ice_fs_watch_find_dir(state, event->wd);
+            if ((idx < state->dirs_count) && (state->dirs[idx].wd == event->wd)) ice_fs_watch_remove_dir(state, idx);
+            continue;
+        }
+
+        dir = ice_fs_watch_get_dir(state, event->wd);
+        if (dir == 0) continue;
+
+        /* Deleted subdirectories are reported by their parents */
+        if ((event->mask & IN_DELETE_SELF) != 0) {
+            if (dir->root == ICE_FS_TRUE) queued = ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_DELETED, ICE_FS_TRUE, dir->path, dir->path_len, 0, 0);
+        } else {
+            len = ice_fs_watch_join(state, 0, dir->path, dir->path_len, event->name, ((event->len > 0) ? ice_fs_str_len(event->name) : 0));
+
+            if (len == 0) {
+                state->overflow = ICE_FS_TRUE;
+                continue;
+            }
+
+            queued = ice_fs_watch_translate_event(state, event, is_dir, len);
+        }
+
+        if (queued == ICE_FS_TRUE) continue;
+
+        /* Event stays in raw buffer till polled events make room for it, Unless it can't fit even in empty queue */
+        if (state->slots_count == 0) {
+            state->overflow = ICE_FS_TRUE;
+            continue;
+        }
+
+        state->raw_pos = start;
+        break;
+    }
+}
+
+/* [INTERNAL] Reads inotify events that are available without waiting and translates them, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_watch_read(ice_fs_watch_state *state) {
+    for (;;) {
+        long read_size;
+
+        ice_fs_watch_translate(state);
+        if (state->raw_pos < state->raw_len) return ICE_FS_TRUE;
+
+        read_size = read(state->fd, state->raw, ICE_FS_WATCH_RAW_SIZE);
+
+        if (read_size == -1) return ((errno == EAGAIN) || (errno == EINTR)) ? ICE_FS_TRUE : ICE_FS_FALSE;
+        if (read_size == 0) return ICE_FS_TRUE;
+
+        state->raw_len = (unsigned long) read_size;
+        state->raw_pos = 0;
+    }
+}
+#endif
+
+/* [INTERNAL] Orders snapshot entries (Pointed by elements) by inode */
+static int ice_fs_watch_cmp_inode(const void *a, const void *b) {
+    const ice_fs_snapshot_entry *entry1 = *(const ice_fs_snapshot_entry* const*) a, *entry2 = *(const ice_fs_snapshot_entry* const*) b;
+
+    if (entry1->inode != entry2->inode) return (entry1->inode < entry2->inode) ? -1 : 1;
+    return 0;
+}
+
+/* [INTERNAL] Orders snapshot entries (Pointed by elements) by path, NULL elements go last */
+static int ice_fs_watch_cmp_path(const void *a, const void *b) {
+    const ice_fs_snapshot_entry *entry1 = *(const ice_fs_snapshot_entry* const*) a, *entry2 = *(const ice_fs_snapshot_entry* const*) b;
+
+    if ((entry1 == 0) || (entry2 == 0)) return (entry1 == entry2) ? 0 : ((entry1 == 0) ? 1 : -1);
+    return strcmp(entry1->path, entry2->path);
+}
+
+/* [INTERNAL] Takes new snapshot of watched tree root and queues its differences from previous one to state, Removed and added objects of same inode are reported as moved (Only moved directory itself, Not its items), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_watch_scan(ice_fs_watch_state *state, ice_fs_watch_root *root) {
+    const ice_fs_snapshot_entry *moved_dir = 0;
+    ice_fs_snapshot_changes changes;
+    ice_fs_snapshot snap;
+    unsigned char *used = 0;
+    unsigned long i, len, new_len;
+
+    if (ice_fs_snapshot_take(&snap, root->path) == ICE_FS_FALSE) {
+        if ((errno != ENOENT) && (errno != ENOTDIR)) return ICE_FS_FALSE;
+
+        if (root->exists == ICE_FS_TRUE) {
+            if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_DELETED, ICE_FS_TRUE, root->path, root->path_len, 0, 0) == ICE_FS_FALSE) state->overflow = ICE_FS_TRUE;
+            ice_fs_free_snapshot(&root->snap);
+            root->exists = ICE_FS_FALSE;
+        }
+
+        return ICE_FS_TRUE;
+    }
+
+    if (root->exists == ICE_FS_FALSE) {
+        if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_CREATED, ICE_FS_TRUE, root->path, root->path_len, 0, 0) == ICE_FS_FALSE) state->overflow = ICE_FS_TRUE;
+        root->exists = ICE_FS_TRUE;
+    }
+
+    if (ice_fs_snapshot_diff(&root->snap, &snap, &changes) == ICE_FS_FALSE) {
+        ice_fs_free_snapshot(&snap);
+        return ICE_FS_FALSE;
+    }
+
+    /* Added entries are sorted by inode so removed ones of same inode are found by binary search */
+    if ((changes.removed_count > 0) && (changes.added_count > 0)) {
+        used = ICE_FS_CALLOC(changes.added_count, sizeof(unsigned char));
+        if (used == 0) goto failure;
+
+        qsort((void*) changes.added, changes.added_count, sizeof(ice_fs_snapshot_entry*), ice_fs_watch_cmp_inode);
+    }
+
+    for (i = 0; i < changes.removed_count; i++) {
+        const ice_fs_snapshot_entry *from = changes.removed[i], *to = 0;
+        unsigned long low = 0, high = changes.added_count;
+
+        /* Windows has no inodes, So everything moved is reported as deleted and created there */
+        while ((used != 0) && (from->inode != 0) && (low < high)) {
+            unsigned long mid = (low + ((high - low) / 2));
+
+            if (changes.added[mid]->inode < from->inode) {
+                low = (mid + 1);
+            } else {
+                high = mid;
+            }
+        }
+
+        for (; (used != 0) && (from->inode != 0) && (low < changes.added_count) && (changes.added[low]->inode == from->inode); low++) {
+            if ((used[low] == 0) && (changes.added[low]->type == from->type)) {
+                to = changes.added[low];
+                used[low] = 1;
+                break;
+            }
+        }
+
+        /* Items of moved directory moved along with it (Removed entries are sorted by path so it comes first) */
+        if ((to != 0) && (moved_dir != 0) && (ice_fs_watch_is_under(from->path, ice_fs_str_len(from->path), moved_dir->path, ice_fs_str_len(moved_dir->path)) == ICE_FS_TRUE)) continue;
+
+        len = ice_fs_watch_join(state, 0, root->path, root->path_len, from->path, ice_fs_str_len(from->path));
+        if (len == 0) goto failure;
+
+        if (to == 0) {
+            if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_DELETED, ((from->type == ICE_FS_OBJECT_TYPE_DIR) ? ICE_FS_TRUE : ICE_FS_FALSE), state->scratch, len, 0, 0) == ICE_FS_FALSE) state->overflow = ICE_FS_TRUE;
+            continue;
+        }
+
+        new_len = ice_fs_watch_join(state, len + 1, root->path, root->path_len, to->path, ice_fs_str_len(to->path));
+        if (new_len == 0) goto failure;
+
+        if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_MOVED, ((from->type == ICE_FS_OBJECT_TYPE_DIR) ? ICE_FS_TRUE : ICE_FS_FALSE), state->scratch, len, state->scratch + len + 1, new_len) == ICE_FS_FALSE) state->overflow = ICE_FS_TRUE;
+        if (from->type == ICE_FS_OBJECT_TYPE_DIR) moved_dir = from;
+    }
+
+    /* Entries of moved objects are dropped from added ones, Which are reported in order of paths (So directories come before their items) */
+    if (used != 0) {
+        for (i = 0; i < changes.added_count; i++) {
+            if (used[i] != 0) changes.added[i] = 0;
+        }
+
+        qsort((void*) changes.added, changes.added_count, sizeof(ice_fs_snapshot_entry*), ice_fs_watch_cmp_path);
+    }
+
+    for (i = 0; (i < changes.added_count) && (changes.added[i] != 0); i++) {
+        len = ice_fs_watch_join(state, 0, root->path, root->path_len, changes.added[i]->path, ice_fs_str_len(changes.added[i]->path));
+        if (len == 0) goto failure;
+
+        if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_CREATED, ((changes.added[i]->type == ICE_FS_OBJECT_TYPE_DIR) ? ICE_FS_TRUE : ICE_FS_FALSE), state->scratch, len, 0, 0) == ICE_FS_FALSE) state->overflow = ICE_FS_TRUE;
+    }
+
+    for (i = 0; i < changes.modified_count; i++) {
+        len = ice_fs_watch_join(state, 0, root->path, root->path_len, changes.modified[i]->path, ice_fs_str_len(changes.modified[i]->path));
+        if (len == 0) goto failure;
+
+        if (ice_fs_watch_push(state, ICE_FS_WATCH_EVENT_MODIFIED, ((changes.modified[i]->type == ICE_FS_OBJECT_TYPE_DIR) ? ICE_FS_TRUE : ICE_FS_FALSE), state->scratch, len, 0, 0) == ICE_FS_FALSE) state->overflow = ICE_FS_TRUE;
+    }
+
+    ICE_FS_FREE(used);
+    ice_fs_free_snapshot_changes(&changes);
+    ice_fs_free_snapshot(&root->snap);
+    root->snap = snap;
+
+    return ICE_FS_TRUE;
+
+failure:
+    ICE_FS_FREE(used);
+    ice_fs_free_snapshot_changes(&changes);
+    ice_fs_free_snapshot(&snap);
+
+    return ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Sleeps for ms milliseconds */
+static void ice_fs_watch_sleep(long ms) {
+#if defined(ICE_FS_MICROSOFT)
+    Sleep((DWORD) ms);
+#elif defined(ICE_FS_UNIX)
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(ms / 1000);
+    ts.tv_nsec = ((ms % 1000) * 1000000L);
+
+    while ((nanosleep(&ts, &ts) == -1) && (errno == EINTR));
+#endif
+}
+
+/* Creates watcher in watcher, Uses inotify if available or compares snapshots of watched trees periodically otherwise, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_watch_init(ice_fs_watcher *watcher) {
+    ice_fs_watch_state *state;
+
+    if (watcher == 0) return ICE_FS_FALSE;
+
+    watcher->handle = 0;
+    watcher->inotify = ICE_FS_FALSE;
+
+    state = ICE_FS_MALLOC(sizeof(ice_fs_watch_state));
+    if (state == 0) return ICE_FS_FALSE;
+
+    state->slots_head = 0;
+    state->slots_count = 0;
+    state->delivered = 0;
+    state->chars_head = 0;
+    state->chars_tail = 0;
+    state->overflow = ICE_FS_FALSE;
+    state->scratch = 0;
+    state->scratch_capacity = 0;
+    state->roots = 0;
+    state->roots_count = 0;
+
+#if defined(ICE_FS_INOTIFY)
+    state->raw_len = 0;
+    state->raw_pos = 0;
+    state->dirs = 0;
+    state->dirs_count = 0;
+    state->dirs_capacity = 0;
+
+    /* Snapshots are compared instead if inotify can't be used (Like when limit of its instances is reached) */
+    state->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (state->fd != -1) watcher->inotify = ICE_FS_TRUE;
+#endif
+
+    watcher->handle = state;
+
+    return ICE_FS_TRUE;
+}
+
+/* Watches directory in path and all of its subdirectories (Including ones created later), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_watch_add(ice_fs_watcher *watcher, const char *path) {
+    ice_fs_watch_state *state;
+    ice_fs_watch_root *roots, *root;
+    unsigned long len;
+
+    if ((watcher == 0) || (watcher->handle == 0) || (path == 0)) return ICE_FS_FALSE;
+
+    state = (ice_fs_watch_state*) watcher->handle;
+
+    len = ice_fs_str_len(path);
+    if (len == 0) return ICE_FS_FALSE;
+
+#if defined(ICE_FS_INOTIFY)
+    if (state->fd != -1) return ice_fs_watch_add_tree(state, path, len, ICE_FS_TRUE, ICE_FS_FALSE);
+#endif
+
+    roots = ICE_FS_REALLOC(state->roots, (state->roots_count + 1) * sizeof(ice_fs_watch_root));
+    if (roots == 0) return ICE_FS_FALSE;
+
+    state->roots = roots;
+    root = &roots[state->roots_count];
+
+    root->path = ICE_FS_MALLOC((len + 1) * sizeof(char));
+    if (root->path == 0) return ICE_FS_FALSE;
+
+    memcpy(root->path, path, len + 1);
+    root->path_len = len;
+    root->exists = ICE_FS_TRUE;
+
+    if (ice_fs_snapshot_take(&root->snap, path) == ICE_FS_FALSE) {
+        ICE_FS_FREE(root->path);
+        return ICE_FS_FALSE;
+    }
+
+    state->roots_count++;
+
+    return ICE_FS_TRUE;
+}
+
+/* Waits up to timeout milliseconds (0 doesn't wait and negative waits forever) for events of watched trees and stores up to events_capacity of them in events and their number in events_count, Repeated changes of same object are merged into one event, Returns ICE_FS_TRUE on success (Even if no event came in time) or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_watch_poll(ice_fs_watcher *watcher, ice_fs_watch_event *events, unsigned long events_capacity, unsigned long *events_count, long timeout) {
+    ice_fs_watch_state *state;
+    unsigned long count = 0, i;
+
+    if (events_count != 0) *events_count = 0;
+    if ((watcher == 0) || (watcher->handle == 0) || (events == 0) || (events_capacity == 0) || (events_count == 0)) return ICE_FS_FALSE;
+
+    state = (ice_fs_watch_state*) watcher->handle;
+    ice_fs_watch_release(state);
+
+#if defined(ICE_FS_INOTIFY)
+    if (state->fd != -1) {
+        if (ice_fs_watch_read(state) == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+        if ((state->slots_count == 0) && (state->overflow == ICE_FS_FALSE) && (timeout != 0)) {
+            struct pollfd pfd;
+            int poll_res;
+
+            pfd.fd = state->fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+
+            poll_res = poll(&pfd, 1, ((timeout < 0) ? -1 : ((timeout > 0x7fffffffL) ? 0x7fffffff : (int) timeout)));
+
+            if ((poll_res == -1) && (errno != EINTR)) return ICE_FS_FALSE;
+            if ((poll_res > 0) && (ice_fs_watch_read(state) == ICE_FS_FALSE)) return ICE_FS_FALSE;
+        }
+    } else
+#endif
+    {
+        long waited = 0;
+
+        for (;;) {
+            /* Trees are only compared again once queued events were all polled */
+            for (i = 0; (state->slots_count == 0) && (i < state->roots_count); i++) {
+                if (ice_fs_watch_scan(state, &state->roots[i]) == ICE_FS_FALSE) return ICE_FS_FALSE;
+            }
+
+            if ((state->slots_count > 0) || (state->overflow == ICE_FS_TRUE) || (timeout == 0) || ((timeout > 0) && (waited >= timeout))) break;
+
+            if ((timeout > 0) && ((timeout - waited) < ICE_FS_WATCH_POLL_INTERVAL)) {
+                ice_fs_watch_sleep(timeout - waited);
+                waited = timeout;
+            } else {
+                ice_fs_watch_sleep(ICE_FS_WATCH_POLL_INTERVAL);
+                waited += ICE_FS_WATCH_POLL_INTERVAL;
+            }
+        }
+    }
+
+    while ((count < events_capacity) && (count < state->slots_count)) {
+        ice_fs_watch_slot *slot = &state->slots[(state->slots_head + count) % ICE_FS_WATCH_EVENTS_CAPACITY];
+
+        events[count].type = slot->type;
+        events[count].is_dir = slot->is_dir;
+        events[count].path = (state->chars + slot->offset);
+        events[count].new_path = ((slot->type == ICE_FS_WATCH_EVENT_MOVED) ? (state->chars + slot->offset + slot->path_len + 1) : 0);
+        count++;
+    }
+
+    state->delivered = count;
+
+    /* Overflow is reported after all queued events */
+    if ((state->overflow == ICE_FS_TRUE) && (count == state->slots_count) && (count < events_capacity)) {
+        events[count].type = ICE_FS_WATCH_EVENT_OVERFLOW;
+        events[count].is_dir = ICE_FS_FALSE;
+        events[count].path = 0;
+        events[count].new_path = 0;
+        count++;
+
+        state->overflow = ICE_FS_FALSE;
+    }
+
+    *events_count = count;
+
+    return ICE_FS_TRUE;
+}
+
+/* Closes watcher created by ice_fs_watch_init, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_watch_close(ice_fs_watcher *watcher) {
+    ice_fs_watch_state *state;
+    ice_fs_bool res = ICE_FS_TRUE;
+    unsigned long i;
+
+    if ((watcher == 0) || (watcher->handle == 0)) return ICE_FS_FALSE;
+
+    state = (ice_fs_watch_state*) watcher->handle;
+
+#if defined(ICE_FS_INOTIFY)
+    if ((state->fd != -1) && (close(state->fd) == -1)) res = ICE_FS_FALSE;
+
+    for (i = 0; i < state->dirs_count; i++) ICE_FS_FREE(state->dirs[i].path);
+    ICE_FS_FREE(state->dirs);
+#endif
+
+    for (i = 0; i < state->roots_count; i++) {
+        ICE_FS_FREE(state->roots[i].path);
+        ice_fs_free_snapshot(&state->roots[i].snap);
+    }
+
+    ICE_FS_FREE(state->roots);
+    ICE_FS_FREE(state->scratch);
+    ICE_FS_FREE(state);
+
+    watcher->handle = 0;
+    watcher->inotify = ICE_FS_FALSE;
+
+    return res;
+}
+
+/* ============================== Packs ============================== */
+
+/* [INTERNAL] Bytes that pack archives start with */
+#define ICE_FS_PACK_MAGIC "ICEFSPAK"
+#define ICE_FS_PACK_VERSION 1
+
+/* [INTERNAL] Layout of pack archives (All numbers are little-endian), Header is followed by table of contents (Entries sorted by path), Hash table of entries, Paths of entries and content of files */
+#define ICE_FS_PACK_HEADER_SIZE 64
+#define ICE_FS_PACK_ENTRY_SIZE 40
+
+/* [INTERNAL] Returned by lookups in pack archives when there's no such entry */
+#define ICE_FS_PACK_NONE ((unsigned long)-1)
+
+/* [INTERNAL] Archive mounted into virtual filesystem, Data points into the mapped archive */
+typedef struct ice_fs_vfs_archive {
+    struct ice_fs_vfs_archive *next;    /* Archive mounted before this one (Lower priority) */
+    ice_fs_map_view view;
+    const unsigned char *toc;           /* Entries of 40 bytes each: Hash, Offset, Size, Path offset (64-bit) then path length and type (32-bit) */
+    const unsigned char *buckets;       /* Hash table of 32-bit entry indexes plus one (0 marks empty bucket) */
+    const char *names;                  /* Null-terminated paths of entries (Relative to packed directory, With / as separator) */
+    unsigned long entries_count;
+    unsigned long buckets_count;
+    char *point;                        /* Mount point (Normalized) */
+    unsigned long point_len;
+} ice_fs_vfs_archive;
+
+/* [INTERNAL] Object found by ice_fs_pack_create */
+typedef struct ice_fs_pack_item {
+    const char *path;                   /* Path relative to packed directory (With / as separator) */
+    const char *full_path;              /* Path to read the object from */
+    unsigned long path_len;
+    ice_fs_object_type type;
+    ice_fs_offset size;
+    ice_fs_offset offset;               /* Offset of content in the archive */
+} ice_fs_pack_item;
+
+/* [INTERNAL] Writes bytes lowest bytes of value to buf in little-endian order */
+static void ice_fs_le_put(unsigned char *buf, ice_fs_hash_value value, unsigned long bytes) {
+    unsigned long i;
+    for (i = 0; i < bytes; i++) buf[i] = (unsigned char)(value >> (i * 8));
+}
+
+/* [INTERNAL] Reads little-endian number of bytes length from buf */
+static ice_fs_hash_value ice_fs_le_get(const unsigned char *buf, unsigned long bytes) {
+    ice_fs_hash_value res = 0;
+    unsigned long i;
+
+    for (i = 0; i < bytes; i++) res |= (((ice_fs_hash_value) buf[i]) << (i * 8));
+
+    return res;
+}
+
+/* [INTERNAL] Hashes index of pack archive (Header without its hash, Table of contents, Hash table and paths) of index_size bytes */
+static ice_fs_hash_value ice_fs_pack_index_hash(const unsigned char *index, unsigned long index_size) {
+    ice_fs_hash_state state;
+
+    ice_fs_hash_begin(&state);
+    ice_fs_hash_update(&state, index, 48);
+    ice_fs_hash_update(&state, index + 56, index_size - 56);
+
+    return ice_fs_hash_digest(&state);
+}
+
+/* [INTERNAL] Orders objects found by ice_fs_pack_create by path */
+static int ice_fs_pack_cmp_path(const void *a, const void *b) {
+    return strcmp(((const ice_fs_pack_item*) a)->path, ((const ice_fs_pack_item*) b)->path);
+}
+
+/* [INTERNAL] Writes zero bytes to stream till pos reaches offset, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_pack_pad(ice_fs_stream *stream, ice_fs_offset *pos, ice_fs_offset offset) {
+    static const unsigned char zeros[256] = { 0 };
+
+    while (*pos < offset) {
+        unsigned long len = (((offset - *pos) > 256) ? 256 : (unsigned long)(offset - *pos));
+
+        if (ice_fs_stream_write(stream, zeros, len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        *pos += len;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* Packs files and directories in directory in path and all of its subdirectories (Listed with ice_fs_dir_content) into read-only archive in pack_path that ice_fs_vfs_mount mounts, Archive has table of contents sorted by path with hash table for lookups and content of files aligned to ICE_FS_PACK_ALIGNMENT bytes, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_pack_create(const char *path, const char *pack_path) {
+    ice_fs_str_arena arena;
+    ice_fs_pack_item *items = 0;
+    ice_fs_stat_info *infos = 0;
+    const char **paths = 0;
+    unsigned char *index = 0;
+    unsigned long items_count = 0, items_capacity = 0, files_count = 0, buckets_count = 1, names_size = 0, listed, root_len, i, j;
+    ice_fs_offset index_size, pos;
+    ice_fs_stream stream;
+    ice_fs_bool res = ICE_FS_FALSE, opened = ICE_FS_FALSE;
+
+    if ((path == 0) || (pack_path == 0)) return ICE_FS_FALSE;
+    if (ice_fs_type(path) != ICE_FS_OBJECT_TYPE_DIR) return ICE_FS_FALSE;
+
+    arena.chunks = 0;
+    root_len = ice_fs_str_len(path);
+
+    /* Directories are listed in order they were found, Starting from packed directory itself (Before the first item) */
+    for (listed = 0; listed <= items_count; listed++) {
+        const char *parent_path = "", *parent_full = path;
+        unsigned long parent_len = 0, prefix_len = 0, full_len = root_len;
+        ice_fs_dir dir;
+
+        /* Parent is copied since growing items moves them */
+        if (listed > 0) {
+            if (items[listed - 1].type != ICE_FS_OBJECT_TYPE_DIR) continue;
+
+            parent_path = items[listed - 1].path;
+            parent_full = items[listed - 1].full_path;
+            parent_len = items[listed - 1].path_len;
+            prefix_len = (parent_len + 1);
+            full_len = ice_fs_str_len(parent_full);
+        }
+
+        dir = ice_fs_dir_content(parent_full);
+
+        for (i = 0; i < dir.items_count; i++) {
+            unsigned long name_len = ice_fs_str_len(dir.items[i].name), len = full_len;
+            ice_fs_pack_item *item;
+            char *item_path, *full_path;
+
+            if (items_count == items_capacity) {
+                unsigned long capacity = ((items_capacity == 0) ? 256 : (items_capacity * 2));
+                ice_fs_pack_item *grown = ICE_FS_REALLOC(items, capacity * sizeof(ice_fs_pack_item));
+
+                if (grown == 0) {
+                    ice_fs_free_dir_content(&dir);
+                    goto end;
+                }
+
+                items = grown;
+                items_capacity = capacity;
+            }
+
+            item_path = ice_fs_str_arena_alloc(&arena, prefix_len + name_len + 1);
+            full_path = ice_fs_str_arena_alloc(&arena, full_len + name_len + 2);
+
+            if ((item_path == 0) || (full_path == 0)) {
+                ice_fs_free_dir_content(&dir);
+                goto end;
+            }
+
+            if (listed > 0) {
+                memcpy(item_path, parent_path, parent_len);
+                item_path[parent_len] = '/';
+            }
+
+            memcpy(item_path + prefix_len, dir.items[i].name, name_len + 1);
+            memcpy(full_path, parent_full, full_len);
+
+            if ((len > 0) && (full_path[len - 1] != '/') && (full_path[len - 1] != '\\')) full_path[len++] = '/';
+            memcpy(full_path + len, dir.items[i].name, name_len + 1);
+
+            item = &items[items_count++];
+            item->path = item_path;
+            item->full_path = full_path;
+            item->path_len = prefix_len + name_len;
+            item->type = dir.items[i].type;
+            item->size = 0;
+            item->offset = 0;
+
+            names_size += (item->path_len + 1);
+            if (item->type == ICE_FS_OBJECT_TYPE_FILE) files_count++;
+        }
+
+        ice_fs_free_dir_content(&dir);
+    }
+
+    /* Sizes of all files are queried at once */
+    if (files_count > 0) {
+        paths = ICE_FS_MALLOC(files_count * sizeof(const char*));
+        infos = ICE_FS_MALLOC(files_count * sizeof(ice_fs_stat_info));
+        if ((paths == 0) || (infos == 0)) goto end;
+
+        for (i = 0, j = 0; i < items_count; i++) {
+            if (items[i].type == ICE_FS_OBJECT_TYPE_FILE) paths[j++] = items[i].full_path;
+        }
+
+        if (ice_fs_get_stats(paths, files_count, ICE_FS_STAT_SIZE, infos) == ICE_FS_FALSE) goto end;
+
+        for (i = 0, j = 0; i < items_count; i++) {
+            if (items[i].type != ICE_FS_OBJECT_TYPE_FILE) continue;
+
+            if (infos[j].error != 0) {
+                errno = infos[j].error;
+                goto end;
+            }
+
+            items[i].size = infos[j++].size;
+        }
+    }
+
+    if (items_count > 0) qsort(items, items_count, sizeof(ice_fs_pack_item), ice_fs_pack_cmp_path);
+
+    /* Hash table stays at most half full, So probing ends quickly on empty bucket */
+    while (buckets_count < ((items_count * 2) + 1)) buckets_count *= 2;
+
+    index_size = (ICE_FS_PACK_HEADER_SIZE + (((ice_fs_offset) items_count) * ICE_FS_PACK_ENTRY_SIZE) + (((ice_fs_offset) buckets_count) * 4) + names_size);
+    index_size = (((index_size + (ICE_FS_PACK_ALIGNMENT - 1)) / ICE_FS_PACK_ALIGNMENT) * ICE_FS_PACK_ALIGNMENT);
+
+    pos = index_size;
+
+    for (i = 0; i < items_count; i++) {
+        if (items[i].type != ICE_FS_OBJECT_TYPE_FILE) continue;
+
+        /* Empty files point at end of index, So they stay inside the archive even if it ends with them */
+        if (items[i].size == 0) {
+            items[i].offset = index_size;
+            continue;
+        }
+
+        items[i].offset = (((pos + (ICE_FS_PACK_ALIGNMENT - 1)) / ICE_FS_PACK_ALIGNMENT) * ICE_FS_PACK_ALIGNMENT);
+        pos = (items[i].offset + items[i].size);
+    }
+
+    /* Whole archive should fit in single mapping */
+    if ((ice_fs_offset)((unsigned long) pos) != pos) goto end;
+
+    index = ICE_FS_CALLOC((unsigned long) index_size, sizeof(unsigned char));
+    if (index == 0) goto end;
+
+    {
+        unsigned char *toc = index + ICE_FS_PACK_HEADER_SIZE,
+                      *buckets = toc + (items_count * ICE_FS_PACK_ENTRY_SIZE);
+        char *names = (char*)(buckets + (buckets_count * 4));
+        unsigned long name_offset = 0;
+
+        memcpy(index, ICE_FS_PACK_MAGIC, 8);
+        ice_fs_le_put(index + 8, ICE_FS_PACK_VERSION, 4);
+        ice_fs_le_put(index + 12, ICE_FS_PACK_ALIGNMENT, 4);
+        ice_fs_le_put(index + 16, items_count, 8);
+        ice_fs_le_put(index + 24, buckets_count, 8);
+        ice_fs_le_put(index + 32, names_size, 8);
+        ice_fs_le_put(index + 40, (ice_fs_hash_value) index_size, 8);
+
+        for (i = 0; i < items_count; i++) {
+            unsigned char *entry = toc + (i * ICE_FS_PACK_ENTRY_SIZE);
+            ice_fs_hash_value hash = ice_fs_hash(items[i].path, items[i].path_len);
+            unsigned long bucket = (unsigned long)(hash & (buckets_count - 1));
+
+            ice_fs_le_put(entry, hash, 8);
+            ice_fs_le_put(entry + 8, (ice_fs_hash_value) items[i].offset, 8);
+            ice_fs_le_put(entry + 16, (ice_fs_hash_value) items[i].size, 8);
+            ice_fs_le_put(entry + 24, name_offset, 8);
+            ice_fs_le_put(entry + 32, items[i].path_len, 4);
+            ice_fs_le_put(entry + 36, ((items[i].type == ICE_FS_OBJECT_TYPE_DIR) ? 1 : 0), 4);
+
+            memcpy(names + name_offset, items[i].path, items[i].path_len + 1);
+            name_offset += (items[i].path_len + 1);
+
+            while (ice_fs_le_get(buckets + (bucket * 4), 4) != 0) bucket = ((bucket + 1) & (buckets_count - 1));
+            ice_fs_le_put(buckets + (bucket * 4), i + 1, 4);
+        }
+
+        ice_fs_le_put(index + 48, ice_fs_pack_index_hash(index, (unsigned long) index_size), 8);
+    }
+
+    if (ice_fs_stream_open(&stream, pack_path, ICE_FS_STREAM_MODE_WRITE, 0, 0) == ICE_FS_FALSE) goto end;
+    opened = ICE_FS_TRUE;
+
+    if (ice_fs_stream_write(&stream, index, (unsigned long) index_size) == ICE_FS_FALSE) goto end;
+    pos = index_size;
+
+    for (i = 0; i < items_count; i++) {
+        ice_fs_map_view view;
+        ice_fs_bool written;
+
+        if ((items[i].type != ICE_FS_OBJECT_TYPE_FILE) || (items[i].size == 0)) continue;
+        if (ice_fs_pack_pad(&stream, &pos, items[i].offset) == ICE_FS_FALSE) goto end;
+        if (ice_fs_map(items[i].full_path, ICE_FS_MAP_HINT_SEQUENTIAL, ICE_FS_FALSE, &view) == ICE_FS_FALSE) goto end;
+
+        /* File that changed since its size was queried would break offsets of next ones */
+        written = (((ice_fs_offset) view.size == items[i].size) ? ice_fs_stream_write(&stream, view.data, view.size) : ICE_FS_FALSE);
+        (void) ice_fs_unmap(&view);
+
+        if (written == ICE_FS_FALSE) goto end;
+        pos += items[i].size;
+    }
+
+    res = ICE_FS_TRUE;
+
+end:
+    if (opened == ICE_FS_TRUE) {
+        if (ice_fs_stream_close(&stream) == ICE_FS_FALSE) res = ICE_FS_FALSE;
+
+        /* Partial archive is removed, So it can't be mounted by mistake */
+        if (res == ICE_FS_FALSE) (void) ice_fs_remove(pack_path);
+    }
+
+    ice_fs_str_arena_free(&arena);
+    ICE_FS_FREE(items);
+    ICE_FS_FREE(paths);
+    ICE_FS_FREE(infos);
+    ICE_FS_FREE(index);
+
+    return res;
+}
+
+/* [INTERNAL] Normalizes path of len bytes for lookups in virtual filesystem (Backslashes become slashes, Leading "./" and trailing slashes are dropped) into dst of len + 1 bytes, Returns length of normalized path */
+static unsigned long ice_fs_vfs_normalize(const char *path, unsigned long len, char *dst) {
+    unsigned long i, start = 0, res = 0;
+
+    while (((len - start) >= 2) && (path[start] == '.') && ((path[start + 1] == '/') || (path[start + 1] == '\\'))) start += 2;
+    if (((len - start) == 1) && (path[start] == '.')) start++;
+
+    for (i = start; i < len; i++) {
+        dst[res++] = ((path[i] == '\\') ? '/' : path[i]);
+    }
+
+    while ((res > 0) && (dst[res - 1] == '/')) res--;
+    dst[res] = 0;
+
+    return res;
+}
+
+/* [INTERNAL] Stores index in rel_start where path of len bytes (Normalized) continues inside archive mounted at mount point of m, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if path is outside of the mount point */
+static ice_fs_bool ice_fs_vfs_rel(const ice_fs_vfs_archive *m, const char *path, unsigned long len, unsigned long *rel_start) {
+    if (m->point_len == 0) {
+        *rel_start = 0;
+        return ICE_FS_TRUE;
+    }
+
+    if ((len < m->point_len) || (memcmp(path, m->point, m->point_len) != 0)) return ICE_FS_FALSE;
+
+    if (len == m->point_len) {
+        *rel_start = len;
+        return ICE_FS_TRUE;
+    }
+
+    if (path[m->point_len] != '/') return ICE_FS_FALSE;
+
+    *rel_start = (m->point_len + 1);
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Returns index of entry of archive mounted as m with path rel of len bytes, Or ICE_FS_PACK_NONE if there's no such entry */
+static unsigned long ice_fs_vfs_find(const ice_fs_vfs_archive *m, const char *rel, unsigned long len) {
+    ice_fs_hash_value hash = ice_fs_hash(rel, len);
+    unsigned long bucket = (unsigned long)(hash & (m->buckets_count - 1));
+
+    for (;;) {
+        unsigned long slot = (unsigned long) ice_fs_le_get(m->buckets + (bucket * 4), 4);
+        const unsigned char *entry;
+
+        if (slot == 0) return ICE_FS_PACK_NONE;
+
+        entry = m->toc + ((slot - 1) * ICE_FS_PACK_ENTRY_SIZE);
+
+        if ((ice_fs_le_get(entry, 8) == hash) && (ice_fs_le_get(entry + 32, 4) == len) && (memcmp(m->names + ice_fs_le_get(entry + 24, 8), rel, len) == 0)) return (slot - 1);
+
+        bucket = ((bucket + 1) & (m->buckets_count - 1));
+    }
+}
+
+/* [INTERNAL] Returns type of object in path of len bytes (Normalized) in mounted archives (Directories that contain mount points too), Or ICE_FS_OBJECT_TYPE_NONE if none of them has it, Stores entry and archive of files in entry and mount if they're not NULL */
+static ice_fs_object_type ice_fs_vfs_lookup(const ice_fs_vfs *vfs, const char *path, unsigned long len, const ice_fs_vfs_archive **mount, unsigned long *entry) {
+    const ice_fs_vfs_archive *m;
+
+    for (m = (const ice_fs_vfs_archive*) vfs->mounts; m != 0; m = m->next) {
+        unsigned long rel_start, index;
+
+        if (ice_fs_vfs_rel(m, path, len, &rel_start) == ICE_FS_FALSE) {
+            /* Directories that lead to mount point exist too */
+            if ((len < m->point_len) && ((len == 0) || ((m->point[len] == '/') && (memcmp(m->point, path, len) == 0)))) return ICE_FS_OBJECT_TYPE_DIR;
+            continue;
+        }
+
+        if (rel_start == len) return ICE_FS_OBJECT_TYPE_DIR;
+
+        index = ice_fs_vfs_find(m, path + rel_start, len - rel_start);
+        if (index == ICE_FS_PACK_NONE) continue;
+
+        if (ice_fs_le_get(m->toc + (index * ICE_FS_PACK_ENTRY_SIZE) + 36, 4) == 1) return ICE_FS_OBJECT_TYPE_DIR;
+
+        if (mount != 0) *mount = m;
+        if (entry != 0) *entry = index;
+
+        return ICE_FS_OBJECT_TYPE_FILE;
+    }
+
+    return ICE_FS_OBJECT_TYPE_NONE;
+}
+
+/* [INTERNAL] Validates archive mapped in m and points m into it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if the archive is malformed */
+static ice_fs_bool ice_fs_vfs_parse(ice_fs_vfs_archive *m) {
+    const unsigned char *data = (const unsigned char*) m->view.data;
+    ice_fs_hash_value count, buckets, names_size, index_size;
+    unsigned long size = m->view.size, used = 0, i;
+    const char *prev = 0;
+
+    if ((data == 0) || (size < ICE_FS_PACK_HEADER_SIZE) || (memcmp(data, ICE_FS_PACK_MAGIC, 8) != 0)) return ICE_FS_FALSE;
+    if (ice_fs_le_get(data + 8, 4) != ICE_FS_PACK_VERSION) return ICE_FS_FALSE;
+
+    count = ice_fs_le_get(data + 16, 8);
+    buckets = ice_fs_le_get(data + 24, 8);
+    names_size = ice_fs_le_get(data + 32, 8);
+    index_size = ice_fs_le_get(data + 40, 8);
+
+    /* Sizes are checked one by one, So their sum can't overflow */
+    if ((index_size > size) || (count > (size / ICE_FS_PACK_ENTRY_SIZE)) || (buckets > (size / 4)) || (names_size > size)) return ICE_FS_FALSE;
+    if ((buckets <= count) || ((buckets & (buckets - 1)) != 0)) return ICE_FS_FALSE;
+    if ((ICE_FS_PACK_HEADER_SIZE + (count * ICE_FS_PACK_ENTRY_SIZE) + (buckets * 4) + names_size) > index_size) return ICE_FS_FALSE;
+    if (ice_fs_pack_index_hash(data, (unsigned long) index_size) != ice_fs_le_get(data + 48, 8)) return ICE_FS_FALSE;
+
+    m->entries_count = (unsigned long) count;
+    m->buckets_count = (unsigned long) buckets;
+    m->toc = data + ICE_FS_PACK_HEADER_SIZE;
+    m->buckets = m->toc + (m->entries_count * ICE_FS_PACK_ENTRY_SIZE);
+    m->names = (const char*)(m->buckets + (m->buckets_count * 4));
+
+    /* Entries are checked once here, So lookups trust them */
+    for (i = 0; i < m->entries_count; i++) {
+        const unsigned char *entry = m->toc + (i * ICE_FS_PACK_ENTRY_SIZE);
+        ice_fs_hash_value offset = ice_fs_le_get(entry + 8, 8),
+                          file_size = ice_fs_le_get(entry + 16, 8),
+                          name_offset = ice_fs_le_get(entry + 24, 8),
+                          name_len = ice_fs_le_get(entry + 32, 4),
+                          type = ice_fs_le_get(entry + 36, 4);
+        const char *name;
+
+        if ((name_offset >= names_size) || (name_len >= (names_size - name_offset)) || (m->names[name_offset + name_len] != 0)) return ICE_FS_FALSE;
+        if ((type > 1) || ((type == 0) && ((offset < index_size) || (offset > size) || (file_size > (size - offset))))) return ICE_FS_FALSE;
+        name = m->names + name_offset;
+        if ((ice_fs_str_len(name) != name_len) || ((prev != 0) && (strcmp(prev, name) >= 0))) return ICE_FS_FALSE;
+
+        prev = name;
+    }
+
+    /* Hash table must have empty buckets, So probing always ends */
+    for (i = 0; i < m->buckets_count; i++) {
+        ice_fs_hash_value slot = ice_fs_le_get(m->buckets + (i * 4), 4);
+
+        if (slot > count) return ICE_FS_FALSE;
+        if (slot != 0) used++;
+    }
+
+    return (used == count) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* Mounts archive in pack_path created by ice_fs_pack_create into vfs at mount_point (Path that archive content appears in, NULL or "" for current directory), Paths found in mounted archives take priority over disk and archives mounted later take priority over earlier ones, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the archive is malformed) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_vfs_mount(ice_fs_vfs *vfs, const char *pack_path, const char *mount_point) {
+    unsigned long point_len = ice_fs_str_len(mount_point);
+    ice_fs_vfs_archive *m;
+
+    if ((vfs == 0) || (pack_path == 0)) return ICE_FS_FALSE;
+
+    m = ICE_FS_MALLOC(sizeof(ice_fs_vfs_archive) + point_len + 1);
+    if (m == 0) return ICE_FS_FALSE;
+
+    m->point = (char*)(m + 1);
+    m->point_len = ice_fs_vfs_normalize(((mount_point == 0) ? "" : mount_point), point_len, m->point);
+
+    /* Lookups jump around table of contents, So read ahead is useless */
+    if (ice_fs_map(pack_path, ICE_FS_MAP_HINT_RANDOM, ICE_FS_FALSE, &m->view) == ICE_FS_FALSE) {
+        ICE_FS_FREE(m);
+        return ICE_FS_FALSE;
+    }
+
+    if (ice_fs_vfs_parse(m) == ICE_FS_FALSE) {
+        (void) ice_fs_unmap(&m->view);
+        ICE_FS_FREE(m);
+        errno = EINVAL;
+
+        return ICE_FS_FALSE;
+    }
+
+    m->next = (ice_fs_vfs_archive*) vfs->mounts;
+    vfs->mounts = m;
+
+    return ICE_FS_TRUE;
+}
+
+/* Returns type of object in path (Looked up in mounted archives then on disk) */
+ICE_FS_API ice_fs_object_type ICE_FS_CALLCONV ice_fs_vfs_type(const ice_fs_vfs *vfs, const char *path) {
+    unsigned long len = ice_fs_str_len(path);
+    ice_fs_object_type res = ICE_FS_OBJECT_TYPE_NONE;
+    char stack[256], *norm;
+
+    if ((vfs == 0) || (path == 0)) return ICE_FS_OBJECT_TYPE_NONE;
+
+    norm = ((len < sizeof(stack)) ? stack : ICE_FS_MALLOC(len + 1));
+    if (norm == 0) return ICE_FS_OBJECT_TYPE_NONE;
+
+    res = ice_fs_vfs_lookup(vfs, norm, ice_fs_vfs_normalize(path, len, norm), 0, 0);
+    if (norm != stack) ICE_FS_FREE(norm);
+
+    return (res != ICE_FS_OBJECT_TYPE_NONE) ? res : ice_fs_type(path);
+}
+
+/* Returns pointer to content of file in path inside mounted archive (Without copying, Valid till ice_fs_vfs_close) and stores its size in file_size, Or NULL if none of mounted archives has the file (Disk is not accessed) */
+ICE_FS_API const void* ICE_FS_CALLCONV ice_fs_vfs_file_data(const ice_fs_vfs *vfs, const char *path, unsigned long *file_size) {
+    unsigned long len = ice_fs_str_len(path), entry = 0;
+    const ice_fs_vfs_archive *m = 0;
+    const unsigned char *data = 0;
+    char stack[256], *norm;
+
+    if ((vfs == 0) || (path == 0)) return 0;
+
+    norm = ((len < sizeof(stack)) ? stack : ICE_FS_MALLOC(len + 1));
+    if (norm == 0) return 0;
+
+    if (ice_fs_vfs_lookup(vfs, norm, ice_fs_vfs_normalize(path, len, norm), &m, &entry) == ICE_FS_OBJECT_TYPE_FILE) {
+        const unsigned char *toc_entry = m->toc + (entry * ICE_FS_PACK_ENTRY_SIZE);
+
+        data = ((const unsigned char*) m->view.data) + ice_fs_le_get(toc_entry + 8, 8);
+        if (file_size != 0) *file_size = (unsigned long) ice_fs_le_get(toc_entry + 16, 8);
+    }
+
+    if (norm != stack) ICE_FS_FREE(norm);
+
+    return data;
+}
+
+/* Same like ice_fs_file_content but file in path is looked up in mounted archives then on disk */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_vfs_file_content(const ice_fs_vfs *vfs, const char *path, unsigned long *file_size) {
+    unsigned long size = 0;
+    const void *data = ice_fs_vfs_file_data(vfs, path, &size);
+    char *res;
+
+    if (data == 0) {
+        /* Directory in archive hides file of same path on disk */
+        if ((vfs == 0) || (ice_fs_vfs_type(vfs, path) == ICE_FS_OBJECT_TYPE_DIR)) return 0;
+        return ice_fs_file_content(path, file_size);
+    }
+
+    res = ICE_FS_MALLOC((size + 1) * sizeof(char));
+    if (res == 0) return 0;
+
+    memcpy(res, data, size);
+    res[size] = 0;
+
+    if (file_size != 0) *file_size = size;
+
+    return res;
+}
+
+/* [INTERNAL] Pushes name of len bytes to b unless it's already there (Looked up in hash table set of set_size buckets that stores indexes of pushed names plus one), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on allocation failure */
+static ice_fs_bool ice_fs_vfs_dir_push(ice_fs_dir_builder *b, unsigned long **set, unsigned long *set_size, const char *name, unsigned long len, ice_fs_object_type type) {
+    unsigned long bucket, i;
+
+    /* Set is rebuilt twice as big when it gets half full */
+    if (((b->entries_count + 1) * 2) > *set_size) {
+        unsigned long size = ((*set_size == 0) ? 64 : (*set_size * 2));
+        unsigned long *grown = ICE_FS_CALLOC(size, sizeof(unsigned long));
+
+        if (grown == 0) return ICE_FS_FALSE;
+
+        for (i = 0; i < b->entries_count; i++) {
+            const char *pushed = b->names + b->entries[i].name_offset;
+
+            bucket = (unsigned long)(ice_fs_hash(pushed, ice_fs_str_len(pushed)) & (size - 1));
+            while (grown[bucket] != 0) bucket = ((bucket + 1) & (size - 1));
+            grown[bucket] = (i + 1);
+        }
+
+        ICE_FS_FREE(*set);
+        *set = grown;
+        *set_size = size;
+    }
+
+    bucket = (unsigned long)(ice_fs_hash(name, len) & (*set_size - 1));
+
+    while ((*set)[bucket] != 0) {
+        const char *pushed = b->names + b->entries[(*set)[bucket] - 1].name_offset;
+
+        if ((strncmp(pushed, name, len) == 0) && (pushed[len] == 0)) return ICE_FS_TRUE;
+        bucket = ((bucket + 1) & (*set_size - 1));
+    }
+
+    if (ice_fs_dir_builder_push(b, name, len, type) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    (*set)[bucket] = b->entries_count;
+
+    return ICE_FS_TRUE;
+}
+
+/* Same like ice_fs_dir_content but items of directory in path are listed from mounted archives then disk (Items found earlier hide ones of same name), Returns directory with no items if path is in none of them */
+ICE_FS_API ice_fs_dir ICE_FS_CALLCONV ice_fs_vfs_dir_content(const ice_fs_vfs *vfs, const char *path) {
+    ice_fs_dir res, disk;
+    ice_fs_dir_builder b = { 0, 0, 0, 0, 0, 0 };
+    const ice_fs_vfs_archive *m;
+    unsigned long len = ice_fs_str_len(path), norm_len, set_size = 0, i, *set = 0;
+    ice_fs_bool pushed = ICE_FS_TRUE;
+    char stack[256], *norm;
+
+    res.items = 0;
+    res.items_count = 0;
+
+    if ((vfs == 0) || (path == 0)) return res;
+
+    norm = ((len < sizeof(stack)) ? stack : ICE_FS_MALLOC(len + 1));
+    if (norm == 0) return res;
+
+    norm_len = ice_fs_vfs_normalize(path, len, norm);
+
+    for (m = (const ice_fs_vfs_archive*) vfs->mounts; (m != 0) && (pushed == ICE_FS_TRUE); m = m->next) {
+        unsigned long rel_start, rel_len, low = 0, high = m->entries_count;
+        const char *rel;
+
+        if (ice_fs_vfs_rel(m, norm, norm_len, &rel_start) == ICE_FS_FALSE) {
+            /* Directory that leads to mount point has next directory of the mount point as item */
+            if ((norm_len < m->point_len) && ((norm_len == 0) || ((m->point[norm_len] == '/') && (memcmp(m->point, norm, norm_len) == 0)))) {
+                const char *name = m->point + ((norm_len == 0) ? 0 : (norm_len + 1));
+                unsigned long name_len = 0;
+
+                while ((name[name_len] != 0) && (name[name_len] != '/')) name_len++;
+                pushed = ice_fs_vfs_dir_push(&b, &set, &set_size, name, name_len, ICE_FS_OBJECT_TYPE_DIR);
+            }
+
+            continue;
+        }
+
+        rel = norm + rel_start;
+        rel_len = norm_len - rel_start;
+
+        if (rel_len > 0) {
+            unsigned long index = ice_fs_vfs_find(m, rel, rel_len);
+            if ((index == ICE_FS_PACK_NONE) || (ice_fs_le_get(m->toc + (index * ICE_FS_PACK_ENTRY_SIZE) + 36, 4) != 1)) continue;
+        }
+
+        /* Items of directory follow it in table of contents sorted by path, So first one is found by binary search for "rel/" */
+        while (low < high) {
+            unsigned long mid = (low + ((high - low) / 2));
+            const char *name = m->names + ice_fs_le_get(m->toc + (mid * ICE_FS_PACK_ENTRY_SIZE) + 24, 8);
+            int cmp = strncmp(name, rel, rel_len);
+
+            if ((cmp == 0) && (rel_len > 0)) cmp = (((unsigned char) name[rel_len]) - ((unsigned char) '/'));
+
+            if (cmp < 0) {
+                low = (mid + 1);
+            } else {
+                high = mid;
+            }
+        }
+
+        for (i = low; (i < m->entries_count) && (pushed == ICE_FS_TRUE); i++) {
+            const unsigned char *entry = m->toc + (i * ICE_FS_PACK_ENTRY_SIZE);
+            const char *name = m->names + ice_fs_le_get(entry + 24, 8);
+            unsigned long name_len = (unsigned long) ice_fs_le_get(entry + 32, 4);
+
+            if (rel_len > 0) {
+                if ((name_len <= rel_len) || (strncmp(name, rel, rel_len) != 0) || (name[rel_len] != '/')) break;
+
+                name += (rel_len + 1);
+                name_len -= (rel_len + 1);
+            }
+
+            /* Items of subdirectories are skipped */
+            if (memchr(name, '/', name_len) != 0) continue;
+
+            pushed = ice_fs_vfs_dir_push(&b, &set, &set_size, name, name_len, ((ice_fs_le_get(entry + 36, 4) == 1) ? ICE_FS_OBJECT_TYPE_DIR : ICE_FS_OBJECT_TYPE_FILE));
+        }
+    }
+
+    if (norm != stack) ICE_FS_FREE(norm);
+
+    disk = ice_fs_dir_content(path);
+
+    for (i = 0; (i < disk.items_count) && (pushed == ICE_FS_TRUE); i++) {
+        pushed = ice_fs_vfs_dir_push(&b, &set, &set_size, disk.items[i].name, ice_fs_str_len(disk.items[i].name), disk.items[i].type);
+    }
+
+    ice_fs_free_dir_content(&disk);
+    ICE_FS_FREE(set);
+
+    if (pushed == ICE_FS_FALSE) {
+        ICE_FS_FREE(b.entries);
+        ICE_FS_FREE(b.names);
+
+        return res;
+    }
+
+    (void) ice_fs_dir_builder_finish(&b, &res);
+    return res;
+}
+
+/* Unmounts all archives mounted into vfs, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_vfs_close(ice_fs_vfs *vfs) {
+    ice_fs_bool res = ICE_FS_TRUE;
+
+    if (vfs == 0) return ICE_FS_FALSE;
+
+    while (vfs->mounts != 0) {
+        ice_fs_vfs_archive *m = (ice_fs_vfs_archive*) vfs->mounts;
+
+        vfs->mounts = m->next;
+        if (ice_fs_unmap(&m->view) == ICE_FS_FALSE) res = ICE_FS_FALSE;
+        ICE_FS_FREE(m);
+    }
+
+    return res;
+}
+
+/* ============================== Compression ============================== */
+
+/* [INTERNAL] Bytes that compressed files start and end with */
+#define ICE_FS_ZFILE_MAGIC "ICEFSLZB"
+#define ICE_FS_ZFILE_END_MAGIC "ICEFSLZE"
+#define ICE_FS_ZFILE_VERSION 1
+
+/* [INTERNAL] Layout of compressed files (All numbers are little-endian), Header (Magic, Version and block size) is followed by compressed blocks, Index of blocks (Offset, Stored size, Uncompressed size and hash of stored bytes of each) and trailer (Blocks count, Uncompressed size, Hash of the index and end magic) */
+#define ICE_FS_ZFILE_HEADER_SIZE 16
+#define ICE_FS_ZFILE_ENTRY_SIZE 24
+#define ICE_FS_ZFILE_TRAILER_SIZE 32
+
+/* [INTERNAL] Set in stored size of blocks that are kept uncompressed (Compression wouldn't make them smaller) */
+#define ICE_FS_ZFILE_RAW_FLAG 0x80000000UL
+
+/* [INTERNAL] Largest block size that compressed files can have (Bigger ones are treated as malformed) */
+#define ICE_FS_ZFILE_MAX_BLOCK_SIZE 0x4000000UL
+
+/* [INTERNAL] Index of block that ice_fs_zstream holds when it holds none */
+#define ICE_FS_ZFILE_NONE ((unsigned long)-1)
+
+/* [INTERNAL] Blocks are compressed in LZ4 block format, Matches are 4 bytes at least and up to 65535 bytes back */
+#define ICE_FS_LZ_MIN_MATCH 4
+#define ICE_FS_LZ_MAX_OFFSET 65535
+#define ICE_FS_LZ_HASH_BITS 12
+
+/* [INTERNAL] State of ice_fs_zstream */
+typedef struct ice_fs_zstream_state {
+    int fd;
+    ice_fs_bool writing;
+    unsigned long block_size;
+    unsigned char *index;               /* Entries of blocks (24 bytes each) */
+    unsigned long blocks_count, blocks_capacity;
+    ice_fs_offset size;                 /* Uncompressed size (Bytes written so far when writing) */
+    ice_fs_offset pos;                  /* Uncompressed position of next read (Reading only) */
+    ice_fs_offset file_pos;             /* Offset that next block is written at (Writing only) */
+    unsigned char *block;               /* Uncompressed block (Bytes pending to be compressed when writing) */
+    unsigned long block_len;            /* Bytes pending in block (Writing only) */
+    unsigned long block_index;          /* Index of block in block (Reading only, ICE_FS_ZFILE_NONE if none) */
+    unsigned char *packed;              /* Compressed block */
+    unsigned long *table;               /* Hash table of compressor (Writing only) */
+} ice_fs_zstream_state;
+
+/* [INTERNAL] State shared by threads that compress or decompress blocks of ice_fs_compress_file and ice_fs_compressed_file_content */
+typedef struct ice_fs_zblocks_ctx {
+    ice_fs_mutex mutex;
+    const unsigned char *src;           /* Content of compressed file (Decompression) or file to compress (Compression) */
+    unsigned char *dst;                 /* Uncompressed content (Decompression) or compressed blocks of the batch (Compression) */
+    const unsigned char *index;         /* Index of blocks (Decompression only) */
+    unsigned long *sizes;               /* Compressed sizes of blocks of the batch, 0 for blocks that stay uncompressed (Compression only) */
+    ice_fs_offset size;                 /* Uncompressed size of the file */
+    unsigned long block_size;
+    unsigned long first, count;         /* Blocks to process */
+    unsigned long next;                 /* Index of first block (Relative to first) that no thread took yet */
+    ice_fs_bool compress;
+    ice_fs_bool failed;
+} ice_fs_zblocks_ctx;
+
+/* [INTERNAL] Writes len (Part of length that didn't fit in token) as 255 bytes ended by smaller byte to dst of dst_size bytes at pos, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if it doesn't fit */
+static ice_fs_bool ice_fs_lz_put_len(unsigned char *dst, unsigned long dst_size, unsigned long *pos, unsigned long len) {
+    for (;;) {
+        if (*pos >= dst_size) return ICE_FS_FALSE;
+
+        if (len < 255) {
+            dst[(*pos)++] = (unsigned char) len;
+            return ICE_FS_TRUE;
+        }
+
+        dst[(*pos)++] = 255;
+        len -= 255;
+    }
+}
+
+/* [INTERNAL] Writes sequence of literals_len bytes of literals followed by match of match_len bytes at offset back (match_len is 0 for last sequence) to dst of dst_size bytes at pos, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if it doesn't fit */
+static ice_fs_bool ice_fs_lz_put_seq(unsigned char *dst, unsigned long dst_size, unsigned long *pos, const unsigned char *literals, unsigned long literals_len, unsigned long offset, unsigned long match_len) {
+    unsigned long token_pos = *pos;
+    unsigned token = (unsigned)(((literals_len >= 15) ? 15 : literals_len) << 4);
+
+    if (*pos >= dst_size) return ICE_FS_FALSE;
+    (*pos)++;
+
+    if (literals_len >= 15) {
+        if (ice_fs_lz_put_len(dst, dst_size, pos, literals_len - 15) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    }
+
+    if ((dst_size - *pos) < literals_len) return ICE_FS_FALSE;
+
+    memcpy(dst + *pos, literals, literals_len);
+    *pos += literals_len;
+
+    if (match_len > 0) {
+        match_len -= ICE_FS_LZ_MIN_MATCH;
+        token |= (unsigned)((match_len >= 15) ? 15 : match_len);
+
+        if ((dst_size - *pos) < 2) return ICE_FS_FALSE;
+
+        dst[(*pos)++] = (unsigned char)(offset & 0xff);
+        dst[(*pos)++] = (unsigned char)(offset >> 8);
+
+        if (match_len >= 15) {
+            if (ice_fs_lz_put_len(dst, dst_size, pos, match_len - 15) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        }
+    }
+
+    dst[token_pos] = (unsigned char) token;
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Compresses len bytes from src into dst of dst_size bytes (LZ4 block format) with table of (1 << ICE_FS_LZ_HASH_BITS) positions, Returns size of compressed data or 0 if it doesn't fit in dst */
+static unsigned long ice_fs_lz_compress(const unsigned char *src, unsigned long len, unsigned char *dst, unsigned long dst_size, unsigned long *table) {
+    unsigned long pos = 0, anchor = 0, i = 0;
+
+    /* Matches end 5 bytes before end of input and start 12 bytes before it at least (Like LZ4 decoders expect) */
+    if (len > 12) {
+        unsigned long match_limit = (len - 5), start_limit = (len - 12);
+
+        for (i = 0; i < (1UL << ICE_FS_LZ_HASH_BITS); i++) table[i] = 0;
+        i = 0;
+
+        while (i < start_limit) {
+            ice_fs_hash_value seq = ice_fs_hash_read32(src + i);
+            unsigned long bucket = (unsigned long)(((seq * 2654435761UL) & 0xffffffffUL) >> (32 - ICE_FS_LZ_HASH_BITS)),
+                          ref = table[bucket], match_len = ICE_FS_LZ_MIN_MATCH;
+
+            /* Positions are stored plus one, So 0 marks empty bucket */
+            table[bucket] = (i + 1);
+
+            if ((ref == 0) || ((i - (ref - 1)) > ICE_FS_LZ_MAX_OFFSET) || (ice_fs_hash_read32(src + ref - 1) != seq)) {
+                /* Step grows while no matches are found, So incompressible data passes quickly */
+                i += (1 + ((i - anchor) >> 6));
+                continue;
+            }
+
+            ref--;
+
+            while (((i + match_len) < match_limit) && (src[ref + match_len] == src[i + match_len])) match_len++;
+
+            /* Match takes over literals before it that match too */
+            while ((i > anchor) && (ref > 0) && (src[i - 1] == src[ref - 1])) {
+                i--;
+                ref--;
+                match_len++;
+            }
+
+            if (ice_fs_lz_put_seq(dst, dst_size, &pos, src + anchor, i - anchor, i - ref, match_len) == ICE_FS_FALSE) return 0;
+
+            i += match_len;
+            anchor = i;
+        }
+    }
+
+    if (ice_fs_lz_put_seq(dst, dst_size, &pos, src + anchor, len - anchor, 0, 0) == ICE_FS_FALSE) return 0;
+
+    return pos;
+}
+
+/* [INTERNAL] Reads length (Part that didn't fit in token) from src of src_len bytes at pos and adds it to len, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if it's malformed or bigger than limit */
+static ice_fs_bool ice_fs_lz_get_len(const unsigned char *src, unsigned long src_len, unsigned long *pos, unsigned long *len, unsigned long limit) {
+    for (;;) {
+        unsigned byte;
+
+        if ((*pos >= src_len) || (*len > limit)) return ICE_FS_FALSE;
+
+        byte = src[(*pos)++];
+        *len += byte;
+
+        if (byte != 255) return ICE_FS_TRUE;
+    }
+}
+
+/* [INTERNAL] Decompresses src_len bytes of LZ4 block from src into dst of exactly dst_len bytes (Malformed input fails instead of reading or writing out of bounds), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_lz_decompress(const unsigned char *src, unsigned long src_len, unsigned char *dst, unsigned long dst_len) {
+    unsigned long ip = 0, op = 0, i;
+
+    while (ip < src_len) {
+        unsigned token = src[ip++];
+        unsigned long len = (token >> 4), offset;
+
+        if (len == 15) {
+            if (ice_fs_lz_get_len(src, src_len, &ip, &len, dst_len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        }
+
+        if ((len > (src_len - ip)) || (len > (dst_len - op))) return ICE_FS_FALSE;
+
+        /* Short literals are copied as fixed 16 bytes while both buffers have room for it (Bytes past them get overwritten later) */
+        if ((len <= 16) && ((src_len - ip) >= 16) && ((dst_len - op) >= 16)) {
+            memcpy(dst + op, src + ip, 16);
+        } else {
+            memcpy(dst + op, src + ip, len);
+        }
+
+        ip += len;
+        op += len;
+
+        /* Last sequence has literals only */
+        if (ip == src_len) break;
+        if ((src_len - ip) < 2) return ICE_FS_FALSE;
+
+        offset = (((unsigned long) src[ip]) | (((unsigned long) src[ip + 1]) << 8));
+        ip += 2;
+
+        if ((offset == 0) || (offset > op)) return ICE_FS_FALSE;
+
+        len = (token & 15);
+
+        if (len == 15) {
+            if (ice_fs_lz_get_len(src, src_len, &ip, &len, dst_len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        }
+
+        len += ICE_FS_LZ_MIN_MATCH;
+        if (len > (dst_len - op)) return ICE_FS_FALSE;
+
+        if ((offset >= 16) && (((dst_len - op) - len) >= 16)) {
+            /* Distant matches are copied in fixed 16 bytes chunks that don't overlap */
+            for (i = 0; i < len; i += 16) memcpy(dst + op + i, dst + op - offset + i, 16);
+            op += len;
+        } else {
+            /* Match that overlaps itself repeats last offset bytes, So it's copied in chunks that double as the repeated bytes grow */
+            unsigned long from = (op - offset);
+
+            while (len > 0) {
+                unsigned long count = (((op - from) < len) ? (op - from) : len);
+
+                memcpy(dst + op, dst + from, count);
+                op += count;
+                len -= count;
+            }
+        }
+    }
+
+    return (op == dst_len) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* [INTERNAL] Returns uncompressed size of block of index in file of size bytes split into blocks of block_size bytes */
+static unsigned long ice_fs_zfile_block_len(ice_fs_offset size, unsigned long block_size, unsigned long index) {
+    ice_fs_offset start = (((ice_fs_offset) index) * block_size);
+    return ((size - start) > (ice_fs_offset) block_size) ? block_size : (unsigned long)(size - start);
+}
+
+/* [INTERNAL] Writes header of compressed file with blocks of block_size bytes to buf */
+static void ice_fs_zfile_header(unsigned char *buf, unsigned long block_size) {
+    memcpy(buf, ICE_FS_ZFILE_MAGIC, 8);
+    ice_fs_le_put(buf + 8, ICE_FS_ZFILE_VERSION, 4);
+    ice_fs_le_put(buf + 12, block_size, 4);
+}
+
+/* [INTERNAL] Checks header and trailer of compressed file of file_size bytes and stores block size, Blocks count and uncompressed size from them, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if they are malformed */
+static ice_fs_bool ice_fs_zfile_parse(const unsigned char *header, const unsigned char *trailer, ice_fs_offset file_size, unsigned long *block_size, unsigned long *blocks_count, ice_fs_offset *size) {
+    ice_fs_hash_value count = ice_fs_le_get(trailer, 8), total = ice_fs_le_get(trailer + 8, 8);
+
+    if ((memcmp(header, ICE_FS_ZFILE_MAGIC, 8) != 0) || (memcmp(trailer + 24, ICE_FS_ZFILE_END_MAGIC, 8) != 0)) return ICE_FS_FALSE;
+    if (ice_fs_le_get(header + 8, 4) != ICE_FS_ZFILE_VERSION) return ICE_FS_FALSE;
+
+    *block_size = (unsigned long) ice_fs_le_get(header + 12, 4);
+    if ((*block_size == 0) || (*block_size > ICE_FS_ZFILE_MAX_BLOCK_SIZE)) return ICE_FS_FALSE;
+
+    /* Index should fit between header and trailer, And blocks should cover uncompressed size exactly */
+    if (count > (ice_fs_hash_value)((file_size - ICE_FS_ZFILE_HEADER_SIZE - ICE_FS_ZFILE_TRAILER_SIZE) / ICE_FS_ZFILE_ENTRY_SIZE)) return ICE_FS_FALSE;
+    if (count != ((total / *block_size) + (((total % *block_size) != 0) ? 1 : 0))) return ICE_FS_FALSE;
+    if ((total >> 62) != 0) return ICE_FS_FALSE;
+
+    *blocks_count = (unsigned long) count;
+    *size = (ice_fs_offset) total;
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Checks index of blocks_count blocks of compressed file that ends at index_offset (Blocks must be before it), Returns ICE_FS_TRUE on success or ICE_FS_FALSE if it's malformed */
+static ice_fs_bool ice_fs_zfile_check_index(const unsigned char *index, const unsigned char *trailer, unsigned long blocks_count, unsigned long block_size, ice_fs_offset size, ice_fs_offset index_offset) {
+    unsigned long i;
+
+    if (ice_fs_hash(index, blocks_count * ICE_FS_ZFILE_ENTRY_SIZE) != ice_fs_le_get(trailer + 16, 8)) return ICE_FS_FALSE;
+
+    for (i = 0; i < blocks_count; i++) {
+        const unsigned char *entry = index + (i * ICE_FS_ZFILE_ENTRY_SIZE);
+        ice_fs_hash_value offset = ice_fs_le_get(entry, 8), stored = ice_fs_le_get(entry + 8, 4), len = ice_fs_le_get(entry + 12, 4);
+
+        if (len != ice_fs_zfile_block_len(size, block_size, i)) return ICE_FS_FALSE;
+
+        if ((stored & ICE_FS_ZFILE_RAW_FLAG) != 0) {
+            if ((stored & ~((ice_fs_hash_value) ICE_FS_ZFILE_RAW_FLAG)) != len) return ICE_FS_FALSE;
+            stored = len;
+        } else if (stored > len) {
+            return ICE_FS_FALSE;
+        }
+
+        if ((offset < ICE_FS_ZFILE_HEADER_SIZE) || (offset > (ice_fs_hash_value) index_offset) || (stored > ((ice_fs_hash_value) index_offset - offset))) return ICE_FS_FALSE;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Checks block stored at src as described by entry of index and decompresses it into dst, Returns ICE_FS_TRUE on success or ICE_FS_FALSE if the block is damaged or malformed */
+static ice_fs_bool ice_fs_zfile_unpack(const unsigned char *entry, const unsigned char *src, unsigned char *dst) {
+    unsigned long stored = (unsigned long) ice_fs_le_get(entry + 8, 4), len = (unsigned long) ice_fs_le_get(entry + 12, 4);
+
+    /* Damaged blocks are caught before they're decompressed */
+    if (ice_fs_hash(src, ((stored & ICE_FS_ZFILE_RAW_FLAG) != 0) ? len : stored) != ice_fs_le_get(entry + 16, 8)) return ICE_FS_FALSE;
+
+    if ((stored & ICE_FS_ZFILE_RAW_FLAG) != 0) {
+        memcpy(dst, src, len);
+        return ICE_FS_TRUE;
+    }
+
+    return ice_fs_lz_decompress(src, stored, dst, len);
+}
+
+/* [INTERNAL] Compresses block of len bytes from src into dst of len bytes with table, Returns compressed size or 0 if the block should stay uncompressed */
+static unsigned long ice_fs_zfile_pack(const unsigned char *src, unsigned long len, unsigned char *dst, unsigned long *table) {
+    /* Compressed block should be smaller than uncompressed one, So stored blocks never grow */
+    return (len > 1) ? ice_fs_lz_compress(src, len, dst, len - 1, table) : 0;
+}
+
+/* [INTERNAL] Writes index of blocks_count blocks and trailer of compressed file with size uncompressed bytes to fd, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_zfile_finish(int fd, const unsigned char *index, unsigned long blocks_count, ice_fs_offset size) {
+    unsigned char trailer[ICE_FS_ZFILE_TRAILER_SIZE];
+
+    ice_fs_le_put(trailer, blocks_count, 8);
+    ice_fs_le_put(trailer + 8, (ice_fs_hash_value) size, 8);
+    ice_fs_le_put(trailer + 16, ice_fs_hash(index, blocks_count * ICE_FS_ZFILE_ENTRY_SIZE), 8);
+    memcpy(trailer + 24, ICE_FS_ZFILE_END_MAGIC, 8);
+
+    if (ice_fs_write_fd(fd, index, blocks_count * ICE_FS_ZFILE_ENTRY_SIZE) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    return ice_fs_write_fd(fd, trailer, ICE_FS_ZFILE_TRAILER_SIZE);
+}
+
+/* [INTERNAL] Reads exactly len bytes at offset of fd into dst, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if file ends before) */
+static ice_fs_bool ice_fs_zfile_read_at(int fd, ice_fs_offset offset, void *dst, unsigned long len) {
+    unsigned long total = 0;
+
+    if (ice_fs_seek_fd(fd, offset, SEEK_SET) == -1) return ICE_FS_FALSE;
+
+    while (total < len) {
+        long res = ice_fs_read_fd(fd, ((char*) dst) + total, len - total);
+
+        if (res <= 0) {
+            if (res == 0) errno = EINVAL;
+            return ICE_FS_FALSE;
+        }
+
+        total += (unsigned long) res;
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* [INTERNAL] Opens file in path in mode (Binary on Microsoft Windows), Returns file descriptor or -1 on failure */
+static int ice_fs_zfile_open_fd(const char *path, ice_fs_stream_mode mode) {
+#if defined(ICE_FS_MICROSOFT)
+    return open(path, ice_fs_stream_flags(mode) | O_BINARY, S_IREAD | S_IWRITE);
+#elif defined(ICE_FS_UNIX)
+    return open(path, ice_fs_stream_flags(mode), 0666);
+#endif
+}
+
+/* [INTERNAL] Frees state of ice_fs_zstream and closes its file, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_zstream_free(ice_fs_zstream_state *state) {
+    ice_fs_bool res = ICE_FS_TRUE;
+
+    if ((state->fd != -1) && (close(state->fd) == -1)) res = ICE_FS_FALSE;
+
+    ICE_FS_FREE(state->index);
+    ICE_FS_FREE(state->block);
+    ICE_FS_FREE(state->packed);
+    ICE_FS_FREE(state->table);
+    ICE_FS_FREE(state);
+
+    return res;
+}
+
+/* [INTERNAL] Loads block of index of stream into dst, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_zstream_load(ice_fs_zstream_state *state, unsigned long index, unsigned char *dst) {
+    const unsigned char *entry = state->index + (index * ICE_FS_ZFILE_ENTRY_SIZE);
+    ice_fs_offset offset = (ice_fs_offset) ice_fs_le_get(entry, 8);
+    unsigned long stored = (unsigned long) ice_fs_le_get(entry + 8, 4), len = (unsigned long) ice_fs_le_get(entry + 12, 4);
+
+    ice_fs_bool res;
+
+    /* Uncompressed blocks are read straight into dst */
+    if ((stored & ICE_FS_ZFILE_RAW_FLAG) != 0) {
+        if (ice_fs_zfile_read_at(state->fd, offset, dst, len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        res = ((ice_fs_hash(dst, len) == ice_fs_le_get(entry + 16, 8)) ? ICE_FS_TRUE : ICE_FS_FALSE);
+    } else {
+        if (ice_fs_zfile_read_at(state->fd, offset, state->packed, stored) == ICE_FS_FALSE) return ICE_FS_FALSE;
+        res = ice_fs_zfile_unpack(entry, state->packed, dst);
+    }
+
+    if (res == ICE_FS_FALSE) errno = EINVAL;
+
+    return res;
+}
+
+/* [INTERNAL] Compresses len bytes from src as next block of stream and writes it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_zstream_store(ice_fs_zstream_state *state, const unsigned char *src, unsigned long len) {
+    unsigned long packed_len = ice_fs_zfile_pack(src, len, state->packed, state->table);
+    unsigned char *entry;
+
+    if (state->blocks_count == state->blocks_capacity) {
+        unsigned long capacity = ((state->blocks_capacity == 0) ? 64 : (state->blocks_capacity * 2));
+        unsigned char *grown = ICE_FS_REALLOC(state->index, capacity * ICE_FS_ZFILE_ENTRY_SIZE);
+        if (grown == 0) return ICE_FS_FALSE;
+
+        state->index = grown;
+        state->blocks_capacity = capacity;
+    }
+
+    if (packed_len == 0) {
+        if (ice_fs_write_fd(state->fd, src, len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    } else {
+        if (ice_fs_write_fd(state->fd, state->packed, packed_len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+    }
+
+    entry = state->index + (state->blocks_count * ICE_FS_ZFILE_ENTRY_SIZE);
+    ice_fs_le_put(entry, (ice_fs_hash_value) state->file_pos, 8);
+    ice_fs_le_put(entry + 8, ((packed_len == 0) ? (len | ICE_FS_ZFILE_RAW_FLAG) : packed_len), 4);
+    ice_fs_le_put(entry + 12, len, 4);
+    ice_fs_le_put(entry + 16, ((packed_len == 0) ? ice_fs_hash(src, len) : ice_fs_hash(state->packed, packed_len)), 8);
+
+    state->blocks_count++;
+    state->file_pos += ((packed_len == 0) ? len : packed_len);
+    state->size += len;
+
+    return ICE_FS_TRUE;
+}
+
+/* Opens compressed file in path as stream in mode (ICE_FS_STREAM_MODE_READ for file created with ice_fs_zstream_write or ice_fs_compress_file, Or ICE_FS_STREAM_MODE_WRITE to create it with blocks of ICE_FS_ZSTREAM_BLOCK_SIZE bytes), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure (Or if the file is malformed) */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_open(ice_fs_zstream *stream, const char *path, ice_fs_stream_mode mode) {
+    unsigned char header[ICE_FS_ZFILE_HEADER_SIZE], trailer[ICE_FS_ZFILE_TRAILER_SIZE];
+    ice_fs_zstream_state *state;
+    ice_fs_offset file_size, index_offset;
+
+    if ((stream == 0) || (path == 0)) return ICE_FS_FALSE;
+    if ((mode != ICE_FS_STREAM_MODE_READ) && (mode != ICE_FS_STREAM_MODE_WRITE)) return ICE_FS_FALSE;
+
+    stream->handle = 0;
+
+    state = ICE_FS_CALLOC(1, sizeof(ice_fs_zstream_state));
+    if (state == 0) return ICE_FS_FALSE;
+
+    state->writing = ICE_FS_FALSE;
+    state->block_index = ICE_FS_ZFILE_NONE;
+    state->fd = ice_fs_zfile_open_fd(path, mode);
+    if (state->fd == -1) goto failure;
+
+    if (mode == ICE_FS_STREAM_MODE_WRITE) {
+        state->writing = ICE_FS_TRUE;
+        state->block_size = ICE_FS_ZSTREAM_BLOCK_SIZE;
+        state->file_pos = ICE_FS_ZFILE_HEADER_SIZE;
+
+        state->block = ICE_FS_MALLOC(state->block_size);
+        state->packed = ICE_FS_MALLOC(state->block_size);
+        state->table = ICE_FS_MALLOC((1UL << ICE_FS_LZ_HASH_BITS) * sizeof(unsigned long));
+        if ((state->block == 0) || (state->packed == 0) || (state->table == 0)) goto failure;
+
+        ice_fs_zfile_header(header, state->block_size);
+        if (ice_fs_write_fd(state->fd, header, ICE_FS_ZFILE_HEADER_SIZE) == ICE_FS_FALSE) goto failure;
+
+        stream->handle = state;
+        return ICE_FS_TRUE;
+    }
+
+    /* Index at end of the file is read once, So reads and seeks don't need to scan blocks */
+    file_size = ice_fs_seek_fd(state->fd, 0, SEEK_END);
+    if ((file_size == -1) || (file_size < (ICE_FS_ZFILE_HEADER_SIZE + ICE_FS_ZFILE_TRAILER_SIZE))) goto malformed;
+
+    if (ice_fs_zfile_read_at(state->fd, 0, header, ICE_FS_ZFILE_HEADER_SIZE) == ICE_FS_FALSE) goto failure;
+    if (ice_fs_zfile_read_at(state->fd, file_size - ICE_FS_ZFILE_TRAILER_SIZE, trailer, ICE_FS_ZFILE_TRAILER_SIZE) == ICE_FS_FALSE) goto failure;
+    if (ice_fs_zfile_parse(header, trailer, file_size, &state->block_size, &state->blocks_count, &state->size) == ICE_FS_FALSE) goto malformed;
+
+    index_offset = (file_size - ICE_FS_ZFILE_TRAILER_SIZE - (((ice_fs_offset) state->blocks_count) * ICE_FS_ZFILE_ENTRY_SIZE));
+
+    state->index = ICE_FS_MALLOC((state->blocks_count * ICE_FS_ZFILE_ENTRY_SIZE) + 1);
+    state->block = ICE_FS_MALLOC(state->block_size);
+    state->packed = ICE_FS_MALLOC(state->block_size);
+    if ((state->index == 0) || (state->block == 0) || (state->packed == 0)) goto failure;
+
+    if (ice_fs_zfile_read_at(state->fd, index_offset, state->index, state->blocks_count * ICE_FS_ZFILE_ENTRY_SIZE) == ICE_FS_FALSE) goto failure;
+    if (ice_fs_zfile_check_index(state->index, trailer, state->blocks_count, state->block_size, state->size, index_offset) == ICE_FS_FALSE) goto malformed;
+
+    stream->handle = state;
+    return ICE_FS_TRUE;
+
+malformed:
+    errno = EINVAL;
+
+failure:
+    (void) ice_fs_zstream_free(state);
+
+    return ICE_FS_FALSE;
+}
+
+/* Reads up to len bytes of uncompressed content from stream into dst and stores number of read bytes in read_len (Less than len only at end of content), Blocks that dst covers whole are decompressed straight into it, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_read(ice_fs_zstream *stream, void *dst, unsigned long len, unsigned long *read_len) {
+    ice_fs_zstream_state *state;
+    unsigned char *bytes = (unsigned char*) dst;
+    unsigned long total = 0;
+
+    if (read_len != 0) *read_len = 0;
+    if ((stream == 0) || (stream->handle == 0) || ((dst == 0) && (len > 0))) return ICE_FS_FALSE;
+
+    state = (ice_fs_zstream_state*) stream->handle;
+    if (state->writing == ICE_FS_TRUE) return ICE_FS_FALSE;
+
+    while ((total < len) && (state->pos < state->size)) {
+        unsigned long index = (unsigned long)(state->pos / state->block_size),
+                      start = (unsigned long)(state->pos % state->block_size),
+                      block_len = ice_fs_zfile_block_len(state->size, state->block_size, index), count;
+
+        if (state->block_index == index) {
+            count = (((len - total) < (block_len - start)) ? (len - total) : (block_len - start));
+            memcpy(bytes + total, state->block + start, count);
+        } else if ((start == 0) && ((len - total) >= block_len)) {
+            count = block_len;
+            if (ice_fs_zstream_load(state, index, bytes + total) == ICE_FS_FALSE) break;
+        } else {
+            /* Block that dst covers partially is kept for next reads */
+            state->block_index = ICE_FS_ZFILE_NONE;
+            if (ice_fs_zstream_load(state, index, state->block) == ICE_FS_FALSE) break;
+
+            state->block_index = index;
+            continue;
+        }
+
+        state->pos += count;
+        total += count;
+    }
+
+    if (read_len != 0) *read_len = total;
+
+    return ((total == len) || (state->pos == state->size)) ? ICE_FS_TRUE : ICE_FS_FALSE;
+}
+
+/* Writes len bytes from src to stream, Each ICE_FS_ZSTREAM_BLOCK_SIZE bytes are compressed into block and written once collected, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_write(ice_fs_zstream *stream, const void *src, unsigned long len) {
+    ice_fs_zstream_state *state;
+    const unsigned char *bytes = (const unsigned char*) src;
+
+    if ((stream == 0) || (stream->handle == 0) || ((src == 0) && (len > 0))) return ICE_FS_FALSE;
+
+    state = (ice_fs_zstream_state*) stream->handle;
+    if (state->writing == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+    while (len > 0) {
+        unsigned long count;
+
+        /* Whole blocks are compressed straight from src */
+        if ((state->block_len == 0) && (len >= state->block_size)) {
+            if (ice_fs_zstream_store(state, bytes, state->block_size) == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+            bytes += state->block_size;
+            len -= state->block_size;
+            continue;
+        }
+
+        count = (((state->block_size - state->block_len) < len) ? (state->block_size - state->block_len) : len);
+        memcpy(state->block + state->block_len, bytes, count);
+
+        state->block_len += count;
+        bytes += count;
+        len -= count;
+
+        if (state->block_len == state->block_size) {
+            if (ice_fs_zstream_store(state, state->block, state->block_len) == ICE_FS_FALSE) return ICE_FS_FALSE;
+            state->block_len = 0;
+        }
+    }
+
+    return ICE_FS_TRUE;
+}
+
+/* Moves position of stream opened for reading to offset of uncompressed content (Only block that holds it gets decompressed on next read), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_seek(ice_fs_zstream *stream, ice_fs_offset offset) {
+    ice_fs_zstream_state *state;
+
+    if ((stream == 0) || (stream->handle == 0)) return ICE_FS_FALSE;
+
+    state = (ice_fs_zstream_state*) stream->handle;
+    if ((state->writing == ICE_FS_TRUE) || (offset < 0) || (offset > state->size)) return ICE_FS_FALSE;
+
+    state->pos = offset;
+
+    return ICE_FS_TRUE;
+}
+
+/* Stores uncompressed size of content of stream in size (Bytes written so far for streams opened for writing), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_size(const ice_fs_zstream *stream, ice_fs_offset *size) {
+    const ice_fs_zstream_state *state;
+
+    if ((stream == 0) || (stream->handle == 0) || (size == 0)) return ICE_FS_FALSE;
+
+    state = (const ice_fs_zstream_state*) stream->handle;
+    *size = (state->size + state->block_len);
+
+    return ICE_FS_TRUE;
+}
+
+/* Closes stream opened by ice_fs_zstream_open after writing pending bytes and index of blocks (For streams opened for writing), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_zstream_close(ice_fs_zstream *stream) {
+    ice_fs_zstream_state *state;
+    ice_fs_bool res = ICE_FS_TRUE;
+
+    if ((stream == 0) || (stream->handle == 0)) return ICE_FS_FALSE;
+
+    state = (ice_fs_zstream_state*) stream->handle;
+    stream->handle = 0;
+
+    if (state->writing == ICE_FS_TRUE) {
+        if (state->block_len > 0) res = ice_fs_zstream_store(state, state->block, state->block_len);
+        if (res == ICE_FS_TRUE) res = ice_fs_zfile_finish(state->fd, state->index, state->blocks_count, state->size);
+    }
+
+    if (ice_fs_zstream_free(state) == ICE_FS_FALSE) res = ICE_FS_FALSE;
+
+    return res;
+}
+
+/* [INTERNAL] Thread of ice_fs_compress_file and ice_fs_compressed_file_content, Takes blocks till none are left or one fails */
+static void ice_fs_zblocks_worker(void *arg) {
+    ice_fs_zblocks_ctx *ctx = (ice_fs_zblocks_ctx*) arg;
+    unsigned long *table = 0;
+
+    if (ctx->compress == ICE_FS_TRUE) {
+        table = ICE_FS_MALLOC((1UL << ICE_FS_LZ_HASH_BITS) * sizeof(unsigned long));
+
+        if (table == 0) {
+            ice_fs_mutex_lock(&ctx->mutex);
+            ctx->failed = ICE_FS_TRUE;
+            ice_fs_mutex_unlock(&ctx->mutex);
+
+            return;
+        }
+    }
+
+    for (;;) {
+        unsigned long i, block;
+        ice_fs_bool done = ICE_FS_TRUE;
+
+        ice_fs_mutex_lock(&ctx->mutex);
+        i = ctx->next;
+        if ((i < ctx->count) && (ctx->failed == ICE_FS_FALSE)) ctx->next++;
+        else i = ctx->count;
+        ice_fs_mutex_unlock(&ctx->mutex);
+
+        if (i == ctx->count) break;
+
+        block = (ctx->first + i);
+
+        if (ctx->compress == ICE_FS_TRUE) {
+            ctx->sizes[i] = ice_fs_zfile_pack(ctx->src + (((ice_fs_offset) block) * ctx->block_size), ice_fs_zfile_block_len(ctx->size, ctx->block_size, block), ctx->dst + (i * ctx->block_size), table);
+        } else {
+            const unsigned char *entry = ctx->index + (block * ICE_FS_ZFILE_ENTRY_SIZE);
+            done = ice_fs_zfile_unpack(entry, ctx->src + ice_fs_le_get(entry, 8), ctx->dst + (((ice_fs_offset) block) * ctx->block_size));
+        }
+
+        if (done == ICE_FS_FALSE) {
+            ice_fs_mutex_lock(&ctx->mutex);
+            ctx->failed = ICE_FS_TRUE;
+            ice_fs_mutex_unlock(&ctx->mutex);
+        }
+    }
+
+    ICE_FS_FREE(table);
+}
+
+/* [INTERNAL] Compresses or decompresses blocks of ctx on multiple threads, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool ice_fs_zblocks_run(ice_fs_zblocks_ctx *ctx) {
+    ice_fs_thread *threads = 0;
+    unsigned long threads_count = ice_fs_get_threads_count(), started = 0, i;
+
+    if (threads_count > ctx->count) threads_count = ctx->count;
+
+    ctx->next = 0;
+    ctx->failed = ICE_FS_FALSE;
+    ice_fs_mutex_init(&ctx->mutex);
+
+    /* Without threads everything runs on calling thread */
+    if (threads_count > 1) threads = ICE_FS_MALLOC((threads_count - 1) * sizeof(ice_fs_thread));
+
+    if (threads != 0) {
+        for (i = 0; i < (threads_count - 1); i++) {
+            if (ice_fs_thread_start(&threads[started], ice_fs_zblocks_worker, ctx) == ICE_FS_FALSE) break;
+            started++;
+        }
+    }
+
+    ice_fs_zblocks_worker(ctx);
+
+    for (i = 0; i < started; i++) ice_fs_thread_join(&threads[i]);
+
+    ICE_FS_FREE(threads);
+    ice_fs_mutex_destroy(&ctx->mutex);
+
+    return (ctx->failed == ICE_FS_TRUE) ? ICE_FS_FALSE : ICE_FS_TRUE;
+}
+
+/* Compresses file in path into compressed_path (Same format ice_fs_zstream_write creates, With blocks of ICE_FS_ZSTREAM_BLOCK_SIZE bytes compressed on multiple threads), Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+ICE_FS_API ice_fs_bool ICE_FS_CALLCONV ice_fs_compress_file(const char *path, const char *compressed_path) {
+    ice_fs_zblocks_ctx ctx;
+    ice_fs_map_view view;
+    unsigned char header[ICE_FS_ZFILE_HEADER_SIZE], *index = 0, *packed = 0;
+    unsigned long *sizes = 0, blocks_count, batch, i;
+    ice_fs_offset file_pos = ICE_FS_ZFILE_HEADER_SIZE;
+    ice_fs_bool res = ICE_FS_FALSE;
+    int fd;
+
+    if ((path == 0) || (compressed_path == 0)) return ICE_FS_FALSE;
+    if (ice_fs_map(path, ICE_FS_MAP_HINT_SEQUENTIAL, ICE_FS_FALSE, &view) == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+    fd = ice_fs_zfile_open_fd(compressed_path, ICE_FS_STREAM_MODE_WRITE);
+
+    if (fd == -1) {
+        (void) ice_fs_unmap(&view);
+        return ICE_FS_FALSE;
+    }
+
+    ctx.src = (const unsigned char*) view.data;
+    ctx.index = 0;
+    ctx.size = (ice_fs_offset) view.size;
+    ctx.block_size = ICE_FS_ZSTREAM_BLOCK_SIZE;
+    ctx.compress = ICE_FS_TRUE;
+
+    blocks_count = ((view.size / ctx.block_size) + (((view.size % ctx.block_size) != 0) ? 1 : 0));
+
+    /* Blocks are compressed in batches of few per thread, So memory use doesn't grow with size of the file */
+    batch = (ice_fs_get_threads_count() * 4);
+    if (batch > blocks_count) batch = blocks_count;
+
+    index = ICE_FS_MALLOC((blocks_count * ICE_FS_ZFILE_ENTRY_SIZE) + 1);
+    packed = ICE_FS_MALLOC((batch * ctx.block_size) + 1);
+    sizes = ICE_FS_MALLOC((batch * sizeof(unsigned long)) + 1);
+    if ((index == 0) || (packed == 0) || (sizes == 0)) goto end;
+
+    ctx.dst = packed;
+    ctx.sizes = sizes;
+
+    ice_fs_zfile_header(header, ctx.block_size);
+    if (ice_fs_write_fd(fd, header, ICE_FS_ZFILE_HEADER_SIZE) == ICE_FS_FALSE) goto end;
+
+    for (ctx.first = 0; ctx.first < blocks_count; ctx.first += batch) {
+        ctx.count = (((blocks_count - ctx.first) < batch) ? (blocks_count - ctx.first) : batch);
+        if (ice_fs_zblocks_run(&ctx) == ICE_FS_FALSE) goto end;
+
+        /* Blocks are written in order once whole batch is compressed */
+        for (i = 0; i < ctx.count; i++) {
+            unsigned long block = (ctx.first + i), len = ice_fs_zfile_block_len(ctx.size, ctx.block_size, block);
+            const unsigned char *stored = ((sizes[i] == 0) ? (ctx.src + (((ice_fs_offset) block) * ctx.block_size)) : (packed + (i * ctx.block_size)));
+            unsigned char *entry = index + (block * ICE_FS_ZFILE_ENTRY_SIZE);
+
+            if (ice_fs_write_fd(fd, stored, ((sizes[i] == 0) ? len : sizes[i])) == ICE_FS_FALSE) goto end;
+
+            ice_fs_le_put(entry, (ice_fs_hash_value) file_pos, 8);
+            ice_fs_le_put(entry + 8, ((sizes[i] == 0) ? (len | ICE_FS_ZFILE_RAW_FLAG) : sizes[i]), 4);
+            ice_fs_le_put(entry + 12, len, 4);
+            ice_fs_le_put(entry + 16, ice_fs_hash(stored, ((sizes[i] == 0) ? len : sizes[i])), 8);
+
+            file_pos += ((sizes[i] == 0) ? len : sizes[i]);
+        }
+    }
+
+    res = ice_fs_zfile_finish(fd, index, blocks_count, ctx.size);
+
+end:
+    if (close(fd) == -1) res = ICE_FS_FALSE;
+    if (ice_fs_unmap(&view) == ICE_FS_FALSE) res = ICE_FS_FALSE;
+
+    /* Partial file is removed, So it can't be read by mistake */
+    if (res == ICE_FS_FALSE) (void) ice_fs_remove(compressed_path);
+
+    ICE_FS_FREE(index);
+    ICE_FS_FREE(packed);
+    ICE_FS_FREE(sizes);
+
+    return res;
+}
+
+/* Same like ice_fs_file_content but file in path is compressed file (Created by ice_fs_compress_file or ice_fs_zstream_write) that is decompressed straight into returned buffer (Blocks on multiple threads), Returns NULL on failure (Or if the file is malformed) */
+ICE_FS_API char* ICE_FS_CALLCONV ice_fs_compressed_file_content(const char *path, unsigned long *file_size) {
+    ice_fs_zblocks_ctx ctx;
+    ice_fs_map_view view;
+    const unsigned char *data;
+    unsigned long blocks_count;
+    ice_fs_offset index_offset;
+    char *res = 0;
+
+    if (path == 0) return 0;
+    if (ice_fs_map(path, ICE_FS_MAP_HINT_WILLNEED, ICE_FS_FALSE, &view) == ICE_FS_FALSE) return 0;
+
+    data = (const unsigned char*) view.data;
+
+    if ((view.size < (ICE_FS_ZFILE_HEADER_SIZE + ICE_FS_ZFILE_TRAILER_SIZE)) ||
+        (ice_fs_zfile_parse(data, data + view.size - ICE_FS_ZFILE_TRAILER_SIZE, (ice_fs_offset) view.size, &ctx.block_size, &blocks_count, &ctx.size) == ICE_FS_FALSE)) goto malformed;
+
+    index_offset = (((ice_fs_offset) view.size) - ICE_FS_ZFILE_TRAILER_SIZE - (((ice_fs_offset) blocks_count) * ICE_FS_ZFILE_ENTRY_SIZE));
+    if (ice_fs_zfile_check_index(data + index_offset, data + view.size - ICE_FS_ZFILE_TRAILER_SIZE, blocks_count, ctx.block_size, ctx.size, index_offset) == ICE_FS_FALSE) goto malformed;
+
+    /* Content should fit in memory */
+    if ((ice_fs_offset)((unsigned long)(ctx.size + 1)) != (ctx.size + 1)) goto malformed;
+
+    res = ICE_FS_MALLOC((unsigned long)(ctx.size + 1));
+    if (res == 0) goto end;
+
+    ctx.src = data;
+    ctx.dst = (unsigned char*) res;
+    ctx.index = data + index_offset;
+    ctx.sizes = 0;
+    ctx.first = 0;
+    ctx.count = blocks_count;
+    ctx.compress = ICE_FS_FALSE;
+
+    if (ice_fs_zblocks_run(&ctx) == ICE_FS_FALSE) {
+        ICE_FS_FREE(res);
+        goto malformed;
+    }
+
+    res[ctx.size] = 0;
+    if (file_size != 0) *file_size = (unsigned long) ctx.size;
+
+    goto end;
+
+malformed:
+    res = 0;
+    errno = EINVAL;
+
+end:
+    (void) ice_fs_unmap(&view);
+
+    return res;
+}
+
 #endif  /* ICE_FS_IMPL */
 #endif  /* ICE_FS_H */
 
@@ -0,0 +1,88 @@
+/* Measures throughput of copying big file with ice_fs_copy (Usage: bench_ice_fs_copy [size in MiB] [runs]) */
+#define ICE_FS_IMPL 1
+#include "ice_fs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Returns current time in seconds from monotonic clock */
+static double now(void) {
+#if defined(_WIN32)
+    return (double) clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+#endif
+}
+
+/* Writes mib MiB of pseudo-random bytes (Including NUL bytes) to file in path, Returns ICE_FS_TRUE on success or ICE_FS_FALSE on failure */
+static ice_fs_bool write_random_file(const char *path, unsigned long mib) {
+    static unsigned char chunk[1024 * 1024];
+    unsigned long seed = 12345, i;
+    ice_fs_stream stream;
+
+    for (i = 0; i < sizeof(chunk); i++) {
+        seed = (seed * 1103515245UL) + 12345UL;
+        chunk[i] = (unsigned char) (seed >> 16);
+    }
+
+    if (ice_fs_stream_open(&stream, path, ICE_FS_STREAM_MODE_WRITE, NULL, 0) == ICE_FS_FALSE) return ICE_FS_FALSE;
+
+    for (i = 0; i < mib; i++) {
+        if (ice_fs_stream_write(&stream, chunk, sizeof(chunk)) == ICE_FS_FALSE) {
+            (void) ice_fs_stream_close(&stream);
+            return ICE_FS_FALSE;
+        }
+    }
+
+    return ice_fs_stream_close(&stream);
+}
+
+/* Returns size in bytes of file in path or -1 on failure */
+static ice_fs_offset file_size(const char *path) {
+    ice_fs_stat_info info;
+    if (ice_fs_get_stats(&path, 1, ICE_FS_STAT_SIZE, &info) == ICE_FS_FALSE) return -1;
+    return (info.error == 0) ? info.size : -1;
+}
+
+int main(int argc, char **argv) {
+    unsigned long mib = (argc > 1) ? strtoul(argv[1], NULL, 10) : 512;
+    unsigned long runs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 3;
+    unsigned long i;
+    double best = -1, bytes = (double) mib * 1024 * 1024;
+
+    if (write_random_file("bench_copy_src.bin", mib) == ICE_FS_FALSE) {
+        printf("ERROR: failed to create bench_copy_src.bin!\n");
+        (void) ice_fs_remove("bench_copy_src.bin");
+        return 1;
+    }
+
+    /* Best of runs, Target is removed before each run so every run creates it */
+    for (i = 0; i < runs; i++) {
+        double start, elapsed;
+        ice_fs_bool res;
+
+        (void) ice_fs_remove("bench_copy_dst.bin");
+
+        start = now();
+        res = ice_fs_copy("bench_copy_src.bin", "bench_copy_dst.bin");
+        elapsed = now() - start;
+
+        if ((res == ICE_FS_FALSE) || (file_size("bench_copy_dst.bin") != (ice_fs_offset) bytes)) {
+            printf("ERROR: ice_fs_copy failed to copy bench_copy_src.bin!\n");
+            (void) ice_fs_remove("bench_copy_src.bin");
+            (void) ice_fs_remove("bench_copy_dst.bin");
+            return 1;
+        }
+
+        if ((best < 0) || (elapsed < best)) best = elapsed;
+    }
+
+    printf("ice_fs_copy: %lu MiB in %.4f s (%.1f MB/s, Best of %lu runs)\n", mib, best, (best > 0) ? (bytes / best / 1e6) : 0.0, runs);
+
+    (void) ice_fs_remove("bench_copy_src.bin");
+    (void) ice_fs_remove("bench_copy_dst.bin");
+    return 0;
+}
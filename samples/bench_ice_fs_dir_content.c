@@ -0,0 +1,66 @@
+/* Measures how many entries per second ice_fs_dir_content lists (Usage: bench_ice_fs_dir_content [entries] [runs]) */
+#define ICE_FS_IMPL 1
+#include "ice_fs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Returns current time in seconds from monotonic clock */
+static double now(void) {
+#if defined(_WIN32)
+    return (double) clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+#endif
+}
+
+int main(int argc, char **argv) {
+    unsigned long entries = (argc > 1) ? strtoul(argv[1], NULL, 10) : 100000;
+    unsigned long runs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 5;
+    unsigned long i;
+    double best = -1;
+    char path[64];
+
+    (void) ice_fs_remove_all("bench_dir_content");
+
+    if (ice_fs_create("bench_dir_content", ICE_FS_OBJECT_TYPE_DIR) == ICE_FS_FALSE) {
+        printf("ERROR: failed to create bench_dir_content!\n");
+        return 1;
+    }
+
+    /* Empty files, So only listing of the folder is measured */
+    for (i = 0; i < entries; i++) {
+        sprintf(path, "bench_dir_content/entry_%lu", i);
+
+        if (ice_fs_create(path, ICE_FS_OBJECT_TYPE_FILE) == ICE_FS_FALSE) {
+            printf("ERROR: failed to create %s!\n", path);
+            (void) ice_fs_remove_all("bench_dir_content");
+            return 1;
+        }
+    }
+
+    /* Best of runs, First run warms cache of directory entries */
+    for (i = 0; i < runs; i++) {
+        double start = now(), elapsed;
+        ice_fs_dir dir = ice_fs_dir_content("bench_dir_content");
+        elapsed = now() - start;
+
+        if (dir.items_count != entries) {
+            printf("ERROR: listed %lu entries instead of %lu!\n", dir.items_count, entries);
+            ice_fs_free_dir_content(&dir);
+            (void) ice_fs_remove_all("bench_dir_content");
+            return 1;
+        }
+
+        ice_fs_free_dir_content(&dir);
+        if ((best < 0) || (elapsed < best)) best = elapsed;
+    }
+
+    printf("ice_fs_dir_content: %lu entries in %.4f s (%.0f entries/s, Best of %lu runs)\n", entries, best, (best > 0) ? ((double) entries / best) : 0.0, runs);
+
+    (void) ice_fs_remove_all("bench_dir_content");
+    return 0;
+}
@@ -0,0 +1,126 @@
+/* Compares cached and direct I/O streams writing and reading big file in 1 MiB transfers (Usage: bench_ice_fs_direct_io [size in MiB] [runs]) */
+#define ICE_FS_IMPL 1
+#include "ice_fs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if !defined(_WIN32)
+#  include <unistd.h>
+#endif
+
+#define TRANSFER_SIZE (1024 * 1024)
+
+/* Returns current time in seconds from monotonic clock */
+static double now(void) {
+#if defined(_WIN32)
+    return (double) clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+#endif
+}
+
+/* Writes mib MiB from data to bench_direct_io.bin in mode and syncs it to disk, Returns seconds it took or -1 on failure */
+static double bench_write(ice_fs_stream_mode mode, const void *data, unsigned long mib) {
+    double start = now();
+    ice_fs_stream stream;
+    unsigned long i;
+
+    if (ice_fs_stream_open(&stream, "bench_direct_io.bin", mode, NULL, 0) == ICE_FS_FALSE) return -1;
+
+    for (i = 0; i < mib; i++) {
+        if (ice_fs_stream_write(&stream, data, TRANSFER_SIZE) == ICE_FS_FALSE) {
+            (void) ice_fs_stream_close(&stream);
+            return -1;
+        }
+    }
+
+    /* Cached writes only reach page cache, So both modes are timed until data is on disk */
+    if (ice_fs_stream_flush(&stream) == ICE_FS_FALSE) {
+        (void) ice_fs_stream_close(&stream);
+        return -1;
+    }
+
+#if !defined(_WIN32)
+    (void) fsync(stream.fd);
+#endif
+
+    if (ice_fs_stream_close(&stream) == ICE_FS_FALSE) return -1;
+    return now() - start;
+}
+
+/* Drops bench_direct_io.bin from page cache then reads it in mode into data, Returns seconds it took or -1 on failure */
+static double bench_read(ice_fs_stream_mode mode, void *data, unsigned long mib) {
+    unsigned long read_len, total = 0;
+    ice_fs_stream stream;
+    double start;
+
+    if (ice_fs_stream_open(&stream, "bench_direct_io.bin", ICE_FS_STREAM_MODE_READ, NULL, 0) == ICE_FS_FALSE) return -1;
+    (void) ice_fs_stream_advise(&stream, 0, 0, ICE_FS_STREAM_HINT_DONTNEED);
+    (void) ice_fs_stream_close(&stream);
+
+    start = now();
+    if (ice_fs_stream_open(&stream, "bench_direct_io.bin", mode, NULL, 0) == ICE_FS_FALSE) return -1;
+
+    do {
+        if (ice_fs_stream_read(&stream, data, TRANSFER_SIZE, &read_len) == ICE_FS_FALSE) {
+            (void) ice_fs_stream_close(&stream);
+            return -1;
+        }
+
+        total += read_len;
+    } while (read_len > 0);
+
+    (void) ice_fs_stream_close(&stream);
+    return (total == (mib * TRANSFER_SIZE)) ? (now() - start) : -1;
+}
+
+/* Returns smaller time of best and elapsed (Failures are -1) */
+static double best_of(double best, double elapsed) {
+    if (elapsed < 0) return best;
+    return ((best < 0) || (elapsed < best)) ? elapsed : best;
+}
+
+int main(int argc, char **argv) {
+    unsigned long mib = (argc > 1) ? strtoul(argv[1], NULL, 10) : 512;
+    unsigned long runs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 3;
+    double write_cached = -1, write_direct = -1, read_cached = -1, read_direct = -1, bytes = (double) mib * TRANSFER_SIZE;
+    unsigned long seed = 12345, i;
+    unsigned char *data;
+
+    /* Transfers of direct streams should be aligned */
+    data = (unsigned char*) ice_fs_aligned_alloc(TRANSFER_SIZE, 0);
+
+    if (data == NULL) {
+        printf("ERROR: failed to allocate transfer buffer!\n");
+        return 1;
+    }
+
+    for (i = 0; i < TRANSFER_SIZE; i++) {
+        seed = (seed * 1103515245UL) + 12345UL;
+        data[i] = (unsigned char) (seed >> 16);
+    }
+
+    for (i = 0; i < runs; i++) {
+        write_cached = best_of(write_cached, bench_write(ICE_FS_STREAM_MODE_WRITE, data, mib));
+        read_cached = best_of(read_cached, bench_read(ICE_FS_STREAM_MODE_READ, data, mib));
+        write_direct = best_of(write_direct, bench_write(ICE_FS_STREAM_MODE_DIRECT_WRITE, data, mib));
+        read_direct = best_of(read_direct, bench_read(ICE_FS_STREAM_MODE_DIRECT_READ, data, mib));
+    }
+
+    (void) ice_fs_remove("bench_direct_io.bin");
+    ice_fs_aligned_free(data);
+
+    if ((write_cached < 0) || (read_cached < 0) || (write_direct < 0) || (read_direct < 0)) {
+        printf("ERROR: failed to write or read bench_direct_io.bin!\n");
+        return 1;
+    }
+
+    printf("Write (With sync): cached %.1f MB/s, direct %.1f MB/s (%lu MiB, Best of %lu runs)\n", bytes / write_cached / 1e6, bytes / write_direct / 1e6, mib, runs);
+    printf("Read (Cold cache): cached %.1f MB/s, direct %.1f MB/s (%lu MiB, Best of %lu runs)\n", bytes / read_cached / 1e6, bytes / read_direct / 1e6, mib, runs);
+
+    return 0;
+}
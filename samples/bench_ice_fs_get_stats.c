@@ -0,0 +1,121 @@
+/* Compares metadata queries of many files one call at a time against ice_fs_get_stats (Usage: bench_ice_fs_get_stats [files] [runs]), Build with -DICE_FS_NO_STATX to measure the stat fallback */
+#define ICE_FS_IMPL 1
+#include "ice_fs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/stat.h>
+
+/* Returns current time in seconds from monotonic clock */
+static double now(void) {
+#if defined(_WIN32)
+    return (double) clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+#endif
+}
+
+/* Removes files created so far then the folder */
+static void cleanup(char **paths, unsigned long count) {
+    unsigned long i;
+    for (i = 0; i < count; i++) free(paths[i]);
+    free(paths);
+    (void) ice_fs_remove_all("bench_get_stats");
+}
+
+int main(int argc, char **argv) {
+    unsigned long files = (argc > 1) ? strtoul(argv[1], NULL, 10) : 20000;
+    unsigned long runs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 5;
+    unsigned long i, j, created = 0;
+    double best_calls = -1, best_bulk = -1;
+    char date_str[ICE_FS_DATE_STR_SIZE];
+    ice_fs_stat_info *infos;
+    char **paths;
+
+    (void) ice_fs_remove_all("bench_get_stats");
+
+    paths = (char**) calloc((files > 0) ? files : 1, sizeof(char*));
+    infos = (ice_fs_stat_info*) calloc((files > 0) ? files : 1, sizeof(ice_fs_stat_info));
+
+    if ((paths == NULL) || (infos == NULL) || (ice_fs_create("bench_get_stats", ICE_FS_OBJECT_TYPE_DIR) == ICE_FS_FALSE)) {
+        printf("ERROR: failed to create bench_get_stats!\n");
+        free(infos);
+        cleanup(paths, 0);
+        return 1;
+    }
+
+    for (created = 0; created < files; created++) {
+        paths[created] = (char*) malloc(64);
+
+        if (paths[created] == NULL) break;
+        sprintf(paths[created], "bench_get_stats/file_%lu", created);
+
+        if (ice_fs_file_write(paths[created], "content", ICE_FS_FALSE) == ICE_FS_FALSE) {
+            created++;
+            break;
+        }
+    }
+
+    if (created != files) {
+        printf("ERROR: failed to create files of bench_get_stats!\n");
+        free(infos);
+        cleanup(paths, created);
+        return 1;
+    }
+
+    /* Best of runs, Both ways retrieve type, Modification date, Size and permission bits of every file */
+    for (i = 0; i < runs; i++) {
+        double start = now(), elapsed;
+
+        for (j = 0; j < files; j++) {
+            ice_fs_date date;
+            struct stat info;
+
+            if ((ice_fs_type(paths[j]) != ICE_FS_OBJECT_TYPE_FILE) ||
+                (ice_fs_get_date_r(paths[j], ICE_FS_LAST_MODIFICATION_DATE, &date, date_str, sizeof(date_str)) == ICE_FS_FALSE) ||
+                (stat(paths[j], &info) == -1)) {
+                printf("ERROR: failed to retrieve metadata of %s!\n", paths[j]);
+                free(infos);
+                cleanup(paths, files);
+                return 1;
+            }
+        }
+
+        elapsed = now() - start;
+        if ((best_calls < 0) || (elapsed < best_calls)) best_calls = elapsed;
+
+        start = now();
+
+        if (ice_fs_get_stats((const char**) paths, files, ICE_FS_STAT_ALL, infos) == ICE_FS_FALSE) {
+            printf("ERROR: ice_fs_get_stats failed!\n");
+            free(infos);
+            cleanup(paths, files);
+            return 1;
+        }
+
+        elapsed = now() - start;
+        if ((best_bulk < 0) || (elapsed < best_bulk)) best_bulk = elapsed;
+
+        for (j = 0; j < files; j++) {
+            if ((infos[j].error != 0) || (infos[j].type != ICE_FS_OBJECT_TYPE_FILE) || (infos[j].size != 7)) {
+                printf("ERROR: ice_fs_get_stats retrieved wrong metadata of %s!\n", paths[j]);
+                free(infos);
+                cleanup(paths, files);
+                return 1;
+            }
+        }
+    }
+
+#if defined(ICE_FS_NO_STATX)
+    printf("Metadata: stat (ICE_FS_NO_STATX)\n");
+#endif
+    printf("Per call (ice_fs_type + ice_fs_get_date_r + stat): %lu files in %.4f s (Best of %lu runs)\n", files, best_calls, runs);
+    printf("ice_fs_get_stats: %lu files in %.4f s (Best of %lu runs)\n", files, best_bulk, runs);
+
+    free(infos);
+    cleanup(paths, files);
+    return 0;
+}
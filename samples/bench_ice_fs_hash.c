@@ -0,0 +1,86 @@
+/* Measures throughput of ice_fs_hash on memory and ice_fs_file_hash on file (Usage: bench_ice_fs_hash [size in MiB] [runs]), Build with -DICE_FS_NO_SIMD to measure the scalar path */
+#define ICE_FS_IMPL 1
+#include "ice_fs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Returns current time in seconds from monotonic clock */
+static double now(void) {
+#if defined(_WIN32)
+    return (double) clock() / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + ((double) ts.tv_nsec / 1e9);
+#endif
+}
+
+int main(int argc, char **argv) {
+    unsigned long mib = (argc > 1) ? strtoul(argv[1], NULL, 10) : 64;
+    unsigned long runs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 5;
+    unsigned long size = mib * 1024 * 1024, seed = 12345, i;
+    double best_mem = -1, best_file = -1;
+    ice_fs_hash_value mem_hash = 0, file_hash = 0;
+    unsigned char *data;
+    ice_fs_stream stream;
+
+    data = (unsigned char*) malloc((size > 0) ? size : 1);
+
+    if (data == NULL) {
+        printf("ERROR: failed to allocate %lu MiB!\n", mib);
+        return 1;
+    }
+
+    for (i = 0; i < size; i++) {
+        seed = (seed * 1103515245UL) + 12345UL;
+        data[i] = (unsigned char) (seed >> 16);
+    }
+
+    /* Same bytes on disk, First file hash reads them back into page cache if they aren't there yet */
+    if ((ice_fs_stream_open(&stream, "bench_hash.bin", ICE_FS_STREAM_MODE_WRITE, NULL, 0) == ICE_FS_FALSE) ||
+        (ice_fs_stream_write(&stream, data, size) == ICE_FS_FALSE) ||
+        (ice_fs_stream_close(&stream) == ICE_FS_FALSE)) {
+        printf("ERROR: failed to create bench_hash.bin!\n");
+        (void) ice_fs_remove("bench_hash.bin");
+        free(data);
+        return 1;
+    }
+
+    for (i = 0; i < runs; i++) {
+        double start = now(), elapsed;
+        mem_hash = ice_fs_hash(data, size);
+        elapsed = now() - start;
+        if ((best_mem < 0) || (elapsed < best_mem)) best_mem = elapsed;
+
+        start = now();
+
+        if (ice_fs_file_hash("bench_hash.bin", &file_hash) == ICE_FS_FALSE) {
+            printf("ERROR: ice_fs_file_hash failed to hash bench_hash.bin!\n");
+            (void) ice_fs_remove("bench_hash.bin");
+            free(data);
+            return 1;
+        }
+
+        elapsed = now() - start;
+        if ((best_file < 0) || (elapsed < best_file)) best_file = elapsed;
+    }
+
+    if (mem_hash != file_hash) {
+        printf("ERROR: hash of file doesn't match hash of same bytes in memory!\n");
+        (void) ice_fs_remove("bench_hash.bin");
+        free(data);
+        return 1;
+    }
+
+#if defined(ICE_FS_NO_SIMD)
+    printf("Hashing path: scalar (ICE_FS_NO_SIMD)\n");
+#endif
+    printf("ice_fs_hash: %lu MiB in %.4f s (%.1f MB/s, Best of %lu runs)\n", mib, best_mem, (best_mem > 0) ? ((double) size / best_mem / 1e6) : 0.0, runs);
+    printf("ice_fs_file_hash: %lu MiB in %.4f s (%.1f MB/s, Best of %lu runs)\n", mib, best_file, (best_file > 0) ? ((double) size / best_file / 1e6) : 0.0, runs);
+
+    (void) ice_fs_remove("bench_hash.bin");
+    free(data);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/* Checks that ice_fs_copy recreates symbolic links of copied folder as links (Exits with 0 on success or 1 on failure) */
+#define ICE_FS_IMPL 1
+#include "ice_fs.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+int main(void) {
+    printf("SKIPPED: creating symbolic links needs extra privileges on Microsoft Windows\n");
+    return 0;
+}
+#else
+#include <unistd.h>
+#include <sys/stat.h>
+
+/* Helper */
+#define check(cond, str) if (!(cond)) { printf("[%s : line %d] FAILED: %s\n", __FILE__, __LINE__, str); failed = 1; }
+
+/* Returns 1 if path is symbolic link whose target is expected or 0 if not */
+static int is_link_to(const char *path, const char *expected) {
+    char target[256];
+    struct stat info;
+    ssize_t len;
+
+    if ((lstat(path, &info) == -1) || !S_ISLNK(info.st_mode)) return 0;
+
+    len = readlink(path, target, sizeof(target) - 1);
+    if (len == -1) return 0;
+    target[len] = 0;
+
+    return (strcmp(target, expected) == 0) ? 1 : 0;
+}
+
+int main(void) {
+    int failed = 0;
+    ice_fs_bool res;
+
+    (void) ice_fs_remove_all("copy_links_src");
+    (void) ice_fs_remove_all("copy_links_dst");
+
+    /* copy_links_src: file, dir/inner, link_file -> file, link_dir -> dir, dangling -> missing */
+    if ((ice_fs_create("copy_links_src", ICE_FS_OBJECT_TYPE_DIR) == ICE_FS_FALSE) ||
+        (ice_fs_create("copy_links_src/dir", ICE_FS_OBJECT_TYPE_DIR) == ICE_FS_FALSE) ||
+        (ice_fs_file_write("copy_links_src/file", "content", ICE_FS_FALSE) == ICE_FS_FALSE) ||
+        (ice_fs_file_write("copy_links_src/dir/inner", "inner", ICE_FS_FALSE) == ICE_FS_FALSE) ||
+        (symlink("file", "copy_links_src/link_file") == -1) ||
+        (symlink("dir", "copy_links_src/link_dir") == -1) ||
+        (symlink("missing", "copy_links_src/dangling") == -1) ||
+        (ice_fs_create("copy_links_dst", ICE_FS_OBJECT_TYPE_DIR) == ICE_FS_FALSE)) {
+        printf("ERROR: failed to create source tree!\n");
+        return 1;
+    }
+
+    /* Content of the source folder is copied into the existing destination folder */
+    res = ice_fs_copy("copy_links_src", "copy_links_dst");
+    check(res == ICE_FS_TRUE, "ice_fs_copy failed to copy folder with symbolic links");
+
+    check(ice_fs_type("copy_links_dst/file") == ICE_FS_OBJECT_TYPE_FILE, "file was not copied");
+    check(ice_fs_type("copy_links_dst/dir/inner") == ICE_FS_OBJECT_TYPE_FILE, "content of folder was not copied");
+    check(is_link_to("copy_links_dst/link_file", "file"), "link to file was not copied as link");
+    check(is_link_to("copy_links_dst/link_dir", "dir"), "link to folder was not copied as link");
+    check(is_link_to("copy_links_dst/dangling", "missing"), "dangling link was not copied as link");
+
+    (void) ice_fs_remove_all("copy_links_src");
+    (void) ice_fs_remove_all("copy_links_dst");
+
+    if (failed == 0) printf("ice_fs_copy copies symbolic links as links\n");
+
+    return failed;
+}
+#endif